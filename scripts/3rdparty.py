@@ -276,6 +276,27 @@ elif name == 'openfec':
     os.chdir('..')
     install_tree('src', os.path.join(builddir, 'include'), match=['*.h'])
     install_files('%s/libopenfec.a' % dist, os.path.join(builddir, 'lib'))
+elif name == 'opus':
+    download(
+      'https://archive.mozilla.org/pub/opus/opus-%s.tar.gz' % ver,
+        'opus-%s.tar.gz' % ver,
+        logfile,
+        vendordir)
+    extract('opus-%s.tar.gz' % ver,
+            'opus-%s' % ver)
+    os.chdir('opus-%s' % ver)
+    execute('./configure --host=%s %s %s' % (
+        toolchain,
+        makeflags(workdir, toolchain, [], cflags='-fPIC -fvisibility=hidden'),
+        ' '.join([
+            '--enable-static',
+            '--disable-shared',
+            '--disable-doc',
+            '--disable-extra-programs',
+        ])), logfile)
+    execute('make -j', logfile)
+    install_files('include/*.h', os.path.join(builddir, 'include', 'opus'))
+    install_files('.libs/libopus.a', os.path.join(builddir, 'lib'))
 elif name == 'alsa':
     download(
       'ftp://ftp.alsa-project.org/pub/lib/alsa-lib-%s.tar.bz2' % ver,
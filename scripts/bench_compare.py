@@ -0,0 +1,98 @@
+#! /usr/bin/python2
+from __future__ import print_function
+
+import sys
+import re
+import json
+import argparse
+
+# Compares two JSON reports produced by roc-bench (or Google Benchmark) and
+# fails if throughput of any benchmark dropped by more than the threshold.
+
+def load(path):
+    try:
+        with open(path) as fp:
+            report = json.load(fp)
+    except (IOError, ValueError) as e:
+        print("error: can't read %s: %s" % (path, e), file=sys.stderr)
+        sys.exit(2)
+
+    results = dict()
+    for bench in report.get('benchmarks', []):
+        if bench.get('error_occurred'):
+            continue
+        if bench.get('run_type') == 'aggregate':
+            continue
+        results[bench['name']] = bench
+    return results
+
+# Returns throughput of benchmark, higher is better.
+def throughput(bench):
+    if bench.get('items_per_second', 0) > 0:
+        return bench['items_per_second'], 'items/s'
+    if bench.get('bytes_per_second', 0) > 0:
+        return bench['bytes_per_second'], 'B/s'
+    return 1e9 / max(bench['cpu_time'], 1e-9), 'iter/s'
+
+def human(value):
+    for div, suffix in [(1e9, 'G'), (1e6, 'M'), (1e3, 'k')]:
+        if value >= div:
+            return '%.2f%s' % (value / div, suffix)
+    return '%.2f' % value
+
+parser = argparse.ArgumentParser(
+    description='compare two benchmark reports')
+
+parser.add_argument('baseline', help='baseline JSON report')
+parser.add_argument('current', help='current JSON report')
+
+parser.add_argument('--threshold', type=float, default=5.0,
+                    help='maximum allowed throughput drop, percents (default 5)')
+parser.add_argument('--filter', default=None,
+                    help='compare only benchmarks matching regex')
+
+args = parser.parse_args()
+
+baseline = load(args.baseline)
+current = load(args.current)
+
+names = sorted(set(baseline.keys()) | set(current.keys()))
+if args.filter:
+    names = [n for n in names if re.search(args.filter, n)]
+
+print('%-40s %14s %14s %9s' % ('Benchmark', 'Baseline', 'Current', 'Change'))
+print('-' * 80)
+
+regressions = []
+
+for name in names:
+    if name not in baseline:
+        print('%-40s %14s %14s %9s' % (name, '-', 'new', ''))
+        continue
+    if name not in current:
+        print('%-40s %14s %14s %9s' % (name, 'removed', '-', ''))
+        continue
+
+    old, unit = throughput(baseline[name])
+    new, _ = throughput(current[name])
+
+    change = (new - old) / old * 100.0
+
+    mark = ''
+    if change < -args.threshold:
+        mark = '  REGRESSION'
+        regressions.append(name)
+
+    print('%-40s %14s %14s %+8.1f%%%s' % (
+        name, human(old), human(new), change, mark))
+
+print()
+
+if regressions:
+    print('%d benchmark(s) regressed by more than %.1f%%:' % (
+        len(regressions), args.threshold))
+    for name in regressions:
+        print('  %s' % name)
+    sys.exit(1)
+
+print('no regressions above %.1f%%' % args.threshold)
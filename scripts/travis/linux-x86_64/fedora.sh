@@ -1,4 +1,4 @@
 #! /bin/bash
 set -euxo pipefail
 scons -Q clean
-scons -Q --enable-werror --build-3rdparty=openfec,cpputest test
+scons -Q --enable-werror --build-3rdparty=openfec,opus,cpputest test
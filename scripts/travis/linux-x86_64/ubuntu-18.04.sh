@@ -7,7 +7,7 @@ scons -Q \
       --enable-werror \
       --enable-debug \
       --sanitizers=all \
-      --build-3rdparty=openfec,cpputest \
+      --build-3rdparty=openfec,opus,cpputest \
       --compiler=clang-6.0 \
       test
 
@@ -16,7 +16,7 @@ do
     scons -Q \
           --enable-werror \
           --enable-pulseaudio-modules \
-          --build-3rdparty=openfec,pulseaudio \
+          --build-3rdparty=openfec,opus,pulseaudio \
           --compiler=$c \
           test
 done
@@ -12,12 +12,12 @@ scons -Q \
       --enable-werror \
       --enable-debug \
       --sanitizers=address \
-      --build-3rdparty=uv,openfec,sox,cpputest \
+      --build-3rdparty=uv,openfec,opus,sox,cpputest \
       test
 
 scons -Q \
       --enable-werror \
-      --build-3rdparty=uv,openfec,sox,cpputest \
+      --build-3rdparty=uv,openfec,opus,sox,cpputest \
       test
 
 scons -Q \
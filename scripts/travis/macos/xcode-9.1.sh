@@ -14,12 +14,12 @@ scons -Q \
       --enable-werror \
       --enable-debug \
       --sanitizers=all \
-      --build-3rdparty=openfec,cpputest \
+      --build-3rdparty=openfec,opus,cpputest \
       test
 
 scons -Q \
       --enable-werror \
-      --build-3rdparty=openfec,cpputest \
+      --build-3rdparty=openfec,opus,cpputest \
       test
 
 scons -Q \
@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "roc_bench/bench.h"
+#include "roc_core/crash.h"
+#include "roc_core/log.h"
+
+using namespace roc;
+
+namespace {
+
+enum { MaxNameSize = 128, MaxResults = 512, MaxIterations = 1000000000 };
+
+struct Options {
+    const char* filter;
+    const char* json_path;
+    double min_time;
+    bool list;
+    bool verbose;
+
+    Options()
+        : filter(NULL)
+        , json_path(NULL)
+        , min_time(0.5)
+        , list(false)
+        , verbose(false) {
+    }
+};
+
+struct Result {
+    char name[MaxNameSize];
+    size_t iterations;
+    double real_time;
+    double cpu_time;
+    double items_per_second;
+    double bytes_per_second;
+    const char* counter_names[bench::State::MaxCounters];
+    double counter_values[bench::State::MaxCounters];
+    size_t n_counters;
+    const char* error;
+};
+
+Result results[MaxResults];
+size_t n_results = 0;
+
+void print_usage(const char* argv0) {
+    printf("Usage: %s [OPTIONS]\n\n"
+           "  -h, --help               Print help and exit\n"
+           "  -v, --verbose            Enable debug logging\n"
+           "      --list               List benchmarks and exit\n"
+           "      --filter=STRING      Run only benchmarks with STRING in name\n"
+           "      --min-time=SECONDS   Minimum measured time per benchmark"
+           " (default 0.5)\n"
+           "      --json=FILE          Write results to FILE in JSON format\n",
+           argv0);
+}
+
+bool parse_options(Options& opts, int argc, char** argv) {
+    for (int n = 1; n < argc; n++) {
+        const char* arg = argv[n];
+
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            exit(0);
+        } else if (strcmp(arg, "-v") == 0 || strcmp(arg, "--verbose") == 0) {
+            opts.verbose = true;
+        } else if (strcmp(arg, "--list") == 0) {
+            opts.list = true;
+        } else if (strncmp(arg, "--filter=", 9) == 0) {
+            opts.filter = arg + 9;
+        } else if (strncmp(arg, "--json=", 7) == 0) {
+            opts.json_path = arg + 7;
+        } else if (strncmp(arg, "--min-time=", 11) == 0) {
+            char* end = NULL;
+            opts.min_time = strtod(arg + 11, &end);
+            if (!end || *end || opts.min_time <= 0) {
+                fprintf(stderr, "invalid --min-time: should be positive number\n");
+                return false;
+            }
+        } else {
+            fprintf(stderr, "unknown option: %s\n", arg);
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+void format_name(char* buf, const bench::Registrar& reg, size_t n_arg) {
+    if (reg.num_args() != 0) {
+        snprintf(buf, MaxNameSize, "%s/%lu", reg.name(),
+                 (unsigned long)reg.args()[n_arg]);
+    } else {
+        snprintf(buf, MaxNameSize, "%s", reg.name());
+    }
+}
+
+void format_rate(char* buf, size_t bufsz, double rate, const char* unit) {
+    const char* suffix = "";
+    if (rate >= 1e9) {
+        rate /= 1e9;
+        suffix = "G";
+    } else if (rate >= 1e6) {
+        rate /= 1e6;
+        suffix = "M";
+    } else if (rate >= 1e3) {
+        rate /= 1e3;
+        suffix = "k";
+    }
+    snprintf(buf, bufsz, "%.2f%s%s", rate, suffix, unit);
+}
+
+// Runs the benchmark with growing number of iterations until the measured
+// time reaches min_time.
+void run_benchmark(Result& result,
+                   const bench::Registrar& reg,
+                   size_t arg,
+                   double min_time) {
+    const double min_time_ns = min_time * core::Second;
+
+    size_t n_iters = 1;
+
+    for (;;) {
+        bench::State state(arg, n_iters);
+        reg.func()(state);
+
+        if (state.error()) {
+            result.error = state.error();
+            return;
+        }
+
+        if (!state.finished()) {
+            result.error = "benchmark exited the loop early";
+            return;
+        }
+
+        const double real_time = (double)state.real_time();
+
+        if (real_time >= min_time_ns || n_iters >= MaxIterations) {
+            const double cpu_time =
+                (double)std::max(state.cpu_time(), (core::nanoseconds_t)1);
+
+            result.iterations = n_iters;
+            result.real_time = real_time / n_iters;
+            result.cpu_time = (double)state.cpu_time() / n_iters;
+            result.items_per_second = state.items() * (double)core::Second / cpu_time;
+            result.bytes_per_second = state.bytes() * (double)core::Second / cpu_time;
+
+            result.n_counters = state.num_counters();
+            for (size_t n = 0; n < result.n_counters; n++) {
+                result.counter_names[n] = state.counter_name(n);
+                result.counter_values[n] = state.counter_value(n);
+            }
+            return;
+        }
+
+        double multiplier = 10;
+        if (real_time > min_time_ns / 10) {
+            multiplier = min_time_ns * 1.4 / real_time;
+        }
+
+        const double next_iters = n_iters * multiplier;
+        if (next_iters >= MaxIterations) {
+            n_iters = MaxIterations;
+        } else {
+            n_iters = std::max((size_t)next_iters, n_iters + 1);
+        }
+    }
+}
+
+void print_header() {
+    printf("%-40s %14s %14s %12s  %s\n", "Benchmark", "Time", "CPU", "Iterations",
+           "Throughput");
+    for (size_t n = 0; n < 100; n++) {
+        putchar('-');
+    }
+    putchar('\n');
+}
+
+void print_result(const Result& result) {
+    if (result.error) {
+        printf("%-40s ERROR: %s\n", result.name, result.error);
+        fflush(stdout);
+        return;
+    }
+
+    char items[64] = "", bytes[64] = "";
+    if (result.items_per_second > 0) {
+        format_rate(items, sizeof(items), result.items_per_second, " items/s");
+    }
+    if (result.bytes_per_second > 0) {
+        format_rate(bytes, sizeof(bytes), result.bytes_per_second, "B/s");
+    }
+
+    printf("%-40s %11.0f ns %11.0f ns %12lu  %s%s%s", result.name, result.real_time,
+           result.cpu_time, (unsigned long)result.iterations, items,
+           *items && *bytes ? " " : "", bytes);
+    for (size_t n = 0; n < result.n_counters; n++) {
+        printf(" %s=%.0f", result.counter_names[n], result.counter_values[n]);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+bool write_json(const char* path, const char* argv0, double min_time) {
+    FILE* fp = fopen(path, "w");
+    if (!fp) {
+        fprintf(stderr, "can't open %s\n", path);
+        return false;
+    }
+
+    char date[64] = "";
+    const time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"context\": {\n");
+    fprintf(fp, "    \"date\": \"%s\",\n", date);
+    fprintf(fp, "    \"executable\": \"%s\",\n", argv0);
+    fprintf(fp, "    \"num_cpus\": %ld,\n", (long)sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(fp, "    \"min_time\": %g\n", min_time);
+    fprintf(fp, "  },\n");
+    fprintf(fp, "  \"benchmarks\": [");
+
+    for (size_t n = 0; n < n_results; n++) {
+        const Result& result = results[n];
+
+        fprintf(fp, "%s\n    {\n", n == 0 ? "" : ",");
+        fprintf(fp, "      \"name\": \"%s\",\n", result.name);
+
+        if (result.error) {
+            fprintf(fp, "      \"error_occurred\": true,\n");
+            fprintf(fp, "      \"error_message\": \"%s\"\n", result.error);
+        } else {
+            fprintf(fp, "      \"iterations\": %lu,\n", (unsigned long)result.iterations);
+            fprintf(fp, "      \"real_time\": %.3f,\n", result.real_time);
+            fprintf(fp, "      \"cpu_time\": %.3f,\n", result.cpu_time);
+            fprintf(fp, "      \"time_unit\": \"ns\",\n");
+            fprintf(fp, "      \"items_per_second\": %.3f,\n", result.items_per_second);
+            fprintf(fp, "      \"bytes_per_second\": %.3f", result.bytes_per_second);
+            for (size_t c = 0; c < result.n_counters; c++) {
+                fprintf(fp, ",\n      \"%s\": %.3f", result.counter_names[c],
+                        result.counter_values[c]);
+            }
+            fprintf(fp, "\n");
+        }
+
+        fprintf(fp, "    }");
+    }
+
+    fprintf(fp, "\n  ]\n}\n");
+
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "can't write %s\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    core::CrashHandler crash_handler;
+
+    Options opts;
+    if (!parse_options(opts, argc, argv)) {
+        return 1;
+    }
+
+    if (opts.verbose) {
+        core::Logger::instance().set_level(LogDebug);
+    } else {
+        core::Logger::instance().set_level(LogNone);
+    }
+
+    if (!opts.list) {
+        print_header();
+    }
+
+    bool ok = true;
+
+    for (bench::Registrar* reg = bench::Registrar::first(); reg; reg = reg->next()) {
+        const size_t n_args = std::max(reg->num_args(), (size_t)1);
+
+        for (size_t n_arg = 0; n_arg < n_args; n_arg++) {
+            char name[MaxNameSize];
+            format_name(name, *reg, n_arg);
+
+            if (opts.filter && !strstr(name, opts.filter)) {
+                continue;
+            }
+
+            if (opts.list) {
+                printf("%s\n", name);
+                continue;
+            }
+
+            if (n_results == MaxResults) {
+                fprintf(stderr, "too many benchmarks\n");
+                return 1;
+            }
+
+            Result& result = results[n_results++];
+            memset(&result, 0, sizeof(result));
+            strcpy(result.name, name);
+
+            run_benchmark(result, *reg, reg->num_args() ? reg->args()[n_arg] : 0,
+                          opts.min_time);
+            print_result(result);
+
+            if (result.error) {
+                ok = false;
+            }
+        }
+    }
+
+    if (opts.json_path && !opts.list) {
+        if (!write_json(opts.json_path, argv[0], opts.min_time)) {
+            return 1;
+        }
+    }
+
+    return ok ? 0 : 1;
+}
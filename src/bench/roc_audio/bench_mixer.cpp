@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/mixer.h"
+#include "roc_bench/bench.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { NumCh = 2, FrameSize = 512 * NumCh, MaxInputs = 16 };
+
+core::HeapAllocator allocator;
+core::BufferPool<sample_t> buffer_pool(allocator, FrameSize, false);
+
+// Produces a constant signal.
+class ConstReader : public IReader {
+public:
+    ConstReader()
+        : value_(0) {
+    }
+
+    void set_value(sample_t value) {
+        value_ = value;
+    }
+
+    virtual void read(Frame& frame) {
+        sample_t* data = frame.data();
+
+        for (size_t n = 0; n < frame.size(); n++) {
+            data[n] = value_;
+        }
+    }
+
+private:
+    sample_t value_;
+};
+
+// Argument is number of mixed inputs.
+void bench_mixer(bench::State& state) {
+    ConstReader readers[MaxInputs];
+
+    Mixer mixer(buffer_pool, FrameSize, false);
+    if (!mixer.valid()) {
+        state.set_error("can't create mixer");
+        return;
+    }
+
+    for (size_t n = 0; n < state.arg() && n < MaxInputs; n++) {
+        readers[n].set_value(0.01f * n);
+        mixer.add(readers[n]);
+    }
+
+    sample_t samples[FrameSize];
+    Frame frame(samples, FrameSize);
+
+    while (state.running()) {
+        mixer.read(frame);
+        bench::do_not_optimize(samples);
+    }
+
+    state.add_items((uint64_t)state.iterations() * FrameSize / NumCh);
+}
+
+// Argument is number of mixed inputs.
+// Mixes directly into 16-bit output.
+void bench_mixer_read_s16(bench::State& state) {
+    ConstReader readers[MaxInputs];
+
+    Mixer mixer(buffer_pool, FrameSize, false);
+    if (!mixer.valid()) {
+        state.set_error("can't create mixer");
+        return;
+    }
+
+    for (size_t n = 0; n < state.arg() && n < MaxInputs; n++) {
+        readers[n].set_value(0.01f * n);
+        mixer.add(readers[n]);
+    }
+
+    int16_t samples[FrameSize];
+
+    while (state.running()) {
+        mixer.read_as(samples, FrameSize, SampleFormat_S16LE, NumCh);
+        bench::do_not_optimize(samples);
+    }
+
+    state.add_items((uint64_t)state.iterations() * FrameSize / NumCh);
+}
+
+const size_t mixer_args[] = { 1, 2, 8, 16 };
+
+ROC_BENCH_ARGS(bench_mixer, mixer_args);
+ROC_BENCH_ARGS(bench_mixer_read_s16, mixer_args);
+
+} // namespace
+
+} // namespace audio
+} // namespace roc
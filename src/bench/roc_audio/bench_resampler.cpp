@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/resampler_reader.h"
+#include "roc_bench/bench.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { ChMask = 0x3, NumCh = 2, FrameSize = 512 * NumCh };
+
+const float Scaling = 0.999f;
+
+core::HeapAllocator allocator;
+core::BufferPool<sample_t> buffer_pool(allocator, FrameSize, false);
+
+// Produces a sawtooth signal.
+class GeneratorReader : public IReader {
+public:
+    GeneratorReader()
+        : value_(0) {
+    }
+
+    virtual void read(Frame& frame) {
+        sample_t* data = frame.data();
+
+        for (size_t n = 0; n < frame.size(); n++) {
+            data[n] = value_;
+            value_ += 0.001f;
+            if (value_ > 1) {
+                value_ = -1;
+            }
+        }
+    }
+
+private:
+    sample_t value_;
+};
+
+// Argument is resampler window size.
+void bench_resampler(bench::State& state) {
+    ResamplerConfig config;
+    config.window_size = state.arg();
+
+    GeneratorReader generator;
+    ResamplerReader reader(generator, buffer_pool, config, ChMask, FrameSize);
+
+    if (!reader.valid() || !reader.set_scaling(Scaling)) {
+        state.set_error("can't create resampler");
+        return;
+    }
+
+    sample_t samples[FrameSize];
+    Frame frame(samples, FrameSize);
+
+    while (state.running()) {
+        reader.read(frame);
+        bench::do_not_optimize(samples);
+    }
+
+    state.add_items((uint64_t)state.iterations() * FrameSize / NumCh);
+}
+
+// Argument is resampler window size. Measures resampler construction, which
+// is a part of every new receiver and sender session, when the sinc table is
+// already cached because another resampler uses it.
+void bench_resampler_create_cached(bench::State& state) {
+    ResamplerConfig config;
+    config.window_size = state.arg();
+
+    GeneratorReader generator;
+    ResamplerReader holder(generator, buffer_pool, config, ChMask, FrameSize);
+
+    if (!holder.valid()) {
+        state.set_error("can't create resampler");
+        return;
+    }
+
+    while (state.running()) {
+        ResamplerReader reader(generator, buffer_pool, config, ChMask, FrameSize);
+        if (!reader.valid()) {
+            state.set_error("can't create resampler");
+            return;
+        }
+    }
+
+    state.add_items((uint64_t)state.iterations());
+}
+
+// Argument is resampler window size. Measures resampler construction when
+// the sinc table is not cached and is built from scratch.
+void bench_resampler_create_uncached(bench::State& state) {
+    ResamplerConfig config;
+    config.window_size = state.arg();
+
+    GeneratorReader generator;
+
+    while (state.running()) {
+        ResamplerReader reader(generator, buffer_pool, config, ChMask, FrameSize);
+        if (!reader.valid()) {
+            state.set_error("can't create resampler");
+            return;
+        }
+    }
+
+    state.add_items((uint64_t)state.iterations());
+}
+
+const size_t resampler_args[] = { 16, 32, 64, 128 };
+
+ROC_BENCH_ARGS(bench_resampler, resampler_args);
+ROC_BENCH_ARGS(bench_resampler_create_cached, resampler_args);
+ROC_BENCH_ARGS(bench_resampler_create_uncached, resampler_args);
+
+} // namespace
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <time.h>
+
+#include "roc_bench/bench.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace bench {
+
+namespace {
+
+core::nanoseconds_t thread_cpu_timestamp() {
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == -1) {
+        roc_panic("bench: clock_gettime(CLOCK_THREAD_CPUTIME_ID) failed");
+    }
+    return core::nanoseconds_t(ts.tv_sec) * 1000000000 + core::nanoseconds_t(ts.tv_nsec);
+}
+
+} // namespace
+
+State::State(size_t arg, size_t n_iterations)
+    : arg_(arg)
+    , n_iterations_(n_iterations)
+    , n_remaining_(n_iterations)
+    , started_(false)
+    , timing_(false)
+    , real_start_(0)
+    , cpu_start_(0)
+    , real_time_(0)
+    , cpu_time_(0)
+    , items_(0)
+    , bytes_(0)
+    , n_counters_(0)
+    , error_(NULL) {
+}
+
+size_t State::arg() const {
+    return arg_;
+}
+
+size_t State::iterations() const {
+    return n_iterations_;
+}
+
+bool State::running() {
+    if (!started_) {
+        started_ = true;
+        start_timing_();
+    }
+
+    if (n_remaining_ == 0 || error_) {
+        stop_timing_();
+        return false;
+    }
+
+    n_remaining_--;
+    return true;
+}
+
+void State::pause_timing() {
+    stop_timing_();
+}
+
+void State::resume_timing() {
+    start_timing_();
+}
+
+void State::add_items(uint64_t n_items) {
+    items_ += n_items;
+}
+
+void State::add_bytes(uint64_t n_bytes) {
+    bytes_ += n_bytes;
+}
+
+void State::set_counter(const char* name, double value) {
+    roc_panic_if(!name);
+
+    for (size_t n = 0; n < n_counters_; n++) {
+        if (strcmp(counter_names_[n], name) == 0) {
+            counter_values_[n] = value;
+            return;
+        }
+    }
+
+    if (n_counters_ == MaxCounters) {
+        roc_panic("bench: too many counters");
+    }
+
+    counter_names_[n_counters_] = name;
+    counter_values_[n_counters_] = value;
+    n_counters_++;
+}
+
+void State::set_error(const char* message) {
+    error_ = message;
+}
+
+core::nanoseconds_t State::real_time() const {
+    return real_time_;
+}
+
+core::nanoseconds_t State::cpu_time() const {
+    return cpu_time_;
+}
+
+uint64_t State::items() const {
+    return items_;
+}
+
+uint64_t State::bytes() const {
+    return bytes_;
+}
+
+size_t State::num_counters() const {
+    return n_counters_;
+}
+
+const char* State::counter_name(size_t n) const {
+    roc_panic_if(n >= n_counters_);
+    return counter_names_[n];
+}
+
+double State::counter_value(size_t n) const {
+    roc_panic_if(n >= n_counters_);
+    return counter_values_[n];
+}
+
+const char* State::error() const {
+    return error_;
+}
+
+bool State::finished() const {
+    return started_ && n_remaining_ == 0 && !timing_;
+}
+
+void State::start_timing_() {
+    if (timing_) {
+        return;
+    }
+    timing_ = true;
+    real_start_ = core::timestamp();
+    cpu_start_ = thread_cpu_timestamp();
+}
+
+void State::stop_timing_() {
+    if (!timing_) {
+        return;
+    }
+    timing_ = false;
+    cpu_time_ += thread_cpu_timestamp() - cpu_start_;
+    real_time_ += core::timestamp() - real_start_;
+}
+
+Registrar::Registrar(const char* name,
+                     BenchFunc func,
+                     const size_t* args,
+                     size_t n_args)
+    : name_(name)
+    , func_(func)
+    , args_(args)
+    , n_args_(n_args)
+    , next_(NULL) {
+    roc_panic_if(!name);
+    roc_panic_if(!func);
+
+    const char* prefix = "bench_";
+    if (strncmp(name_, prefix, strlen(prefix)) == 0) {
+        name_ += strlen(prefix);
+    }
+
+    Registrar** tail = &head_();
+    while (*tail) {
+        tail = &(*tail)->next_;
+    }
+    *tail = this;
+}
+
+Registrar* Registrar::first() {
+    return head_();
+}
+
+Registrar* Registrar::next() const {
+    return next_;
+}
+
+const char* Registrar::name() const {
+    return name_;
+}
+
+BenchFunc Registrar::func() const {
+    return func_;
+}
+
+const size_t* Registrar::args() const {
+    return args_;
+}
+
+size_t Registrar::num_args() const {
+    return n_args_;
+}
+
+Registrar*& Registrar::head_() {
+    static Registrar* head = NULL;
+    return head;
+}
+
+} // namespace bench
+} // namespace roc
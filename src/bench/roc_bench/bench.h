@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_bench/bench.h
+//! @brief Benchmark harness.
+
+#ifndef ROC_BENCH_BENCH_H_
+#define ROC_BENCH_BENCH_H_
+
+#include "roc_core/helpers.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace bench {
+
+//! Benchmark state.
+//! @remarks
+//!  Passed to benchmark function. The function should perform setup, then
+//!  run the measured code in a loop while running() returns true, and then
+//!  report the amount of processed data.
+class State : public core::NonCopyable<> {
+public:
+    //! Maximum number of custom counters.
+    enum { MaxCounters = 8 };
+
+    //! Initialize.
+    State(size_t arg, size_t n_iterations);
+
+    //! Get benchmark argument.
+    size_t arg() const;
+
+    //! Get number of iterations.
+    size_t iterations() const;
+
+    //! Check whether the next iteration should be performed.
+    //! @remarks
+    //!  Starts timing on the first call and stops it on the last one.
+    bool running();
+
+    //! Stop timing, e.g. to exclude per-iteration setup.
+    void pause_timing();
+
+    //! Resume timing after pause_timing().
+    void resume_timing();
+
+    //! Report number of processed items, e.g. samples or packets.
+    void add_items(uint64_t n_items);
+
+    //! Report number of processed bytes.
+    void add_bytes(uint64_t n_bytes);
+
+    //! Report custom metric, e.g. latency percentile.
+    //! @remarks
+    //!  @p name should be a string literal. Setting the same counter again
+    //!  overwrites its value.
+    void set_counter(const char* name, double value);
+
+    //! Report setup error and skip benchmark.
+    void set_error(const char* message);
+
+    //! Get measured wall clock time, nanoseconds.
+    core::nanoseconds_t real_time() const;
+
+    //! Get measured CPU time of the calling thread, nanoseconds.
+    core::nanoseconds_t cpu_time() const;
+
+    //! Get number of processed items.
+    uint64_t items() const;
+
+    //! Get number of processed bytes.
+    uint64_t bytes() const;
+
+    //! Get number of custom counters.
+    size_t num_counters() const;
+
+    //! Get name of custom counter.
+    const char* counter_name(size_t n) const;
+
+    //! Get value of custom counter.
+    double counter_value(size_t n) const;
+
+    //! Get error message or NULL.
+    const char* error() const;
+
+    //! Check if all iterations were performed.
+    bool finished() const;
+
+private:
+    void start_timing_();
+    void stop_timing_();
+
+    const size_t arg_;
+    const size_t n_iterations_;
+
+    size_t n_remaining_;
+    bool started_;
+    bool timing_;
+
+    core::nanoseconds_t real_start_;
+    core::nanoseconds_t cpu_start_;
+    core::nanoseconds_t real_time_;
+    core::nanoseconds_t cpu_time_;
+
+    uint64_t items_;
+    uint64_t bytes_;
+
+    const char* counter_names_[MaxCounters];
+    double counter_values_[MaxCounters];
+    size_t n_counters_;
+
+    const char* error_;
+};
+
+//! Benchmark function.
+typedef void (*BenchFunc)(State& state);
+
+//! Benchmark registration.
+//! @remarks
+//!  Registrars are static objects linked into a global list. Use ROC_BENCH
+//!  and ROC_BENCH_ARGS macros to define them.
+class Registrar : public core::NonCopyable<> {
+public:
+    //! Register benchmark.
+    //! @remarks
+    //!  "bench_" prefix is removed from @p name. If @p args is not NULL,
+    //!  benchmark is run once for every element of @p args.
+    Registrar(const char* name, BenchFunc func, const size_t* args, size_t n_args);
+
+    //! Get first registered benchmark.
+    static Registrar* first();
+
+    //! Get next registered benchmark.
+    Registrar* next() const;
+
+    //! Get benchmark name.
+    const char* name() const;
+
+    //! Get benchmark function.
+    BenchFunc func() const;
+
+    //! Get arguments.
+    const size_t* args() const;
+
+    //! Get number of arguments.
+    size_t num_args() const;
+
+private:
+    static Registrar*& head_();
+
+    const char* name_;
+    BenchFunc func_;
+    const size_t* args_;
+    size_t n_args_;
+
+    Registrar* next_;
+};
+
+//! Prevent compiler from optimizing out computation of @p value.
+template <class T> inline void do_not_optimize(const T& value) {
+    __asm__ __volatile__("" : : "r"(&value) : "memory");
+}
+
+} // namespace bench
+} // namespace roc
+
+//! Register benchmark function without arguments.
+#define ROC_BENCH(func)                                                                  \
+    static ::roc::bench::Registrar func##_registrar(#func, &func, NULL, 0)
+
+//! Register benchmark function for every element of array @p args.
+#define ROC_BENCH_ARGS(func, args)                                                       \
+    static ::roc::bench::Registrar func##_registrar(#func, &func, args,                  \
+                                                    ROC_ARRAY_SIZE(args))
+
+#endif // ROC_BENCH_BENCH_H_
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_bench/bench.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/pool.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { ObjectSize = 256, MaxBatch = 1024 };
+
+struct Object {
+    char data[ObjectSize];
+};
+
+HeapAllocator allocator;
+
+// Argument is number of objects allocated before freeing them.
+void bench_pool(bench::State& state) {
+    const size_t n_objects = std::min(state.arg(), (size_t)MaxBatch);
+
+    Pool<Object> pool(allocator, sizeof(Object), false);
+    if (!pool.reserve(n_objects)) {
+        state.set_error("can't reserve objects");
+        return;
+    }
+
+    void* objects[MaxBatch];
+
+    while (state.running()) {
+        for (size_t n = 0; n < n_objects; n++) {
+            objects[n] = pool.allocate();
+        }
+        bench::do_not_optimize(objects);
+
+        for (size_t n = 0; n < n_objects; n++) {
+            pool.deallocate(objects[n]);
+        }
+    }
+
+    state.add_items((uint64_t)state.iterations() * n_objects);
+}
+
+const size_t pool_args[] = { 1, 16, 256, 1024 };
+
+ROC_BENCH_ARGS(bench_pool, pool_args);
+
+} // namespace
+
+} // namespace core
+} // namespace roc
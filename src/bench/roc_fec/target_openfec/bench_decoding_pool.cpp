@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_bench/bench.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/time.h"
+#include "roc_core/time_histogram.h"
+#include "roc_core/unique_ptr.h"
+#include "roc_fec/composer.h"
+#include "roc_fec/decoding_pool.h"
+#include "roc_fec/headers.h"
+#include "roc_fec/of_decoder.h"
+#include "roc_fec/of_encoder.h"
+#include "roc_fec/reader.h"
+#include "roc_fec/writer.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/sorted_queue.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/format_map.h"
+#include "roc_rtp/headers.h"
+#include "roc_rtp/parser.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+enum {
+    NumSessions = 32,
+    NumSourcePackets = 20,
+    NumRepairPackets = 10,
+    LossPercent = 5,
+    MaxBuffSize = 2000
+};
+
+const unsigned SourceID = 555;
+const unsigned PayloadType = rtp::PayloadType_L16_Stereo;
+
+const size_t RTPPayloadSize = 1280;
+const size_t FECPayloadSize = RTPPayloadSize + sizeof(rtp::Header);
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBuffSize, false);
+packet::PacketPool packet_pool(allocator, false);
+
+rtp::FormatMap format_map;
+rtp::Parser rtp_parser(format_map, NULL);
+
+rtp::Composer rtp_composer(NULL);
+Composer<RSm8_PayloadID, Source, Footer> source_composer(&rtp_composer);
+Composer<RSm8_PayloadID, Repair, Header> repair_composer_inner(NULL);
+rtp::Composer repair_composer(&repair_composer_inner);
+
+// Splits packets into source and repair queues and loses LossPercent of
+// source packets, spread evenly.
+class Dispatcher : public packet::IWriter {
+public:
+    Dispatcher()
+        : packet_num_(0)
+        , source_queue_(0)
+        , repair_queue_(0) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        if (pp->flags() & packet::Packet::FlagAudio) {
+            if ((packet_num_++ * 37) % 100 >= LossPercent) {
+                source_queue_.write(pp);
+            }
+        } else {
+            repair_queue_.write(pp);
+        }
+    }
+
+    packet::IReader& source_reader() {
+        return source_queue_;
+    }
+
+    packet::IReader& repair_reader() {
+        return repair_queue_;
+    }
+
+private:
+    size_t packet_num_;
+
+    packet::SortedQueue source_queue_;
+    packet::SortedQueue repair_queue_;
+};
+
+// Sender and receiver sides of a single FEC stream.
+class Session {
+public:
+    Session(const Config& config, DecodingPool* decoding_pool)
+        : encoder_(config, FECPayloadSize, allocator)
+        , decoder_(config, FECPayloadSize, buffer_pool, allocator)
+        , writer_(config,
+                  FECPayloadSize,
+                  encoder_,
+                  dispatcher_,
+                  source_composer,
+                  repair_composer,
+                  packet_pool,
+                  buffer_pool,
+                  allocator)
+        , reader_(config,
+                  decoder_,
+                  dispatcher_.source_reader(),
+                  dispatcher_.repair_reader(),
+                  rtp_parser,
+                  packet_pool,
+                  decoding_pool,
+                  allocator)
+        , seqnum_(0) {
+    }
+
+    bool valid() const {
+        return encoder_.valid() && decoder_.valid() && writer_.valid()
+            && reader_.valid();
+    }
+
+    // Writes one block of source packets, repair packets are generated by writer.
+    bool write_block() {
+        for (size_t n = 0; n < NumSourcePackets; n++) {
+            packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+            core::Slice<uint8_t> bp =
+                new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+
+            if (!pp || !bp || !source_composer.prepare(*pp, bp, RTPPayloadSize)) {
+                return false;
+            }
+
+            pp->set_data(bp);
+            pp->add_flags(packet::Packet::FlagAudio);
+
+            pp->rtp()->source = SourceID;
+            pp->rtp()->payload_type = PayloadType;
+            pp->rtp()->seqnum = seqnum_;
+            pp->rtp()->timestamp = packet::timestamp_t(seqnum_ * 10);
+
+            memset(pp->rtp()->payload.data(), seqnum_ & 0xff, RTPPayloadSize);
+
+            writer_.write(pp);
+            seqnum_++;
+        }
+
+        return true;
+    }
+
+    packet::PacketPtr read() {
+        return reader_.read();
+    }
+
+private:
+    OFEncoder encoder_;
+    OFDecoder decoder_;
+
+    Dispatcher dispatcher_;
+
+    Writer writer_;
+    Reader reader_;
+
+    packet::seqnum_t seqnum_;
+};
+
+// Argument is number of decoding pool threads, zero means no pool.
+// Runs NumSessions sessions with LossPercent source packet loss. Every
+// iteration writes the next block of every session and then reads the
+// previous one, so that the pool can decode a block in background while
+// other sessions are read. Reports latency of reader read() calls.
+void bench_fec_decoding_pool(bench::State& state) {
+    Config config;
+    config.codec = ReedSolomon8m;
+    config.n_source_packets = NumSourcePackets;
+    config.n_repair_packets = NumRepairPackets;
+
+    core::UniquePtr<DecodingPool> decoding_pool;
+    if (state.arg() != 0) {
+        decoding_pool.reset(new (allocator) DecodingPool(state.arg(), allocator),
+                            allocator);
+        if (!decoding_pool || !decoding_pool->valid()) {
+            state.set_error("can't create decoding pool");
+            return;
+        }
+    }
+
+    core::UniquePtr<Session> sessions[NumSessions];
+
+    for (size_t n = 0; n < NumSessions; n++) {
+        sessions[n].reset(new (allocator) Session(config, decoding_pool.get()),
+                          allocator);
+        if (!sessions[n] || !sessions[n]->valid() || !sessions[n]->write_block()) {
+            state.set_error("can't create session");
+            return;
+        }
+    }
+
+    core::TimeHistogram read_latency;
+
+    while (state.running()) {
+        state.pause_timing();
+
+        for (size_t n = 0; n < NumSessions; n++) {
+            if (!sessions[n]->write_block()) {
+                state.set_error("can't write block");
+                return;
+            }
+        }
+
+        state.resume_timing();
+
+        for (size_t n = 0; n < NumSessions; n++) {
+            for (size_t p = 0; p < NumSourcePackets; p++) {
+                const core::nanoseconds_t start = core::timestamp();
+                packet::PacketPtr pp = sessions[n]->read();
+                read_latency.add(core::timestamp() - start);
+
+                if (!pp) {
+                    state.set_error("can't read packet");
+                    return;
+                }
+            }
+        }
+    }
+
+    state.add_items((uint64_t)state.iterations() * NumSessions * NumSourcePackets);
+
+    state.set_counter("read_p50_ns", (double)read_latency.quantile(0.50));
+    state.set_counter("read_p99_ns", (double)read_latency.quantile(0.99));
+    state.set_counter("read_max_ns", (double)read_latency.max());
+}
+
+const size_t decoding_pool_args[] = { 0, 1, 2, 4 };
+
+ROC_BENCH_ARGS(bench_fec_decoding_pool, decoding_pool_args);
+
+} // namespace
+
+} // namespace fec
+} // namespace roc
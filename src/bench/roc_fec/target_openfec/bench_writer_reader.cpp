@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_bench/bench.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_fec/composer.h"
+#include "roc_fec/headers.h"
+#include "roc_fec/of_decoder.h"
+#include "roc_fec/of_encoder.h"
+#include "roc_fec/reader.h"
+#include "roc_fec/writer.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/sorted_queue.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/format_map.h"
+#include "roc_rtp/headers.h"
+#include "roc_rtp/parser.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+enum { MaxSourcePackets = 64, MaxBuffSize = 2000 };
+
+const unsigned SourceID = 555;
+const unsigned PayloadType = rtp::PayloadType_L16_Stereo;
+
+const size_t RTPPayloadSize = 1280;
+const size_t FECPayloadSize = RTPPayloadSize + sizeof(rtp::Header);
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBuffSize, false);
+packet::PacketPool packet_pool(allocator, false);
+
+rtp::FormatMap format_map;
+rtp::Parser rtp_parser(format_map, NULL);
+
+// Splits packets into source and repair queues and loses one source packet
+// per block.
+class Dispatcher : public packet::IWriter {
+public:
+    Dispatcher(size_t block_len)
+        : block_len_(block_len)
+        , packet_num_(0)
+        , source_queue_(0)
+        , repair_queue_(0) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        if (pp->flags() & packet::Packet::FlagAudio) {
+            if (packet_num_++ % block_len_ != LostPacket) {
+                source_queue_.write(pp);
+            }
+        } else {
+            repair_queue_.write(pp);
+        }
+    }
+
+    packet::IReader& source_reader() {
+        return source_queue_;
+    }
+
+    packet::IReader& repair_reader() {
+        return repair_queue_;
+    }
+
+private:
+    enum { LostPacket = 1 };
+
+    const size_t block_len_;
+    size_t packet_num_;
+
+    packet::SortedQueue source_queue_;
+    packet::SortedQueue repair_queue_;
+};
+
+template <class SourceID_Type, class RepairID_Type>
+void run_writer_reader(bench::State& state, CodecType codec, bool decode) {
+    Config config;
+    config.codec = codec;
+    config.n_source_packets = std::min(state.arg(), (size_t)MaxSourcePackets);
+    config.n_repair_packets = config.n_source_packets / 2;
+
+    rtp::Composer rtp_composer(NULL);
+    Composer<SourceID_Type, Source, Footer> source_composer(&rtp_composer);
+    Composer<RepairID_Type, Repair, Header> repair_composer_inner(NULL);
+    rtp::Composer repair_composer(&repair_composer_inner);
+
+    OFEncoder encoder(config, FECPayloadSize, allocator);
+    OFDecoder decoder(config, FECPayloadSize, buffer_pool, allocator);
+
+    if (!encoder.valid() || !decoder.valid()) {
+        state.set_error("can't create codec");
+        return;
+    }
+
+    Dispatcher dispatcher(config.n_source_packets);
+
+    Writer writer(config, FECPayloadSize, encoder, dispatcher, source_composer,
+                  repair_composer, packet_pool, buffer_pool, allocator);
+
+    Reader reader(config, decoder, dispatcher.source_reader(),
+                  dispatcher.repair_reader(), rtp_parser, packet_pool, NULL, allocator);
+
+    if (!writer.valid() || !reader.valid()) {
+        state.set_error("can't create fec writer or reader");
+        return;
+    }
+
+    packet::PacketPtr packets[MaxSourcePackets];
+
+    packet::seqnum_t sn = 0;
+
+    while (state.running()) {
+        state.pause_timing();
+
+        for (size_t n = 0; n < config.n_source_packets; n++) {
+            packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+            core::Slice<uint8_t> bp =
+                new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+
+            if (!pp || !bp || !source_composer.prepare(*pp, bp, RTPPayloadSize)) {
+                state.set_error("can't prepare packet");
+                return;
+            }
+
+            pp->set_data(bp);
+            pp->add_flags(packet::Packet::FlagAudio);
+
+            pp->rtp()->source = SourceID;
+            pp->rtp()->payload_type = PayloadType;
+            pp->rtp()->seqnum = sn;
+            pp->rtp()->timestamp = packet::timestamp_t(sn * 10);
+
+            memset(pp->rtp()->payload.data(), sn & 0xff, RTPPayloadSize);
+
+            packets[n] = pp;
+            sn++;
+        }
+
+        state.resume_timing();
+
+        for (size_t n = 0; n < config.n_source_packets; n++) {
+            writer.write(packets[n]);
+            packets[n] = NULL;
+        }
+
+        if (decode) {
+            for (size_t n = 0; n < config.n_source_packets; n++) {
+                bench::do_not_optimize(reader.read());
+            }
+        } else {
+            state.pause_timing();
+
+            packet::PacketPtr pp;
+            while ((pp = dispatcher.source_reader().read())) {
+            }
+            while ((pp = dispatcher.repair_reader().read())) {
+            }
+
+            state.resume_timing();
+        }
+    }
+
+    state.add_items((uint64_t)state.iterations() * config.n_source_packets);
+    state.add_bytes((uint64_t)state.iterations() * config.n_source_packets
+                    * RTPPayloadSize);
+}
+
+// Argument is number of source packets per block.
+// Encodes blocks and sends source and repair packets.
+void bench_fec_rs8m_writer(bench::State& state) {
+    run_writer_reader<RSm8_PayloadID, RSm8_PayloadID>(state, ReedSolomon8m, false);
+}
+
+// Argument is number of source packets per block.
+// Encodes blocks, loses one source packet per block and repairs it.
+void bench_fec_rs8m_writer_reader(bench::State& state) {
+    run_writer_reader<RSm8_PayloadID, RSm8_PayloadID>(state, ReedSolomon8m, true);
+}
+
+// Argument is number of source packets per block.
+// Encodes blocks and sends source and repair packets.
+void bench_fec_ldpc_writer(bench::State& state) {
+    run_writer_reader<LDPC_Source_PayloadID, LDPC_Repair_PayloadID>(state, LDPCStaircase,
+                                                                    false);
+}
+
+// Argument is number of source packets per block.
+// Encodes blocks, loses one source packet per block and repairs it.
+void bench_fec_ldpc_writer_reader(bench::State& state) {
+    run_writer_reader<LDPC_Source_PayloadID, LDPC_Repair_PayloadID>(state, LDPCStaircase,
+                                                                    true);
+}
+
+const size_t fec_args[] = { 10, 20, 40 };
+
+ROC_BENCH_ARGS(bench_fec_rs8m_writer, fec_args);
+ROC_BENCH_ARGS(bench_fec_rs8m_writer_reader, fec_args);
+ROC_BENCH_ARGS(bench_fec_ldpc_writer, fec_args);
+ROC_BENCH_ARGS(bench_fec_ldpc_writer_reader, fec_args);
+
+} // namespace
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_bench/bench.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/time.h"
+#include "roc_core/time_histogram.h"
+#include "roc_netio/transceiver.h"
+#include "roc_packet/concurrent_queue.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/parse_address.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+enum { BufferSize = 200 };
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, BufferSize, false);
+packet::PacketPool packet_pool(allocator, false);
+
+packet::PacketPtr
+new_packet(packet::Address tx_addr, packet::Address rx_addr, core::nanoseconds_t ts) {
+    packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+    if (!pp) {
+        return NULL;
+    }
+
+    core::Slice<uint8_t> bp = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+    if (!bp) {
+        return NULL;
+    }
+    bp.resize(BufferSize);
+
+    pp->add_flags(packet::Packet::FlagUDP);
+    pp->set_data(bp);
+
+    pp->udp()->src_addr = tx_addr;
+    pp->udp()->dst_addr = rx_addr;
+    pp->udp()->send_time = ts;
+
+    return pp;
+}
+
+// Argument is interval between packets in microseconds. Every iteration
+// sends one paced packet over loopback and waits until it's received.
+// Reports how much the interval between receive timestamps of consecutive
+// packets deviates from the expected one, and how late packets arrive
+// relative to their send time.
+void bench_udp_pacing(bench::State& state) {
+    const core::nanoseconds_t interval =
+        core::nanoseconds_t(state.arg()) * core::Microsecond;
+
+    packet::Address tx_addr;
+    packet::Address rx_addr;
+    if (!packet::parse_address("127.0.0.1:0", tx_addr)
+        || !packet::parse_address("127.0.0.1:0", rx_addr)) {
+        state.set_error("can't parse address");
+        return;
+    }
+
+    packet::ConcurrentQueue rx_queue;
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    if (!trx.valid()) {
+        state.set_error("can't create transceiver");
+        return;
+    }
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr, UDPSenderConfig());
+    if (!tx_sender || !trx.add_udp_receiver(rx_addr, rx_queue) || !trx.start()) {
+        state.set_error("can't start transceiver");
+        return;
+    }
+
+    core::TimeHistogram jitter;
+    core::TimeHistogram lateness;
+
+    const core::nanoseconds_t start = core::timestamp() + interval;
+
+    core::nanoseconds_t prev_receive_ts = 0;
+    size_t n = 0;
+
+    while (state.running()) {
+        const core::nanoseconds_t send_time = start + interval * core::nanoseconds_t(n);
+
+        packet::PacketPtr pp = new_packet(tx_addr, rx_addr, send_time);
+        if (!pp) {
+            state.set_error("can't create packet");
+            break;
+        }
+
+        tx_sender->write(pp);
+
+        pp = rx_queue.read();
+
+        const core::nanoseconds_t receive_ts = pp->udp()->receive_timestamp;
+
+        if (n != 0) {
+            const core::nanoseconds_t delta = receive_ts - prev_receive_ts - interval;
+            jitter.add(delta < 0 ? -delta : delta);
+        }
+        lateness.add(receive_ts - send_time);
+
+        prev_receive_ts = receive_ts;
+        n++;
+    }
+
+    trx.stop();
+    trx.join();
+
+    trx.remove_port(tx_addr);
+    trx.remove_port(rx_addr);
+
+    state.add_items(n);
+
+    state.set_counter("jitter_p50_ns", (double)jitter.quantile(0.50));
+    state.set_counter("jitter_p99_ns", (double)jitter.quantile(0.99));
+    state.set_counter("jitter_max_ns", (double)jitter.max());
+    state.set_counter("late_p50_ns", (double)lateness.quantile(0.50));
+    state.set_counter("late_p99_ns", (double)lateness.quantile(0.99));
+}
+
+const size_t udp_pacing_args[] = { 500, 2500, 5000 };
+
+ROC_BENCH_ARGS(bench_udp_pacing, udp_pacing_args);
+
+} // namespace
+
+} // namespace netio
+} // namespace roc
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_bench/bench.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/router.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { MaxRoutes = 2, NumPackets = 64, SourceID = 123 };
+
+core::HeapAllocator allocator;
+PacketPool pool(allocator, false);
+
+// Counts written packets.
+class CountingWriter : public IWriter {
+public:
+    CountingWriter()
+        : n_packets_(0) {
+    }
+
+    virtual void write(const PacketPtr&) {
+        n_packets_++;
+    }
+
+    size_t num_packets() const {
+        return n_packets_;
+    }
+
+private:
+    size_t n_packets_;
+};
+
+// Routes interleaved audio and repair packets of a single source.
+void bench_router(bench::State& state) {
+    Router router(allocator, MaxRoutes);
+
+    CountingWriter audio_writer;
+    CountingWriter repair_writer;
+
+    if (!router.valid() || !router.add_route(audio_writer, Packet::FlagAudio)
+        || !router.add_route(repair_writer, Packet::FlagRepair)) {
+        state.set_error("can't create router");
+        return;
+    }
+
+    PacketPtr packets[NumPackets];
+    for (size_t n = 0; n < NumPackets; n++) {
+        packets[n] = new (pool) Packet(pool);
+        if (!packets[n]) {
+            state.set_error("can't allocate packet");
+            return;
+        }
+        packets[n]->add_flags(Packet::FlagRTP
+                              | (n % 3 == 2 ? Packet::FlagRepair : Packet::FlagAudio));
+        packets[n]->rtp()->source = SourceID;
+    }
+
+    while (state.running()) {
+        for (size_t n = 0; n < NumPackets; n++) {
+            router.write(packets[n]);
+        }
+    }
+
+    bench::do_not_optimize(audio_writer.num_packets() + repair_writer.num_packets());
+
+    state.add_items((uint64_t)state.iterations() * NumPackets);
+}
+
+ROC_BENCH(bench_router);
+
+} // namespace
+
+} // namespace packet
+} // namespace roc
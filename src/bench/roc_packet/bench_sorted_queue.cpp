@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_bench/bench.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/sorted_queue.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { MaxPackets = 1024, ReorderPeriod = 8 };
+
+core::HeapAllocator allocator;
+PacketPool pool(allocator, false);
+
+// Argument is number of packets written before reading them back.
+// Every ReorderPeriod packets, two adjacent packets are swapped.
+void bench_sorted_queue(bench::State& state) {
+    const size_t n_packets = std::min(state.arg(), (size_t)MaxPackets);
+
+    PacketPtr packets[MaxPackets];
+    for (size_t n = 0; n < n_packets; n++) {
+        packets[n] = new (pool) Packet(pool);
+        if (!packets[n]) {
+            state.set_error("can't allocate packet");
+            return;
+        }
+        packets[n]->add_flags(Packet::FlagRTP);
+    }
+
+    SortedQueue queue(0);
+
+    seqnum_t sn = 0;
+
+    while (state.running()) {
+        for (size_t n = 0; n < n_packets; n++) {
+            size_t pos = n;
+            if (n % ReorderPeriod == 0 && n + 1 < n_packets) {
+                pos = n + 1;
+            } else if (n % ReorderPeriod == 1) {
+                pos = n - 1;
+            }
+            packets[n]->rtp()->seqnum = seqnum_t(sn + pos);
+            queue.write(packets[n]);
+        }
+
+        for (size_t n = 0; n < n_packets; n++) {
+            bench::do_not_optimize(queue.read());
+        }
+
+        sn += seqnum_t(n_packets);
+    }
+
+    state.add_items((uint64_t)state.iterations() * n_packets);
+}
+
+const size_t sorted_queue_args[] = { 1, 16, 128, 1024 };
+
+ROC_BENCH_ARGS(bench_sorted_queue, sorted_queue_args);
+
+} // namespace
+
+} // namespace packet
+} // namespace roc
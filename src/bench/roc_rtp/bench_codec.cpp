@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <math.h>
+
+#include "roc_bench/bench.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/unique_ptr.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/format_map.h"
+
+namespace roc {
+namespace rtp {
+
+namespace {
+
+enum { MaxChannels = 2, MaxSamples = 2880, MaxBufSize = 4096 };
+
+const core::nanoseconds_t PacketLength = 20 * core::Millisecond;
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBufSize, false);
+packet::PacketPool packet_pool(allocator, false);
+
+FormatMap format_map;
+
+// Prepares packet for given number of samples.
+packet::PacketPtr new_packet(audio::IEncoder& encoder, size_t num_samples) {
+    packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+    if (!pp) {
+        return NULL;
+    }
+
+    core::Slice<uint8_t> bp = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+    if (!bp) {
+        return NULL;
+    }
+
+    Composer composer(NULL);
+    if (!composer.prepare(*pp, bp, encoder.payload_size(num_samples))) {
+        return NULL;
+    }
+
+    pp->set_data(bp);
+    return pp;
+}
+
+void fill_samples(audio::sample_t* samples, size_t num_samples, size_t sample_rate) {
+    for (size_t n = 0; n < num_samples; n++) {
+        const float s = 0.5f * (float)sin(2 * M_PI / sample_rate * 440 * n);
+        for (size_t ch = 0; ch < MaxChannels; ch++) {
+            samples[n * MaxChannels + ch] = s;
+        }
+    }
+}
+
+// Argument is payload type. Every iteration encodes one stereo 20ms packet
+// using encoder from format map, so that PCM and Opus can be compared.
+void bench_codec_encode(bench::State& state) {
+    const Format* format = format_map.format((unsigned)state.arg());
+    if (!format) {
+        state.set_error("unknown payload type");
+        return;
+    }
+
+    const size_t num_samples =
+        (size_t)packet::timestamp_from_ns(PacketLength, format->sample_rate);
+
+    core::UniquePtr<audio::IEncoder> encoder(format->new_encoder(allocator), allocator);
+    if (!encoder) {
+        state.set_error("can't create encoder");
+        return;
+    }
+
+    packet::PacketPtr pp = new_packet(*encoder, num_samples);
+    if (!pp) {
+        state.set_error("can't create packet");
+        return;
+    }
+
+    audio::sample_t samples[MaxSamples * MaxChannels];
+    fill_samples(samples, num_samples, format->sample_rate);
+
+    while (state.running()) {
+        encoder->write_samples(*pp, 0, samples, num_samples, 0x3);
+        if (!encoder->finish_packet(*pp, num_samples)) {
+            state.set_error("can't encode packet");
+            return;
+        }
+        bench::do_not_optimize(pp->rtp()->payload.data());
+    }
+
+    state.add_items((uint64_t)state.iterations() * num_samples);
+    state.set_counter("payload_bytes", (double)pp->rtp()->payload.size());
+}
+
+// Argument is payload type. Every iteration decodes one stereo 20ms packet
+// using decoder from format map. The seqnum is changed every iteration so
+// that decoders that cache the last packet decode it again.
+void bench_codec_decode(bench::State& state) {
+    const Format* format = format_map.format((unsigned)state.arg());
+    if (!format) {
+        state.set_error("unknown payload type");
+        return;
+    }
+
+    const size_t num_samples =
+        (size_t)packet::timestamp_from_ns(PacketLength, format->sample_rate);
+
+    core::UniquePtr<audio::IEncoder> encoder(format->new_encoder(allocator), allocator);
+    core::UniquePtr<audio::IDecoder> decoder(format->new_decoder(allocator), allocator);
+    if (!encoder || !decoder) {
+        state.set_error("can't create codec");
+        return;
+    }
+
+    packet::PacketPtr pp = new_packet(*encoder, num_samples);
+    if (!pp) {
+        state.set_error("can't create packet");
+        return;
+    }
+
+    audio::sample_t samples[MaxSamples * MaxChannels];
+    fill_samples(samples, num_samples, format->sample_rate);
+
+    encoder->write_samples(*pp, 0, samples, num_samples, 0x3);
+    if (!encoder->finish_packet(*pp, num_samples)) {
+        state.set_error("can't encode packet");
+        return;
+    }
+
+    while (state.running()) {
+        pp->rtp()->seqnum++;
+        decoder->read_samples(*pp, 0, samples, num_samples, 0x3);
+        bench::do_not_optimize(samples);
+    }
+
+    state.add_items((uint64_t)state.iterations() * num_samples);
+}
+
+const size_t codec_args[] = {
+    PayloadType_L16_Stereo,
+    PayloadType_L16_48k_Stereo,
+#ifdef ROC_TARGET_OPUS
+    PayloadType_Opus_Stereo,
+#endif // ROC_TARGET_OPUS
+};
+
+ROC_BENCH_ARGS(bench_codec_encode, codec_args);
+ROC_BENCH_ARGS(bench_codec_decode, codec_args);
+
+} // namespace
+
+} // namespace rtp
+} // namespace roc
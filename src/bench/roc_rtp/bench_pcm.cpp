@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_bench/bench.h"
+#include "roc_rtp/pcm_helpers.h"
+
+namespace roc {
+namespace rtp {
+
+namespace {
+
+enum { PacketCh = 2, NumSamples = 480, MaxSamples = NumSamples * PacketCh };
+
+// Argument is number of channels of the input samples, the packet is stereo.
+template <class Sample> void bench_pcm_write(bench::State& state) {
+    const packet::channel_mask_t chan_mask =
+        (packet::channel_mask_t)(1 << state.arg()) - 1;
+
+    audio::sample_t samples[MaxSamples];
+    for (size_t n = 0; n < MaxSamples; n++) {
+        samples[n] = float(n) / MaxSamples - 0.5f;
+    }
+
+    Sample payload[MaxSamples];
+
+    const typename PCMEncodeKernel<Sample>::Func kernel =
+        pcm_encode_kernel<Sample, PacketCh>(chan_mask);
+
+    while (state.running()) {
+        pcm_write<Sample, PacketCh>(payload, sizeof(payload), 0, samples, NumSamples,
+                                    chan_mask, kernel);
+        bench::do_not_optimize(payload);
+    }
+
+    state.add_items((uint64_t)state.iterations() * NumSamples);
+    state.add_bytes((uint64_t)state.iterations() * sizeof(payload));
+}
+
+// Argument is number of channels of the output samples, the packet is stereo.
+template <class Sample> void bench_pcm_read(bench::State& state) {
+    const packet::channel_mask_t chan_mask =
+        (packet::channel_mask_t)(1 << state.arg()) - 1;
+
+    Sample payload[MaxSamples];
+    for (size_t n = 0; n < MaxSamples; n++) {
+        payload[n] = pcm_pack<Sample>(float(n) / MaxSamples - 0.5f);
+    }
+
+    audio::sample_t samples[MaxSamples];
+
+    const typename PCMDecodeKernel<Sample>::Func kernel =
+        pcm_decode_kernel<Sample, PacketCh>(chan_mask);
+
+    while (state.running()) {
+        pcm_read<Sample, PacketCh>(payload, sizeof(payload), 0, samples, NumSamples,
+                                   chan_mask, kernel);
+        bench::do_not_optimize(samples);
+    }
+
+    state.add_items((uint64_t)state.iterations() * NumSamples);
+    state.add_bytes((uint64_t)state.iterations() * sizeof(payload));
+}
+
+void bench_pcm_write_l16(bench::State& state) {
+    bench_pcm_write<int16_t>(state);
+}
+
+void bench_pcm_read_l16(bench::State& state) {
+    bench_pcm_read<int16_t>(state);
+}
+
+void bench_pcm_write_l24(bench::State& state) {
+    bench_pcm_write<PCMInt24>(state);
+}
+
+void bench_pcm_read_l24(bench::State& state) {
+    bench_pcm_read<PCMInt24>(state);
+}
+
+void bench_pcm_write_f32(bench::State& state) {
+    bench_pcm_write<PCMFloat32>(state);
+}
+
+void bench_pcm_read_f32(bench::State& state) {
+    bench_pcm_read<PCMFloat32>(state);
+}
+
+const size_t pcm_args[] = { 1, 2 };
+
+ROC_BENCH_ARGS(bench_pcm_write_l16, pcm_args);
+ROC_BENCH_ARGS(bench_pcm_read_l16, pcm_args);
+ROC_BENCH_ARGS(bench_pcm_write_l24, pcm_args);
+ROC_BENCH_ARGS(bench_pcm_read_l24, pcm_args);
+ROC_BENCH_ARGS(bench_pcm_write_f32, pcm_args);
+ROC_BENCH_ARGS(bench_pcm_read_f32, pcm_args);
+
+} // namespace
+
+} // namespace rtp
+} // namespace roc
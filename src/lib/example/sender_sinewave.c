@@ -143,6 +143,11 @@ int main() {
         oops("roc_sender_connect");
     }
 
+    /* Create sender pipeline before writing samples. */
+    if (roc_sender_start(sender) != 0) {
+        oops("roc_sender_start");
+    }
+
     /* Generate sine wave and write it to the sender. */
     size_t i;
     for (i = 0; i < EXAMPLE_SINE_SAMPLES / EXAMPLE_BUFFER_SIZE; i++) {
@@ -87,7 +87,27 @@ typedef enum roc_packet_encoding {
      * Uncompressed samples coded as interleaved 16-bit signed big-endian
      * integers in two's complement notation.
      */
-    ROC_PACKET_ENCODING_AVP_L16 = 2
+    ROC_PACKET_ENCODING_AVP_L16 = 2,
+
+    /** Opus.
+     * Samples are compressed using Opus codec (RFC 6716) at 48000 Hz, with
+     * constant bitrate. Requires the library to be built with Opus support.
+     * Much lower bandwidth than L16 at the cost of CPU and some latency.
+     */
+    ROC_PACKET_ENCODING_OPUS = 3,
+
+    /** PCM signed 24-bit.
+     * "L24" encoding (RFC 3190).
+     * Uncompressed samples coded as interleaved 24-bit signed big-endian
+     * integers in two's complement notation. Supports 48000 and 96000 Hz.
+     */
+    ROC_PACKET_ENCODING_AVP_L24 = 4,
+
+    /** PCM floats.
+     * Uncompressed samples coded as interleaved 32-bit big-endian IEEE 754
+     * floats in range [-1; 1]. Supports 48000 and 96000 Hz.
+     */
+    ROC_PACKET_ENCODING_PCM_FLOAT = 5
 } roc_packet_encoding;
 
 /** Frame encoding. */
@@ -96,7 +116,26 @@ typedef enum roc_frame_encoding {
      * Uncompressed samples coded as floats in range [-1; 1].
      * Channels are interleaved, e.g. two channels are encoded as "L R L R ...".
      */
-    ROC_FRAME_ENCODING_PCM_FLOAT = 1
+    ROC_FRAME_ENCODING_PCM_FLOAT = 1,
+
+    /** PCM floats, planar.
+     * Uncompressed samples coded as floats in range [-1; 1].
+     * Channels are not interleaved: all samples of the first channel are followed by
+     * all samples of the second channel, e.g. "L L ... L R R ... R".
+     */
+    ROC_FRAME_ENCODING_PCM_FLOAT_PLANAR = 2,
+
+    /** PCM signed 16-bit.
+     * Uncompressed samples coded as 16-bit signed little-endian integers in two's
+     * complement notation. Channels are interleaved.
+     */
+    ROC_FRAME_ENCODING_PCM_S16LE = 3,
+
+    /** PCM signed 32-bit.
+     * Uncompressed samples coded as 32-bit signed little-endian integers in two's
+     * complement notation. Channels are interleaved.
+     */
+    ROC_FRAME_ENCODING_PCM_S32LE = 4
 } roc_frame_encoding;
 
 /** Channel set. */
@@ -127,6 +166,35 @@ typedef enum roc_resampler_profile {
     ROC_RESAMPLER_LOW = 3
 } roc_resampler_profile;
 
+/** Packet pacing mode. */
+typedef enum roc_packet_pacing {
+    /** No pacing.
+     * Packets are sent as soon as they are produced, possibly in bursts.
+     */
+    ROC_PACING_DISABLE = -1,
+
+    /** Default mode.
+     * Current default is @c ROC_PACING_DISABLE.
+     */
+    ROC_PACING_DEFAULT = 0,
+
+    /** Pacing in network thread.
+     * Every packet is assigned a send time, and packets are spread evenly
+     * according to their duration. The network thread releases packets at
+     * their send time, sleeping and then spinning shortly before it.
+     */
+    ROC_PACING_SOFTWARE = 1,
+
+    /** Pacing in kernel.
+     * Like @c ROC_PACING_SOFTWARE, but the send time is passed to the kernel
+     * using @c SO_TXTIME, and the kernel releases packets. Requires Linux and
+     * the ETF queuing discipline configured on the outgoing interface. Falls
+     * back to @c ROC_PACING_SOFTWARE if @c SO_TXTIME is not supported, or if
+     * the kernel is found to send packets before their send time.
+     */
+    ROC_PACING_TXTIME = 2
+} roc_packet_pacing;
+
 /** Context configuration.
  * @see roc_context
  */
@@ -142,6 +210,36 @@ typedef struct roc_context_config {
      * pipeline. Does not limit the size of the frames provided by user.
      */
     unsigned int max_frame_size;
+
+    /** Socket send buffer size in bytes.
+     * Applied to all ports of the context. If zero, default value is used.
+     */
+    unsigned int socket_send_buffer_size;
+
+    /** Socket receive buffer size in bytes.
+     * Applied to all ports of the context. Larger buffers prevent the kernel from
+     * dropping packets when they arrive in bursts, e.g. FEC repair packets from
+     * many senders. If zero, default value is used.
+     */
+    unsigned int socket_recv_buffer_size;
+
+    /** DSCP value for outgoing packets.
+     * Should be in range [0; 63]. For example, 46 means Expedited Forwarding, which
+     * is usually used for audio. If zero, default value is used.
+     */
+    unsigned int socket_dscp;
+
+    /** Socket priority (SO_PRIORITY).
+     * Supported only on Linux. Values above 6 require CAP_NET_ADMIN.
+     * If zero, default value is used.
+     */
+    unsigned int socket_priority;
+
+    /** Busy polling timeout (SO_BUSY_POLL), in microseconds.
+     * Supported only on Linux. Reduces receive latency at the cost of CPU usage.
+     * If zero, busy polling is not enabled.
+     */
+    unsigned int socket_busy_poll;
 } roc_context_config;
 
 /** Sender configuration.
@@ -168,7 +266,9 @@ typedef struct roc_sender_config {
 
     /** The rate of the samples in the packets generated by sender.
      * Number of samples per channel per second.
-     * If zero, default value is used.
+     * If zero, default value is used: 44100 for ROC_PACKET_ENCODING_AVP_L16 and
+     * 48000 for other encodings. To avoid resampling, set it to @c frame_sample_rate
+     * if the packet encoding supports that rate.
      */
     unsigned int packet_sample_rate;
 
@@ -187,6 +287,7 @@ typedef struct roc_sender_config {
      * The samples written to the sender are buffered until the full packet is
      * accumulated or the sender is flushed or closed. Larger number reduces
      * packet overhead but also increases latency.
+     * With ROC_PACKET_ENCODING_OPUS, should be 2.5, 5, 10, 20, 40, or 60 ms.
      * If zero, default value is used.
      */
     unsigned long long packet_length;
@@ -229,6 +330,33 @@ typedef struct roc_sender_config {
      * If zero, default value is used.
      */
     unsigned int fec_block_repair_packets;
+
+    /** TTL of outgoing multicast packets.
+     * Used if the sender is connected to a multicast address.
+     * If zero, default value is used, which usually restricts multicast packets
+     * to the local network.
+     */
+    unsigned int multicast_ttl;
+
+    /** Interface for outgoing multicast packets.
+     * Should be an IPv4 or IPv6 address of a local interface.
+     * If NULL, default interface is used.
+     */
+    const char* multicast_interface;
+
+    /** Enable profiling.
+     * If non-zero, the sender measures time spent in every pipeline stage,
+     * which can be retrieved using roc_sender_get_profile().
+     * If zero, no measurements are performed.
+     */
+    unsigned int enable_profiling;
+
+    /** Packet pacing mode.
+     * If automatic timing is enabled, packets are produced a bit earlier than
+     * their send time, so that late wakeups of the writing thread don't affect
+     * the moment when packets are sent.
+     */
+    roc_packet_pacing packet_pacing;
 } roc_sender_config;
 
 /** Receiver configuration.
@@ -274,14 +402,15 @@ typedef struct roc_receiver_config {
 
     /** Maximum delta between current and target latency, in nanoseconds.
      * If current latency becomes larger than the target latency plus this value, the
-     * session is terminated.
+     * excess is skipped, or the session is terminated if latency recovery is disabled.
      * If zero, default value is used.
      */
     unsigned long long max_latency_overrun;
 
     /** Maximum delta between target and current latency, in nanoseconds.
-     * If current latency becomes smaller than the target latency minus this value, the
-     * session is terminated.
+     * If current latency becomes smaller than the target latency minus this value,
+     * silence is inserted to restore the target latency, or the session is terminated
+     * if latency recovery is disabled.
      * May be larger than the target latency because current latency may be negative,
      * which means that the playback run ahead of the last packet received from network.
      * If zero, default value is used.
@@ -298,7 +427,8 @@ typedef struct roc_receiver_config {
 
     /** Timeout for broken playback, in nanoseconds.
      * If there the playback is considered broken during this period, the session
-     * is terminated. The playback is broken if there is a breakage detected at every
+     * tries to restore the target latency if it's too low, and otherwise is
+     * terminated. The playback is broken if there is a breakage detected at every
      * @c breakage_detection_window during @c broken_playback_timeout.
      * This mechanism allows to detect vicious circles like when all client packets
      * are a bit late and receiver constantly drops them producing unpleasant noise.
@@ -336,6 +466,78 @@ typedef struct roc_receiver_config {
      * Should be set to the same value as on the sender.
      */
     unsigned int fec_block_repair_packets;
+
+    /** Enable packet loss concealment.
+     * If non-zero, gaps caused by lost packets are filled with a signal
+     * synthesized from the recent history, fading out if the gap is long.
+     * If zero, gaps are filled with silence.
+     */
+    unsigned int packet_loss_concealment;
+
+    /** Enable adaptive latency.
+     * If non-zero, the receiver measures network jitter and moves the target
+     * latency between @c min_target_latency and @c target_latency. The latency
+     * is raised quickly when the jitter grows and lowered slowly when it shrinks.
+     * Has effect only if resampler is enabled.
+     */
+    unsigned int adaptive_latency;
+
+    /** Minimum target latency for adaptive latency, in nanoseconds.
+     * Used if adaptive latency is enabled. If zero, default value is used.
+     */
+    unsigned long long min_target_latency;
+
+    /** Disable latency recovery.
+     * If zero, when the latency goes out of bounds, the session skips excess
+     * samples or inserts silence to restore the target latency in place.
+     * If non-zero, the session is terminated and recreated instead.
+     */
+    unsigned int disable_latency_recovery;
+
+    /** Number of sessions to construct in advance.
+     * Pre-constructed sessions are used for new senders, and terminated sessions
+     * are returned to the pool, so that a new sender doesn't cause memory
+     * allocations in the audio thread. Pooled sessions are used only for senders
+     * with @c session_pool_encoding and @c session_pool_sample_rate.
+     * If zero, sessions are constructed when the first packet is received.
+     */
+    unsigned int session_pool_size;
+
+    /** Interface for joining multicast groups.
+     * Used if the receiver is bound to a multicast address.
+     * Should be an IPv4 or IPv6 address of a local interface.
+     * If NULL, default interface is used.
+     */
+    const char* multicast_interface;
+
+    /** Source address for source-specific multicast.
+     * Used if the receiver is bound to a multicast address.
+     * If set, only packets sent from this IPv4 or IPv6 address are received
+     * from the group. If NULL, packets from any source are received.
+     */
+    const char* multicast_source;
+
+    /** Enable profiling.
+     * If non-zero, the receiver measures time spent in every pipeline stage,
+     * which can be retrieved using roc_receiver_get_profile().
+     * If zero, no measurements are performed.
+     */
+    unsigned int enable_profiling;
+
+    /** Packet encoding of sessions constructed in advance.
+     * Used if @c session_pool_size is non-zero. Should match the packet encoding
+     * of the senders, otherwise pooled sessions are not used.
+     * If zero, ROC_PACKET_ENCODING_AVP_L16 is used.
+     */
+    roc_packet_encoding session_pool_encoding;
+
+    /** Packet sample rate of sessions constructed in advance.
+     * Used if @c session_pool_size is non-zero. Should match the packet sample
+     * rate of the senders, otherwise pooled sessions are not used.
+     * If zero, default rate for @c session_pool_encoding is used, the same as
+     * for @c packet_sample_rate in roc_sender_config.
+     */
+    unsigned int session_pool_sample_rate;
 } roc_receiver_config;
 
 #ifdef __cplusplus
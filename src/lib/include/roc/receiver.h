@@ -19,6 +19,7 @@
 #include "roc/context.h"
 #include "roc/frame.h"
 #include "roc/platform.h"
+#include "roc/stats.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -111,11 +112,33 @@ extern "C" {
  *    CPU might have slightly different clocks, and the difference will eventually lead
  *    to an underrun or an overrun.
  *
+ * With the automatic timing, the user may also avoid blocking in two ways:
+ *
+ *  - roc_receiver_read_ready() returns only the samples that are due by now and reports
+ *    when the next frame will be due, so that the user may poll the receiver from its
+ *    own event loop.
+ *
+ *  - roc_receiver_start() starts a receiver thread that decodes frames at the configured
+ *    rate and passes them to a user callback, without an intermediate buffer.
+ *
  * @b Thread-safety
  *  - can be used concurrently
  */
 typedef struct roc_receiver roc_receiver;
 
+/** Receiver frame callback.
+ *
+ * Invoked from the receiver thread started by roc_receiver_start() for every decoded
+ * frame. The frame and its samples are valid only until the callback returns. The
+ * callback should not block, otherwise the receiver will fall behind the configured
+ * sample rate.
+ *
+ * @b Parameters
+ *  - @p arg is the argument passed to roc_receiver_start()
+ *  - @p frame points to the decoded frame
+ */
+typedef void (*roc_receiver_callback)(void* arg, const roc_frame* frame);
+
 /** Open a new receiver.
  *
  * Allocates and initializes a new receiver, and attaches it to the context.
@@ -141,6 +164,11 @@ ROC_API roc_receiver* roc_receiver_open(roc_context* context,
  * port. If the function succeeds, the actual port to which the receiver was bound
  * is written back to @p address.
  *
+ * If @p address is a multicast address, the receiver joins this multicast group and
+ * leaves it when closed. The @c multicast_interface and @c multicast_source fields
+ * of roc_receiver_config are used to select the interface and the source for
+ * source-specific multicast.
+ *
  * @b Parameters
  *  - @p receiver should point to an opened receiver
  *  - @p type specifies the port type
@@ -179,11 +207,117 @@ ROC_API int roc_receiver_bind(roc_receiver* receiver,
  */
 ROC_API int roc_receiver_read(roc_receiver* receiver, roc_frame* frame);
 
+/** Read samples that are ready without blocking.
+ *
+ * Works like roc_receiver_read(), but never blocks. If the automatic timing is enabled,
+ * decodes only the samples that should have been decoded by now according to the
+ * configured sample rate, which may be less than the frame size or even zero. Otherwise,
+ * fills the whole frame.
+ *
+ * @b Parameters
+ *  - @p receiver should point to an opened receiver
+ *  - @p frame should point to an initialized frame; on success, its size is set to the
+ *    number of bytes actually written
+ *  - @p deadline should point to a variable which will be set to the time when the next
+ *    frame of the same size will be ready, in nanoseconds of the monotonic clock; it is
+ *    set to zero if the automatic timing is disabled; may be NULL
+ *
+ * @b Returns
+ *  - returns zero if the ready samples were successfully decoded
+ *  - returns a negative value if the arguments are invalid
+ */
+ROC_API int roc_receiver_read_ready(roc_receiver* receiver,
+                                    roc_frame* frame,
+                                    long long* deadline);
+
+/** Start delivering frames to a callback.
+ *
+ * Starts a receiver thread which reads frames of the given size at the configured
+ * sample rate and passes them to @p callback. Requires the automatic timing to be
+ * enabled, because it defines when frames are decoded. The thread is stopped when the
+ * receiver is closed. The user should not read from the receiver after this call.
+ *
+ * @b Parameters
+ *  - @p receiver should point to an opened receiver
+ *  - @p frame_size defines the size of every frame in bytes; it should be a multiple of
+ *    the number of channels multiplied by the sample size
+ *  - @p callback defines a function to be invoked for every frame
+ *  - @p arg defines an argument to be passed to @p callback
+ *
+ * @b Returns
+ *  - returns zero if the receiver thread was successfully started
+ *  - returns a negative value if the arguments are invalid
+ *  - returns a negative value if the automatic timing is disabled
+ *  - returns a negative value if the receiver thread is already started
+ *  - returns a negative value if there are not enough resources
+ */
+ROC_API int roc_receiver_start(roc_receiver* receiver,
+                               size_t frame_size,
+                               roc_receiver_callback callback,
+                               void* arg);
+
+/** Get receiver FEC statistics.
+ *
+ * Fills @p stats with FEC counters summed over all sessions created since the
+ * receiver was opened. Counters are published together with the statistics
+ * returned by roc_receiver_get_stats(). This function doesn't block and doesn't
+ * interfere with audio decoding, so it may be called at any time and from any
+ * thread.
+ *
+ * @b Parameters
+ *  - @p receiver should point to an opened receiver
+ *  - @p stats should point to a structure which will be filled with statistics
+ *
+ * @b Returns
+ *  - returns zero if the statistics were successfully retrieved
+ *  - returns a negative value if the arguments are invalid
+ */
+ROC_API int roc_receiver_get_fec_stats(roc_receiver* receiver,
+                                       roc_receiver_fec_stats* stats);
+
+/** Get receiver statistics.
+ *
+ * Fills @p stats with receiver counters, network counters summed over all ports
+ * to which the receiver is bound, and per-session counters and gauges.
+ *
+ * Pipeline statistics are published by the receiver at most every 10ms of
+ * produced audio and are read without interfering with audio decoding. Network
+ * counters are fetched from the network thread, so this function briefly waits
+ * for it. May be called at any time and from any thread.
+ *
+ * @b Parameters
+ *  - @p receiver should point to an opened receiver
+ *  - @p stats should point to a structure which will be filled with statistics
+ *
+ * @b Returns
+ *  - returns zero if the statistics were successfully retrieved
+ *  - returns a negative value if the arguments are invalid
+ */
+ROC_API int roc_receiver_get_stats(roc_receiver* receiver, roc_receiver_stats* stats);
+
+/** Get receiver profile.
+ *
+ * Fills @p stats with time spent in every stage of the receiver pipeline. If
+ * @c enable_profiling was not set in roc_receiver_config, no stages are
+ * reported. This function doesn't block and may be called at any time and
+ * from any thread.
+ *
+ * @b Parameters
+ *  - @p receiver should point to an opened receiver
+ *  - @p stats should point to a structure which will be filled with statistics
+ *
+ * @b Returns
+ *  - returns zero if the statistics were successfully retrieved
+ *  - returns a negative value if the arguments are invalid
+ */
+ROC_API int roc_receiver_get_profile(roc_receiver* receiver, roc_profile_stats* stats);
+
 /** Close the receiver.
  *
- * Deinitializes and deallocates the receiver, and detaches it from the context. The user
- * should ensure that nobody uses the receiver during and after this call. If this
- * function fails, the receiver is kept opened and attached to the context.
+ * Stops the receiver thread if it was started, deinitializes and deallocates the
+ * receiver, and detaches it from the context. The user should ensure that nobody uses
+ * the receiver during and after this call. If this function fails, the receiver is
+ * kept opened and attached to the context.
  *
  * @b Parameters
  *  - @p receiver should point to an opened receiver
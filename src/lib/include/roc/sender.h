@@ -19,6 +19,7 @@
 #include "roc/context.h"
 #include "roc/frame.h"
 #include "roc/platform.h"
+#include "roc/stats.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -64,6 +65,12 @@ extern "C" {
  *    @c ROC_FEC_RS8M is used, the corresponding protocols would be
  *    @c ROC_PROTO_RTP_RSM8_SOURCE and @c ROC_PROTO_RSM8_REPAIR.
  *
+ * The sender may be connected to multiple receivers by connecting the same port type
+ * multiple times. All destinations of the same port type should use the same protocol.
+ * Packets are encoded once and then sent to every destination. Multicast addresses
+ * are supported as well, see @c multicast_ttl and @c multicast_interface in
+ * roc_sender_config.
+ *
  * @b Resampling
  *
  * If the sample rate of the user frames and the sample rate of the network packets are
@@ -139,6 +146,9 @@ ROC_API int roc_sender_bind(roc_sender* sender, roc_address* address);
  * before calling roc_sender_write() first time. The @p type and @p proto should be
  * the same as they are set at the receiver for this port.
  *
+ * If a port of the same type is already connected, adds another destination for this
+ * port type. In this case, @p proto should be the same as for the first destination.
+ *
  * @b Parameters
  *  - @p sender should point to an opened sender
  *  - @p type specifies the receiver port type
@@ -148,17 +158,43 @@ ROC_API int roc_sender_bind(roc_sender* sender, roc_address* address);
  * @b Returns
  *  - returns zero if the sender was successfully connected to a port
  *  - returns a negative value if the arguments are invalid
- *  - returns a negative value if roc_sender_write() was already called
+ *  - returns a negative value if @p proto differs from the protocol of another
+ *    destination of the same port type
+ *  - returns a negative value if roc_sender_start() or roc_sender_write() was
+ *    already called
  */
 ROC_API int roc_sender_connect(roc_sender* sender,
                                roc_port_type type,
                                roc_protocol proto,
                                const roc_address* address);
 
+/** Start the sender.
+ *
+ * Creates the sender pipeline and preallocates packets and buffers needed to encode
+ * and send the first packets. Should be called after roc_sender_bind() and
+ * roc_sender_connect() and before calling roc_sender_write() first time.
+ *
+ * If this function is not called, the pipeline is created during the first call of
+ * roc_sender_write(), which makes it much slower than the subsequent calls. This
+ * function allows to move this work out of the real-time thread that writes samples.
+ *
+ * @b Parameters
+ *  - @p sender should point to an opened, bound, and connected sender
+ *
+ * @b Returns
+ *  - returns zero if the sender was successfully started
+ *  - returns a negative value if the arguments are invalid
+ *  - returns a negative value if the sender is not bound or connected
+ *  - returns a negative value if the sender is already started
+ *  - returns a negative value if there are not enough resources
+ */
+ROC_API int roc_sender_start(roc_sender* sender);
+
 /** Encode samples to packets and transmit them to the receiver.
  *
  * Encodes samples to packets and enqueues them for transmission by the context network
- * worker thread. Should be called after roc_sender_bind() and roc_sender_connect().
+ * worker thread. Should be called after roc_sender_bind() and roc_sender_connect(),
+ * and preferably after roc_sender_start().
  *
  * If the automatic timing is enabled, the function blocks until it's time to encode the
  * samples according to the configured sample rate. The function returns after encoding
@@ -176,9 +212,44 @@ ROC_API int roc_sender_connect(roc_sender* sender,
  */
 ROC_API int roc_sender_write(roc_sender* sender, const roc_frame* frame);
 
+/** Get sender statistics.
+ *
+ * Fills @p stats with sender counters. Statistics are updated by the sender
+ * after every written frame. This function doesn't block and doesn't interfere
+ * with audio encoding, so it may be called at any time and from any thread.
+ * If the sender is not started yet, all counters are zero.
+ *
+ * @b Parameters
+ *  - @p sender should point to an opened sender
+ *  - @p stats should point to a structure which will be filled with statistics
+ *
+ * @b Returns
+ *  - returns zero if the statistics were successfully retrieved
+ *  - returns a negative value if the arguments are invalid
+ */
+ROC_API int roc_sender_get_stats(roc_sender* sender, roc_sender_stats* stats);
+
+/** Get sender profile.
+ *
+ * Fills @p stats with time spent in every stage of the sender pipeline. If
+ * @c enable_profiling was not set in roc_sender_config or the sender is not
+ * started yet, no stages are reported. This function doesn't block and may be
+ * called at any time and from any thread.
+ *
+ * @b Parameters
+ *  - @p sender should point to an opened sender
+ *  - @p stats should point to a structure which will be filled with statistics
+ *
+ * @b Returns
+ *  - returns zero if the statistics were successfully retrieved
+ *  - returns a negative value if the arguments are invalid
+ */
+ROC_API int roc_sender_get_profile(roc_sender* sender, roc_profile_stats* stats);
+
 /** Close the sender.
  *
- * Deinitializes and deallocates the sender, and detaches it from the context. The user
+ * Flushes packets held by the sender, e.g. repair packets delayed for pacing, then
+ * deinitializes and deallocates the sender, and detaches it from the context. The user
  * should ensure that nobody uses the sender during and after this call. If this
  * function fails, the sender is kept opened and attached to the context.
  *
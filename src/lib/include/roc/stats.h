@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file roc/stats.h
+ * @brief Statistics.
+ */
+
+#ifndef ROC_STATS_H_
+#define ROC_STATS_H_
+
+#include "roc/address.h"
+#include "roc/platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of buckets in FEC decode time histogram. */
+#define ROC_FEC_DECODE_TIME_BUCKETS 16
+
+/** Receiver FEC statistics.
+ *
+ * Contains counters accumulated over all sessions since the receiver was opened,
+ * including sessions that were already removed.
+ *
+ * @b Thread-safety
+ *  - should not be used concurrently
+ */
+typedef struct roc_receiver_fec_stats {
+    /** Number of FEC blocks processed. */
+    unsigned long long n_blocks;
+
+    /** Number of source packets that were not received.
+     * Equal to the sum of @c n_repaired and @c n_unrepairable.
+     */
+    unsigned long long n_lost;
+
+    /** Number of lost source packets restored using repair packets. */
+    unsigned long long n_repaired;
+
+    /** Number of lost source packets that could not be restored. */
+    unsigned long long n_unrepairable;
+
+    /** Number of repair packets dropped because they arrived after their block
+     * was already played.
+     */
+    unsigned long long n_late_repair;
+
+    /** Number of FEC decoder invocations. */
+    unsigned long long n_decodes;
+
+    /** FEC decode time histogram.
+     * Bucket @c i counts decodes which took [2^i, 2^(i+1)) microseconds. The first
+     * bucket also counts shorter decodes, and the last one also counts longer decodes.
+     */
+    unsigned long long decode_time_hist[ROC_FEC_DECODE_TIME_BUCKETS];
+} roc_receiver_fec_stats;
+
+/** Maximum number of sessions reported in receiver statistics. */
+#define ROC_RECEIVER_MAX_SESSION_STATS 16
+
+/** Receiver session statistics.
+ *
+ * Contains counters accumulated since the session was created, and gauges
+ * describing the current state of the session.
+ *
+ * @b Thread-safety
+ *  - should not be used concurrently
+ */
+typedef struct roc_session_stats {
+    /** Sender address. */
+    roc_address address;
+
+    /** Number of source packets received, including duplicates. */
+    unsigned long long n_packets_received;
+
+    /** Number of source packets that were never received.
+     * Computed from RTP sequence numbers as defined by RFC 3550. Packets older
+     * than the last 256 sequence numbers are not counted as received.
+     */
+    unsigned long long n_packets_lost;
+
+    /** Number of source packets dropped because they arrived too late to be played. */
+    unsigned long long n_packets_late;
+
+    /** Number of duplicate source packets received.
+     * Duplicates are detected among the last 256 sequence numbers, even if the
+     * original packet was already played.
+     */
+    unsigned long long n_packets_duplicate;
+
+    /** Number of lost source packets restored using repair packets. */
+    unsigned long long n_packets_repaired;
+
+    /** Number of packets dropped because they belong to an unknown stream or
+     * the queue was full.
+     */
+    unsigned long long n_packets_dropped;
+
+    /** Current latency, nanoseconds. */
+    long long latency;
+
+    /** Current target latency, nanoseconds.
+     * Changes over time if @c latency_tuner is enabled in roc_receiver_config.
+     */
+    long long target_latency;
+
+    /** Resampler scaling factor applied to compensate clock drift.
+     * Equal to one if resampling is disabled.
+     */
+    float scaling;
+
+    /** Mean jitter as defined by RFC 3550, nanoseconds.
+     * Always zero if @c latency_tuner is disabled in roc_receiver_config.
+     */
+    long long jitter;
+
+    /** Number of frames produced. */
+    unsigned long long n_frames;
+
+    /** Number of frames without any decoded samples. */
+    unsigned long long n_blank_frames;
+
+    /** Number of frames partially filled with decoded samples. */
+    unsigned long long n_incomplete_frames;
+
+    /** How long every produced frame has been blank, nanoseconds.
+     * The session is terminated when it reaches @c no_playback_timeout from
+     * roc_receiver_config, unless the timeout is disabled.
+     */
+    long long blank_duration;
+
+    /** Non-zero if the session is about to be terminated because of frequent
+     * breakages, as configured by @c broken_playback_timeout in roc_receiver_config.
+     */
+    int broken;
+} roc_session_stats;
+
+/** Receiver statistics.
+ *
+ * @b Thread-safety
+ *  - should not be used concurrently
+ */
+typedef struct roc_receiver_stats {
+    /** Number of alive sessions. */
+    unsigned int n_sessions;
+
+    /** Number of packets passed to the receiver pipeline. */
+    unsigned long long n_packets;
+
+    /** Number of packets dropped because they can't be parsed or routed to a session. */
+    unsigned long long n_dropped_packets;
+
+    /** Number of packets received from the network on all bound ports. */
+    unsigned long long n_net_packets;
+
+    /** Number of packets dropped by the kernel before the receiver could read them.
+     * Packets are dropped when the socket receive buffer overflows. If this counter
+     * grows, increase @c socket_recv_buffer_size in roc_context_config.
+     * Always zero if not supported by the platform.
+     */
+    unsigned long long n_kernel_drops;
+
+    /** Number of packets currently allocated from the context packet pool.
+     * The pool is shared by all senders and receivers of the context.
+     */
+    unsigned long long n_pool_packets;
+
+    /** Number of buffers currently allocated from the context byte buffer pool.
+     * The pool is shared by all senders and receivers of the context.
+     */
+    unsigned long long n_pool_byte_buffers;
+
+    /** Number of buffers currently allocated from the context sample buffer pool.
+     * The pool is shared by all senders and receivers of the context.
+     */
+    unsigned long long n_pool_sample_buffers;
+
+    /** Statistics of alive sessions.
+     * Only first @c n_sessions elements, but no more than
+     * @c ROC_RECEIVER_MAX_SESSION_STATS, are filled.
+     */
+    roc_session_stats sessions[ROC_RECEIVER_MAX_SESSION_STATS];
+} roc_receiver_stats;
+
+/** Sender statistics.
+ *
+ * Contains counters accumulated since the sender was started.
+ *
+ * @b Thread-safety
+ *  - should not be used concurrently
+ */
+typedef struct roc_sender_stats {
+    /** Number of samples per channel written to the sender. */
+    unsigned long long n_samples;
+
+    /** Number of source packets sent.
+     * Packets sent to multiple destinations are counted once per destination.
+     */
+    unsigned long long n_source_packets;
+
+    /** Number of repair packets sent. Counted like @c n_source_packets. */
+    unsigned long long n_repair_packets;
+
+    /** Number of bytes in sent packets. Counted like @c n_source_packets. */
+    unsigned long long n_bytes;
+
+    /** Number of packets not sent to additional destinations.
+     * Incremented when a packet copy for one of the destinations can't be
+     * allocated; other destinations still get the packet.
+     */
+    unsigned long long n_dropped_packets;
+} roc_sender_stats;
+
+/** Maximum number of stages reported in profile. */
+#define ROC_MAX_PROFILE_STAGES 16
+
+/** Pipeline stage timing statistics.
+ *
+ * Durations don't include time spent in other measured stages called by this
+ * stage, so that every stage gets only its own time.
+ *
+ * @b Thread-safety
+ *  - should not be used concurrently
+ */
+typedef struct roc_stage_stats {
+    /** Stage name, e.g. "fec" or "resampler". */
+    const char* name;
+
+    /** Number of measured calls. */
+    unsigned long long n_calls;
+
+    /** Median call duration, nanoseconds. */
+    long long p50;
+
+    /** 99th percentile of call duration, nanoseconds. */
+    long long p99;
+
+    /** Maximum call duration, nanoseconds. */
+    long long max;
+} roc_stage_stats;
+
+/** Pipeline profile.
+ *
+ * Contains timing statistics of pipeline stages which were called at least once.
+ * Quantiles are estimated with an error below 25%.
+ *
+ * @b Thread-safety
+ *  - should not be used concurrently
+ */
+typedef struct roc_profile_stats {
+    /** Number of filled stages. */
+    unsigned int n_stages;
+
+    /** Statistics of stages.
+     * Only first @c n_stages elements are filled.
+     */
+    roc_stage_stats stages[ROC_MAX_PROFILE_STAGES];
+} roc_profile_stats;
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* ROC_STATS_H_ */
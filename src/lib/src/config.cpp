@@ -27,9 +27,102 @@ bool make_context_config(roc_context_config& out, const roc_context_config& in)
         out.max_frame_size = 4096;
     }
 
+    if (in.socket_dscp > 63) {
+        roc_log(LogError, "roc_config: invalid socket_dscp");
+        return false;
+    }
+
+    out.socket_send_buffer_size = in.socket_send_buffer_size;
+    out.socket_recv_buffer_size = in.socket_recv_buffer_size;
+    out.socket_dscp = in.socket_dscp;
+    out.socket_priority = in.socket_priority;
+    out.socket_busy_poll = in.socket_busy_poll;
+
     return true;
 }
 
+void make_socket_options(netio::SocketOptions& out, const roc_context_config& in) {
+    out.send_buffer_size = in.socket_send_buffer_size;
+    out.recv_buffer_size = in.socket_recv_buffer_size;
+
+    if (in.socket_dscp != 0) {
+        out.dscp = (int)in.socket_dscp;
+    }
+
+    if (in.socket_priority != 0) {
+        out.priority = (int)in.socket_priority;
+    }
+
+    out.busy_poll = (int)in.socket_busy_poll;
+}
+
+bool make_sample_format(audio::SampleFormat& out, roc_frame_encoding in) {
+    switch ((int)in) {
+    case ROC_FRAME_ENCODING_PCM_FLOAT:
+        out = audio::SampleFormat_Float;
+        return true;
+
+    case ROC_FRAME_ENCODING_PCM_FLOAT_PLANAR:
+        out = audio::SampleFormat_FloatPlanar;
+        return true;
+
+    case ROC_FRAME_ENCODING_PCM_S16LE:
+        out = audio::SampleFormat_S16LE;
+        return true;
+
+    case ROC_FRAME_ENCODING_PCM_S32LE:
+        out = audio::SampleFormat_S32LE;
+        return true;
+    }
+
+    return false;
+}
+
+const rtp::Format* make_packet_format(const rtp::FormatMap& format_map,
+                                      roc_packet_encoding encoding,
+                                      unsigned int sample_rate,
+                                      packet::channel_mask_t channels) {
+    rtp::Encoding rtp_encoding;
+    size_t default_rate;
+
+    switch ((int)encoding) {
+    case 0:
+    case ROC_PACKET_ENCODING_AVP_L16:
+        rtp_encoding = rtp::Encoding_L16;
+        default_rate = 44100;
+        break;
+    case ROC_PACKET_ENCODING_AVP_L24:
+        rtp_encoding = rtp::Encoding_L24;
+        default_rate = 48000;
+        break;
+    case ROC_PACKET_ENCODING_PCM_FLOAT:
+        rtp_encoding = rtp::Encoding_Float32;
+        default_rate = 48000;
+        break;
+    case ROC_PACKET_ENCODING_OPUS:
+        rtp_encoding = rtp::Encoding_Opus;
+        default_rate = 48000;
+        break;
+    default:
+        roc_log(LogError, "roc_config: invalid packet_encoding");
+        return NULL;
+    }
+
+    // the default rate doesn't follow frame_sample_rate, so that the default
+    // wire format stays the same (L16 at 44100 Hz for the default encoding)
+    const rtp::Format* format = format_map.find(
+        rtp_encoding, sample_rate != 0 ? sample_rate : default_rate, channels);
+
+    if (!format) {
+        roc_log(LogError,
+                "roc_config: invalid packet_sample_rate or packet_encoding,"
+                " no such format supported");
+        return NULL;
+    }
+
+    return format;
+}
+
 bool make_sender_config(pipeline::SenderConfig& out, const roc_sender_config& in) {
     if (in.frame_sample_rate != 0) {
         out.input_sample_rate = in.frame_sample_rate;
@@ -43,35 +136,56 @@ bool make_sender_config(pipeline::SenderConfig& out, const roc_sender_config& in
         return false;
     }
 
-    if (in.frame_encoding != ROC_FRAME_ENCODING_PCM_FLOAT) {
+    audio::SampleFormat sample_format;
+    if (!make_sample_format(sample_format, in.frame_encoding)) {
         roc_log(LogError, "roc_config: invalid frame_encoding");
         return false;
     }
 
-    if (in.packet_sample_rate != 0 && in.packet_sample_rate != 44100) {
-        roc_log(
-            LogError,
-            "roc_config: invalid packet_sample_rate, only 44100 is currently supported");
-        return false;
-    }
-
     if (in.packet_channels != 0 && in.packet_channels != ROC_CHANNEL_SET_STEREO) {
         roc_log(LogError, "roc_config: invalid packet_channels");
         return false;
     }
 
-    if (in.packet_encoding != 0 && in.packet_encoding != ROC_PACKET_ENCODING_AVP_L16) {
-        roc_log(LogError, "roc_config: invalid packet_encoding");
+    rtp::FormatMap format_map;
+
+    const rtp::Format* format = make_packet_format(
+        format_map, in.packet_encoding, in.packet_sample_rate, out.input_channels);
+    if (!format) {
         return false;
     }
 
+    out.payload_type = format->payload_type;
+
     if (in.packet_length != 0) {
         out.packet_length = (core::nanoseconds_t)in.packet_length;
+    } else if (format->encoding == rtp::Encoding_Opus) {
+        out.packet_length = pipeline::DefaultOpusPacketLength;
+    }
+
+    if (!format->is_valid_duration(out.packet_length)) {
+        roc_log(LogError,
+                "roc_config: invalid packet_length, not supported by packet_encoding");
+        return false;
     }
 
     out.interleaving = in.packet_interleaving;
     out.timing = in.automatic_timing;
 
+    switch ((int)in.packet_pacing) {
+    case ROC_PACING_DISABLE:
+    case ROC_PACING_DEFAULT:
+        out.pacing = false;
+        break;
+    case ROC_PACING_SOFTWARE:
+    case ROC_PACING_TXTIME:
+        out.pacing = true;
+        break;
+    default:
+        roc_log(LogError, "roc_config: invalid packet_pacing");
+        return false;
+    }
+
     out.resampling = (in.resampler_profile != ROC_RESAMPLER_DISABLE);
 
     switch ((int)in.resampler_profile) {
@@ -113,6 +227,49 @@ bool make_sender_config(pipeline::SenderConfig& out, const roc_sender_config& in
         out.fec.n_repair_packets = in.fec_block_repair_packets;
     }
 
+    out.profiling = in.enable_profiling;
+
+    return true;
+}
+
+bool make_udp_sender_config(netio::UDPSenderConfig& out, const roc_sender_config& in) {
+    out.txtime = (in.packet_pacing == ROC_PACING_TXTIME);
+
+    if (in.multicast_ttl > 255) {
+        roc_log(LogError, "roc_config: invalid multicast_ttl");
+        return false;
+    }
+    out.multicast_ttl = (int)in.multicast_ttl;
+
+    if (in.multicast_interface) {
+        if (!out.multicast_interface.set_ipv4(in.multicast_interface, 0)
+            && !out.multicast_interface.set_ipv6(in.multicast_interface, 0)) {
+            roc_log(LogError, "roc_config: invalid multicast_interface");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool make_udp_receiver_config(netio::UDPReceiverConfig& out,
+                              const roc_receiver_config& in) {
+    if (in.multicast_interface) {
+        if (!out.multicast_interface.set_ipv4(in.multicast_interface, 0)
+            && !out.multicast_interface.set_ipv6(in.multicast_interface, 0)) {
+            roc_log(LogError, "roc_config: invalid multicast_interface");
+            return false;
+        }
+    }
+
+    if (in.multicast_source) {
+        if (!out.multicast_source.set_ipv4(in.multicast_source, 0)
+            && !out.multicast_source.set_ipv6(in.multicast_source, 0)) {
+            roc_log(LogError, "roc_config: invalid multicast_source");
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -129,7 +286,8 @@ bool make_receiver_config(pipeline::ReceiverConfig& out, const roc_receiver_conf
         return false;
     }
 
-    if (in.frame_encoding != ROC_FRAME_ENCODING_PCM_FLOAT) {
+    audio::SampleFormat sample_format;
+    if (!make_sample_format(sample_format, in.frame_encoding)) {
         roc_log(LogError, "roc_config: invalid frame_encoding");
         return false;
     }
@@ -161,6 +319,8 @@ bool make_receiver_config(pipeline::ReceiverConfig& out, const roc_receiver_conf
 
     if (in.target_latency != 0) {
         out.default_session.target_latency = (core::nanoseconds_t)in.target_latency;
+        out.default_session.latency_tuner.max_latency =
+            (core::nanoseconds_t)in.target_latency;
 
         out.default_session.latency_monitor.min_latency =
             (core::nanoseconds_t)in.target_latency * pipeline::DefaultMinLatencyFactor;
@@ -235,9 +395,57 @@ bool make_receiver_config(pipeline::ReceiverConfig& out, const roc_receiver_conf
         out.default_session.fec.n_repair_packets = in.fec_block_repair_packets;
     }
 
+    out.default_session.plc.enabled = in.packet_loss_concealment;
+
+    out.default_session.latency_monitor.latency_recovery = !in.disable_latency_recovery;
+
+    out.session_pool_size = in.session_pool_size;
+
+    if (out.session_pool_size != 0) {
+        rtp::FormatMap format_map;
+
+        const rtp::Format* format =
+            make_packet_format(format_map, in.session_pool_encoding,
+                               in.session_pool_sample_rate, out.output.channels);
+        if (!format) {
+            return false;
+        }
+
+        out.session_pool_payload_type = format->payload_type;
+    }
+
+    out.default_session.latency_tuner.enabled = in.adaptive_latency;
+
+    if (in.min_target_latency != 0) {
+        out.default_session.latency_tuner.min_latency =
+            (core::nanoseconds_t)in.min_target_latency;
+    }
+
+    if (out.default_session.latency_tuner.min_latency
+        > out.default_session.latency_tuner.max_latency) {
+        out.default_session.latency_tuner.min_latency =
+            out.default_session.latency_tuner.max_latency;
+    }
+
+    out.profiling = in.enable_profiling;
+
     return true;
 }
 
+void make_profile_stats(roc_profile_stats& out, const pipeline::ProfilerStats& in) {
+    const size_t n_stages = std::min(in.n_stages, (size_t)ROC_MAX_PROFILE_STAGES);
+
+    out.n_stages = (unsigned int)n_stages;
+
+    for (size_t n = 0; n < n_stages; n++) {
+        out.stages[n].name = pipeline::stage_to_str(in.stages[n].stage);
+        out.stages[n].n_calls = in.stages[n].n_calls;
+        out.stages[n].p50 = in.stages[n].p50;
+        out.stages[n].p99 = in.stages[n].p99;
+        out.stages[n].max = in.stages[n].max;
+    }
+}
+
 bool make_port_config(pipeline::PortConfig& out,
                       roc_port_type type,
                       roc_protocol proto,
@@ -18,6 +18,7 @@ roc_context::roc_context(const roc_context_config& cfg)
     , sample_buffer_pool(allocator, cfg.max_frame_size / sizeof(audio::sample_t), false)
     , trx(packet_pool, byte_buffer_pool, allocator)
     , counter(0) {
+    make_socket_options(socket_options, cfg);
 }
 
 roc_context* roc_context_open(const roc_context_config* config) {
@@ -14,11 +14,14 @@
 #include "roc/receiver.h"
 #include "roc/sender.h"
 
+#include "roc_audio/sample_format.h"
 #include "roc_audio/units.h"
+#include "roc_core/array.h"
 #include "roc_core/atomic.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
 #include "roc_core/mutex.h"
+#include "roc_core/thread.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_netio/transceiver.h"
 #include "roc_packet/address.h"
@@ -32,10 +35,26 @@ const roc::packet::Address& get_address(const roc_address* address);
 roc::packet::Address& get_address(roc_address* address);
 
 bool make_context_config(roc_context_config& out, const roc_context_config& in);
+void make_socket_options(roc::netio::SocketOptions& out, const roc_context_config& in);
+
+bool make_sample_format(roc::audio::SampleFormat& out, roc_frame_encoding in);
+
+const roc::rtp::Format* make_packet_format(const roc::rtp::FormatMap& format_map,
+                                           roc_packet_encoding encoding,
+                                           unsigned int sample_rate,
+                                           roc::packet::channel_mask_t channels);
 
 bool make_sender_config(roc::pipeline::SenderConfig& out, const roc_sender_config& in);
+bool make_udp_sender_config(roc::netio::UDPSenderConfig& out,
+                            const roc_sender_config& in);
+
 bool make_receiver_config(roc::pipeline::ReceiverConfig& out,
                           const roc_receiver_config& in);
+bool make_udp_receiver_config(roc::netio::UDPReceiverConfig& out,
+                              const roc_receiver_config& in);
+
+void make_profile_stats(roc_profile_stats& out,
+                        const roc::pipeline::ProfilerStats& in);
 
 bool make_port_config(roc::pipeline::PortConfig& out,
                       roc_port_type type,
@@ -52,23 +71,30 @@ struct roc_context {
     roc::core::BufferPool<roc::audio::sample_t> sample_buffer_pool;
 
     roc::netio::Transceiver trx;
+    roc::netio::SocketOptions socket_options;
 
     roc::core::Atomic counter;
 };
 
 struct roc_sender {
-    roc_sender(roc_context& ctx, roc::pipeline::SenderConfig& cfg);
+    roc_sender(roc_context& ctx,
+               roc::pipeline::SenderConfig& cfg,
+               roc::audio::SampleFormat fmt);
 
     roc_context& context;
 
     roc::rtp::FormatMap format_map;
 
     roc::pipeline::SenderConfig config;
+    roc::netio::UDPSenderConfig udp_config;
 
     roc::pipeline::PortConfig source_port;
     roc::pipeline::PortConfig repair_port;
 
+    roc::core::Array<roc::pipeline::PortConfig> extra_ports;
+
     roc::core::UniquePtr<roc::pipeline::Sender> sender;
+    roc::core::Atomic started;
     roc::packet::IWriter* writer;
 
     roc::packet::Address address;
@@ -76,17 +102,59 @@ struct roc_sender {
     roc::core::Mutex mutex;
 
     size_t num_channels;
+    roc::audio::SampleFormat sample_format;
+};
+
+class roc_receiver_thread : public roc::core::Thread {
+public:
+    roc_receiver_thread(roc::pipeline::Receiver& receiver,
+                        roc::core::IAllocator& allocator,
+                        size_t frame_size,
+                        roc::audio::SampleFormat sample_format,
+                        roc_receiver_callback callback,
+                        void* callback_arg);
+
+    ~roc_receiver_thread();
+
+    bool valid() const;
+
+    void stop();
+
+private:
+    virtual void run();
+
+    roc::pipeline::Receiver& receiver_;
+
+    roc::core::Array<uint8_t> frame_data_;
+    const roc::audio::SampleFormat sample_format_;
+    const size_t num_samples_;
+
+    roc_receiver_callback callback_;
+    void* callback_arg_;
+
+    roc::core::Atomic stop_;
 };
 
 struct roc_receiver {
-    roc_receiver(roc_context& ctx, roc::pipeline::ReceiverConfig& cfg);
+    roc_receiver(roc_context& ctx,
+                 roc::pipeline::ReceiverConfig& cfg,
+                 roc::audio::SampleFormat fmt);
 
     roc_context& context;
 
     roc::rtp::FormatMap format_map;
     roc::pipeline::Receiver receiver;
 
+    roc::netio::UDPReceiverConfig udp_config;
+    roc::core::Array<roc::packet::Address> addresses;
+
+    roc::core::UniquePtr<roc_receiver_thread> thread;
+
+    roc::core::Mutex mutex;
+
     size_t num_channels;
+    roc::audio::SampleFormat sample_format;
+    bool timing;
 };
 
 #endif // ROC_PRIVATE_H_
@@ -23,9 +23,74 @@ void receiver_close_port(void* arg, const pipeline::PortConfig& port) {
     receiver->context.trx.remove_port(port.address);
 }
 
+bool receiver_check_frame_size(const char* func, roc_receiver* receiver, size_t size) {
+    const size_t step =
+        receiver->num_channels * audio::sample_format_size(receiver->sample_format);
+
+    if (size % step != 0) {
+        roc_log(LogError,
+                "%s: invalid arguments: # of samples should be multiple of # of %u",
+                func, (unsigned)step);
+        return false;
+    }
+
+    return true;
+}
+
 } // namespace
 
-roc_receiver::roc_receiver(roc_context& ctx, pipeline::ReceiverConfig& cfg)
+roc_receiver_thread::roc_receiver_thread(pipeline::Receiver& receiver,
+                                         core::IAllocator& allocator,
+                                         size_t frame_size,
+                                         audio::SampleFormat sample_format,
+                                         roc_receiver_callback callback,
+                                         void* callback_arg)
+    : receiver_(receiver)
+    , frame_data_(allocator)
+    , sample_format_(sample_format)
+    , num_samples_(frame_size / audio::sample_format_size(sample_format))
+    , callback_(callback)
+    , callback_arg_(callback_arg)
+    , stop_(0) {
+    if (!frame_data_.resize(frame_size)) {
+        roc_log(LogError, "roc_receiver: can't allocate frame for receiver thread");
+    }
+}
+
+roc_receiver_thread::~roc_receiver_thread() {
+    stop();
+}
+
+bool roc_receiver_thread::valid() const {
+    return frame_data_.size() != 0;
+}
+
+void roc_receiver_thread::stop() {
+    stop_ = 1;
+
+    if (joinable()) {
+        join();
+    }
+}
+
+void roc_receiver_thread::run() {
+    roc_log(LogDebug, "roc_receiver: starting receiver thread");
+
+    roc_frame frame;
+    frame.samples = &frame_data_[0];
+    frame.samples_size = frame_data_.size();
+
+    while (!stop_) {
+        receiver_.read_as(frame.samples, num_samples_, sample_format_);
+        callback_(callback_arg_, &frame);
+    }
+
+    roc_log(LogDebug, "roc_receiver: finishing receiver thread");
+}
+
+roc_receiver::roc_receiver(roc_context& ctx,
+                           pipeline::ReceiverConfig& cfg,
+                           audio::SampleFormat fmt)
     : context(ctx)
     , receiver(cfg,
                format_map,
@@ -33,7 +98,10 @@ roc_receiver::roc_receiver(roc_context& ctx, pipeline::ReceiverConfig& cfg)
                context.byte_buffer_pool,
                context.sample_buffer_pool,
                context.allocator)
-    , num_channels(packet::num_channels(cfg.output.channels)) {
+    , addresses(ctx.allocator)
+    , num_channels(packet::num_channels(cfg.output.channels))
+    , sample_format(fmt)
+    , timing(cfg.output.timing) {
 }
 
 roc_receiver* roc_receiver_open(roc_context* context, const roc_receiver_config* config) {
@@ -55,9 +123,21 @@ roc_receiver* roc_receiver_open(roc_context* context, const roc_receiver_config*
         return NULL;
     }
 
-    core::UniquePtr<roc_receiver> receiver(new (context->allocator)
-                                               roc_receiver(*context, private_config),
-                                           context->allocator);
+    audio::SampleFormat sample_format = audio::SampleFormat_Float;
+    if (!make_sample_format(sample_format, config->frame_encoding)) {
+        roc_log(LogError, "roc_receiver_open: invalid arguments: bad frame encoding");
+        return NULL;
+    }
+
+    netio::UDPReceiverConfig udp_config;
+    if (!make_udp_receiver_config(udp_config, *config)) {
+        roc_log(LogError, "roc_receiver_open: invalid arguments: bad multicast config");
+        return NULL;
+    }
+
+    core::UniquePtr<roc_receiver> receiver(
+        new (context->allocator) roc_receiver(*context, private_config, sample_format),
+        context->allocator);
 
     if (!receiver) {
         roc_log(LogError, "roc_receiver_open: can't allocate receiver pipeline");
@@ -69,6 +149,9 @@ roc_receiver* roc_receiver_open(roc_context* context, const roc_receiver_config*
         return NULL;
     }
 
+    receiver->udp_config = udp_config;
+    receiver->udp_config.socket_options = context->socket_options;
+
     ++context->counter;
 
     return receiver.release();
@@ -94,7 +177,8 @@ int roc_receiver_bind(roc_receiver* receiver,
         return -1;
     }
 
-    if (!receiver->context.trx.add_udp_receiver(addr, receiver->receiver)) {
+    if (!receiver->context.trx.add_udp_receiver(addr, receiver->udp_config,
+                                                receiver->receiver)) {
         roc_log(LogError, "roc_receiver_bind: bind failed");
         return -1;
     }
@@ -110,6 +194,17 @@ int roc_receiver_bind(roc_receiver* receiver,
         return -1;
     }
 
+    {
+        core::Mutex::Lock lock(receiver->mutex);
+
+        if (!receiver->addresses.grow(receiver->addresses.size() + 1)) {
+            roc_log(LogError, "roc_receiver_bind: can't allocate port");
+            return -1;
+        }
+
+        receiver->addresses.push_back(addr);
+    }
+
     roc_log(LogInfo, "roc_receiver: bound to %s %s",
             packet::address_to_str(port_config.address).c_str(),
             pipeline::proto_to_str(port_config.protocol));
@@ -132,13 +227,7 @@ int roc_receiver_read(roc_receiver* receiver, roc_frame* frame) {
         return 0;
     }
 
-    const size_t step = receiver->num_channels * sizeof(float);
-
-    if (frame->samples_size % step != 0) {
-        roc_log(LogError,
-                "roc_receiver_read: invalid arguments: # of samples should be "
-                "multiple of # of %u",
-                (unsigned)step);
+    if (!receiver_check_frame_size("roc_receiver_read", receiver, frame->samples_size)) {
         return -1;
     }
 
@@ -147,8 +236,228 @@ int roc_receiver_read(roc_receiver* receiver, roc_frame* frame) {
         return -1;
     }
 
-    audio::Frame audio_frame((float*)frame->samples, frame->samples_size / sizeof(float));
-    receiver->receiver.read(audio_frame);
+    const size_t sample_size = audio::sample_format_size(receiver->sample_format);
+
+    receiver->receiver.read_as(frame->samples, frame->samples_size / sample_size,
+                               receiver->sample_format);
+
+    return 0;
+}
+
+int roc_receiver_read_ready(roc_receiver* receiver,
+                            roc_frame* frame,
+                            long long* deadline) {
+    if (!receiver) {
+        roc_log(LogError, "roc_receiver_read_ready: invalid arguments: receiver is null");
+        return -1;
+    }
+
+    if (!frame) {
+        roc_log(LogError, "roc_receiver_read_ready: invalid arguments: frame is null");
+        return -1;
+    }
+
+    if (!receiver_check_frame_size("roc_receiver_read_ready", receiver,
+                                   frame->samples_size)) {
+        return -1;
+    }
+
+    if (frame->samples_size != 0 && !frame->samples) {
+        roc_log(LogError, "roc_receiver_read_ready: invalid arguments: samples is null");
+        return -1;
+    }
+
+    const size_t sample_size = audio::sample_format_size(receiver->sample_format);
+
+    core::nanoseconds_t next_deadline = 0;
+    const size_t n_samples =
+        receiver->receiver.read_ready(frame->samples, frame->samples_size / sample_size,
+                                      receiver->sample_format, next_deadline);
+
+    frame->samples_size = n_samples * sample_size;
+
+    if (deadline) {
+        *deadline = (long long)next_deadline;
+    }
+
+    return 0;
+}
+
+int roc_receiver_start(roc_receiver* receiver,
+                       size_t frame_size,
+                       roc_receiver_callback callback,
+                       void* arg) {
+    if (!receiver) {
+        roc_log(LogError, "roc_receiver_start: invalid arguments: receiver is null");
+        return -1;
+    }
+
+    if (!callback) {
+        roc_log(LogError, "roc_receiver_start: invalid arguments: callback is null");
+        return -1;
+    }
+
+    if (frame_size == 0) {
+        roc_log(LogError, "roc_receiver_start: invalid arguments: frame size is zero");
+        return -1;
+    }
+
+    if (!receiver_check_frame_size("roc_receiver_start", receiver, frame_size)) {
+        return -1;
+    }
+
+    if (!receiver->timing) {
+        roc_log(LogError, "roc_receiver_start: automatic timing is disabled");
+        return -1;
+    }
+
+    core::Mutex::Lock lock(receiver->mutex);
+
+    if (receiver->thread) {
+        roc_log(LogError, "roc_receiver_start: receiver thread is already started");
+        return -1;
+    }
+
+    core::UniquePtr<roc_receiver_thread> thread(
+        new (receiver->context.allocator) roc_receiver_thread(
+            receiver->receiver, receiver->context.allocator, frame_size,
+            receiver->sample_format, callback, arg),
+        receiver->context.allocator);
+
+    if (!thread || !thread->valid()) {
+        roc_log(LogError, "roc_receiver_start: can't allocate receiver thread");
+        return -1;
+    }
+
+    if (!thread->start()) {
+        roc_log(LogError, "roc_receiver_start: can't start receiver thread");
+        return -1;
+    }
+
+    receiver->thread.reset(thread.release(), receiver->context.allocator);
+
+    roc_log(LogInfo, "roc_receiver: started receiver thread");
+
+    return 0;
+}
+
+int roc_receiver_get_fec_stats(roc_receiver* receiver, roc_receiver_fec_stats* stats) {
+    if (!receiver) {
+        roc_log(LogError,
+                "roc_receiver_get_fec_stats: invalid arguments: receiver is null");
+        return -1;
+    }
+
+    if (!stats) {
+        roc_log(LogError, "roc_receiver_get_fec_stats: invalid arguments: stats is null");
+        return -1;
+    }
+
+    fec::ReaderStats fec_stats;
+    receiver->receiver.get_fec_stats(fec_stats);
+
+    stats->n_blocks = fec_stats.n_blocks;
+    stats->n_lost = fec_stats.n_lost;
+    stats->n_repaired = fec_stats.n_repaired;
+    stats->n_unrepairable = fec_stats.n_unrepairable;
+    stats->n_late_repair = fec_stats.n_late_repair;
+    stats->n_decodes = fec_stats.n_decodes;
+
+    for (size_t n = 0; n < ROC_FEC_DECODE_TIME_BUCKETS; n++) {
+        stats->decode_time_hist[n] = fec_stats.decode_time_hist[n];
+    }
+
+    return 0;
+}
+
+int roc_receiver_get_stats(roc_receiver* receiver, roc_receiver_stats* stats) {
+    if (!receiver) {
+        roc_log(LogError, "roc_receiver_get_stats: invalid arguments: receiver is null");
+        return -1;
+    }
+
+    if (!stats) {
+        roc_log(LogError, "roc_receiver_get_stats: invalid arguments: stats is null");
+        return -1;
+    }
+
+    pipeline::ReceiverStats recv_stats;
+    receiver->receiver.get_stats(recv_stats);
+
+    stats->n_sessions = (unsigned int)recv_stats.n_sessions;
+    stats->n_packets = recv_stats.n_packets;
+    stats->n_dropped_packets = recv_stats.n_dropped_packets;
+
+    stats->n_pool_packets = recv_stats.n_pool_packets;
+    stats->n_pool_byte_buffers = recv_stats.n_pool_byte_buffers;
+    stats->n_pool_sample_buffers = recv_stats.n_pool_sample_buffers;
+
+    stats->n_net_packets = 0;
+    stats->n_kernel_drops = 0;
+
+    {
+        core::Mutex::Lock lock(receiver->mutex);
+
+        for (size_t n = 0; n < receiver->addresses.size(); n++) {
+            netio::UDPReceiverStats port_stats;
+            if (!receiver->context.trx.get_receiver_stats(receiver->addresses[n],
+                                                          port_stats)) {
+                continue;
+            }
+
+            stats->n_net_packets += port_stats.n_packets;
+            stats->n_kernel_drops += port_stats.n_kernel_drops;
+        }
+    }
+
+    const size_t n_sessions = std::min(recv_stats.n_sessions,
+                                       (size_t)ROC_RECEIVER_MAX_SESSION_STATS);
+
+    for (size_t n = 0; n < n_sessions; n++) {
+        const pipeline::ReceiverSessionStats& in = recv_stats.sessions[n];
+        roc_session_stats& out = stats->sessions[n];
+
+        get_address(&out.address) = in.src_address;
+
+        out.n_packets_received = in.n_packets_received;
+        out.n_packets_lost = in.n_packets_lost;
+        out.n_packets_late = in.n_packets_late;
+        out.n_packets_duplicate = in.n_packets_duplicate;
+        out.n_packets_repaired = in.n_packets_repaired;
+        out.n_packets_dropped = in.n_packets_dropped;
+
+        out.latency = in.latency;
+        out.target_latency = in.target_latency;
+        out.scaling = in.scaling;
+        out.jitter = in.jitter;
+
+        out.n_frames = in.n_frames;
+        out.n_blank_frames = in.n_blank_frames;
+        out.n_incomplete_frames = in.n_incomplete_frames;
+
+        out.blank_duration = in.blank_duration;
+        out.broken = in.broken;
+    }
+
+    return 0;
+}
+
+int roc_receiver_get_profile(roc_receiver* receiver, roc_profile_stats* stats) {
+    if (!receiver) {
+        roc_log(LogError,
+                "roc_receiver_get_profile: invalid arguments: receiver is null");
+        return -1;
+    }
+
+    if (!stats) {
+        roc_log(LogError, "roc_receiver_get_profile: invalid arguments: stats is null");
+        return -1;
+    }
+
+    pipeline::ProfilerStats profile;
+    receiver->receiver.get_profile(profile);
+
+    make_profile_stats(*stats, profile);
 
     return 0;
 }
@@ -161,6 +470,10 @@ int roc_receiver_close(roc_receiver* receiver) {
 
     roc_context& context = receiver->context;
 
+    if (receiver->thread) {
+        receiver->thread->stop();
+    }
+
     receiver->receiver.iterate_ports(receiver_close_port, receiver);
     receiver->context.allocator.destroy(*receiver);
     --context.counter;
@@ -35,6 +35,40 @@ bool sender_init_pipeline(roc_sender* sender) {
         return false;
     }
 
+    for (size_t n = 0; n < sender->extra_ports.size(); n++) {
+        if (!sender->sender->add_destination(sender->extra_ports[n])) {
+            roc_log(LogError, "roc_sender: can't add destination to sender pipeline");
+            return false;
+        }
+    }
+
+    if (!sender->sender->reserve()) {
+        roc_log(LogError, "roc_sender: can't reserve packets for sender pipeline");
+        return false;
+    }
+
+    sender->started = true;
+
+    return true;
+}
+
+bool sender_add_extra_port(roc_sender* sender,
+                           const pipeline::PortConfig& existing_port,
+                           const pipeline::PortConfig& port_config) {
+    if (existing_port.protocol != port_config.protocol) {
+        roc_log(LogError,
+                "roc_sender: all destinations of the same port type should use"
+                " the same protocol");
+        return false;
+    }
+
+    if (!sender->extra_ports.grow(sender->extra_ports.size() + 1)) {
+        roc_log(LogError, "roc_sender: can't allocate destination");
+        return false;
+    }
+
+    sender->extra_ports.push_back(port_config);
+
     return true;
 }
 
@@ -44,8 +78,15 @@ bool sender_set_port(roc_sender* sender,
     switch ((int)type) {
     case ROC_PORT_AUDIO_SOURCE:
         if (sender->source_port.protocol != pipeline::Proto_None) {
-            roc_log(LogError, "roc_sender: audio source port is already set");
-            return false;
+            if (!sender_add_extra_port(sender, sender->source_port, port_config)) {
+                return false;
+            }
+
+            roc_log(LogInfo, "roc_sender: added audio source destination %s %s",
+                    packet::address_to_str(port_config.address).c_str(),
+                    pipeline::proto_to_str(port_config.protocol));
+
+            return true;
         }
 
         sender->source_port = port_config;
@@ -58,8 +99,15 @@ bool sender_set_port(roc_sender* sender,
 
     case ROC_PORT_AUDIO_REPAIR:
         if (sender->repair_port.protocol != pipeline::Proto_None) {
-            roc_log(LogError, "roc_sender: audio repair port is already set");
-            return false;
+            if (!sender_add_extra_port(sender, sender->repair_port, port_config)) {
+                return false;
+            }
+
+            roc_log(LogInfo, "roc_sender: added audio repair destination %s %s",
+                    packet::address_to_str(port_config.address).c_str(),
+                    pipeline::proto_to_str(port_config.protocol));
+
+            return true;
         }
 
         if (sender->config.fec.codec == fec::NoCodec) {
@@ -98,11 +146,15 @@ bool sender_check_connected(roc_sender* sender) {
 
 } // namespace
 
-roc_sender::roc_sender(roc_context& ctx, pipeline::SenderConfig& cfg)
+roc_sender::roc_sender(roc_context& ctx,
+                       pipeline::SenderConfig& cfg,
+                       audio::SampleFormat fmt)
     : context(ctx)
     , config(cfg)
+    , extra_ports(ctx.allocator)
     , writer(NULL)
-    , num_channels(packet::num_channels(cfg.input_channels)) {
+    , num_channels(packet::num_channels(cfg.input_channels))
+    , sample_format(fmt) {
 }
 
 roc_sender* roc_sender_open(roc_context* context, const roc_sender_config* config) {
@@ -124,12 +176,28 @@ roc_sender* roc_sender_open(roc_context* context, const roc_sender_config* confi
         return NULL;
     }
 
-    roc_sender* sender = new (context->allocator) roc_sender(*context, private_config);
+    audio::SampleFormat sample_format = audio::SampleFormat_Float;
+    if (!make_sample_format(sample_format, config->frame_encoding)) {
+        roc_log(LogError, "roc_sender_open: invalid arguments: bad frame encoding");
+        return NULL;
+    }
+
+    netio::UDPSenderConfig udp_config;
+    if (!make_udp_sender_config(udp_config, *config)) {
+        roc_log(LogError, "roc_sender_open: invalid arguments: bad multicast config");
+        return NULL;
+    }
+
+    roc_sender* sender =
+        new (context->allocator) roc_sender(*context, private_config, sample_format);
     if (!sender) {
         roc_log(LogError, "roc_sender_open: can't allocate roc_sender");
         return NULL;
     }
 
+    sender->udp_config = udp_config;
+    sender->udp_config.socket_options = context->socket_options;
+
     ++context->counter;
 
     return sender;
@@ -155,7 +223,7 @@ int roc_sender_bind(roc_sender* sender, roc_address* address) {
     core::Mutex::Lock lock(sender->mutex);
 
     if (sender->sender) {
-        roc_log(LogError, "roc_sender_bind: can't be called after first write");
+        roc_log(LogError, "roc_sender_bind: can't be called after start");
         return -1;
     }
 
@@ -164,7 +232,7 @@ int roc_sender_bind(roc_sender* sender, roc_address* address) {
         return -1;
     }
 
-    sender->writer = sender->context.trx.add_udp_sender(addr);
+    sender->writer = sender->context.trx.add_udp_sender(addr, sender->udp_config);
     if (!sender->writer) {
         roc_log(LogError, "roc_sender_bind: bind failed");
         return -1;
@@ -200,7 +268,7 @@ int roc_sender_connect(roc_sender* sender,
     core::Mutex::Lock lock(sender->mutex);
 
     if (sender->sender) {
-        roc_log(LogError, "roc_sender_connect: can't be called after first write");
+        roc_log(LogError, "roc_sender_connect: can't be called after start");
         return -1;
     }
 
@@ -218,6 +286,39 @@ int roc_sender_connect(roc_sender* sender,
     return 0;
 }
 
+int roc_sender_start(roc_sender* sender) {
+    if (!sender) {
+        roc_log(LogError, "roc_sender_start: invalid arguments: sender is null");
+        return -1;
+    }
+
+    core::Mutex::Lock lock(sender->mutex);
+
+    if (sender->sender) {
+        roc_log(LogError, "roc_sender_start: sender is already started");
+        return -1;
+    }
+
+    if (!sender->writer) {
+        roc_log(LogError, "roc_sender_start: sender is not properly bound");
+        return -1;
+    }
+
+    if (!sender_check_connected(sender)) {
+        roc_log(LogError, "roc_sender_start: sender is not properly connected");
+        return -1;
+    }
+
+    if (!sender_init_pipeline(sender)) {
+        roc_log(LogError, "roc_sender_start: initialization failed");
+        return -1;
+    }
+
+    roc_log(LogInfo, "roc_sender: started sender");
+
+    return 0;
+}
+
 int roc_sender_write(roc_sender* sender, const roc_frame* frame) {
     if (!sender) {
         roc_log(LogError, "roc_sender_write: invalid arguments: sender is null");
@@ -257,7 +358,8 @@ int roc_sender_write(roc_sender* sender, const roc_frame* frame) {
         return 0;
     }
 
-    const size_t step = sender->num_channels * sizeof(float);
+    const size_t step =
+        sender->num_channels * audio::sample_format_size(sender->sample_format);
 
     if (frame->samples_size % step != 0) {
         roc_log(LogError,
@@ -272,8 +374,60 @@ int roc_sender_write(roc_sender* sender, const roc_frame* frame) {
         return -1;
     }
 
-    audio::Frame audio_frame((float*)frame->samples, frame->samples_size / sizeof(float));
-    sender->sender->write(audio_frame);
+    const size_t sample_size = audio::sample_format_size(sender->sample_format);
+
+    sender->sender->write_as(frame->samples, frame->samples_size / sample_size,
+                             sender->sample_format);
+
+    return 0;
+}
+
+int roc_sender_get_stats(roc_sender* sender, roc_sender_stats* stats) {
+    if (!sender) {
+        roc_log(LogError, "roc_sender_get_stats: invalid arguments: sender is null");
+        return -1;
+    }
+
+    if (!stats) {
+        roc_log(LogError, "roc_sender_get_stats: invalid arguments: stats is null");
+        return -1;
+    }
+
+    pipeline::SenderStats send_stats;
+
+    // sender mutex is held during writes, so don't lock it here; the pipeline
+    // is never destroyed before close after it was started
+    if (sender->started) {
+        sender->sender->get_stats(send_stats);
+    }
+
+    stats->n_samples = send_stats.n_samples;
+    stats->n_source_packets = send_stats.n_source_packets;
+    stats->n_repair_packets = send_stats.n_repair_packets;
+    stats->n_bytes = send_stats.n_bytes;
+    stats->n_dropped_packets = send_stats.n_dropped_packets;
+
+    return 0;
+}
+
+int roc_sender_get_profile(roc_sender* sender, roc_profile_stats* stats) {
+    if (!sender) {
+        roc_log(LogError, "roc_sender_get_profile: invalid arguments: sender is null");
+        return -1;
+    }
+
+    if (!stats) {
+        roc_log(LogError, "roc_sender_get_profile: invalid arguments: stats is null");
+        return -1;
+    }
+
+    pipeline::ProfilerStats profile;
+
+    if (sender->started) {
+        sender->sender->get_profile(profile);
+    }
+
+    make_profile_stats(*stats, profile);
 
     return 0;
 }
@@ -284,6 +438,10 @@ int roc_sender_close(roc_sender* sender) {
         return -1;
     }
 
+    if (sender->sender && sender->sender->valid()) {
+        sender->sender->flush();
+    }
+
     if (sender->writer) {
         sender->context.trx.remove_port(sender->address);
     }
@@ -32,10 +32,12 @@ inline void write_beep(sample_t* buf, size_t bufsz) {
 
 Depacketizer::Depacketizer(packet::IReader& reader,
                            IDecoder& decoder,
+                           PLC* plc,
                            packet::channel_mask_t channels,
                            bool beep)
     : reader_(reader)
     , decoder_(decoder)
+    , plc_(plc)
     , channels_(channels)
     , num_channels_(packet::num_channels(channels))
     , packet_pos_(0)
@@ -43,6 +45,7 @@ Depacketizer::Depacketizer(packet::IReader& reader,
     , zero_samples_(0)
     , missing_samples_(0)
     , packet_samples_(0)
+    , delay_samples_(0)
     , rate_limiter_(LogInterval)
     , first_packet_(true)
     , beep_(beep)
@@ -60,6 +63,60 @@ packet::timestamp_t Depacketizer::timestamp() const {
     return timestamp_;
 }
 
+void Depacketizer::add_delay(packet::timestamp_t n_samples) {
+    if (first_packet_) {
+        return;
+    }
+    delay_samples_ += n_samples;
+}
+
+void Depacketizer::skip(packet::timestamp_t n_samples) {
+    if (first_packet_) {
+        return;
+    }
+
+    const packet::timestamp_t n_delay = std::min(n_samples, delay_samples_);
+
+    delay_samples_ -= n_delay;
+    n_samples -= n_delay;
+
+    if (n_samples == 0) {
+        return;
+    }
+
+    roc_log(LogDebug, "depacketizer: skipping samples: ts=%lu n_samples=%lu",
+            (unsigned long)timestamp_, (unsigned long)n_samples);
+
+    timestamp_ += n_samples;
+
+    skip_packets_();
+}
+
+packet::timestamp_t Depacketizer::pending_delay() const {
+    return delay_samples_;
+}
+
+const DepacketizerStats& Depacketizer::stats() const {
+    return stats_;
+}
+
+void Depacketizer::reset() {
+    packet_.reset();
+    packet_pos_ = 0;
+
+    timestamp_ = 0;
+
+    zero_samples_ = 0;
+    missing_samples_ = 0;
+    packet_samples_ = 0;
+    delay_samples_ = 0;
+
+    first_packet_ = true;
+    dropped_packets_ = 0;
+
+    stats_ = DepacketizerStats();
+}
+
 void Depacketizer::read(Frame& frame) {
     const size_t prev_dropped_packets = dropped_packets_;
     const packet::timestamp_t prev_packet_samples = packet_samples_;
@@ -94,6 +151,10 @@ void Depacketizer::read_frame_(Frame& frame) {
 }
 
 sample_t* Depacketizer::read_samples_(sample_t* buff_ptr, sample_t* buff_end) {
+    if (delay_samples_ != 0) {
+        return read_delay_samples_(buff_ptr, buff_end);
+    }
+
     update_packet_();
 
     if (packet_) {
@@ -127,9 +188,14 @@ sample_t* Depacketizer::read_packet_samples_(sample_t* buff_ptr, sample_t* buff_
     const size_t num_samples =
         decoder_.read_samples(*packet_, packet_pos_, buff_ptr, max_samples, channels_);
 
+    if (plc_) {
+        plc_->update(buff_ptr, num_samples);
+    }
+
     timestamp_ += packet::timestamp_t(num_samples);
     packet_pos_ += packet::timestamp_t(num_samples);
     packet_samples_ += num_samples;
+    stats_.n_decoded_samples += num_samples;
 
     if (num_samples == 0) {
         packet_.reset();
@@ -141,11 +207,7 @@ sample_t* Depacketizer::read_packet_samples_(sample_t* buff_ptr, sample_t* buff_
 sample_t* Depacketizer::read_missing_samples_(sample_t* buff_ptr, sample_t* buff_end) {
     const size_t num_samples = (size_t)(buff_end - buff_ptr) / num_channels_;
 
-    if (beep_) {
-        write_beep(buff_ptr, num_samples * num_channels_);
-    } else {
-        write_zeros(buff_ptr, num_samples * num_channels_);
-    }
+    conceal_samples_(buff_ptr, num_samples);
 
     timestamp_ += packet::timestamp_t(num_samples);
 
@@ -153,11 +215,47 @@ sample_t* Depacketizer::read_missing_samples_(sample_t* buff_ptr, sample_t* buff
         zero_samples_ += num_samples;
     } else {
         missing_samples_ += num_samples;
+        stats_.n_missing_samples += num_samples;
     }
 
     return (buff_ptr + num_samples * num_channels_);
 }
 
+sample_t* Depacketizer::read_delay_samples_(sample_t* buff_ptr, sample_t* buff_end) {
+    const size_t max_samples = (size_t)(buff_end - buff_ptr) / num_channels_;
+    const size_t num_samples = std::min((size_t)delay_samples_, max_samples);
+
+    conceal_samples_(buff_ptr, num_samples);
+
+    delay_samples_ -= packet::timestamp_t(num_samples);
+
+    return (buff_ptr + num_samples * num_channels_);
+}
+
+void Depacketizer::conceal_samples_(sample_t* buff_ptr, size_t num_samples) {
+    size_t num_concealed = 0;
+    if (!first_packet_) {
+        num_concealed = decoder_.conceal_samples(buff_ptr, num_samples, channels_);
+
+        if (plc_) {
+            if (num_concealed != 0) {
+                plc_->update(buff_ptr, num_concealed);
+            }
+            num_concealed += plc_->conceal(buff_ptr + num_concealed * num_channels_,
+                                           num_samples - num_concealed);
+        }
+    }
+
+    sample_t* fill_ptr = buff_ptr + num_concealed * num_channels_;
+    const size_t fill_size = (num_samples - num_concealed) * num_channels_;
+
+    if (beep_) {
+        write_beep(fill_ptr, fill_size);
+    } else {
+        write_zeros(fill_ptr, fill_size);
+    }
+}
+
 void Depacketizer::update_packet_() {
     if (packet_) {
         return;
@@ -190,12 +288,15 @@ void Depacketizer::update_packet_() {
                 n_dropped);
 
         dropped_packets_ += n_dropped;
+        stats_.n_late_packets += n_dropped;
     }
 
     if (!packet_) {
         return;
     }
 
+    stats_.n_packets++;
+
     if (first_packet_) {
         roc_log(LogDebug, "depacketizer: got first packet: zero_samples=%lu",
                 (unsigned long)zero_samples_);
@@ -212,6 +313,33 @@ void Depacketizer::update_packet_() {
     }
 }
 
+void Depacketizer::skip_packets_() {
+    if (packet_ && !packet::timestamp_lt(timestamp_, packet_->end())) {
+        packet_.reset();
+    }
+
+    // Skipped packets are not reported as dropped, since it's not a breakage.
+    while (!packet_) {
+        if (!(packet_ = read_packet_())) {
+            return;
+        }
+        if (!packet::timestamp_lt(timestamp_, packet_->end())) {
+            packet_.reset();
+        } else {
+            stats_.n_packets++;
+        }
+    }
+
+    const packet::timestamp_t pkt_timestamp = packet_->rtp()->timestamp;
+
+    if (packet::timestamp_lt(pkt_timestamp, timestamp_)) {
+        packet_pos_ =
+            (packet::timestamp_t)packet::timestamp_diff(timestamp_, pkt_timestamp);
+    } else {
+        packet_pos_ = 0;
+    }
+}
+
 packet::PacketPtr Depacketizer::read_packet_() {
     packet::PacketPtr pp = reader_.read();
     if (!pp) {
@@ -246,6 +374,13 @@ void Depacketizer::set_frame_flags_(Frame& frame,
     }
 
     frame.set_flags(flags);
+
+    stats_.n_frames++;
+    if (flags & Frame::FlagBlank) {
+        stats_.n_blank_frames++;
+    } else if (flags & Frame::FlagIncomplete) {
+        stats_.n_incomplete_frames++;
+    }
 }
 
 } // namespace audio
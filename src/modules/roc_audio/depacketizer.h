@@ -14,6 +14,7 @@
 
 #include "roc_audio/idecoder.h"
 #include "roc_audio/ireader.h"
+#include "roc_audio/plc.h"
 #include "roc_audio/units.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/rate_limiter.h"
@@ -22,6 +23,40 @@
 namespace roc {
 namespace audio {
 
+//! Depacketizer statistics.
+struct DepacketizerStats {
+    //! Number of packets decoded.
+    size_t n_packets;
+
+    //! Number of packets dropped because they arrived too late.
+    size_t n_late_packets;
+
+    //! Number of frames produced.
+    size_t n_frames;
+
+    //! Number of frames without any decoded samples.
+    size_t n_blank_frames;
+
+    //! Number of frames partially filled with decoded samples.
+    size_t n_incomplete_frames;
+
+    //! Number of decoded samples per channel.
+    size_t n_decoded_samples;
+
+    //! Number of samples per channel missing because of lost or late packets.
+    size_t n_missing_samples;
+
+    DepacketizerStats()
+        : n_packets(0)
+        , n_late_packets(0)
+        , n_frames(0)
+        , n_blank_frames(0)
+        , n_incomplete_frames(0)
+        , n_decoded_samples(0)
+        , n_missing_samples(0) {
+    }
+};
+
 //! Depacketizer.
 //! @remarks
 //!  Reads packets from a packet reader, decodes samples from packets using a
@@ -33,10 +68,12 @@ public:
     //! @b Parameters
     //!  - @p reader is used to read packets
     //!  - @p decoder is used to extract samples from packets
+    //!  - @p plc is used to conceal packet loss; may be null
     //!  - @p channels defines a set of channels in the output frames
     //!  - @p beep enables weird beeps instead of silence on packet loss
     Depacketizer(packet::IReader& reader,
                  IDecoder& decoder,
+                 PLC* plc,
                  packet::channel_mask_t channels,
                  bool beep);
 
@@ -51,6 +88,33 @@ public:
     //!  started() should return true
     packet::timestamp_t timestamp() const;
 
+    //! Increase latency by given number of samples.
+    //! @remarks
+    //!  Before rendering the next packet samples, inserts @p n_samples samples
+    //!  produced in the same way as samples for lost packets, without advancing
+    //!  the stream timestamp. Has no effect until the first packet is received.
+    void add_delay(packet::timestamp_t n_samples);
+
+    //! Decrease latency by given number of samples.
+    //! @remarks
+    //!  Cancels pending delay, if any, and then advances the stream timestamp,
+    //!  discarding samples of the current and queued packets that fall before
+    //!  the new timestamp. Has no effect until the first packet is received.
+    void skip(packet::timestamp_t n_samples);
+
+    //! Get number of samples inserted by add_delay() and not rendered yet.
+    packet::timestamp_t pending_delay() const;
+
+    //! Get statistics.
+    //! @remarks
+    //!  Counters are accumulated since construction or last reset().
+    const DepacketizerStats& stats() const;
+
+    //! Reset to initial state.
+    //! @remarks
+    //!  Forgets the current packet and waits for the first packet again.
+    void reset();
+
 private:
     void read_frame_(Frame& frame);
 
@@ -58,16 +122,20 @@ private:
 
     sample_t* read_packet_samples_(sample_t* buff_ptr, sample_t* buff_end);
     sample_t* read_missing_samples_(sample_t* buff_ptr, sample_t* buff_end);
+    sample_t* read_delay_samples_(sample_t* buff_ptr, sample_t* buff_end);
+    void conceal_samples_(sample_t* buff_ptr, size_t num_samples);
 
     void set_frame_flags_(Frame& frame,
                           size_t prev_dropped_packets,
                           packet::timestamp_t prev_packet_samples);
 
     void update_packet_();
+    void skip_packets_();
     packet::PacketPtr read_packet_();
 
     packet::IReader& reader_;
     IDecoder& decoder_;
+    PLC* plc_;
 
     const packet::channel_mask_t channels_;
     const size_t num_channels_;
@@ -80,6 +148,7 @@ private:
     packet::timestamp_t zero_samples_;
     packet::timestamp_t missing_samples_;
     packet::timestamp_t packet_samples_;
+    packet::timestamp_t delay_samples_;
 
     core::RateLimiter rate_limiter_;
 
@@ -87,6 +156,8 @@ private:
     bool beep_;
 
     size_t dropped_packets_;
+
+    DepacketizerStats stats_;
 };
 
 } // namespace audio
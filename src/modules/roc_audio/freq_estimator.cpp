@@ -7,6 +7,7 @@
  */
 
 #include "roc_audio/freq_estimator.h"
+#include "roc_core/log.h"
 #include "roc_core/panic.h"
 
 namespace roc {
@@ -14,9 +15,6 @@ namespace audio {
 
 namespace {
 
-const float P = 100e-8f; // Proportional gain of PI-controller.
-const float I = 0.5e-8f; // Integral gain of PI-controller.
-
 // Calculates dot product of arrays IR of filter (@p coeff) and input array (@p samples).
 //
 // - @p coeff Filter impulse response.
@@ -40,20 +38,22 @@ float dot_prod(const float* coeff,
 
 } // namespace
 
-FreqEstimator::FreqEstimator(packet::timestamp_t target_latency)
-    : target_(target_latency)
+FreqEstimator::FreqEstimator(const FreqEstimatorConfig& config,
+                             packet::timestamp_t target_latency)
+    : config_(config)
+    , target_(target_latency)
     , dec1_ind_(0)
     , dec2_ind_(0)
     , samples_counter_(0)
     , accum_(0)
+    , locked_(config.mode == FreqEstimatorMode_Fixed)
+    , lock_counter_(0)
+    , lock_coeff_sum_(0)
     , coeff_(1) {
     if (fe_decim_len % 2 != 0) {
         roc_panic("freq estimator: decim_len should be power of two");
     }
-    for (size_t i = 0; i < fe_decim_len; i++) {
-        dec1_casc_buff_[i] = target_;
-        dec2_casc_buff_[i] = target_;
-    }
+    reset(target_latency);
 }
 
 float FreqEstimator::freq_coeff() const {
@@ -68,6 +68,34 @@ void FreqEstimator::update(packet::timestamp_t current) {
     }
 }
 
+void FreqEstimator::set_target(packet::timestamp_t target_latency) {
+    target_ = (float)target_latency;
+}
+
+bool FreqEstimator::locked() const {
+    return locked_;
+}
+
+void FreqEstimator::reset(packet::timestamp_t target_latency) {
+    target_ = (float)target_latency;
+
+    for (size_t i = 0; i < fe_decim_len; i++) {
+        dec1_casc_buff_[i] = target_;
+        dec2_casc_buff_[i] = target_;
+    }
+    dec1_ind_ = 0;
+    dec2_ind_ = 0;
+
+    samples_counter_ = 0;
+    accum_ = 0;
+
+    locked_ = config_.mode == FreqEstimatorMode_Fixed;
+    lock_counter_ = 0;
+    lock_coeff_sum_ = 0;
+
+    coeff_ = 1;
+}
+
 bool FreqEstimator::run_decimators_(packet::timestamp_t current, float& filtered) {
     samples_counter_++;
 
@@ -79,6 +107,20 @@ bool FreqEstimator::run_decimators_(packet::timestamp_t current, float& filtered
                                               fe_decim_len, fe_decim_len_mask)
             / fe_decim_h_gain;
 
+        if (!locked_) {
+            // In acquisition phase, first decimator's output is used directly.
+            filtered = dec2_casc_buff_[dec2_ind_];
+
+            if ((samples_counter_ % (fe_decim_factor * fe_decim_factor)) == 0) {
+                samples_counter_ = 0;
+            }
+
+            dec2_ind_ = (dec2_ind_ + 1) & fe_decim_len_mask;
+            dec1_ind_ = (dec1_ind_ + 1) & fe_decim_len_mask;
+
+            return true;
+        }
+
         if (((samples_counter_ % (fe_decim_factor * fe_decim_factor)) == 0)) {
             samples_counter_ = 0;
 
@@ -101,8 +143,68 @@ bool FreqEstimator::run_decimators_(packet::timestamp_t current, float& filtered
 float FreqEstimator::run_controller_(float current) {
     const float error = (current - target_);
 
-    accum_ = accum_ + error;
-    return 1 + P * error + I * accum_;
+    update_phase_(error);
+
+    // Integral term is kept in frequency units, so that switching between
+    // phases doesn't change the coefficient abruptly.
+    if (locked_) {
+        accum_ = accum_ + config_.i_gain * error;
+        return 1 + config_.p_gain * error + accum_;
+    } else {
+        accum_ = accum_ + config_.acquisition_i_gain * error;
+        return 1 + config_.acquisition_p_gain * error + accum_;
+    }
+}
+
+void FreqEstimator::update_phase_(float error) {
+    if (config_.mode == FreqEstimatorMode_Fixed) {
+        return;
+    }
+
+    const float rel_error = (error >= 0 ? error : -error) / target_;
+
+    if (locked_) {
+        if (rel_error > config_.unlock_threshold) {
+            roc_log(LogDebug,
+                    "freq estimator: lost lock, restarting acquisition: error=%.3f",
+                    (double)rel_error);
+            locked_ = false;
+            lock_counter_ = 0;
+            lock_coeff_sum_ = 0;
+        }
+        return;
+    }
+
+    if (rel_error > config_.lock_threshold) {
+        lock_counter_ = 0;
+        lock_coeff_sum_ = 0;
+        return;
+    }
+
+    lock_coeff_sum_ += (double)coeff_;
+
+    if (++lock_counter_ < config_.lock_duration) {
+        return;
+    }
+
+    roc_log(LogDebug, "freq estimator: locked, switching to tracking: coeff=%.6f",
+            (double)coeff_);
+
+    // Second decimator history was built during acquisition and lags behind;
+    // restart it from the current latency to avoid a kick after switching.
+    const float current = error + target_;
+    for (size_t i = 0; i < fe_decim_len; i++) {
+        dec2_casc_buff_[i] = current;
+    }
+
+    // Latency was stable during the lock period, so the mean coefficient over
+    // this period is a good estimate of the clock drift; use it as the initial
+    // integral term for tracking. Unlike the last coefficient, it's not affected
+    // by the jitter passed through the first decimator.
+    accum_ = float(lock_coeff_sum_ / (double)lock_counter_) - 1;
+
+    locked_ = true;
+    samples_counter_ = 0;
 }
 
 } // namespace audio
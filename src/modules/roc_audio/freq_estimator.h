@@ -20,14 +20,72 @@
 namespace roc {
 namespace audio {
 
+//! FreqEstimator controller mode.
+enum FreqEstimatorMode {
+    //! Controller always uses tracking gains and runs after both decimators.
+    FreqEstimatorMode_Fixed,
+
+    //! Controller starts in acquisition phase and switches to tracking phase.
+    //! @remarks
+    //!  During acquisition, the controller runs after the first decimator with
+    //!  acquisition gains, which gives much lower delay in the loop and allows
+    //!  to lock onto the sender clock drift quickly. When the latency error stays
+    //!  within lock threshold long enough, the controller switches to tracking
+    //!  gains and runs after both decimators, which filters out network jitter.
+    //!  If the error exceeds unlock threshold, the acquisition is restarted.
+    FreqEstimatorMode_Adaptive
+};
+
+//! FreqEstimator parameters.
+struct FreqEstimatorConfig {
+    //! Controller mode.
+    FreqEstimatorMode mode;
+
+    //! Proportional gain of PI controller in tracking phase.
+    float p_gain;
+
+    //! Integral gain of PI controller in tracking phase.
+    float i_gain;
+
+    //! Proportional gain of PI controller in acquisition phase.
+    float acquisition_p_gain;
+
+    //! Integral gain of PI controller in acquisition phase.
+    float acquisition_i_gain;
+
+    //! Maximum latency error to switch to tracking, relative to target latency.
+    float lock_threshold;
+
+    //! Number of controller updates with error within lock threshold required
+    //! to switch to tracking.
+    size_t lock_duration;
+
+    //! Minimum latency error to switch back to acquisition, relative to target
+    //! latency.
+    float unlock_threshold;
+
+    //! Initialize config with default values.
+    FreqEstimatorConfig()
+        : mode(FreqEstimatorMode_Adaptive)
+        , p_gain(100e-8f)
+        , i_gain(0.5e-8f)
+        , acquisition_p_gain(2000e-8f)
+        , acquisition_i_gain(50e-8f)
+        , lock_threshold(0.02f)
+        , lock_duration(200)
+        , unlock_threshold(0.2f) {
+    }
+};
+
 //! Evaluates sender's frequency to receivers's frequency ratio.
 class FreqEstimator : public core::NonCopyable<> {
 public:
     //! Initialize.
     //!
     //! @b Parameters
+    //!  - @p config defines controller parameters
     //!  - @p target_latency defines latency we want to archive.
-    FreqEstimator(packet::timestamp_t target_latency);
+    FreqEstimator(const FreqEstimatorConfig& config, packet::timestamp_t target_latency);
 
     //! Get current frequecy coefficient.
     float freq_coeff() const;
@@ -35,11 +93,23 @@ public:
     //! Compute new value of frequency coefficient.
     void update(packet::timestamp_t current_latency);
 
+    //! Change target latency.
+    void set_target(packet::timestamp_t target_latency);
+
+    //! Check if the controller is in tracking phase.
+    bool locked() const;
+
+    //! Reset to initial state with given target latency.
+    void reset(packet::timestamp_t target_latency);
+
 private:
     bool run_decimators_(packet::timestamp_t current, float& filtered);
     float run_controller_(float current);
+    void update_phase_(float error);
 
-    const float target_; // Target latency.
+    const FreqEstimatorConfig config_;
+
+    float target_; // Target latency.
 
     float dec1_casc_buff_[fe_decim_len];
     size_t dec1_ind_;
@@ -48,7 +118,11 @@ private:
     size_t dec2_ind_;
 
     size_t samples_counter_; // Input samples counter.
-    float accum_;            // Integrator value.
+    float accum_;            // Integral term value.
+
+    bool locked_;           // Whether the controller is in tracking phase.
+    size_t lock_counter_;   // Number of updates with error within lock threshold.
+    double lock_coeff_sum_; // Sum of coefficients during these updates.
 
     float coeff_; // Current frequency coefficient value.
 };
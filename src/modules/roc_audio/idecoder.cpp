@@ -14,5 +14,12 @@ namespace audio {
 IDecoder::~IDecoder() {
 }
 
+size_t IDecoder::conceal_samples(sample_t*, size_t, packet::channel_mask_t) {
+    return 0;
+}
+
+void IDecoder::reset() {
+}
+
 } // namespace audio
 } // namespace roc
@@ -48,6 +48,29 @@ public:
                                 sample_t* samples,
                                 size_t n_samples,
                                 packet::channel_mask_t channels) = 0;
+
+    //! Conceal lost samples.
+    //!
+    //! @b Parameters
+    //!  - @p samples - output buffer
+    //!  - @p n_samples - number of samples in output buffer
+    //!  - @p channels - output buffer channel mask
+    //!
+    //! Called instead of read_samples() for the samples of lost packets. Decoders
+    //! that have built-in packet loss concealment may synthesize these samples
+    //! from the previously decoded packets.
+    //!
+    //! @returns number of concealed samples for every channel, or zero if the
+    //! decoder doesn't support concealment.
+    virtual size_t conceal_samples(sample_t* samples,
+                                   size_t n_samples,
+                                   packet::channel_mask_t channels);
+
+    //! Reset decoder state.
+    //! @remarks
+    //!  Called when the decoder is reused for another stream. Stateless
+    //!  decoders don't need to override it.
+    virtual void reset();
 };
 
 } // namespace audio
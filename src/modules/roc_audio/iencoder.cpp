@@ -14,5 +14,9 @@ namespace audio {
 IEncoder::~IEncoder() {
 }
 
+bool IEncoder::finish_packet(packet::Packet&, size_t) {
+    return true;
+}
+
 } // namespace audio
 } // namespace roc
@@ -52,6 +52,19 @@ public:
                                  const sample_t* samples,
                                  size_t n_samples,
                                  packet::channel_mask_t channels) = 0;
+
+    //! Finish packet.
+    //!
+    //! @b Parameters
+    //!  - @p packet - packet to finish
+    //!  - @p n_samples - number of samples written to packet
+    //!
+    //! Called after all samples were written to @p packet and its payload was
+    //! truncated to payload_size(n_samples). Encoders that compress samples as a
+    //! whole, rather than one by one, produce the payload here.
+    //!
+    //! @returns false if the packet can't be encoded and should be dropped.
+    virtual bool finish_packet(packet::Packet& packet, size_t n_samples);
 };
 
 } // namespace audio
@@ -9,6 +9,7 @@
 #include "roc_audio/latency_monitor.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
 
 namespace roc {
 namespace audio {
@@ -17,11 +18,32 @@ namespace {
 
 const core::nanoseconds_t LogInterval = 5 * core::Second;
 
+// Latency is recovered in place only if it's not further from the target than
+// this number of max_latency spans. Larger jumps usually mean that the sender
+// was restarted or its timestamps jumped, and the session is terminated.
+const int64_t MaxRecoverySpans = 4;
+
+// Timestamp distance may be arbitrary large after a jump, so the latency is
+// summed in 64 bits and saturated.
+packet::timestamp_diff_t saturate_latency(int64_t latency) {
+    const int64_t max_latency = (int64_t)((packet::timestamp_t)-1 / 2);
+    const int64_t min_latency = -max_latency - 1;
+
+    if (latency > max_latency) {
+        return (packet::timestamp_diff_t)max_latency;
+    }
+    if (latency < min_latency) {
+        return (packet::timestamp_diff_t)min_latency;
+    }
+    return (packet::timestamp_diff_t)latency;
+}
+
 } // namespace
 
 LatencyMonitor::LatencyMonitor(const packet::SortedQueue& queue,
-                               const Depacketizer& depacketizer,
+                               Depacketizer& depacketizer,
                                ResamplerReader* resampler,
+                               const LatencyTuner* tuner,
                                const LatencyMonitorConfig& config,
                                core::nanoseconds_t target_latency,
                                size_t input_sample_rate,
@@ -29,19 +51,27 @@ LatencyMonitor::LatencyMonitor(const packet::SortedQueue& queue,
     : queue_(queue)
     , depacketizer_(depacketizer)
     , resampler_(resampler)
-    , fe_((packet::timestamp_t)packet::timestamp_from_ns(target_latency,
+    , tuner_(tuner)
+    , fe_(config.fe,
+          (packet::timestamp_t)packet::timestamp_from_ns(target_latency,
                                                          input_sample_rate))
     , rate_limiter_(LogInterval)
     , update_interval_((packet::timestamp_t)packet::timestamp_from_ns(
           config.fe_update_interval, input_sample_rate))
     , update_pos_(0)
     , has_update_pos_(false)
+    , initial_target_latency_((packet::timestamp_t)packet::timestamp_from_ns(
+          target_latency, input_sample_rate))
     , target_latency_((packet::timestamp_t)packet::timestamp_from_ns(target_latency,
                                                                      input_sample_rate))
     , min_latency_(packet::timestamp_from_ns(config.min_latency, input_sample_rate))
     , max_latency_(packet::timestamp_from_ns(config.max_latency, input_sample_rate))
+    , latency_recovery_(config.latency_recovery)
     , max_scaling_delta_(config.max_scaling_delta)
+    , input_sample_rate_(input_sample_rate)
     , sample_rate_coeff_(0.f)
+    , latency_(0)
+    , freq_coeff_(1.f)
     , valid_(false) {
     roc_log(LogDebug,
             "latency monitor: initializing: target_latency=%lu in_rate=%lu out_rate=%lu",
@@ -92,13 +122,23 @@ bool LatencyMonitor::update(packet::timestamp_t pos) {
     }
 
     if (!check_latency_(latency)) {
-        return false;
+        if (!latency_recovery_ || !restore_latency_(latency)) {
+            return false;
+        }
+        latency = (packet::timestamp_diff_t)target_latency_;
+    }
+
+    if (latency < 0) {
+        latency = 0;
+    }
+
+    latency_ = (packet::timestamp_t)latency;
+
+    if (tuner_) {
+        update_target_((packet::timestamp_t)latency);
     }
 
     if (resampler_) {
-        if (latency < 0) {
-            latency = 0;
-        }
         if (!update_resampler_(pos, (packet::timestamp_t)latency)) {
             return false;
         }
@@ -109,6 +149,55 @@ bool LatencyMonitor::update(packet::timestamp_t pos) {
     return true;
 }
 
+bool LatencyMonitor::recover() {
+    if (!latency_recovery_) {
+        return false;
+    }
+
+    packet::timestamp_diff_t latency = 0;
+
+    if (!get_latency_(latency)) {
+        return false;
+    }
+
+    if (latency >= (packet::timestamp_diff_t)target_latency_) {
+        return false;
+    }
+
+    return restore_latency_(latency);
+}
+
+void LatencyMonitor::reset() {
+    roc_panic_if(!valid());
+
+    target_latency_ = initial_target_latency_;
+    fe_.reset(initial_target_latency_);
+
+    update_pos_ = 0;
+    has_update_pos_ = false;
+
+    latency_ = 0;
+    freq_coeff_ = 1.f;
+
+    if (resampler_) {
+        if (!resampler_->set_scaling(sample_rate_coeff_)) {
+            roc_panic("latency monitor: can't reset resampler scaling");
+        }
+    }
+}
+
+packet::timestamp_t LatencyMonitor::latency() const {
+    return latency_;
+}
+
+packet::timestamp_t LatencyMonitor::target_latency() const {
+    return target_latency_;
+}
+
+float LatencyMonitor::freq_coeff() const {
+    return freq_coeff_;
+}
+
 bool LatencyMonitor::get_latency_(packet::timestamp_diff_t& latency) const {
     if (!depacketizer_.started()) {
         return false;
@@ -123,10 +212,31 @@ bool LatencyMonitor::get_latency_(packet::timestamp_diff_t& latency) const {
 
     const packet::timestamp_t tail = latest->end();
 
-    latency = packet::timestamp_diff(tail, head);
+    // Samples inserted by depacketizer but not rendered yet are already
+    // buffered, so they are included in the latency.
+    latency = saturate_latency((int64_t)packet::timestamp_diff(tail, head)
+                               + (int64_t)arrival_offset_(*latest)
+                               + (int64_t)depacketizer_.pending_delay());
     return true;
 }
 
+packet::timestamp_diff_t
+LatencyMonitor::arrival_offset_(const packet::Packet& packet) const {
+    const packet::UDP* udp = packet.udp();
+    if (!udp || udp->receive_timestamp == 0) {
+        return 0;
+    }
+
+    const core::nanoseconds_t elapsed = core::timestamp() - udp->receive_timestamp;
+    if (elapsed <= 0) {
+        return 0;
+    }
+
+    // Don't extrapolate beyond the next packet, which is late or lost.
+    return std::min(packet::timestamp_from_ns(elapsed, input_sample_rate_),
+                    (packet::timestamp_diff_t)packet.rtp()->duration);
+}
+
 bool LatencyMonitor::check_latency_(packet::timestamp_diff_t latency) const {
     if (latency < min_latency_) {
         roc_log(LogDebug, "latency monitor: latency out of bounds: latency=%ld min=%ld",
@@ -143,6 +253,38 @@ bool LatencyMonitor::check_latency_(packet::timestamp_diff_t latency) const {
     return true;
 }
 
+bool LatencyMonitor::restore_latency_(packet::timestamp_diff_t latency) {
+    const packet::timestamp_diff_t target = (packet::timestamp_diff_t)target_latency_;
+
+    const int64_t distance = (int64_t)latency - (int64_t)target;
+    const int64_t max_distance = MaxRecoverySpans * (int64_t)max_latency_;
+
+    if (distance > max_distance || distance < -max_distance) {
+        roc_log(LogDebug,
+                "latency monitor: latency too far from target, can't restore:"
+                " latency=%ld target=%ld",
+                (long)latency, (long)target);
+        return false;
+    }
+
+    roc_log(LogDebug, "latency monitor: restoring target latency: latency=%ld target=%ld",
+            (long)latency, (long)target);
+
+    // The recovery happens in place: the session keeps its state, and the
+    // depacketizer either skips excess samples or inserts missing ones.
+    if (distance > 0) {
+        depacketizer_.skip(packet::timestamp_t(distance));
+    } else if (distance < 0) {
+        depacketizer_.add_delay(packet::timestamp_t(-distance));
+    }
+
+    // FreqEstimator state was accumulated for the old latency and would
+    // cause a scaling spike, so it starts over.
+    fe_.reset(target_latency_);
+
+    return true;
+}
+
 float LatencyMonitor::trim_scaling_(float freq_coeff) const {
     const float min_coeff = 1.0f - max_scaling_delta_;
     const float max_coeff = 1.0f + max_scaling_delta_;
@@ -158,6 +300,25 @@ float LatencyMonitor::trim_scaling_(float freq_coeff) const {
     return freq_coeff;
 }
 
+void LatencyMonitor::update_target_(packet::timestamp_t latency) {
+    const packet::timestamp_t new_target = tuner_->target_latency();
+    if (new_target == target_latency_) {
+        return;
+    }
+
+    roc_log(LogDebug, "latency monitor: updating target latency: target=%lu prev=%lu",
+            (unsigned long)new_target, (unsigned long)target_latency_);
+
+    // The latency is raised immediately by inserting samples before the next
+    // packet, and lowered gradually by FreqEstimator via resampler speed-up.
+    if (new_target > target_latency_ && latency < new_target) {
+        depacketizer_.add_delay(new_target - std::max(latency, target_latency_));
+    }
+
+    target_latency_ = new_target;
+    fe_.set_target(new_target);
+}
+
 bool LatencyMonitor::init_resampler_(size_t input_sample_rate,
                                      size_t output_sample_rate) {
     if (input_sample_rate == 0 || output_sample_rate == 0) {
@@ -193,6 +354,8 @@ bool LatencyMonitor::update_resampler_(packet::timestamp_t pos,
     const float trimmed_coeff = trim_scaling_(freq_coeff);
     const float adjusted_coeff = sample_rate_coeff_ * trimmed_coeff;
 
+    freq_coeff_ = trimmed_coeff;
+
     if (rate_limiter_.allow()) {
         roc_log(
             LogDebug,
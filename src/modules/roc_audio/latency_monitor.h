@@ -14,6 +14,7 @@
 
 #include "roc_audio/depacketizer.h"
 #include "roc_audio/freq_estimator.h"
+#include "roc_audio/latency_tuner.h"
 #include "roc_audio/resampler_reader.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/rate_limiter.h"
@@ -31,13 +32,26 @@ struct LatencyMonitorConfig {
     core::nanoseconds_t fe_update_interval;
 
     //! Minimum allowed latency, nanoseconds.
-    //! If the latency goes out of bounds, the session is terminated.
+    //! If the latency goes out of bounds, the session is recovered or terminated.
     core::nanoseconds_t min_latency;
 
     //! Maximum allowed latency, nanoseconds.
-    //! If the latency goes out of bounds, the session is terminated.
+    //! If the latency goes out of bounds, the session is recovered or terminated.
     core::nanoseconds_t max_latency;
 
+    //! Recover latency in place when it goes out of bounds.
+    //! @remarks
+    //!  If enabled, when the latency exceeds the maximum, the stream is skipped
+    //!  forward to the target latency, and when it falls below the minimum,
+    //!  silence is inserted until the target latency is restored. If disabled,
+    //!  the session is terminated instead. Enabled by default. Latency jumps
+    //!  larger than a few max_latency spans, e.g. when the sender restarts, still
+    //!  terminate the session.
+    bool latency_recovery;
+
+    //! FreqEstimator parameters.
+    FreqEstimatorConfig fe;
+
     //! Maximum allowed freq_coeff delta around one.
     //! If the scaling goes out of bounds, it is trimmed.
     //! For example, 0.01 allows freq_coeff values in range [0.99; 1.01].
@@ -47,16 +61,21 @@ struct LatencyMonitorConfig {
         : fe_update_interval(5 * core::Millisecond)
         , min_latency(0)
         , max_latency(0)
+        , latency_recovery(true)
         , max_scaling_delta(0.005f) {
     }
 };
 
 //! Session latency monitor.
-//!  - calculates session latency
+//!  - calculates session latency; if packets have receive timestamps, the
+//!    latency is extended by the time passed since the latest packet was
+//!    received, so that it doesn't drop between packet arrivals
 //!  - calculates session scaling factor
 //!  - trims scaling factor to the allowed range
 //!  - updates resampler scaling
-//!  - shutdowns session if the latency goes out of bounds
+//!  - follows target latency provided by latency tuner, if any
+//!  - restores target latency or shutdowns session if the latency goes out
+//!    of bounds
 class LatencyMonitor : public core::NonCopyable<> {
 public:
     //! Constructor.
@@ -64,13 +83,15 @@ public:
     //! @b Parameters
     //!  - @p queue and @p depacketizer are used to calculate the latency
     //!  - @p resampler is used to set the scaling factor, may be null
+    //!  - @p tuner is used to get the adaptive target latency, may be null
     //!  - @p config defines various miscellaneous parameters
     //!  - @p target_latency defines FreqEstimator target latency, in samples
     //!  - @p input_sample_rate is the sample rate of the input packets
     //!  - @p output_sample_rate is the sample rate of the output frames
     LatencyMonitor(const packet::SortedQueue& queue,
-                   const Depacketizer& depacketizer,
+                   Depacketizer& depacketizer,
                    ResamplerReader* resampler,
+                   const LatencyTuner* tuner,
                    const LatencyMonitorConfig& config,
                    core::nanoseconds_t target_latency,
                    size_t input_sample_rate,
@@ -84,20 +105,55 @@ public:
     //!  false if the session should be terminated.
     bool update(packet::timestamp_t time);
 
+    //! Restore target latency if it's too low.
+    //! @remarks
+    //!  Inserts silence before the next packet so that the latency becomes
+    //!  equal to the target latency. Used when the playback is broken because
+    //!  packets are constantly arriving a bit late.
+    //! @returns
+    //!  false if latency recovery is disabled, the latency is unknown, it's
+    //!  not below the target latency, or it's too far from the target latency.
+    bool recover();
+
+    //! Reset to initial state.
+    //! @remarks
+    //!  Restores initial target latency and resampler scaling. Should be called
+    //!  after the depacketizer and the resampler are reset.
+    void reset();
+
+    //! Get latency measured during last update(), number of samples.
+    //! @remarks
+    //!  Returns zero if the latency is not known yet.
+    packet::timestamp_t latency() const;
+
+    //! Get current target latency, number of samples.
+    packet::timestamp_t target_latency() const;
+
+    //! Get scaling factor applied to compensate clock drift.
+    //! @remarks
+    //!  Doesn't include the conversion between input and output sample rates.
+    //!  Returns one if resampling is disabled.
+    float freq_coeff() const;
+
 private:
     bool get_latency_(packet::timestamp_diff_t& latency) const;
+    packet::timestamp_diff_t arrival_offset_(const packet::Packet& packet) const;
     bool check_latency_(packet::timestamp_diff_t latency) const;
+    bool restore_latency_(packet::timestamp_diff_t latency);
 
     float trim_scaling_(float scaling) const;
 
+    void update_target_(packet::timestamp_t latency);
+
     bool init_resampler_(size_t input_sample_rate, size_t output_sample_rate);
     bool update_resampler_(packet::timestamp_t time, packet::timestamp_t latency);
 
     void report_latency_(packet::timestamp_t latency);
 
     const packet::SortedQueue& queue_;
-    const Depacketizer& depacketizer_;
+    Depacketizer& depacketizer_;
     ResamplerReader* resampler_;
+    const LatencyTuner* tuner_;
     FreqEstimator fe_;
 
     core::RateLimiter rate_limiter_;
@@ -106,13 +162,19 @@ private:
     packet::timestamp_t update_pos_;
     bool has_update_pos_;
 
-    const packet::timestamp_t target_latency_;
+    const packet::timestamp_t initial_target_latency_;
+    packet::timestamp_t target_latency_;
     const packet::timestamp_diff_t min_latency_;
     const packet::timestamp_diff_t max_latency_;
+    const bool latency_recovery_;
 
     const float max_scaling_delta_;
+    const size_t input_sample_rate_;
     float sample_rate_coeff_;
 
+    packet::timestamp_t latency_;
+    float freq_coeff_;
+
     bool valid_;
 };
 
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/latency_tuner.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+LatencyTuner::LatencyTuner(const LatencyTunerConfig& config,
+                           core::nanoseconds_t target_latency,
+                           size_t sample_rate)
+    : sample_rate_(sample_rate)
+    , min_latency_(config.min_latency)
+    , max_latency_(config.max_latency)
+    , window_(config.jitter_window)
+    , margin_(config.jitter_margin)
+    , decrease_speed_(config.decrease_speed)
+    , initial_target_(target_latency)
+    , target_(target_latency)
+    , started_(false)
+    , last_ts_(0)
+    , last_arrival_(0)
+    , last_transit_(0)
+    , stream_pos_(0)
+    , window_start_(0)
+    , cur_min_(0)
+    , cur_max_(0)
+    , prev_min_(0)
+    , prev_max_(0)
+    , has_prev_(false)
+    , mean_jitter_(0)
+    , valid_(false) {
+    if (sample_rate == 0 || config.min_latency <= 0
+        || config.max_latency < config.min_latency || target_latency < config.min_latency
+        || target_latency > config.max_latency || config.jitter_window <= 0
+        || config.jitter_margin <= 0 || config.decrease_speed < 0) {
+        roc_log(LogError,
+                "latency tuner: invalid config: target_latency=%ld min_latency=%ld"
+                " max_latency=%ld jitter_window=%ld jitter_margin=%.3f"
+                " decrease_speed=%.5f",
+                (long)target_latency, (long)config.min_latency, (long)config.max_latency,
+                (long)config.jitter_window, (double)config.jitter_margin,
+                (double)config.decrease_speed);
+        return;
+    }
+
+    roc_log(LogDebug,
+            "latency tuner: initializing: target_latency=%ld min_latency=%ld"
+            " max_latency=%ld",
+            (long)target_latency, (long)config.min_latency, (long)config.max_latency);
+
+    valid_ = true;
+}
+
+bool LatencyTuner::valid() const {
+    return valid_;
+}
+
+void LatencyTuner::add_packet(core::nanoseconds_t arrival_time,
+                              packet::timestamp_t timestamp) {
+    roc_panic_if(!valid());
+
+    if (!started_) {
+        started_ = true;
+        last_ts_ = timestamp;
+        last_arrival_ = arrival_time;
+        last_transit_ = arrival_time;
+        window_start_ = arrival_time;
+        cur_min_ = cur_max_ = arrival_time;
+        return;
+    }
+
+    const packet::timestamp_diff_t ts_diff = packet::timestamp_diff(timestamp, last_ts_);
+    const core::nanoseconds_t pos =
+        stream_pos_ + ts_diff * core::Second / (core::nanoseconds_t)sample_rate_;
+
+    if (ts_diff > 0) {
+        stream_pos_ = pos;
+        last_ts_ = timestamp;
+    }
+
+    const core::nanoseconds_t transit = arrival_time - pos;
+
+    const core::nanoseconds_t transit_diff = transit - last_transit_;
+    mean_jitter_ +=
+        ((double)(transit_diff >= 0 ? transit_diff : -transit_diff) - mean_jitter_) / 16;
+    last_transit_ = transit;
+
+    update_window_(arrival_time, transit);
+
+    const core::nanoseconds_t elapsed = arrival_time - last_arrival_;
+    if (elapsed > 0) {
+        last_arrival_ = arrival_time;
+    }
+
+    update_target_(std::max(elapsed, (core::nanoseconds_t)0));
+}
+
+packet::timestamp_t LatencyTuner::target_latency() const {
+    return (packet::timestamp_t)packet::timestamp_from_ns(target_, sample_rate_);
+}
+
+core::nanoseconds_t LatencyTuner::peak_jitter() const {
+    core::nanoseconds_t min_transit = cur_min_, max_transit = cur_max_;
+
+    if (has_prev_) {
+        min_transit = std::min(min_transit, prev_min_);
+        max_transit = std::max(max_transit, prev_max_);
+    }
+
+    return max_transit - min_transit;
+}
+
+core::nanoseconds_t LatencyTuner::mean_jitter() const {
+    return (core::nanoseconds_t)mean_jitter_;
+}
+
+void LatencyTuner::reset() {
+    roc_panic_if(!valid());
+
+    target_ = initial_target_;
+
+    started_ = false;
+    last_ts_ = 0;
+    last_arrival_ = 0;
+    last_transit_ = 0;
+    stream_pos_ = 0;
+
+    window_start_ = 0;
+    cur_min_ = cur_max_ = 0;
+    prev_min_ = prev_max_ = 0;
+    has_prev_ = false;
+
+    mean_jitter_ = 0;
+}
+
+void LatencyTuner::update_window_(core::nanoseconds_t arrival_time,
+                                  core::nanoseconds_t transit) {
+    if (arrival_time - window_start_ >= window_) {
+        prev_min_ = cur_min_;
+        prev_max_ = cur_max_;
+        has_prev_ = true;
+
+        cur_min_ = cur_max_ = transit;
+        window_start_ = arrival_time;
+    } else {
+        cur_min_ = std::min(cur_min_, transit);
+        cur_max_ = std::max(cur_max_, transit);
+    }
+}
+
+void LatencyTuner::update_target_(core::nanoseconds_t elapsed) {
+    core::nanoseconds_t desired = core::nanoseconds_t(peak_jitter() * margin_);
+
+    desired = std::max(desired, min_latency_);
+    desired = std::min(desired, max_latency_);
+
+    const core::nanoseconds_t prev_target = target_;
+
+    if (desired > target_) {
+        target_ = desired;
+    } else if (desired < target_) {
+        target_ =
+            std::max(desired, target_ - core::nanoseconds_t(elapsed * decrease_speed_));
+    }
+
+    if (target_ > prev_target) {
+        roc_log(LogDebug,
+                "latency tuner: raising target latency: target=%ld prev=%ld"
+                " peak_jitter=%ld mean_jitter=%ld",
+                (long)target_, (long)prev_target, (long)peak_jitter(),
+                (long)mean_jitter());
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/latency_tuner.h
+//! @brief Latency tuner.
+
+#ifndef ROC_AUDIO_LATENCY_TUNER_H_
+#define ROC_AUDIO_LATENCY_TUNER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace audio {
+
+//! Latency tuner parameters.
+struct LatencyTunerConfig {
+    //! Enable adaptive target latency.
+    //! @remarks
+    //!  If disabled, the target latency is constant.
+    bool enabled;
+
+    //! Minimum target latency, nanoseconds.
+    core::nanoseconds_t min_latency;
+
+    //! Maximum target latency, nanoseconds.
+    core::nanoseconds_t max_latency;
+
+    //! Jitter measurement window, nanoseconds.
+    //! @remarks
+    //!  Peak jitter is measured over the last one or two windows. After the
+    //!  jitter decreases, the target latency starts going down after this
+    //!  period at most.
+    core::nanoseconds_t jitter_window;
+
+    //! Multiplier applied to the peak jitter to get the target latency.
+    float jitter_margin;
+
+    //! Maximum speed of decreasing target latency.
+    //! @remarks
+    //!  Number of nanoseconds of latency removed per nanosecond of stream.
+    //!  Should be lower than the resampler scaling delta, so that the resampler
+    //!  can follow the target.
+    float decrease_speed;
+
+    //! Initialize config with default values.
+    LatencyTunerConfig()
+        : enabled(false)
+        , min_latency(20 * core::Millisecond)
+        , max_latency(200 * core::Millisecond)
+        , jitter_window(5 * core::Second)
+        , jitter_margin(2.0f)
+        , decrease_speed(0.002f) {
+    }
+};
+
+//! Latency tuner.
+//! @remarks
+//!  Estimates network jitter from packet arrival times and RTP timestamps and
+//!  computes the target latency for the session:
+//!   - the transit time of every packet (arrival time minus RTP timestamp) is
+//!     compared against the fastest packet in the measurement window; the
+//!     largest difference is the peak jitter
+//!   - when the peak jitter grows, the target latency is raised immediately
+//!   - when the peak jitter shrinks, the target latency is lowered gradually
+//!   - the target latency is kept within the configured range
+class LatencyTuner : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p config defines tuner parameters
+    //!  - @p target_latency defines initial target latency
+    //!  - @p sample_rate defines sample rate of RTP timestamps
+    LatencyTuner(const LatencyTunerConfig& config,
+                 core::nanoseconds_t target_latency,
+                 size_t sample_rate);
+
+    //! Check if the object was initialized successfully.
+    bool valid() const;
+
+    //! Report packet arrival.
+    //! @remarks
+    //!  @p arrival_time is the time when the packet was received, and
+    //!  @p timestamp is its RTP timestamp.
+    void add_packet(core::nanoseconds_t arrival_time, packet::timestamp_t timestamp);
+
+    //! Get current target latency, number of samples.
+    packet::timestamp_t target_latency() const;
+
+    //! Get peak jitter over measurement window, nanoseconds.
+    core::nanoseconds_t peak_jitter() const;
+
+    //! Get mean jitter as defined by RFC 3550, nanoseconds.
+    core::nanoseconds_t mean_jitter() const;
+
+    //! Reset to initial state.
+    //! @remarks
+    //!  Forgets measured jitter and restores initial target latency.
+    void reset();
+
+private:
+    void update_window_(core::nanoseconds_t arrival_time, core::nanoseconds_t transit);
+    void update_target_(core::nanoseconds_t elapsed);
+
+    const size_t sample_rate_;
+
+    const core::nanoseconds_t min_latency_;
+    const core::nanoseconds_t max_latency_;
+    const core::nanoseconds_t window_;
+    const float margin_;
+    const float decrease_speed_;
+
+    const core::nanoseconds_t initial_target_;
+    core::nanoseconds_t target_;
+
+    bool started_;
+    packet::timestamp_t last_ts_;
+    core::nanoseconds_t last_arrival_;
+    core::nanoseconds_t last_transit_;
+    core::nanoseconds_t stream_pos_;
+
+    core::nanoseconds_t window_start_;
+    core::nanoseconds_t cur_min_;
+    core::nanoseconds_t cur_max_;
+    core::nanoseconds_t prev_min_;
+    core::nanoseconds_t prev_max_;
+    bool has_prev_;
+
+    double mean_jitter_;
+
+    bool valid_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_LATENCY_TUNER_H_
@@ -28,8 +28,9 @@ sample_t clamp(const sample_t x) {
 
 } // namespace
 
-Mixer::Mixer(core::BufferPool<sample_t>& pool, size_t frame_size)
-    : valid_(false) {
+Mixer::Mixer(core::BufferPool<sample_t>& pool, size_t frame_size, bool poisoning)
+    : poisoning_(poisoning)
+    , valid_(false) {
     temp_buf_ = new (pool) core::Buffer<sample_t>(pool);
     if (!temp_buf_) {
         roc_log(LogError, "mixer: can't allocate temporary buffer");
@@ -40,6 +41,18 @@ Mixer::Mixer(core::BufferPool<sample_t>& pool, size_t frame_size)
         return;
     }
     temp_buf_.resize(frame_size);
+
+    mix_buf_ = new (pool) core::Buffer<sample_t>(pool);
+    if (!mix_buf_) {
+        roc_log(LogError, "mixer: can't allocate temporary buffer");
+        return;
+    }
+    if (mix_buf_.capacity() < frame_size) {
+        roc_log(LogError, "mixer: allocated buffer is too small");
+        return;
+    }
+    mix_buf_.resize(frame_size);
+
     valid_ = true;
 }
 
@@ -63,6 +76,7 @@ void Mixer::read(Frame& frame) {
     roc_panic_if(!valid_);
 
     if (readers_.size() == 1) {
+        poison_(frame.data(), frame.size());
         readers_.front()->read(frame);
         return;
     }
@@ -85,9 +99,53 @@ void Mixer::read(Frame& frame) {
     }
 }
 
+void Mixer::read_as(void* data,
+                    size_t n_samples,
+                    SampleFormat format,
+                    size_t num_channels) {
+    roc_panic_if(!valid_);
+    roc_panic_if(num_channels == 0);
+
+    const size_t frame_len = n_samples / num_channels;
+    const size_t max_len = mix_buf_.size() / num_channels;
+
+    roc_panic_if(max_len == 0);
+
+    size_t pos = 0;
+
+    while (pos < frame_len) {
+        const size_t n_read = std::min(frame_len - pos, max_len);
+
+        mix_(mix_buf_.data(), n_read * num_channels);
+
+        sample_format_from_float(format, data, frame_len, pos, mix_buf_.data(), n_read,
+                                 num_channels);
+
+        pos += n_read;
+    }
+}
+
+// clamps the sum only once, like sample_format_from_float() does for read_as(),
+// so that both paths produce the same mix
 void Mixer::read_(sample_t* data, size_t size) {
+    mix_(data, size);
+
+    for (size_t n = 0; n < size; n++) {
+        data[n] = clamp(data[n]);
+    }
+}
+
+void Mixer::mix_(sample_t* data, size_t size) {
     roc_panic_if(!data);
     roc_panic_if(size == 0);
+    roc_panic_if(size > temp_buf_.size());
+
+    if (readers_.size() == 1) {
+        Frame frame(data, size);
+        poison_(data, size);
+        readers_.front()->read(frame);
+        return;
+    }
 
     memset(data, 0, size * sizeof(sample_t));
 
@@ -95,13 +153,24 @@ void Mixer::read_(sample_t* data, size_t size) {
         sample_t* temp_data = temp_buf_.data();
 
         Frame temp_frame(temp_data, size);
+        poison_(temp_data, size);
         rp->read(temp_frame);
 
         for (size_t n = 0; n < size; n++) {
-            data[n] = clamp(data[n] + temp_data[n]);
+            data[n] += temp_data[n];
         }
     }
 }
 
+void Mixer::poison_(sample_t* data, size_t size) const {
+    if (!poisoning_) {
+        return;
+    }
+
+    for (size_t n = 0; n < size; n++) {
+        data[n] = SampleMax;
+    }
+}
+
 } // namespace audio
 } // namespace roc
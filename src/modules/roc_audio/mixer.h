@@ -13,6 +13,7 @@
 #define ROC_AUDIO_MIXER_H_
 
 #include "roc_audio/ireader.h"
+#include "roc_audio/sample_format.h"
 #include "roc_audio/units.h"
 #include "roc_core/list.h"
 #include "roc_core/noncopyable.h"
@@ -40,10 +41,12 @@ public:
     //! Initialize.
     //!
     //! @b Parameters
-    //!  - @p pool is used to allocate a temporary buffer of samples
+    //!  - @p pool is used to allocate temporary buffers of samples
     //!  - @p frame_size defines the temporary buffer size used to read from
     //!    attached readers
-    explicit Mixer(core::BufferPool<sample_t>& pool, size_t frame_size);
+    //!  - @p poisoning enables filling buffers with SampleMax before passing
+    //!    them to attached readers, to catch readers that don't fill them
+    Mixer(core::BufferPool<sample_t>& pool, size_t frame_size, bool poisoning);
 
     //! Check if the mixer was succefully constructed.
     bool valid() const;
@@ -57,15 +60,29 @@ public:
     //! Read audio frame.
     //! @remarks
     //!  Reads samples from every input reader, mixes them, and fills @p frame
-    //!  with the result.
+    //!  with the result. The sum is clamped once, after all readers are mixed.
     virtual void read(Frame& frame);
 
+    //! Read audio samples in given format.
+    //! @remarks
+    //!  Same as read(), but clamps and converts the mixed samples directly into
+    //!  @p data, so that no intermediate frame is needed. @p n_samples is the
+    //!  number of samples for all channels.
+    void read_as(void* data,
+                 size_t n_samples,
+                 SampleFormat format,
+                 size_t num_channels);
+
 private:
     void read_(sample_t* out_data, size_t out_sz);
+    void mix_(sample_t* out_data, size_t out_sz);
+    void poison_(sample_t* data, size_t size) const;
 
     core::List<IReader, core::NoOwnership> readers_;
     core::Slice<sample_t> temp_buf_;
+    core::Slice<sample_t> mix_buf_;
 
+    const bool poisoning_;
     bool valid_;
 };
 
@@ -116,15 +116,20 @@ packet::PacketPtr Packetizer::start_packet_() {
 }
 
 bool Packetizer::finish_packet_() {
-    if (packet_pos_ == samples_per_packet_) {
-        return true;
+    if (packet_pos_ != samples_per_packet_) {
+        if (!composer_.truncate(*packet_, encoder_.payload_size(packet_pos_))) {
+            roc_log(LogError, "packetizer: can't truncate packet");
+            return false;
+        }
     }
 
-    if (!composer_.truncate(*packet_, encoder_.payload_size(packet_pos_))) {
-        roc_log(LogError, "packetizer: can't truncate packet");
+    if (!encoder_.finish_packet(*packet_, packet_pos_)) {
+        roc_log(LogDebug, "packetizer: can't encode packet");
         return false;
     }
 
+    packet_->rtp()->duration = (packet::timestamp_t)packet_pos_;
+
     return true;
 }
 
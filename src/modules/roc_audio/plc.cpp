@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/plc.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+// Pitch search is performed at a rate close to this one and then refined.
+const size_t PitchSearchRate = 8000;
+
+size_t ns_to_samples(core::nanoseconds_t ns, size_t sample_rate) {
+    if (ns <= 0) {
+        return 0;
+    }
+    return (size_t)packet::timestamp_from_ns(ns, sample_rate);
+}
+
+} // namespace
+
+PLC::PLC(const PLCConfig& config,
+         packet::channel_mask_t channels,
+         size_t sample_rate,
+         core::IAllocator& allocator)
+    : num_channels_(packet::num_channels(channels))
+    , min_pitch_(ns_to_samples(config.min_pitch_period, sample_rate))
+    , max_pitch_(ns_to_samples(config.max_pitch_period, sample_rate))
+    , hold_len_(ns_to_samples(config.hold_length, sample_rate))
+    , fade_len_(ns_to_samples(config.fade_length, sample_rate))
+    , overlap_len_(ns_to_samples(config.overlap_length, sample_rate))
+    , decim_(std::max(sample_rate / PitchSearchRate, (size_t)1))
+    , history_(allocator)
+    , mono_(allocator)
+    , history_len_(max_pitch_ * 2)
+    , history_fill_(0)
+    , concealing_(false)
+    , pitch_(0)
+    , period_pos_(0)
+    , conceal_pos_(0)
+    , valid_(false) {
+    if (num_channels_ == 0 || min_pitch_ == 0 || min_pitch_ > max_pitch_
+        || overlap_len_ > min_pitch_) {
+        roc_log(LogError,
+                "plc: invalid config: num_channels=%lu min_pitch=%lu max_pitch=%lu"
+                " overlap=%lu",
+                (unsigned long)num_channels_, (unsigned long)min_pitch_,
+                (unsigned long)max_pitch_, (unsigned long)overlap_len_);
+        return;
+    }
+
+    if (!history_.resize(history_len_ * num_channels_) || !mono_.resize(history_len_)) {
+        roc_log(LogError, "plc: can't allocate history");
+        return;
+    }
+
+    roc_log(LogDebug,
+            "plc: initializing: min_pitch=%lu max_pitch=%lu hold=%lu fade=%lu"
+            " overlap=%lu decim=%lu",
+            (unsigned long)min_pitch_, (unsigned long)max_pitch_,
+            (unsigned long)hold_len_, (unsigned long)fade_len_,
+            (unsigned long)overlap_len_, (unsigned long)decim_);
+
+    valid_ = true;
+}
+
+bool PLC::valid() const {
+    return valid_;
+}
+
+void PLC::update(sample_t* samples, size_t n_samples) {
+    roc_panic_if(!valid());
+
+    if (concealing_) {
+        const size_t n_overlap = std::min(overlap_len_, n_samples);
+
+        for (size_t n = 0; n < n_overlap; n++) {
+            const float w = float(n + 1) / (n_overlap + 1);
+            const float g = gain_();
+
+            for (size_t ch = 0; ch < num_channels_; ch++) {
+                sample_t& s = samples[n * num_channels_ + ch];
+                s = s * w + next_sample_(ch) * g * (1 - w);
+            }
+
+            if (++period_pos_ == pitch_) {
+                period_pos_ = 0;
+            }
+            conceal_pos_++;
+        }
+
+        concealing_ = false;
+    }
+
+    append_history_(samples, n_samples);
+}
+
+size_t PLC::conceal(sample_t* samples, size_t n_samples) {
+    roc_panic_if(!valid());
+
+    if (!concealing_) {
+        if (history_fill_ < history_len_) {
+            return 0;
+        }
+        start_concealment_();
+    }
+
+    const size_t max_samples = hold_len_ + fade_len_;
+
+    size_t n = 0;
+    for (; n < n_samples && conceal_pos_ < max_samples; n++) {
+        const float g = gain_();
+
+        for (size_t ch = 0; ch < num_channels_; ch++) {
+            samples[n * num_channels_ + ch] = next_sample_(ch) * g;
+        }
+
+        if (++period_pos_ == pitch_) {
+            period_pos_ = 0;
+        }
+        conceal_pos_++;
+    }
+
+    return n;
+}
+
+void PLC::reset() {
+    roc_panic_if(!valid());
+
+    history_fill_ = 0;
+    concealing_ = false;
+    pitch_ = 0;
+    period_pos_ = 0;
+    conceal_pos_ = 0;
+}
+
+void PLC::append_history_(const sample_t* samples, size_t n_samples) {
+    sample_t* history = &history_[0];
+
+    if (n_samples >= history_len_) {
+        memcpy(history, samples + (n_samples - history_len_) * num_channels_,
+               history_len_ * num_channels_ * sizeof(sample_t));
+    } else {
+        memmove(history, history + n_samples * num_channels_,
+                (history_len_ - n_samples) * num_channels_ * sizeof(sample_t));
+        memcpy(history + (history_len_ - n_samples) * num_channels_, samples,
+               n_samples * num_channels_ * sizeof(sample_t));
+    }
+
+    history_fill_ = std::min(history_fill_ + n_samples, history_len_);
+}
+
+void PLC::start_concealment_() {
+    mix_mono_();
+    pitch_ = find_pitch_();
+    period_pos_ = 0;
+    conceal_pos_ = 0;
+    concealing_ = true;
+}
+
+size_t PLC::find_pitch_() const {
+    size_t best_lag = max_pitch_;
+    float best_corr = 0;
+
+    for (size_t lag = min_pitch_; lag <= max_pitch_; lag += decim_) {
+        const float corr = correlation_(lag, decim_);
+        if (corr > best_corr) {
+            best_corr = corr;
+            best_lag = lag;
+        }
+    }
+
+    if (decim_ > 1) {
+        const size_t from =
+            std::max(best_lag - std::min(best_lag, decim_ - 1), min_pitch_);
+        const size_t to = std::min(best_lag + decim_ - 1, max_pitch_);
+
+        best_corr = 0;
+        for (size_t lag = from; lag <= to; lag++) {
+            const float corr = correlation_(lag, 1);
+            if (corr > best_corr) {
+                best_corr = corr;
+                best_lag = lag;
+            }
+        }
+    }
+
+    return best_lag;
+}
+
+void PLC::mix_mono_() {
+    const sample_t* history = &history_[0];
+    sample_t* mono = &mono_[0];
+
+    for (size_t pos = 0; pos < history_len_; pos++) {
+        sample_t s = 0;
+        for (size_t ch = 0; ch < num_channels_; ch++) {
+            s += history[pos * num_channels_ + ch];
+        }
+        mono[pos] = s;
+    }
+}
+
+float PLC::correlation_(size_t lag, size_t step) const {
+    const sample_t* mono = &mono_[0];
+
+    float xy = 0, yy = 0;
+
+    for (size_t pos = history_len_ - max_pitch_; pos < history_len_; pos += step) {
+        const sample_t x = mono[pos];
+        const sample_t y = mono[pos - lag];
+
+        xy += x * y;
+        yy += y * y;
+    }
+
+    if (yy <= 0) {
+        return 0;
+    }
+
+    return xy / std::sqrt(yy);
+}
+
+sample_t PLC::next_sample_(size_t ch) const {
+    return history_[(history_len_ - pitch_ + period_pos_) * num_channels_ + ch];
+}
+
+float PLC::gain_() const {
+    if (conceal_pos_ < hold_len_) {
+        return 1;
+    }
+    if (conceal_pos_ < hold_len_ + fade_len_) {
+        return 1 - float(conceal_pos_ - hold_len_) / fade_len_;
+    }
+    return 0;
+}
+
+} // namespace audio
+} // namespace roc
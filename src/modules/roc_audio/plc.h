@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/plc.h
+//! @brief Packet loss concealment.
+
+#ifndef ROC_AUDIO_PLC_H_
+#define ROC_AUDIO_PLC_H_
+
+#include "roc_audio/units.h"
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace audio {
+
+//! Packet loss concealment parameters.
+struct PLCConfig {
+    //! Enable packet loss concealment.
+    //! @remarks
+    //!  If disabled, gaps caused by lost packets are filled with silence.
+    bool enabled;
+
+    //! Minimum pitch period to search for, nanoseconds.
+    core::nanoseconds_t min_pitch_period;
+
+    //! Maximum pitch period to search for, nanoseconds.
+    //! @remarks
+    //!  Defines the length of the history kept by PLC.
+    core::nanoseconds_t max_pitch_period;
+
+    //! Duration of concealment with full volume, nanoseconds.
+    core::nanoseconds_t hold_length;
+
+    //! Duration of the fade-out after the hold period, nanoseconds.
+    //! @remarks
+    //!  After the fade-out, the rest of the gap is filled with silence.
+    core::nanoseconds_t fade_length;
+
+    //! Duration of the cross-fade when the stream resumes, nanoseconds.
+    //! @remarks
+    //!  Should not be larger than minimum pitch period.
+    core::nanoseconds_t overlap_length;
+
+    //! Initialize config with default values.
+    PLCConfig()
+        : enabled(false)
+        , min_pitch_period(2500 * core::Microsecond)
+        , max_pitch_period(15 * core::Millisecond)
+        , hold_length(10 * core::Millisecond)
+        , fade_length(50 * core::Millisecond)
+        , overlap_length(2 * core::Millisecond) {
+    }
+};
+
+//! Packet loss concealment.
+//! @remarks
+//!  Keeps a short history of the decoded stream. When a gap starts, finds the
+//!  pitch period of the last samples using normalized autocorrelation and fills
+//!  the gap by repeating the last pitch period, holding full volume for a while
+//!  and then fading out. When the stream resumes, cross-fades the concealed
+//!  signal into the decoded one.
+//!
+//!  The pitch search is performed once per gap and is bounded by the configured
+//!  pitch range; every other operation is linear in the number of samples, so
+//!  the time spent per frame is bounded.
+class PLC : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    PLC(const PLCConfig& config,
+        packet::channel_mask_t channels,
+        size_t sample_rate,
+        core::IAllocator& allocator);
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Pass decoded samples through PLC.
+    //! @remarks
+    //!  Adds samples to the history. If the previous samples were concealed,
+    //!  cross-fades the beginning of @p samples with the concealed signal.
+    //!  @p n_samples is the number of samples per channel.
+    void update(sample_t* samples, size_t n_samples);
+
+    //! Generate concealment samples.
+    //! @remarks
+    //!  @p n_samples is the number of samples per channel.
+    //! @returns
+    //!  number of samples per channel written to @p samples, which may be less
+    //!  than @p n_samples if the history is too short or the fade-out finished.
+    size_t conceal(sample_t* samples, size_t n_samples);
+
+    //! Reset to initial state.
+    //! @remarks
+    //!  Forgets the history.
+    void reset();
+
+private:
+    void append_history_(const sample_t* samples, size_t n_samples);
+
+    void start_concealment_();
+    void mix_mono_();
+    size_t find_pitch_() const;
+    float correlation_(size_t lag, size_t step) const;
+
+    sample_t next_sample_(size_t ch) const;
+    float gain_() const;
+
+    const size_t num_channels_;
+
+    const size_t min_pitch_;
+    const size_t max_pitch_;
+    const size_t hold_len_;
+    const size_t fade_len_;
+    const size_t overlap_len_;
+    const size_t decim_;
+
+    core::Array<sample_t> history_;
+    core::Array<sample_t> mono_;
+    size_t history_len_;
+    size_t history_fill_;
+
+    bool concealing_;
+    size_t pitch_;
+    size_t period_pos_;
+    size_t conceal_pos_;
+
+    bool valid_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_PLC_H_
@@ -72,8 +72,7 @@ inline size_t calc_bits(size_t n) {
 
 } // namespace
 
-Resampler::Resampler(core::IAllocator& allocator,
-                     const ResamplerConfig& config,
+Resampler::Resampler(const ResamplerConfig& config,
                      packet::channel_mask_t channels,
                      size_t frame_size)
     : channel_mask_(channels)
@@ -89,7 +88,6 @@ Resampler::Resampler(core::IAllocator& allocator,
     , qt_half_sinc_window_size_(float_to_fixedpoint(window_size_))
     , window_interp_(config.window_interp)
     , window_interp_bits_(calc_bits(config.window_interp))
-    , sinc_table_(allocator)
     , sinc_table_ptr_(NULL)
     , qt_half_window_size_(float_to_fixedpoint((float)window_size_ / scaling_))
     , qt_epsilon_(float_to_fixedpoint(5e-8f))
@@ -101,9 +99,13 @@ Resampler::Resampler(core::IAllocator& allocator,
     if (!check_config_()) {
         return;
     }
-    if (!fill_sinc_()) {
+
+    sinc_table_ = SincTableCache::instance().get(window_size_, window_interp_);
+    if (!sinc_table_) {
+        roc_log(LogError, "resampler: can't get sinc table");
         return;
     }
+    sinc_table_ptr_ = sinc_table_->data();
 
     roc_log(LogDebug,
             "resampler: initializing: "
@@ -249,30 +251,13 @@ void Resampler::renew_buffers(core::Slice<sample_t>& prev,
     next_frame_ = next.data();
 }
 
-bool Resampler::fill_sinc_() {
-    if (!sinc_table_.resize(window_size_ * window_interp_ + 2)) {
-        roc_log(LogError, "resampler: can't allocate sinc table");
-        return false;
-    }
-
-    const double sinc_step = 1.0 / (double)window_interp_;
-    double sinc_t = sinc_step;
-
-    sinc_table_[0] = 1.0f;
-    for (size_t i = 1; i < sinc_table_.size(); ++i) {
-        const double window = 0.54
-            - 0.46
-                * std::cos(2 * M_PI
-                           * ((double)(i - 1) / 2.0 / (double)sinc_table_.size() + 0.5));
-        sinc_table_[i] = (float)(std::sin(M_PI * sinc_t) / M_PI / sinc_t * window);
-        sinc_t += sinc_step;
-    }
-    sinc_table_[sinc_table_.size() - 2] = 0;
-    sinc_table_[sinc_table_.size() - 1] = 0;
-
-    sinc_table_ptr_ = &sinc_table_[0];
+void Resampler::reset() {
+    prev_frame_ = NULL;
+    curr_frame_ = NULL;
+    next_frame_ = NULL;
 
-    return true;
+    out_frame_pos_ = 0;
+    qt_sample_ = float_to_fixedpoint(0);
 }
 
 // Computes sinc value in x position using linear interpolation between
@@ -14,8 +14,8 @@
 
 #include "roc_audio/frame.h"
 #include "roc_audio/ireader.h"
+#include "roc_audio/sinc_table.h"
 #include "roc_audio/units.h"
-#include "roc_core/array.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/slice.h"
 #include "roc_core/stddefs.h"
@@ -48,8 +48,10 @@ struct ResamplerConfig {
 class Resampler : public core::NonCopyable<> {
 public:
     //! Initialize.
-    Resampler(core::IAllocator& allocator,
-              const ResamplerConfig& config,
+    //! @remarks
+    //!  Sinc table is taken from SincTableCache and is shared with other
+    //!  resamplers having the same window parameters.
+    Resampler(const ResamplerConfig& config,
               packet::channel_mask_t channels,
               size_t frame_size);
 
@@ -73,6 +75,12 @@ public:
                        core::Slice<sample_t>& cur,
                        core::Slice<sample_t>& next);
 
+    //! Reset stream position.
+    //! @remarks
+    //!  Forgets current buffers; renew_buffers() should be called before next
+    //!  resample_buff(). Keeps sinc table and scaling.
+    void reset();
+
 private:
     typedef uint32_t fixedpoint_t;
     typedef uint64_t long_fixedpoint_t;
@@ -94,7 +102,6 @@ private:
 
     bool check_config_() const;
 
-    bool fill_sinc_();
     sample_t sinc_(fixedpoint_t x, float fract_x);
 
     sample_t* prev_frame_;
@@ -114,7 +121,7 @@ private:
     const size_t window_interp_;
     const size_t window_interp_bits_;
 
-    core::Array<sample_t> sinc_table_;
+    core::SharedPtr<SincTable> sinc_table_;
     const sample_t* sinc_table_ptr_;
 
     // half window len in Q8.24 in terms of input signal
@@ -17,11 +17,10 @@ namespace audio {
 
 ResamplerReader::ResamplerReader(IReader& reader,
                                  core::BufferPool<sample_t>& buffer_pool,
-                                 core::IAllocator& allocator,
                                  const ResamplerConfig& config,
                                  packet::channel_mask_t channels,
                                  size_t frame_size)
-    : resampler_(allocator, config, channels, frame_size)
+    : resampler_(config, channels, frame_size)
     , reader_(reader)
     , frame_size_(frame_size)
     , frames_empty_(true)
@@ -45,6 +44,13 @@ bool ResamplerReader::set_scaling(float scaling) {
     return resampler_.set_scaling(scaling);
 }
 
+void ResamplerReader::reset() {
+    roc_panic_if_not(valid());
+
+    resampler_.reset();
+    frames_empty_ = true;
+}
+
 void ResamplerReader::read(Frame& frame) {
     roc_panic_if_not(valid());
 
@@ -39,7 +39,6 @@ public:
     //!  - @p channels is the bitmask of audio channels
     ResamplerReader(IReader& reader,
                     core::BufferPool<sample_t>& buffer_pool,
-                    core::IAllocator& allocator,
                     const ResamplerConfig& config,
                     packet::channel_mask_t channels,
                     size_t frame_size);
@@ -61,6 +60,11 @@ public:
     //!  function returns false.
     bool set_scaling(float);
 
+    //! Reset to initial state.
+    //! @remarks
+    //!  Next read() refills the resampler window from the input reader.
+    void reset();
+
 private:
     bool init_frames_(core::BufferPool<sample_t>&);
     void renew_frames_();
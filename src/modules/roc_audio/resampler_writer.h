@@ -39,7 +39,6 @@ public:
     //!  - @p channels is the bitmask of audio channels
     ResamplerWriter(IWriter& writer,
                     core::BufferPool<sample_t>& buffer_pool,
-                    core::IAllocator& allocator,
                     const ResamplerConfig& config,
                     packet::channel_mask_t channels,
                     size_t frame_size);
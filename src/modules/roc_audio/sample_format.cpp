@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/sample_format.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+sample_t clamp(const sample_t x) {
+    if (x > SampleMax) {
+        return SampleMax;
+    } else if (x < SampleMin) {
+        return SampleMin;
+    } else {
+        return x;
+    }
+}
+
+// Scales, rounds to nearest and clips sample.
+void pack_s16le(uint8_t* out, sample_t x) {
+    float s = std::floor(x * 32768.0f + 0.5f);
+    s = std::min(s, +32767.0f);
+    s = std::max(s, -32768.0f);
+
+    const uint16_t v = (uint16_t)(int16_t)s;
+
+    out[0] = uint8_t(v & 0xff);
+    out[1] = uint8_t((v >> 8) & 0xff);
+}
+
+sample_t unpack_s16le(const uint8_t* in) {
+    const uint16_t v = uint16_t(in[0] | (in[1] << 8));
+    return sample_t((int16_t)v) / 32768.0f;
+}
+
+// Scales, rounds to nearest and clips sample.
+void pack_s32le(uint8_t* out, sample_t x) {
+    double s = std::floor(double(x) * 2147483648.0 + 0.5);
+    s = std::min(s, +2147483647.0);
+    s = std::max(s, -2147483648.0);
+
+    const uint32_t v = (uint32_t)(int32_t)s;
+
+    out[0] = uint8_t(v & 0xff);
+    out[1] = uint8_t((v >> 8) & 0xff);
+    out[2] = uint8_t((v >> 16) & 0xff);
+    out[3] = uint8_t((v >> 24) & 0xff);
+}
+
+sample_t unpack_s32le(const uint8_t* in) {
+    const uint32_t v = uint32_t(in[0]) | (uint32_t(in[1]) << 8) | (uint32_t(in[2]) << 16)
+        | (uint32_t(in[3]) << 24);
+    return sample_t(double((int32_t)v) / 2147483648.0);
+}
+
+} // namespace
+
+size_t sample_format_size(SampleFormat format) {
+    switch (format) {
+    case SampleFormat_Float:
+    case SampleFormat_FloatPlanar:
+        return sizeof(float);
+    case SampleFormat_S16LE:
+        return sizeof(int16_t);
+    case SampleFormat_S32LE:
+        return sizeof(int32_t);
+    }
+
+    roc_panic("sample format: unknown format %d", (int)format);
+}
+
+void sample_format_from_float(SampleFormat format,
+                              void* frame,
+                              size_t frame_len,
+                              size_t offset,
+                              const sample_t* samples,
+                              size_t n_samples,
+                              size_t num_channels) {
+    roc_panic_if(offset + n_samples > frame_len);
+
+    const size_t n_total = n_samples * num_channels;
+
+    switch (format) {
+    case SampleFormat_Float: {
+        float* out = (float*)frame + offset * num_channels;
+        for (size_t n = 0; n < n_total; n++) {
+            out[n] = clamp(samples[n]);
+        }
+    } break;
+
+    case SampleFormat_FloatPlanar: {
+        for (size_t ch = 0; ch < num_channels; ch++) {
+            float* out = (float*)frame + ch * frame_len + offset;
+            for (size_t n = 0; n < n_samples; n++) {
+                out[n] = clamp(samples[n * num_channels + ch]);
+            }
+        }
+    } break;
+
+    case SampleFormat_S16LE: {
+        uint8_t* out = (uint8_t*)frame + offset * num_channels * sizeof(int16_t);
+        for (size_t n = 0; n < n_total; n++) {
+            pack_s16le(out + n * sizeof(int16_t), samples[n]);
+        }
+    } break;
+
+    case SampleFormat_S32LE: {
+        uint8_t* out = (uint8_t*)frame + offset * num_channels * sizeof(int32_t);
+        for (size_t n = 0; n < n_total; n++) {
+            pack_s32le(out + n * sizeof(int32_t), samples[n]);
+        }
+    } break;
+    }
+}
+
+void sample_format_to_float(SampleFormat format,
+                            const void* frame,
+                            size_t frame_len,
+                            size_t offset,
+                            sample_t* samples,
+                            size_t n_samples,
+                            size_t num_channels) {
+    roc_panic_if(offset + n_samples > frame_len);
+
+    const size_t n_total = n_samples * num_channels;
+
+    switch (format) {
+    case SampleFormat_Float: {
+        const float* in = (const float*)frame + offset * num_channels;
+        memcpy(samples, in, n_total * sizeof(float));
+    } break;
+
+    case SampleFormat_FloatPlanar: {
+        for (size_t ch = 0; ch < num_channels; ch++) {
+            const float* in = (const float*)frame + ch * frame_len + offset;
+            for (size_t n = 0; n < n_samples; n++) {
+                samples[n * num_channels + ch] = in[n];
+            }
+        }
+    } break;
+
+    case SampleFormat_S16LE: {
+        const uint8_t* in =
+            (const uint8_t*)frame + offset * num_channels * sizeof(int16_t);
+        for (size_t n = 0; n < n_total; n++) {
+            samples[n] = unpack_s16le(in + n * sizeof(int16_t));
+        }
+    } break;
+
+    case SampleFormat_S32LE: {
+        const uint8_t* in =
+            (const uint8_t*)frame + offset * num_channels * sizeof(int32_t);
+        for (size_t n = 0; n < n_total; n++) {
+            samples[n] = unpack_s32le(in + n * sizeof(int32_t));
+        }
+    } break;
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/sample_format.h
+//! @brief Sample format.
+
+#ifndef ROC_AUDIO_SAMPLE_FORMAT_H_
+#define ROC_AUDIO_SAMPLE_FORMAT_H_
+
+#include "roc_audio/units.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! Format of samples in user-provided memory.
+enum SampleFormat {
+    //! Interleaved 32-bit floats in native byte order.
+    SampleFormat_Float,
+
+    //! Planar 32-bit floats in native byte order.
+    //! @remarks
+    //!  All samples of the first channel are followed by all samples of the
+    //!  second channel, and so on.
+    SampleFormat_FloatPlanar,
+
+    //! Interleaved 16-bit signed little-endian integers.
+    SampleFormat_S16LE,
+
+    //! Interleaved 32-bit signed little-endian integers.
+    SampleFormat_S32LE
+};
+
+//! Get size of one sample in bytes.
+size_t sample_format_size(SampleFormat format);
+
+//! Convert samples to given format.
+//! @remarks
+//!  Clamps interleaved @p samples and stores them into @p frame starting from
+//!  position @p offset. @p frame_len is the total frame length; it's needed to
+//!  locate channels in planar formats. @p frame_len, @p offset, and
+//!  @p n_samples are numbers of samples per channel.
+void sample_format_from_float(SampleFormat format,
+                              void* frame,
+                              size_t frame_len,
+                              size_t offset,
+                              const sample_t* samples,
+                              size_t n_samples,
+                              size_t num_channels);
+
+//! Convert samples from given format.
+//! @remarks
+//!  Loads samples from @p frame starting from position @p offset and stores
+//!  them into interleaved @p samples. @p frame_len, @p offset, and @p n_samples
+//!  are numbers of samples per channel.
+void sample_format_to_float(SampleFormat format,
+                            const void* frame,
+                            size_t frame_len,
+                            size_t offset,
+                            sample_t* samples,
+                            size_t n_samples,
+                            size_t num_channels);
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_SAMPLE_FORMAT_H_
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/sinc_table.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/unique_ptr.h"
+
+namespace roc {
+namespace audio {
+
+SincTable::SincTable(core::IAllocator& allocator,
+                     size_t window_size,
+                     size_t window_interp)
+    : window_size_(window_size)
+    , window_interp_(window_interp)
+    , table_(allocator)
+    , valid_(false) {
+    if (!fill_()) {
+        return;
+    }
+    valid_ = true;
+}
+
+bool SincTable::valid() const {
+    return valid_;
+}
+
+size_t SincTable::window_size() const {
+    return window_size_;
+}
+
+size_t SincTable::window_interp() const {
+    return window_interp_;
+}
+
+size_t SincTable::size() const {
+    return table_.size();
+}
+
+const sample_t* SincTable::data() const {
+    roc_panic_if(!valid());
+    return &table_[0];
+}
+
+void SincTable::destroy() {
+    // Another thread may take this table from the cache before we lock it, so
+    // the cache decides whether it's still unused.
+    SincTableCache::instance().release_(this);
+}
+
+bool SincTable::fill_() {
+    if (!table_.resize(window_size_ * window_interp_ + 2)) {
+        roc_log(LogError, "sinc table: can't allocate table");
+        return false;
+    }
+
+    const double sinc_step = 1.0 / (double)window_interp_;
+    double sinc_t = sinc_step;
+
+    table_[0] = 1.0f;
+    for (size_t i = 1; i < table_.size(); ++i) {
+        const double window = 0.54
+            - 0.46
+                * std::cos(2 * M_PI
+                           * ((double)(i - 1) / 2.0 / (double)table_.size() + 0.5));
+        table_[i] = (float)(std::sin(M_PI * sinc_t) / M_PI / sinc_t * window);
+        sinc_t += sinc_step;
+    }
+    table_[table_.size() - 2] = 0;
+    table_[table_.size() - 1] = 0;
+
+    return true;
+}
+
+SincTableCache::SincTableCache() {
+}
+
+core::SharedPtr<SincTable> SincTableCache::get(size_t window_size,
+                                               size_t window_interp) {
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        if (SincTable* table = find_(window_size, window_interp)) {
+            return table;
+        }
+    }
+
+    // The table is built without holding the lock, so that sessions which
+    // use cached tables are not blocked while a new one is computed.
+    core::UniquePtr<SincTable> new_table(
+        new (allocator_) SincTable(allocator_, window_size, window_interp), allocator_);
+    if (!new_table || !new_table->valid()) {
+        return NULL;
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
+    // Another thread could build the same table meanwhile; if so, ours is
+    // freed after the lock is released.
+    if (SincTable* table = find_(window_size, window_interp)) {
+        return table;
+    }
+
+    roc_log(LogDebug,
+            "sinc table cache: created table: window_size=%lu window_interp=%lu",
+            (unsigned long)window_size, (unsigned long)window_interp);
+
+    tables_.push_back(*new_table);
+
+    return new_table.release();
+}
+
+size_t SincTableCache::num_tables() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return tables_.size();
+}
+
+size_t SincTableCache::num_bytes() const {
+    core::Mutex::Lock lock(mutex_);
+
+    size_t n_bytes = 0;
+    for (SincTable* table = tables_.front(); table != NULL;
+         table = tables_.nextof(*table)) {
+        n_bytes += table->size() * sizeof(sample_t);
+    }
+
+    return n_bytes;
+}
+
+SincTable* SincTableCache::find_(size_t window_size, size_t window_interp) const {
+    for (SincTable* table = tables_.front(); table != NULL;
+         table = tables_.nextof(*table)) {
+        if (table->window_size() == window_size
+            && table->window_interp() == window_interp) {
+            return table;
+        }
+    }
+    return NULL;
+}
+
+void SincTableCache::release_(SincTable* released) {
+    core::Mutex::Lock lock(mutex_);
+
+    for (SincTable* table = tables_.front(); table != NULL;
+         table = tables_.nextof(*table)) {
+        if (table != released) {
+            continue;
+        }
+        if (table->getref() != 0) {
+            return;
+        }
+
+        roc_log(LogDebug,
+                "sinc table cache: freeing table: window_size=%lu window_interp=%lu",
+                (unsigned long)table->window_size(),
+                (unsigned long)table->window_interp());
+
+        tables_.remove(*table);
+        allocator_.destroy(*table);
+        return;
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/sinc_table.h
+//! @brief Shared sinc table.
+
+#ifndef ROC_AUDIO_SINC_TABLE_H_
+#define ROC_AUDIO_SINC_TABLE_H_
+
+#include "roc_audio/units.h"
+#include "roc_core/array.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/list.h"
+#include "roc_core/list_node.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/refcnt.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_core/singleton.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+class SincTableCache;
+
+//! Sinc table.
+//! @remarks
+//!  Read-only table of windowed sinc values used by resampler. Tables are
+//!  obtained from SincTableCache and shared between all resamplers with the
+//!  same window parameters.
+class SincTable : public core::RefCnt<SincTable>, public core::ListNode {
+public:
+    //! Get window size.
+    size_t window_size() const;
+
+    //! Get window interpolation.
+    size_t window_interp() const;
+
+    //! Get number of values in table.
+    size_t size() const;
+
+    //! Get table values.
+    const sample_t* data() const;
+
+private:
+    friend class core::RefCnt<SincTable>;
+    friend class SincTableCache;
+
+    SincTable(core::IAllocator& allocator, size_t window_size, size_t window_interp);
+
+    bool valid() const;
+    void destroy();
+
+    bool fill_();
+
+    const size_t window_size_;
+    const size_t window_interp_;
+
+    // Allocated with the default alignment of the heap allocator. Resampler
+    // reads pairs of values at arbitrary offsets using scalar loads, so a
+    // stronger alignment wouldn't make these reads faster.
+    core::Array<sample_t> table_;
+
+    bool valid_;
+};
+
+//! Sinc table cache.
+//! @remarks
+//!  Process-wide cache of sinc tables keyed by window parameters. A table is
+//!  built when it is requested for the first time and freed when the last
+//!  reference to it is released. Thread-safe.
+class SincTableCache : public core::NonCopyable<> {
+public:
+    //! Get instance.
+    static SincTableCache& instance() {
+        return core::Singleton<SincTableCache>::instance();
+    }
+
+    //! Get table for given window parameters.
+    //! @returns
+    //!  shared table or NULL if it can't be allocated.
+    core::SharedPtr<SincTable> get(size_t window_size, size_t window_interp);
+
+    //! Get number of tables in cache.
+    size_t num_tables() const;
+
+    //! Get total size of tables in cache, in bytes.
+    size_t num_bytes() const;
+
+private:
+    friend class core::Singleton<SincTableCache>;
+    friend class SincTable;
+
+    SincTableCache();
+
+    SincTable* find_(size_t window_size, size_t window_interp) const;
+    void release_(SincTable* table);
+
+    core::HeapAllocator allocator_;
+    core::List<SincTable, core::NoOwnership> tables_;
+
+    mutable core::Mutex mutex_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_SINC_TABLE_H_
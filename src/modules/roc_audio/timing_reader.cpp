@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/timing_reader.h"
+
+namespace roc {
+namespace audio {
+
+TimingReader::TimingReader(IReader& reader,
+                           core::TimeHistogram& histogram,
+                           core::StageTimer& timer)
+    : reader_(reader)
+    , histogram_(histogram)
+    , timer_(timer) {
+}
+
+void TimingReader::read(Frame& frame) {
+    const core::nanoseconds_t outer = timer_.begin();
+    const core::nanoseconds_t start = core::timestamp();
+
+    reader_.read(frame);
+
+    histogram_.add(timer_.end(outer, core::timestamp() - start));
+}
+
+} // namespace audio
+} // namespace roc
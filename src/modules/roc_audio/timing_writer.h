@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/timing_writer.h
+//! @brief Timing writer.
+
+#ifndef ROC_AUDIO_TIMING_WRITER_H_
+#define ROC_AUDIO_TIMING_WRITER_H_
+
+#include "roc_audio/frame.h"
+#include "roc_audio/iwriter.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stage_timer.h"
+#include "roc_core/time_histogram.h"
+
+namespace roc {
+namespace audio {
+
+//! Measures time spent writing audio frames.
+//! @remarks
+//!  Passes every call to the underlying writer and adds its duration, excluding
+//!  nested stages measured by the same timer, to the histogram.
+class TimingWriter : public IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    TimingWriter(IWriter& writer,
+                 core::TimeHistogram& histogram,
+                 core::StageTimer& timer);
+
+    //! Write audio frame.
+    virtual void write(Frame& frame);
+
+private:
+    IWriter& writer_;
+    core::TimeHistogram& histogram_;
+    core::StageTimer& timer_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_TIMING_WRITER_H_
@@ -8,6 +8,7 @@
 
 #include "roc_audio/watchdog.h"
 #include "roc_core/log.h"
+#include "roc_core/panic.h"
 
 namespace roc {
 namespace audio {
@@ -32,6 +33,7 @@ Watchdog::Watchdog(IReader& reader,
     , status_(allocator)
     , status_pos_(0)
     , status_show_(false)
+    , broken_(false)
     , alive_(true)
     , valid_(false) {
     if (config.no_playback_timeout < 0 || config.broken_playback_timeout < 0
@@ -94,9 +96,8 @@ void Watchdog::read(Frame& frame) {
 
     curr_read_pos_ = next_read_pos;
 
-    if (!check_drops_timeout_()) {
-        flush_status_();
-        alive_ = false;
+    if (!broken_ && !check_drops_timeout_()) {
+        broken_ = true;
     }
 }
 
@@ -105,6 +106,12 @@ bool Watchdog::update() {
         return false;
     }
 
+    if (broken_) {
+        flush_status_();
+        alive_ = false;
+        return false;
+    }
+
     if (!check_blank_timeout_()) {
         flush_status_();
         alive_ = false;
@@ -114,12 +121,40 @@ bool Watchdog::update() {
     return true;
 }
 
+bool Watchdog::broken() const {
+    return broken_;
+}
+
+packet::timestamp_t Watchdog::blank_duration() const {
+    return curr_read_pos_ - last_pos_before_blank_;
+}
+
+void Watchdog::reset_breakage() {
+    roc_log(LogDebug, "watchdog: resetting breakage: curr_read_pos=%lu",
+            (unsigned long)curr_read_pos_);
+
+    last_pos_before_drops_ = curr_read_pos_;
+    curr_window_flags_ = 0;
+    broken_ = false;
+}
+
+void Watchdog::reset() {
+    roc_panic_if(!valid());
+
+    curr_read_pos_ = 0;
+    last_pos_before_blank_ = 0;
+    last_pos_before_drops_ = 0;
+    curr_window_flags_ = 0;
+
+    status_pos_ = 0;
+    status_show_ = false;
+
+    broken_ = false;
+    alive_ = true;
+}
+
 void Watchdog::update_blank_timeout_(const Frame& frame,
                                      packet::timestamp_t next_read_pos) {
-    if (max_blank_duration_ == 0) {
-        return;
-    }
-
     if (frame.flags() & audio::Frame::FlagBlank) {
         return;
     }
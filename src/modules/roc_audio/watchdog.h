@@ -86,6 +86,21 @@ public:
     //!  filled and contain dropped packets was exceeded.
     bool update();
 
+    //! Check if the broken playback timeout was reached.
+    //! @remarks
+    //!  If the caller is able to recover the stream, it should call reset_breakage()
+    //!  before the next update(); otherwise, update() terminates the session.
+    bool broken() const;
+
+    //! Get duration of the current run of blank frames, number of samples.
+    packet::timestamp_t blank_duration() const;
+
+    //! Restart breakage detection from the current position.
+    void reset_breakage();
+
+    //! Reset to initial state.
+    void reset();
+
 private:
     void update_blank_timeout_(const Frame& frame, packet::timestamp_t next_read_pos);
     bool check_blank_timeout_() const;
@@ -114,6 +129,7 @@ private:
     size_t status_pos_;
     bool status_show_;
 
+    bool broken_;
     bool alive_;
     bool valid_;
 };
@@ -98,6 +98,33 @@ public:
         deallocate(&object);
     }
 
+    //! Preallocate memory for objects.
+    //! @remarks
+    //!  Allocates chunks until at least @p n_objects objects can be allocated
+    //!  without allocating memory.
+    //! @returns
+    //!  false if memory can't be allocated.
+    bool reserve(size_t n_objects) {
+        Mutex::Lock lock(mutex_);
+
+        while (free_elems_.size() < n_objects) {
+            const size_t n_free = free_elems_.size();
+            allocate_chunk_();
+            if (free_elems_.size() == n_free) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //! Get number of objects currently allocated from the pool.
+    size_t num_used() const {
+        Mutex::Lock lock(mutex_);
+
+        return used_elems_;
+    }
+
 private:
     enum { PoisonAllocated = 0x7a, PoisonDeallocated = 0x7d };
 
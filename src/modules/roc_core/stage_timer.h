@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/stage_timer.h
+//! @brief Stage timer.
+
+#ifndef ROC_CORE_STAGE_TIMER_H_
+#define ROC_CORE_STAGE_TIMER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+//! Stage timer.
+//! @remarks
+//!  Computes time spent in nested pipeline stages. When a measured stage calls
+//!  another measured stage, time spent in the inner stage is subtracted from the
+//!  outer one, so that every stage gets only its own time.
+//!
+//!  Should be used from a single thread. Usage:
+//!  @code
+//!   const nanoseconds_t outer = timer.begin();
+//!   const nanoseconds_t start = timestamp();
+//!   // call the stage, which may call other measured stages
+//!   const nanoseconds_t own = timer.end(outer, timestamp() - start);
+//!  @endcode
+class StageTimer : public NonCopyable<> {
+public:
+    //! Initialize.
+    StageTimer()
+        : nested_(0) {
+    }
+
+    //! Begin measuring stage.
+    //! @returns
+    //!  value that should be passed to end()
+    nanoseconds_t begin() {
+        const nanoseconds_t outer = nested_;
+        nested_ = 0;
+        return outer;
+    }
+
+    //! End measuring stage.
+    //! @remarks
+    //!  @p outer is the value returned by begin(), and @p elapsed is the total
+    //!  time spent in the stage.
+    //! @returns
+    //!  time spent in the stage excluding nested stages.
+    nanoseconds_t end(nanoseconds_t outer, nanoseconds_t elapsed) {
+        const nanoseconds_t own = elapsed - nested_;
+        nested_ = outer + elapsed;
+        return own;
+    }
+
+private:
+    nanoseconds_t nested_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_STAGE_TIMER_H_
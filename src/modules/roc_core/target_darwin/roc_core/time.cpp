@@ -96,5 +96,14 @@ void sleep_for(nanoseconds_t ns) {
     sleep_until(timestamp() + ns);
 }
 
+void sleep_until_precise(nanoseconds_t ns, nanoseconds_t spin_ns) {
+    if (timestamp() < ns - spin_ns) {
+        sleep_until(ns - spin_ns);
+    }
+    while (timestamp() < ns) {
+        // busy wait
+    }
+}
+
 } // namespace core
 } // namespace roc
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_gnu/roc_core/seqlock.h
+//! @brief Seqlock.
+
+#ifndef ROC_CORE_SEQLOCK_H_
+#define ROC_CORE_SEQLOCK_H_
+
+#include "roc_core/noncopyable.h"
+
+namespace roc {
+namespace core {
+
+//! Seqlock.
+//! @remarks
+//!  Allows one writer to publish a value and any number of readers to read it
+//!  without locks. The writer never waits for readers. A reader retries if the
+//!  value was modified while being read.
+//!
+//!  The writer increments the version before and after modifying the value, so
+//!  the version is odd while the value is being modified. A reader copies the
+//!  value and checks that the version was even and didn't change meanwhile.
+//!
+//!  T should be a copyable type without pointers to mutable data.
+template <class T> class Seqlock : public NonCopyable<> {
+public:
+    //! Initialize with default value.
+    Seqlock()
+        : version_(0)
+        , value_() {
+    }
+
+    //! Store value.
+    //! @remarks
+    //!  Should not be called concurrently with another store().
+    void store(const T& value) {
+        __sync_add_and_fetch(&version_, 1);
+        value_ = value;
+        __sync_add_and_fetch(&version_, 1);
+    }
+
+    //! Try to load value.
+    //! @returns
+    //!  false if the value was being modified concurrently; in this case,
+    //!  @p value may be inconsistent and the load should be repeated.
+    bool try_load(T& value) const {
+        const unsigned long version0 = load_version_();
+        if (version0 & 1) {
+            return false;
+        }
+
+        value = value_;
+
+        const unsigned long version1 = load_version_();
+        return version0 == version1;
+    }
+
+    //! Load value.
+    //! @remarks
+    //!  Repeats try_load() until it succeeds.
+    void load(T& value) const {
+        while (!try_load(value)) {
+        }
+    }
+
+private:
+    unsigned long load_version_() const {
+        __sync_synchronize();
+        const unsigned long version = *(const volatile unsigned long*)&version_;
+        __sync_synchronize();
+        return version;
+    }
+
+    unsigned long version_;
+    T value_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_SEQLOCK_H_
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/time_histogram.h"
+
+namespace roc {
+namespace core {
+
+TimeHistogram::TimeHistogram()
+    : count_(0)
+    , max_(0) {
+    for (size_t n = 0; n < NumBuckets; n++) {
+        buckets_[n] = 0;
+    }
+}
+
+void TimeHistogram::add(nanoseconds_t duration) {
+    if (duration < 0) {
+        duration = 0;
+    }
+
+    __sync_add_and_fetch(&buckets_[bucket_index_(duration)], 1);
+    __sync_add_and_fetch(&count_, 1);
+
+    const unsigned long value = (unsigned long)duration;
+
+    for (;;) {
+        const unsigned long prev_max = load_(max_);
+        if (value <= prev_max) {
+            break;
+        }
+        if (__sync_bool_compare_and_swap(&max_, prev_max, value)) {
+            break;
+        }
+    }
+}
+
+size_t TimeHistogram::count() const {
+    return load_(count_);
+}
+
+nanoseconds_t TimeHistogram::max() const {
+    return (nanoseconds_t)load_(max_);
+}
+
+nanoseconds_t TimeHistogram::quantile(double q) const {
+    unsigned long counts[NumBuckets];
+    unsigned long total = 0;
+
+    for (size_t n = 0; n < NumBuckets; n++) {
+        counts[n] = load_(buckets_[n]);
+        total += counts[n];
+    }
+
+    if (total == 0) {
+        return 0;
+    }
+
+    if (q < 0) {
+        q = 0;
+    }
+    if (q > 1) {
+        q = 1;
+    }
+
+    unsigned long target = (unsigned long)(q * total + 0.5);
+    if (target == 0) {
+        target = 1;
+    }
+
+    const nanoseconds_t max_duration = max();
+
+    unsigned long sum = 0;
+    for (size_t n = 0; n < NumBuckets; n++) {
+        sum += counts[n];
+        if (sum >= target) {
+            const nanoseconds_t upper = bucket_upper_(n);
+            return upper < max_duration ? upper : max_duration;
+        }
+    }
+
+    return max_duration;
+}
+
+size_t TimeHistogram::bucket_index_(nanoseconds_t duration) {
+    const unsigned long long value = (unsigned long long)duration;
+
+    if (value < SubBuckets) {
+        return (size_t)value;
+    }
+
+    const size_t octave = size_t(63 - __builtin_clzll(value));
+    if (octave > MaxOctave) {
+        return NumBuckets - 1;
+    }
+
+    const size_t sub = size_t(value >> (octave - SubBucketBits)) & (SubBuckets - 1);
+
+    return (octave - SubBucketBits + 1) * SubBuckets + sub;
+}
+
+nanoseconds_t TimeHistogram::bucket_upper_(size_t index) {
+    if (index < SubBuckets) {
+        return (nanoseconds_t)index;
+    }
+
+    const size_t octave = index / SubBuckets + SubBucketBits - 1;
+    const size_t sub = index % SubBuckets;
+
+    return (nanoseconds_t)((((unsigned long long)SubBuckets + sub + 1)
+                            << (octave - SubBucketBits))
+                           - 1);
+}
+
+unsigned long TimeHistogram::load_(const unsigned long& value) {
+    return __sync_add_and_fetch(const_cast<unsigned long*>(&value), 0);
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_gnu/roc_core/time_histogram.h
+//! @brief Time histogram.
+
+#ifndef ROC_CORE_TIME_HISTOGRAM_H_
+#define ROC_CORE_TIME_HISTOGRAM_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+//! Time histogram.
+//! @remarks
+//!  Counts durations in logarithmic buckets: every power of two is split into
+//!  four buckets, so quantiles are estimated with an error below 25%.
+//!
+//!  Every counter is updated atomically, so durations may be added from one
+//!  thread while quantiles are computed from another one without locks. The
+//!  counters are not read as a consistent snapshot, which may only cause a
+//!  negligible error in the estimated quantiles.
+class TimeHistogram : public NonCopyable<> {
+public:
+    //! Initialize empty histogram.
+    TimeHistogram();
+
+    //! Add duration.
+    void add(nanoseconds_t duration);
+
+    //! Get number of added durations.
+    size_t count() const;
+
+    //! Get maximum added duration.
+    nanoseconds_t max() const;
+
+    //! Estimate quantile.
+    //! @remarks
+    //!  @p q should be in range [0; 1]. Returns upper bound of the bucket
+    //!  containing the quantile, but no more than max(). Returns zero if the
+    //!  histogram is empty.
+    nanoseconds_t quantile(double q) const;
+
+private:
+    enum {
+        SubBucketBits = 2,
+        SubBuckets = 1 << SubBucketBits,
+        MaxOctave = 40,
+        NumBuckets = (MaxOctave - SubBucketBits + 2) * SubBuckets
+    };
+
+    static size_t bucket_index_(nanoseconds_t duration);
+    static nanoseconds_t bucket_upper_(size_t index);
+
+    static unsigned long load_(const unsigned long& value);
+
+    unsigned long buckets_[NumBuckets];
+    unsigned long count_;
+    unsigned long max_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_TIME_HISTOGRAM_H_
@@ -84,5 +84,14 @@ void sleep_until(nanoseconds_t ns) {
 }
 #endif // defined(CLOCK_MONOTONIC) && defined(TIMER_ABSTIME)
 
+void sleep_until_precise(nanoseconds_t ns, nanoseconds_t spin_ns) {
+    if (timestamp() < ns - spin_ns) {
+        sleep_until(ns - spin_ns);
+    }
+    while (timestamp() < ns) {
+        // busy wait
+    }
+}
+
 } // namespace core
 } // namespace roc
@@ -42,6 +42,11 @@ public:
         uv_cond_wait(&cond_, &mutex_);
     }
 
+    //! Wake up one pending wait.
+    void signal() const {
+        uv_cond_signal(&cond_);
+    }
+
     //! Wake up all pending waits.
     void broadcast() const {
         uv_cond_broadcast(&cond_);
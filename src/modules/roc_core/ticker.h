@@ -54,13 +54,19 @@ public:
         }
     }
 
-    //! Wait until the given number of ticks elapses since start.
+    //! Get time when the given number of ticks elapses since start.
     //! If ticker is not started yet, it is started automatically.
-    void wait(Ticks ticks) {
+    nanoseconds_t deadline(Ticks ticks) {
         if (!started_) {
             start();
         }
-        sleep_until(start_ + nanoseconds_t(ticks / ratio_));
+        return start_ + nanoseconds_t(ticks / ratio_);
+    }
+
+    //! Wait until the given number of ticks elapses since start.
+    //! If ticker is not started yet, it is started automatically.
+    void wait(Ticks ticks) {
+        sleep_until(deadline(ticks));
     }
 
 private:
@@ -46,6 +46,13 @@ nanoseconds_t timestamp();
 //!  @p timestamp specifies absolute time point in nanoseconds.
 void sleep_until(nanoseconds_t timestamp);
 
+//! Sleep until the specified absolute time point with high precision.
+//! @remarks
+//!  Sleeps until @p timestamp minus @p spin_duration and then busy-waits for
+//!  the rest of the time, hiding the wakeup latency of the OS scheduler at
+//!  the cost of spending up to @p spin_duration of CPU time.
+void sleep_until_precise(nanoseconds_t timestamp, nanoseconds_t spin_duration);
+
 //! Sleep specified amount of time.
 //! @remarks
 //!  @p duration specifies number of nanoseconds to sleep.
@@ -52,13 +52,24 @@ struct Config {
     //! Configuration for ReedSolomon scheme.
     uint16_t rs_m;
 
+    //! Spread repair packets over the next block.
+    //! @remarks
+    //!  If set, repair packets of a block are not sent back to back after its
+    //!  last source packet, but are interleaved with source packets of the
+    //!  next block instead, to avoid bursts. This delays repair packets by
+    //!  about one block, so they can repair losses only if the receiver latency
+    //!  is larger than about two blocks. Repair packets of the last block are
+    //!  written when the writer is flushed.
+    bool pace_repair_packets;
+
     Config()
         : codec(NoCodec)
         , n_source_packets(20)
         , n_repair_packets(10)
         , ldpc_prng_seed(1297501556)
         , ldpc_N1(7)
-        , rs_m(8) {
+        , rs_m(8)
+        , pace_repair_packets(false) {
     }
 };
 
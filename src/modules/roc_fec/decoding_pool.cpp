@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2015 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/decoding_pool.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+DecodingTask::DecodingTask()
+    : state_(Idle) {
+}
+
+DecodingTask::~DecodingTask() {
+    if (state_ == Pending || state_ == Running) {
+        roc_panic("decoding task: can't destroy task which is still scheduled");
+    }
+}
+
+DecodingPool::DecodingPool(size_t num_threads, core::IAllocator& allocator)
+    : allocator_(allocator)
+    , task_cond_(mutex_)
+    , done_cond_(mutex_)
+    , workers_(allocator)
+    , stop_requested_(false)
+    , valid_(false) {
+    if (!workers_.grow(num_threads)) {
+        return;
+    }
+
+    for (size_t n = 0; n < num_threads; n++) {
+        Worker* worker = new (allocator_) Worker(*this);
+        if (!worker) {
+            roc_log(LogError, "decoding pool: can't allocate thread");
+            return;
+        }
+
+        workers_.push_back(worker);
+
+        if (!worker->start()) {
+            roc_log(LogError, "decoding pool: can't start thread");
+            return;
+        }
+    }
+
+    roc_log(LogDebug, "decoding pool: initialized: num_threads=%lu",
+            (unsigned long)num_threads);
+
+    valid_ = true;
+}
+
+DecodingPool::~DecodingPool() {
+    stop_();
+
+    for (size_t n = 0; n < workers_.size(); n++) {
+        workers_[n]->join();
+        allocator_.destroy(*workers_[n]);
+    }
+
+    // workers drain the queue before exiting, but there may be no workers
+    drain_();
+
+    if (tasks_.size() != 0) {
+        roc_panic("decoding pool: %lu task(s) left in queue after stopping threads",
+                  (unsigned long)tasks_.size());
+    }
+}
+
+bool DecodingPool::valid() const {
+    return valid_;
+}
+
+void DecodingPool::schedule(DecodingTask& task) {
+    core::Mutex::Lock lock(mutex_);
+
+    if (task.state_ != DecodingTask::Idle) {
+        roc_panic("decoding pool: task is already scheduled");
+    }
+
+    task.state_ = DecodingTask::Pending;
+    tasks_.push_back(task);
+
+    task_cond_.signal();
+}
+
+void DecodingPool::wait(DecodingTask& task) {
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        if (task.state_ == DecodingTask::Idle) {
+            return;
+        }
+
+        if (task.state_ != DecodingTask::Pending) {
+            while (task.state_ != DecodingTask::Done) {
+                done_cond_.wait();
+            }
+            task.state_ = DecodingTask::Idle;
+            return;
+        }
+
+        // Not picked up by a thread yet, so it's cheaper to run it here
+        // than to wait until all preceding tasks are done.
+        tasks_.remove(task);
+        task.state_ = DecodingTask::Running;
+    }
+
+    task.decode();
+
+    core::Mutex::Lock lock(mutex_);
+    task.state_ = DecodingTask::Idle;
+}
+
+bool DecodingPool::try_wait(DecodingTask& task) {
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        if (task.state_ == DecodingTask::Running) {
+            return false;
+        }
+
+        if (task.state_ != DecodingTask::Pending) {
+            task.state_ = DecodingTask::Idle;
+            return true;
+        }
+
+        if (workers_.size() != 0) {
+            return false;
+        }
+    }
+
+    // there are no threads to pick up the task
+    wait(task);
+    return true;
+}
+
+void DecodingPool::work_() {
+    core::Mutex::Lock lock(mutex_);
+
+    for (;;) {
+        while (!stop_requested_ && tasks_.size() == 0) {
+            task_cond_.wait();
+        }
+
+        // after stop is requested, finish queued tasks before exiting
+        if (tasks_.size() == 0) {
+            break;
+        }
+
+        DecodingTask* task = tasks_.front();
+        tasks_.remove(*task);
+        task->state_ = DecodingTask::Running;
+
+        mutex_.unlock();
+        task->decode();
+        mutex_.lock();
+
+        task->state_ = DecodingTask::Done;
+        done_cond_.broadcast();
+    }
+}
+
+void DecodingPool::stop_() {
+    core::Mutex::Lock lock(mutex_);
+
+    stop_requested_ = true;
+    task_cond_.broadcast();
+}
+
+void DecodingPool::drain_() {
+    core::Mutex::Lock lock(mutex_);
+
+    while (DecodingTask* task = tasks_.front()) {
+        tasks_.remove(*task);
+        task->state_ = DecodingTask::Running;
+
+        mutex_.unlock();
+        task->decode();
+        mutex_.lock();
+
+        task->state_ = DecodingTask::Done;
+    }
+}
+
+DecodingPool::Worker::Worker(DecodingPool& pool)
+    : pool_(pool) {
+}
+
+DecodingPool::Worker::~Worker() {
+}
+
+void DecodingPool::Worker::run() {
+    pool_.work_();
+}
+
+} // namespace fec
+} // namespace roc
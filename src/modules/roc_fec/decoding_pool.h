@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2015 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/decoding_pool.h
+//! @brief Pool of FEC decoding threads.
+
+#ifndef ROC_FEC_DECODING_POOL_H_
+#define ROC_FEC_DECODING_POOL_H_
+
+#include "roc_core/array.h"
+#include "roc_core/cond.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/list.h"
+#include "roc_core/list_node.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/thread.h"
+
+namespace roc {
+namespace fec {
+
+class DecodingPool;
+
+//! Decoding task.
+//! @remarks
+//!  Task object is owned by the caller and may be scheduled again after
+//!  DecodingPool::wait() returns or DecodingPool::try_wait() returns true.
+class DecodingTask : public core::ListNode {
+public:
+    DecodingTask();
+
+    virtual ~DecodingTask();
+
+protected:
+    //! Perform decoding.
+    //! @remarks
+    //!  Called from a pool thread or from the thread calling DecodingPool::wait().
+    virtual void decode() = 0;
+
+private:
+    friend class DecodingPool;
+
+    enum State { Idle, Pending, Running, Done };
+
+    State state_;
+};
+
+//! Pool of FEC decoding threads.
+//! @remarks
+//!  Allows to run FEC decoding of multiple sessions in parallel, instead of
+//!  running it in the thread which reads audio.
+class DecodingPool : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  Starts @p num_threads threads. If @p num_threads is zero, tasks are
+    //!  executed in wait().
+    DecodingPool(size_t num_threads, core::IAllocator& allocator);
+
+    //! Stop and join threads.
+    //! @remarks
+    //!  Tasks that are still queued are decoded before the threads exit.
+    ~DecodingPool();
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Schedule task for decoding.
+    //! @pre
+    //!  Task should not be already scheduled.
+    void schedule(DecodingTask& task);
+
+    //! Wait until task is decoded.
+    //! @remarks
+    //!  If the task was not picked up by a thread yet, it is removed from the
+    //!  queue and executed in the calling thread. Does nothing if the task is
+    //!  not scheduled.
+    void wait(DecodingTask& task);
+
+    //! Collect task if it's decoded, without waiting for a thread.
+    //! @remarks
+    //!  Unlike wait(), decodes the task in the calling thread only if the pool
+    //!  has no threads.
+    //! @returns
+    //!  true if the task is decoded or not scheduled, and false if it's still
+    //!  queued or being decoded; in the latter case the caller should try again
+    //!  later or call wait().
+    bool try_wait(DecodingTask& task);
+
+private:
+    class Worker : public core::Thread {
+    public:
+        Worker(DecodingPool& pool);
+
+        virtual ~Worker();
+
+    private:
+        virtual void run();
+
+        DecodingPool& pool_;
+    };
+
+    void work_();
+    void stop_();
+    void drain_();
+
+    core::IAllocator& allocator_;
+
+    core::Mutex mutex_;
+
+    // signaled when a task is queued or stop is requested
+    core::Cond task_cond_;
+
+    // broadcasted when a task is decoded
+    core::Cond done_cond_;
+
+    core::List<DecodingTask, core::NoOwnership> tasks_;
+    core::Array<Worker*> workers_;
+
+    bool stop_requested_;
+    bool valid_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_DECODING_POOL_H_
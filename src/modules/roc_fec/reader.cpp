@@ -9,6 +9,7 @@
 #include "roc_fec/reader.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/time.h"
 
 namespace roc {
 namespace fec {
@@ -19,16 +20,24 @@ Reader::Reader(const Config& config,
                packet::IReader& repair_reader,
                packet::IParser& parser,
                packet::PacketPool& packet_pool,
+               DecodingPool* decoding_pool,
                core::IAllocator& allocator)
     : decoder_(decoder)
     , source_reader_(source_reader)
     , repair_reader_(repair_reader)
     , parser_(parser)
     , packet_pool_(packet_pool)
+    , decoding_pool_(decoding_pool)
     , source_queue_(0)
     , repair_queue_(0)
     , source_block_(allocator)
     , repair_block_(allocator)
+    , task_source_block_(allocator)
+    , task_repair_block_(allocator)
+    , task_repaired_block_(allocator)
+    , task_decode_time_(0)
+    , task_block_sn_(0)
+    , task_scheduled_(false)
     , valid_(false)
     , alive_(true)
     , started_(false)
@@ -44,13 +53,88 @@ Reader::Reader(const Config& config,
     if (!repair_block_.resize(config.n_repair_packets)) {
         return;
     }
+    if (decoding_pool_) {
+        if (!task_source_block_.resize(config.n_source_packets)) {
+            return;
+        }
+        if (!task_repair_block_.resize(config.n_repair_packets)) {
+            return;
+        }
+        if (!task_repaired_block_.resize(config.n_source_packets)) {
+            return;
+        }
+    }
     valid_ = true;
 }
 
+Reader::~Reader() {
+    if (task_scheduled_) {
+        decoding_pool_->wait(*this);
+    }
+}
+
 bool Reader::valid() const {
     return valid_;
 }
 
+const ReaderStats& Reader::stats() const {
+    return stats_;
+}
+
+ReaderStats Reader::final_stats() const {
+    ReaderStats stats = stats_;
+
+    if (started_) {
+        for (size_t n = 0; n < next_packet_; n++) {
+            if (!source_block_[n]) {
+                stats.n_lost++;
+                stats.n_unrepairable++;
+            }
+        }
+    }
+
+    return stats;
+}
+
+void Reader::reset() {
+    roc_panic_if_not(valid());
+
+    if (task_scheduled_) {
+        decoding_pool_->wait(*this);
+        task_scheduled_ = false;
+    }
+
+    for (size_t n = 0; n < source_block_.size(); n++) {
+        source_block_[n] = NULL;
+    }
+    for (size_t n = 0; n < repair_block_.size(); n++) {
+        repair_block_[n] = NULL;
+    }
+    for (size_t n = 0; n < task_source_block_.size(); n++) {
+        task_source_block_[n] = NULL;
+        task_repaired_block_[n] = core::Slice<uint8_t>();
+    }
+    for (size_t n = 0; n < task_repair_block_.size(); n++) {
+        task_repair_block_[n] = NULL;
+    }
+
+    source_queue_.reset();
+    repair_queue_.reset();
+
+    decoder_.reset();
+
+    alive_ = true;
+    started_ = false;
+    can_repair_ = false;
+    next_packet_ = 0;
+    cur_block_sn_ = 0;
+    has_source_ = false;
+    source_ = 0;
+    n_packets_ = 0;
+
+    stats_ = ReaderStats();
+}
+
 bool Reader::started() const {
     return started_;
 }
@@ -104,6 +188,13 @@ packet::PacketPtr Reader::read_() {
 packet::PacketPtr Reader::get_next_packet_() {
     update_packets_();
 
+    if (decoding_pool_) {
+        if (task_scheduled_) {
+            finish_repair_();
+        }
+        schedule_repair_();
+    }
+
     packet::PacketPtr pp = source_block_[next_packet_];
 
     do {
@@ -142,6 +233,10 @@ void Reader::next_block_() {
     roc_log(LogTrace, "fec reader: next block: sn=%lu", (unsigned long)cur_block_sn_);
 
     for (size_t n = 0; n < source_block_.size(); n++) {
+        if (!source_block_[n]) {
+            stats_.n_lost++;
+            stats_.n_unrepairable++;
+        }
         source_block_[n] = NULL;
     }
 
@@ -152,15 +247,24 @@ void Reader::next_block_() {
     cur_block_sn_ += source_block_.size();
     next_packet_ = 0;
 
+    stats_.n_blocks++;
+
     can_repair_ = false;
     update_packets_();
 }
 
 void Reader::try_repair_() {
+    // decoder is used by the pool thread until the task is finished
+    if (task_scheduled_ && !finish_repair_()) {
+        return;
+    }
+
     if (!can_repair_) {
         return;
     }
 
+    const core::nanoseconds_t start_time = core::timestamp();
+
     for (size_t n = 0; n < source_block_.size(); n++) {
         if (!source_block_[n]) {
             continue;
@@ -185,29 +289,154 @@ void Reader::try_repair_() {
             continue;
         }
 
-        packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
-        if (!pp) {
-            roc_log(LogError, "fec reader: can't allocate packet");
-            continue;
+        source_block_[n] = make_repaired_packet_(buffer, n);
+        if (source_block_[n]) {
+            stats_.n_lost++;
+            stats_.n_repaired++;
         }
+    }
 
-        if (!parser_.parse(*pp, buffer)) {
-            roc_log(LogDebug, "fec reader: can't parse repaired packet");
-            continue;
+    decoder_.reset();
+    can_repair_ = false;
+
+    stats_.add_decode_time(core::timestamp() - start_time);
+}
+
+packet::PacketPtr Reader::make_repaired_packet_(const core::Slice<uint8_t>& buffer,
+                                                size_t pos) {
+    packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
+    if (!pp) {
+        roc_log(LogError, "fec reader: can't allocate packet");
+        return NULL;
+    }
+
+    if (!parser_.parse(*pp, buffer)) {
+        roc_log(LogDebug, "fec reader: can't parse repaired packet");
+        return NULL;
+    }
+
+    pp->set_data(buffer);
+
+    if (!check_packet_(pp, pos)) {
+        roc_log(LogDebug, "fec reader: dropping unexpected repaired packet");
+        return NULL;
+    }
+
+    return pp;
+}
+
+void Reader::schedule_repair_() {
+    if (task_scheduled_ || !can_repair_) {
+        return;
+    }
+
+    size_t n_source = 0, n_repair = 0;
+
+    for (size_t n = 0; n < source_block_.size(); n++) {
+        if (source_block_[n]) {
+            n_source++;
+        }
+    }
+
+    for (size_t n = 0; n < repair_block_.size(); n++) {
+        if (repair_block_[n]) {
+            n_repair++;
         }
+    }
+
+    // nothing to repair or not enough packets yet
+    if (n_source == source_block_.size() || n_source + n_repair < source_block_.size()) {
+        return;
+    }
+
+    for (size_t n = 0; n < source_block_.size(); n++) {
+        task_source_block_[n] = source_block_[n];
+    }
 
-        pp->set_data(buffer);
+    for (size_t n = 0; n < repair_block_.size(); n++) {
+        task_repair_block_[n] = repair_block_[n];
+    }
+
+    // new packets arriving after this point will set it again
+    can_repair_ = false;
+    task_scheduled_ = true;
+    task_block_sn_ = cur_block_sn_;
 
-        if (!check_packet_(pp, n)) {
-            roc_log(LogDebug, "fec reader: dropping unexpected repaired packet");
+    decoding_pool_->schedule(*this);
+}
+
+bool Reader::finish_repair_() {
+    if (!decoding_pool_->try_wait(*this)) {
+        return false;
+    }
+
+    task_scheduled_ = false;
+
+    stats_.add_decode_time(task_decode_time_);
+
+    // the block was finished before the task was decoded
+    const bool outdated = task_block_sn_ != cur_block_sn_;
+
+    bool has_missing = false;
+
+    for (size_t n = 0; n < source_block_.size(); n++) {
+        // skipped packets are already counted as lost
+        if (!outdated && n >= next_packet_ && !source_block_[n]
+            && task_repaired_block_[n]) {
+            source_block_[n] = make_repaired_packet_(task_repaired_block_[n], n);
+            if (source_block_[n]) {
+                stats_.n_lost++;
+                stats_.n_repaired++;
+            }
+        }
+        if (!source_block_[n]) {
+            has_missing = true;
+        }
+
+        task_source_block_[n] = NULL;
+        task_repaired_block_[n] = core::Slice<uint8_t>();
+    }
+
+    for (size_t n = 0; n < repair_block_.size(); n++) {
+        task_repair_block_[n] = NULL;
+    }
+
+    if (!outdated && !has_missing) {
+        can_repair_ = false;
+    }
+
+    return true;
+}
+
+// called from decoding pool thread; only the snapshot of the block is used
+void Reader::decode() {
+    const core::nanoseconds_t start_time = core::timestamp();
+
+    for (size_t n = 0; n < task_source_block_.size(); n++) {
+        if (!task_source_block_[n]) {
             continue;
         }
+        decoder_.set(n, task_source_block_[n]->fec()->payload);
+    }
 
-        source_block_[n] = pp;
+    for (size_t n = 0; n < task_repair_block_.size(); n++) {
+        if (!task_repair_block_[n]) {
+            continue;
+        }
+        decoder_.set(task_source_block_.size() + n,
+                     task_repair_block_[n]->fec()->payload);
+    }
+
+    for (size_t n = 0; n < task_source_block_.size(); n++) {
+        if (task_source_block_[n]) {
+            continue;
+        }
+        task_repaired_block_[n] = decoder_.repair(n);
     }
 
     decoder_.reset();
-    can_repair_ = false;
+
+    task_decode_time_ = core::timestamp() - start_time;
 }
 
 bool Reader::check_packet_(const packet::PacketPtr& pp, size_t pos) {
@@ -347,6 +576,7 @@ void Reader::update_repair_packets_() {
                     "fec reader: dropping repair packet from previous block:"
                     " blk_sn=%lu pkt_data_blk=%lu",
                     (unsigned long)cur_block_sn_, (unsigned long)fec->blknum);
+            stats_.n_late_repair++;
             n_dropped++;
             continue;
         }
@@ -17,7 +17,9 @@
 #include "roc_core/noncopyable.h"
 #include "roc_core/slice.h"
 #include "roc_fec/config.h"
+#include "roc_fec/decoding_pool.h"
 #include "roc_fec/idecoder.h"
+#include "roc_fec/reader_stats.h"
 #include "roc_packet/iparser.h"
 #include "roc_packet/ireader.h"
 #include "roc_packet/packet.h"
@@ -28,7 +30,9 @@ namespace roc {
 namespace fec {
 
 //! FEC reader.
-class Reader : public packet::IReader, public core::NonCopyable<> {
+class Reader : public packet::IReader,
+               private DecodingTask,
+               public core::NonCopyable<> {
 public:
     //! Initialize.
     //!
@@ -38,6 +42,8 @@ public:
     //!  - @p source_reader specifies input queue with data packets;
     //!  - @p repair_reader specifies input queue with FEC packets;
     //!  - @p parser specifies packet parser for restored packets.
+    //!  - @p decoding_pool specifies optional thread pool for decoding;
+    //!    if it's NULL, decoding is performed in read()
     //!  - @p allocator is used to initialize a packet array
     Reader(const Config& config,
            IDecoder& decoder,
@@ -45,8 +51,11 @@ public:
            packet::IReader& repair_reader,
            packet::IParser& parser,
            packet::PacketPool& packet_pool,
+           DecodingPool* decoding_pool,
            core::IAllocator& allocator);
 
+    ~Reader();
+
     //! Check if object is successfully constructed.
     bool valid() const;
 
@@ -59,16 +68,44 @@ public:
     //! Read packet.
     //! @remarks
     //!  When a packet loss is detected, try to restore it from repair packets.
+    //!  If decoding pool is used, decoding is started as soon as the current
+    //!  block has enough packets. read() never waits for the pool: if decoding
+    //!  isn't finished when it reaches the lost packet, the packet is skipped,
+    //!  and the result is used for the remaining packets of the block, if any.
     virtual packet::PacketPtr read();
 
+    //! Get statistics.
+    //! @remarks
+    //!  Losses are accounted when the block is finished.
+    const ReaderStats& stats() const;
+
+    //! Get statistics including the current block.
+    //! @remarks
+    //!  Packets of the current block that were already skipped without being
+    //!  repaired are counted as lost, as if the block was finished now. Used
+    //!  when the reader is going to be destroyed or reset.
+    ReaderStats final_stats() const;
+
+    //! Reset to initial state.
+    //! @remarks
+    //!  Waits for the scheduled decoding task, if any, drops all packets,
+    //!  resets decoder and statistics. Doesn't allocate memory.
+    void reset();
+
 private:
     packet::PacketPtr read_();
     packet::PacketPtr get_next_packet_();
 
     void next_block_();
     void try_repair_();
+    packet::PacketPtr make_repaired_packet_(const core::Slice<uint8_t>& buffer,
+                                            size_t pos);
     bool check_packet_(const packet::PacketPtr&, size_t pos);
 
+    void schedule_repair_();
+    bool finish_repair_();
+    virtual void decode();
+
     void fetch_packets_();
     void update_packets_();
 
@@ -85,6 +122,7 @@ private:
     packet::IReader& repair_reader_;
     packet::IParser& parser_;
     packet::PacketPool& packet_pool_;
+    DecodingPool* decoding_pool_;
 
     packet::SortedQueue source_queue_;
     packet::SortedQueue repair_queue_;
@@ -92,6 +130,14 @@ private:
     core::Array<packet::PacketPtr> source_block_;
     core::Array<packet::PacketPtr> repair_block_;
 
+    // snapshot of the current block passed to decoding pool
+    core::Array<packet::PacketPtr> task_source_block_;
+    core::Array<packet::PacketPtr> task_repair_block_;
+    core::Array<core::Slice<uint8_t> > task_repaired_block_;
+    core::nanoseconds_t task_decode_time_;
+    packet::seqnum_t task_block_sn_;
+    bool task_scheduled_;
+
     bool valid_;
 
     bool alive_;
@@ -105,6 +151,8 @@ private:
     packet::source_t source_;
 
     unsigned n_packets_;
+
+    ReaderStats stats_;
 };
 
 } // namespace fec
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2015 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/reader_stats.h
+//! @brief FEC reader statistics.
+
+#ifndef ROC_FEC_READER_STATS_H_
+#define ROC_FEC_READER_STATS_H_
+
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace fec {
+
+//! FEC reader statistics.
+struct ReaderStats {
+    //! Number of buckets in decode time histogram.
+    enum { NumDecodeTimeBuckets = 16 };
+
+    //! Number of processed blocks.
+    size_t n_blocks;
+
+    //! Number of source packets that were not received.
+    size_t n_lost;
+
+    //! Number of lost source packets that were repaired.
+    size_t n_repaired;
+
+    //! Number of lost source packets that were not repaired.
+    size_t n_unrepairable;
+
+    //! Number of repair packets dropped because their block was already read.
+    size_t n_late_repair;
+
+    //! Number of decoder invocations.
+    size_t n_decodes;
+
+    //! Decode time histogram.
+    //! @remarks
+    //!  Bucket @c i counts decodes which took [2^i, 2^(i+1)) microseconds,
+    //!  the first bucket also counts shorter decodes, and the last one
+    //!  also counts longer decodes.
+    size_t decode_time_hist[NumDecodeTimeBuckets];
+
+    ReaderStats()
+        : n_blocks(0)
+        , n_lost(0)
+        , n_repaired(0)
+        , n_unrepairable(0)
+        , n_late_repair(0)
+        , n_decodes(0) {
+        for (size_t n = 0; n < NumDecodeTimeBuckets; n++) {
+            decode_time_hist[n] = 0;
+        }
+    }
+
+    //! Add decode time to histogram.
+    void add_decode_time(core::nanoseconds_t time) {
+        size_t bucket = 0;
+        for (core::nanoseconds_t us = time / core::Microsecond;
+             us > 1 && bucket < NumDecodeTimeBuckets - 1; us /= 2) {
+            bucket++;
+        }
+        decode_time_hist[bucket]++;
+        n_decodes++;
+    }
+
+    //! Add counters from another object.
+    void add(const ReaderStats& other) {
+        n_blocks += other.n_blocks;
+        n_lost += other.n_lost;
+        n_repaired += other.n_repaired;
+        n_unrepairable += other.n_unrepairable;
+        n_late_repair += other.n_late_repair;
+        n_decodes += other.n_decodes;
+        for (size_t n = 0; n < NumDecodeTimeBuckets; n++) {
+            decode_time_hist[n] += other.decode_time_hist[n];
+        }
+    }
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_READER_STATS_H_
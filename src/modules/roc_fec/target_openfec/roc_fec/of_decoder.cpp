@@ -28,6 +28,7 @@ OFDecoder::OFDecoder(const Config& config,
     , payload_size_(payload_size)
     , of_sess_(NULL)
     , of_sess_params_(NULL)
+    , n_sessions_(0)
     , buffer_pool_(buffer_pool)
     , buff_tab_(allocator)
     , data_tab_(allocator)
@@ -73,8 +74,6 @@ OFDecoder::OFDecoder(const Config& config,
     of_sess_params_->encoding_symbol_length = (uint32_t)payload_size_;
     of_verbosity = 0;
 
-    OFDecoder::reset(); // non-virtual call from ctor
-
     valid_ = true;
 }
 
@@ -112,15 +111,11 @@ void OFDecoder::set(size_t index, const core::Slice<uint8_t>& buffer) {
 
     has_new_packets_ = true;
 
+    // packets are passed to OpenFEC only when there are enough of them
+    // to decode the block, see decode_()
     buff_tab_[index] = buffer;
     data_tab_[index] = buffer.data();
     recv_tab_[index] = true;
-
-    // register new packet and try to repair more packets
-    if (of_decode_with_new_symbol(of_sess_, data_tab_[index], (unsigned int)index)
-        != OF_STATUS_OK) {
-        roc_panic("of decoder: can't add packet to OF session");
-    }
 }
 
 core::Slice<uint8_t> OFDecoder::repair(size_t index) {
@@ -135,12 +130,13 @@ core::Slice<uint8_t> OFDecoder::repair(size_t index) {
 }
 
 void OFDecoder::reset() {
-    if (of_sess_ != NULL) {
+    if (has_n_packets_(1)) {
         report_();
-        destroy_session_();
     }
 
-    reset_session_();
+    if (of_sess_ != NULL) {
+        destroy_session_();
+    }
 
     has_new_packets_ = false;
     decoding_finished_ = false;
@@ -152,16 +148,20 @@ void OFDecoder::reset() {
     }
 }
 
-void OFDecoder::update_() {
-    roc_panic_if(of_sess_ == NULL);
+size_t OFDecoder::num_sessions() const {
+    return n_sessions_;
+}
 
+void OFDecoder::update_() {
     if (!has_new_packets_) {
         return;
     }
 
     decode_();
 
-    of_get_source_symbols_tab(of_sess_, &data_tab_[0]);
+    if (of_sess_ != NULL) {
+        of_get_source_symbols_tab(of_sess_, &data_tab_[0]);
+    }
 
     has_new_packets_ = false;
 }
@@ -171,17 +171,18 @@ void OFDecoder::decode_() {
         return;
     }
 
+    // session creation is expensive (e.g. LDPC builds its matrix), so we
+    // don't create it until there is a chance to repair something
     if (!has_n_packets_(blk_source_packets_)) {
         return;
     }
 
-    if (decoding_finished_) {
-        // it's not allowed to decode twice, so we recrate the session
-        reset_session_();
+    // it's not allowed to decode twice, so we create a new session if the
+    // block was already decoded; repaired packets are kept in data_tab_
+    reset_session_();
 
-        if (of_set_available_symbols(of_sess_, &data_tab_[0]) != OF_STATUS_OK) {
-            roc_panic("of decoder: can't add packets to OF session");
-        }
+    if (of_set_available_symbols(of_sess_, &data_tab_[0]) != OF_STATUS_OK) {
+        roc_panic("of decoder: can't add packets to OF session");
     }
 
     // try to repair more packets
@@ -226,6 +227,8 @@ void OFDecoder::reset_session_() {
 
     roc_panic_if(of_sess_ == NULL);
 
+    n_sessions_++;
+
     if (OF_STATUS_OK != of_set_fec_parameters(of_sess_, of_sess_params_)) {
         roc_panic("of decoder: of_set_fec_parameters() failed");
     }
@@ -59,6 +59,12 @@ public:
     //! Reset current block.
     virtual void reset();
 
+    //! Get number of OpenFEC sessions created so far.
+    //! @remarks
+    //!  OpenFEC allocates session state using malloc(), bypassing our allocator,
+    //!  so this is the number of times such allocations happened.
+    size_t num_sessions() const;
+
 private:
     void update_();
     void decode_();
@@ -87,9 +93,11 @@ private:
         of_ldpc_parameters ldpc_params_;
     } codec_params_;
 
-    // session is recreated for every new block
+    // session is created when the block has enough packets to be decoded,
+    // and destroyed when the block is reset
     of_session_t* of_sess_;
     of_parameters_t* of_sess_params_;
+    size_t n_sessions_;
 
     core::BufferPool<uint8_t>& buffer_pool_;
 
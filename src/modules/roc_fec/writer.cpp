@@ -26,6 +26,7 @@ Writer::Writer(const Config& config,
     : n_source_packets_(config.n_source_packets)
     , n_repair_packets_(config.n_repair_packets)
     , payload_size_(payload_size)
+    , pace_repair_packets_(config.pace_repair_packets)
     , encoder_(encoder)
     , writer_(writer)
     , source_composer_(source_composer)
@@ -33,6 +34,7 @@ Writer::Writer(const Config& config,
     , packet_pool_(packet_pool)
     , buffer_pool_(buffer_pool)
     , repair_packets_(allocator)
+    , next_repair_packet_(config.n_repair_packets)
     , source_(0)
     , first_packet_(true)
     , cur_block_source_sn_(0)
@@ -84,33 +86,61 @@ void Writer::write(const packet::PacketPtr& pp) {
     writer_.write(pp);
 
     encoder_.set(cur_packet_, pp->fec()->payload);
+
+    if (pace_repair_packets_) {
+        // Spread repair packets of the previous block evenly between source
+        // packets of the current block; the last one is written not later
+        // than the last source packet.
+        write_repair_packets_(
+            (cur_packet_ + 1) * n_repair_packets_ / n_source_packets_);
+    }
+
     cur_packet_++;
 
     if (cur_packet_ == n_source_packets_) {
-        for (packet::seqnum_t i = 0; i < n_repair_packets_; i++) {
-            packet::PacketPtr rp = make_repair_packet_(i);
-            if (!rp) {
-                roc_log(LogDebug, "fec writer: can't create repair packet");
-                continue;
-            }
-            repair_packets_[i] = rp;
-            encoder_.set(cur_packet_ + i, rp->fec()->payload);
+        make_repair_packets_();
+
+        if (!pace_repair_packets_) {
+            write_repair_packets_(n_repair_packets_);
         }
 
-        encoder_.commit();
+        cur_block_repair_sn_ += n_repair_packets_;
+        cur_packet_ = 0;
+    }
+}
+
+void Writer::flush() {
+    roc_panic_if_not(valid());
 
-        for (packet::seqnum_t i = 0; i < n_repair_packets_; i++) {
-            packet::PacketPtr rp = repair_packets_[i];
-            if (rp) {
-                writer_.write(repair_packets_[i]);
-                repair_packets_[i] = NULL;
-            }
+    write_repair_packets_(n_repair_packets_);
+}
+
+void Writer::make_repair_packets_() {
+    roc_panic_if(next_repair_packet_ != n_repair_packets_);
+
+    for (packet::seqnum_t i = 0; i < n_repair_packets_; i++) {
+        packet::PacketPtr rp = make_repair_packet_(i);
+        if (!rp) {
+            roc_log(LogDebug, "fec writer: can't create repair packet");
+            continue;
         }
+        repair_packets_[i] = rp;
+        encoder_.set(cur_packet_ + i, rp->fec()->payload);
+    }
 
-        encoder_.reset();
+    encoder_.commit();
+    encoder_.reset();
 
-        cur_block_repair_sn_ += n_repair_packets_;
-        cur_packet_ = 0;
+    next_repair_packet_ = 0;
+}
+
+void Writer::write_repair_packets_(size_t until) {
+    for (; next_repair_packet_ < until; next_repair_packet_++) {
+        packet::PacketPtr rp = repair_packets_[next_repair_packet_];
+        if (rp) {
+            writer_.write(rp);
+            repair_packets_[next_repair_packet_] = NULL;
+        }
     }
 }
 
@@ -58,12 +58,25 @@ public:
     //! @remarks
     //!  - writes the given source packet to the output writer
     //!  - generates repair packets and also writes them to the output writer
+    //!  - if repair packets pacing is enabled, repair packets of a block are
+    //!    written evenly between source packets of the next block
     virtual void write(const packet::PacketPtr&);
 
+    //! Write repair packets held for pacing.
+    //! @remarks
+    //!  If repair packets pacing is enabled, repair packets of the last block
+    //!  are held until source packets of the next block are written. Should be
+    //!  called when the stream ends, otherwise they are never written.
+    void flush();
+
 private:
     const size_t n_source_packets_;
     const size_t n_repair_packets_;
     const size_t payload_size_;
+    const bool pace_repair_packets_;
+
+    void make_repair_packets_();
+    void write_repair_packets_(size_t until);
 
     packet::PacketPtr make_repair_packet_(packet::seqnum_t n);
     void fill_packet_fec_id_(const packet::PacketPtr& packet, packet::seqnum_t n);
@@ -78,6 +91,7 @@ private:
     core::BufferPool<uint8_t>& buffer_pool_;
 
     core::Array<packet::PacketPtr> repair_packets_;
+    size_t next_repair_packet_;
 
     packet::source_t source_;
     bool first_packet_;
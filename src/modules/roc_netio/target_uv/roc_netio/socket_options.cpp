@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include "roc_netio/socket_options.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_packet/address_to_str.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+bool set_buffer_size(uv_udp_t& handle, size_t size, bool send) {
+    if (size == 0) {
+        return true;
+    }
+
+    int value = (int)size;
+    if (int err = send ? uv_send_buffer_size((uv_handle_t*)&handle, &value)
+                       : uv_recv_buffer_size((uv_handle_t*)&handle, &value)) {
+        roc_log(LogError, "socket options: %s(): [%s] %s",
+                send ? "uv_send_buffer_size" : "uv_recv_buffer_size", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    int actual = 0;
+    if (send) {
+        uv_send_buffer_size((uv_handle_t*)&handle, &actual);
+    } else {
+        uv_recv_buffer_size((uv_handle_t*)&handle, &actual);
+    }
+
+    roc_log(LogDebug, "socket options: set %s buffer size: requested=%lu actual=%ld",
+            send ? "send" : "receive", (unsigned long)size, (long)actual);
+
+    return true;
+}
+
+bool set_int_option(uv_os_fd_t fd, int level, int name, int value, const char* name_str) {
+    if (setsockopt(fd, level, name, &value, sizeof(value)) == -1) {
+        roc_log(LogError, "socket options: setsockopt(%s): %s", name_str,
+                core::errno_to_str(errno).c_str());
+        return false;
+    }
+
+    roc_log(LogDebug, "socket options: set %s to %d", name_str, value);
+
+    return true;
+}
+
+bool set_dscp(uv_os_fd_t fd, int ip_version, int dscp) {
+    if (dscp < 0) {
+        return true;
+    }
+
+    if (dscp > 63) {
+        roc_log(LogError, "socket options: invalid dscp %d, expected [0; 63]", dscp);
+        return false;
+    }
+
+    // DSCP occupies the upper 6 bits of the TOS or traffic class field.
+    const int tos = dscp << 2;
+
+    if (ip_version == 6) {
+#if defined(IPV6_TCLASS)
+        return set_int_option(fd, IPPROTO_IPV6, IPV6_TCLASS, tos, "IPV6_TCLASS");
+#else  // !defined(IPV6_TCLASS)
+        roc_log(LogError, "socket options: IPV6_TCLASS is not supported");
+        return false;
+#endif // defined(IPV6_TCLASS)
+    }
+
+    return set_int_option(fd, IPPROTO_IP, IP_TOS, tos, "IP_TOS");
+}
+
+bool set_priority(uv_os_fd_t fd, int priority) {
+    if (priority < 0) {
+        return true;
+    }
+
+#if defined(SO_PRIORITY)
+    return set_int_option(fd, SOL_SOCKET, SO_PRIORITY, priority, "SO_PRIORITY");
+#else  // !defined(SO_PRIORITY)
+    (void)fd;
+    roc_log(LogError, "socket options: SO_PRIORITY is not supported");
+    return false;
+#endif // defined(SO_PRIORITY)
+}
+
+bool set_busy_poll(uv_os_fd_t fd, int busy_poll) {
+    if (busy_poll <= 0) {
+        return true;
+    }
+
+#if defined(SO_BUSY_POLL)
+    return set_int_option(fd, SOL_SOCKET, SO_BUSY_POLL, busy_poll, "SO_BUSY_POLL");
+#else  // !defined(SO_BUSY_POLL)
+    (void)fd;
+    roc_log(LogError, "socket options: SO_BUSY_POLL is not supported");
+    return false;
+#endif // defined(SO_BUSY_POLL)
+}
+
+} // namespace
+
+bool set_socket_options(uv_udp_t& handle, int ip_version, const SocketOptions& options) {
+    if (!set_buffer_size(handle, options.send_buffer_size, true)) {
+        return false;
+    }
+
+    if (!set_buffer_size(handle, options.recv_buffer_size, false)) {
+        return false;
+    }
+
+    if (options.dscp < 0 && options.priority < 0 && options.busy_poll <= 0) {
+        return true;
+    }
+
+    uv_os_fd_t fd;
+    if (int err = uv_fileno((uv_handle_t*)&handle, &fd)) {
+        roc_log(LogError, "socket options: uv_fileno(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    if (!set_dscp(fd, ip_version, options.dscp)) {
+        return false;
+    }
+
+    if (!set_priority(fd, options.priority)) {
+        return false;
+    }
+
+    if (!set_busy_poll(fd, options.busy_poll)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool get_interface_index(const packet::Address& address, unsigned& index) {
+    uv_interface_address_t* ifaces = NULL;
+    int n_ifaces = 0;
+
+    if (int err = uv_interface_addresses(&ifaces, &n_ifaces)) {
+        roc_log(LogError, "socket options: uv_interface_addresses(): [%s] %s",
+                uv_err_name(err), uv_strerror(err));
+        return false;
+    }
+
+    index = 0;
+
+    for (int n = 0; n < n_ifaces; n++) {
+        bool match = false;
+
+        if (address.version() == 4) {
+            const sockaddr_in& sa = ifaces[n].address.address4;
+            match = sa.sin_family == AF_INET
+                && memcmp(&sa.sin_addr, &((const sockaddr_in*)address.saddr())->sin_addr,
+                          sizeof(sa.sin_addr))
+                    == 0;
+        } else if (address.version() == 6) {
+            const sockaddr_in6& sa = ifaces[n].address.address6;
+            match = sa.sin6_family == AF_INET6
+                && memcmp(&sa.sin6_addr,
+                          &((const sockaddr_in6*)address.saddr())->sin6_addr,
+                          sizeof(sa.sin6_addr))
+                    == 0;
+        }
+
+        if (match) {
+            index = if_nametoindex(ifaces[n].name);
+            break;
+        }
+    }
+
+    uv_free_interface_addresses(ifaces, n_ifaces);
+
+    if (index == 0) {
+        roc_log(LogError, "socket options: no local interface with address %s",
+                packet::address_to_str(address).c_str());
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace netio
+} // namespace roc
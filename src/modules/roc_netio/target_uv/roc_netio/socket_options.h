@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_uv/roc_netio/socket_options.h
+//! @brief Socket options.
+
+#ifndef ROC_NETIO_SOCKET_OPTIONS_H_
+#define ROC_NETIO_SOCKET_OPTIONS_H_
+
+#include <uv.h>
+
+#include "roc_core/stddefs.h"
+#include "roc_packet/address.h"
+
+namespace roc {
+namespace netio {
+
+//! Socket options.
+//! @remarks
+//!  Every option has a value which means that the option is not changed and
+//!  the system default is used.
+struct SocketOptions {
+    //! Socket send buffer size (SO_SNDBUF), bytes.
+    //! @remarks
+    //!  If zero, not changed. The kernel may clamp or double the value.
+    size_t send_buffer_size;
+
+    //! Socket receive buffer size (SO_RCVBUF), bytes.
+    //! @remarks
+    //!  If zero, not changed. The kernel may clamp or double the value. Larger
+    //!  buffers prevent kernel drops on bursty arrivals.
+    size_t recv_buffer_size;
+
+    //! DSCP of outgoing packets, from 0 to 63.
+    //! @remarks
+    //!  If negative, not changed. Set via IP_TOS for IPv4 and IPV6_TCLASS for
+    //!  IPv6. DSCP 46 (Expedited Forwarding) is usually used for audio.
+    int dscp;
+
+    //! Socket priority (SO_PRIORITY).
+    //! @remarks
+    //!  If negative, not changed. Linux only. Values above 6 require
+    //!  CAP_NET_ADMIN.
+    int priority;
+
+    //! Busy polling timeout (SO_BUSY_POLL), microseconds.
+    //! @remarks
+    //!  If zero, not changed. Linux only. Raising the value above the system
+    //!  default requires CAP_NET_ADMIN.
+    int busy_poll;
+
+    SocketOptions()
+        : send_buffer_size(0)
+        , recv_buffer_size(0)
+        , dscp(-1)
+        , priority(-1)
+        , busy_poll(0) {
+    }
+};
+
+//! Apply socket options to an opened socket.
+//! @remarks
+//!  @p ip_version is the IP version of the socket address (4 or 6).
+//! @returns
+//!  false if some option can't be applied.
+bool set_socket_options(uv_udp_t& handle, int ip_version, const SocketOptions& options);
+
+//! Find index of the local network interface which has given IP address.
+//! @remarks
+//!  IPv6 multicast options identify interfaces by index rather than address.
+//! @returns
+//!  false if there is no such interface.
+bool get_interface_index(const packet::Address& address, unsigned& index);
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_SOCKET_OPTIONS_H_
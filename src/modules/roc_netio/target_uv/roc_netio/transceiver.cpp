@@ -142,6 +142,12 @@ size_t Transceiver::num_ports() const {
 
 bool Transceiver::add_udp_receiver(packet::Address& bind_address,
                                    packet::IWriter& writer) {
+    return add_udp_receiver(bind_address, UDPReceiverConfig(), writer);
+}
+
+bool Transceiver::add_udp_receiver(packet::Address& bind_address,
+                                   const UDPReceiverConfig& config,
+                                   packet::IWriter& writer) {
     if (!valid()) {
         roc_panic("transceiver: can't use invalid transceiver");
     }
@@ -150,6 +156,7 @@ bool Transceiver::add_udp_receiver(packet::Address& bind_address,
     task.fn = &Transceiver::add_udp_receiver_;
     task.address = &bind_address;
     task.writer = &writer;
+    task.receiver_config = &config;
 
     run_task_(task);
 
@@ -157,6 +164,11 @@ bool Transceiver::add_udp_receiver(packet::Address& bind_address,
 }
 
 packet::IWriter* Transceiver::add_udp_sender(packet::Address& bind_address) {
+    return add_udp_sender(bind_address, UDPSenderConfig());
+}
+
+packet::IWriter* Transceiver::add_udp_sender(packet::Address& bind_address,
+                                             const UDPSenderConfig& config) {
     if (!valid()) {
         roc_panic("transceiver: can't use invalid transceiver");
     }
@@ -165,6 +177,7 @@ packet::IWriter* Transceiver::add_udp_sender(packet::Address& bind_address) {
     task.fn = &Transceiver::add_udp_sender_;
     task.address = &bind_address;
     task.writer = NULL;
+    task.sender_config = &config;
 
     run_task_(task);
 
@@ -189,6 +202,22 @@ void Transceiver::remove_port(packet::Address bind_address) {
     }
 }
 
+bool Transceiver::get_receiver_stats(packet::Address bind_address,
+                                     UDPReceiverStats& stats) {
+    if (!valid()) {
+        roc_panic("transceiver: can't use invalid transceiver");
+    }
+
+    Task task;
+    task.fn = &Transceiver::get_receiver_stats_;
+    task.address = &bind_address;
+    task.receiver_stats = &stats;
+
+    run_task_(task);
+
+    return task.result;
+}
+
 void Transceiver::run() {
     if (!valid()) {
         roc_panic("transceiver: can't use invalid transceiver");
@@ -298,8 +327,9 @@ bool Transceiver::add_udp_receiver_(Task& task) {
         return false;
     }
 
-    core::SharedPtr<UDPReceiver> rp = new (allocator_)
-        UDPReceiver(loop_, *task.writer, packet_pool_, buffer_pool_, allocator_);
+    core::SharedPtr<UDPReceiver> rp =
+        new (allocator_) UDPReceiver(loop_, *task.receiver_config, *task.writer,
+                                     packet_pool_, buffer_pool_, allocator_);
 
     if (!rp) {
         roc_log(LogError, "transceiver: can't add port %s: can't allocate receiver",
@@ -332,7 +362,8 @@ bool Transceiver::add_udp_sender_(Task& task) {
         return false;
     }
 
-    core::SharedPtr<UDPSender> sp = new (allocator_) UDPSender(loop_, allocator_);
+    core::SharedPtr<UDPSender> sp =
+        new (allocator_) UDPSender(loop_, *task.sender_config, allocator_);
 
     if (!sp) {
         roc_log(LogError, "transceiver: can't add port %s: can't allocate sender",
@@ -375,6 +406,18 @@ bool Transceiver::remove_port_(Task& task) {
     return false;
 }
 
+bool Transceiver::get_receiver_stats_(Task& task) {
+    for (core::SharedPtr<UDPReceiver> rp = receivers_.front(); rp;
+         rp = receivers_.nextof(*rp)) {
+        if (rp->address() == *task.address) {
+            rp->get_stats(*task.receiver_stats);
+            return true;
+        }
+    }
+
+    return false;
+}
+
 bool Transceiver::has_port_(const packet::Address& address) const {
     for (core::SharedPtr<UDPReceiver> rp = receivers_.front(); rp;
          rp = receivers_.nextof(*rp)) {
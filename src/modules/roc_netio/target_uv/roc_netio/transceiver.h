@@ -76,6 +76,15 @@ public:
     //!  true on success or false if error occured
     bool add_udp_receiver(packet::Address& bind_address, packet::IWriter& writer);
 
+    //! Add UDP datagram receiver port with given parameters.
+    //!
+    //! Same as above, but allows to configure how packets are received. If
+    //! @p bind_address is a multicast address, the receiver joins this group,
+    //! using the multicast interface and source from @p config.
+    bool add_udp_receiver(packet::Address& bind_address,
+                          const UDPReceiverConfig& config,
+                          packet::IWriter& writer);
+
     //! Add UDP datagram sender port.
     //!
     //! Creates a new UDP sender, bind to @p bind_address, and returns a writer
@@ -90,15 +99,30 @@ public:
     //!  a new packet writer on success or null if error occured
     packet::IWriter* add_udp_sender(packet::Address& bind_address);
 
+    //! Add UDP datagram sender port with given parameters.
+    //!
+    //! Same as above, but allows to configure how packets are sent, e.g. how
+    //! packet send time is respected.
+    packet::IWriter* add_udp_sender(packet::Address& bind_address,
+                                    const UDPSenderConfig& config);
+
     //! Remove sender or receiver port.
     void remove_port(packet::Address bind_address);
 
+    //! Get statistics of receiver port.
+    //! @returns
+    //!  false if there is no receiver port with given address.
+    bool get_receiver_stats(packet::Address bind_address, UDPReceiverStats& stats);
+
 private:
     struct Task : core::ListNode {
         bool (Transceiver::*fn)(Task&);
 
         packet::Address* address;
         packet::IWriter* writer;
+        const UDPSenderConfig* sender_config;
+        const UDPReceiverConfig* receiver_config;
+        UDPReceiverStats* receiver_stats;
 
         bool result;
         bool done;
@@ -112,6 +136,9 @@ private:
             : fn(NULL)
             , address(NULL)
             , writer(NULL)
+            , sender_config(NULL)
+            , receiver_config(NULL)
+            , receiver_stats(NULL)
             , result(false)
             , done(false) {
         }
@@ -131,6 +158,7 @@ private:
     bool add_udp_receiver_(Task&);
     bool add_udp_sender_(Task&);
     bool remove_port_(Task&);
+    bool get_receiver_stats_(Task&);
 
     bool has_port_(const packet::Address& address) const;
 
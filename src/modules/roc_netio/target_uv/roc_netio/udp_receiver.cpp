@@ -6,7 +6,20 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <time.h>
+
+#if defined(__linux__)
+#include <linux/sock_diag.h>
+#include <linux/sockios.h>
+#endif
+
 #include "roc_netio/udp_receiver.h"
+#include "roc_core/errno_to_str.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/shared_ptr.h"
@@ -15,7 +28,15 @@
 namespace roc {
 namespace netio {
 
+namespace {
+
+// Kernel timestamps older than this are considered bogus.
+const core::nanoseconds_t MaxSocketDelay = core::Second;
+
+} // namespace
+
 UDPReceiver::UDPReceiver(uv_loop_t& event_loop,
+                         const UDPReceiverConfig& config,
                          packet::IWriter& writer,
                          packet::PacketPool& packet_pool,
                          core::BufferPool<uint8_t>& buffer_pool,
@@ -23,6 +44,9 @@ UDPReceiver::UDPReceiver(uv_loop_t& event_loop,
     : allocator_(allocator)
     , loop_(event_loop)
     , handle_initialized_(false)
+    , kernel_timestamps_(false)
+    , config_(config)
+    , multicast_joined_(false)
     , writer_(writer)
     , packet_pool_(packet_pool)
     , buffer_pool_(buffer_pool)
@@ -77,6 +101,20 @@ bool UDPReceiver::start(packet::Address& bind_address) {
         return false;
     }
 
+    if (!set_socket_options(handle_, bind_address.version(), config_.socket_options)) {
+        return false;
+    }
+
+    address_ = bind_address;
+
+    if (bind_address.multicast()) {
+        if (!join_multicast_group_()) {
+            return false;
+        }
+    }
+
+    enable_timestamps_();
+
     if (int err = uv_udp_recv_start(&handle_, alloc_cb_, recv_cb_)) {
         roc_log(LogError, "udp receiver: uv_udp_recv_start(): [%s] %s", uv_err_name(err),
                 uv_strerror(err));
@@ -86,7 +124,6 @@ bool UDPReceiver::start(packet::Address& bind_address) {
     roc_log(LogInfo, "udp receiver: opened port %s",
             packet::address_to_str(bind_address).c_str());
 
-    address_ = bind_address;
     return true;
 }
 
@@ -107,6 +144,8 @@ void UDPReceiver::stop() {
                 uv_strerror(err));
     }
 
+    leave_multicast_group_();
+
     uv_close((uv_handle_t*)&handle_, close_cb_);
 }
 
@@ -126,6 +165,11 @@ const packet::Address& UDPReceiver::address() const {
     return address_;
 }
 
+void UDPReceiver::get_stats(UDPReceiverStats& stats) const {
+    stats.n_packets = packet_counter_;
+    stats.n_kernel_drops = kernel_drops_();
+}
+
 void UDPReceiver::close_cb_(uv_handle_t* handle) {
     roc_panic_if_not(handle);
 
@@ -249,11 +293,278 @@ void UDPReceiver::recv_cb_(uv_udp_t* handle,
 
     pp->udp()->src_addr = src_addr;
     pp->udp()->dst_addr = self.address_;
+    pp->udp()->receive_timestamp = self.receive_timestamp_();
 
     pp->set_data(core::Slice<uint8_t>(*bp, 0, (size_t)nread));
 
     self.writer_.write(pp);
 }
 
+bool UDPReceiver::join_multicast_group_() {
+    if (config_.multicast_source.valid()) {
+        if (!set_source_membership_(UV_JOIN_GROUP)) {
+            return false;
+        }
+    } else {
+        if (!set_membership_(UV_JOIN_GROUP)) {
+            return false;
+        }
+    }
+
+    roc_log(LogInfo, "udp receiver: joined multicast group %s: source=%s interface=%s",
+            packet::address_to_str(address_).c_str(),
+            packet::address_to_str(config_.multicast_source).c_str(),
+            packet::address_to_str(config_.multicast_interface).c_str());
+
+    multicast_joined_ = true;
+    return true;
+}
+
+void UDPReceiver::leave_multicast_group_() {
+    if (!multicast_joined_) {
+        return;
+    }
+
+    multicast_joined_ = false;
+
+    if (config_.multicast_source.valid()) {
+        set_source_membership_(UV_LEAVE_GROUP);
+    } else {
+        set_membership_(UV_LEAVE_GROUP);
+    }
+
+    roc_log(LogDebug, "udp receiver: left multicast group %s",
+            packet::address_to_str(address_).c_str());
+}
+
+bool UDPReceiver::set_membership_(uv_membership membership) {
+    if (config_.multicast_interface.valid()
+        && config_.multicast_interface.version() != address_.version()) {
+        roc_log(LogError,
+                "udp receiver: multicast group and interface should have"
+                " the same IP version");
+        return false;
+    }
+
+    // libuv can't pass interface index for IPv6
+    if (address_.version() == 6 && config_.multicast_interface.valid()) {
+        return set_ipv6_membership_(membership);
+    }
+
+    char group[64];
+    if (!address_.get_ip(group, sizeof(group))) {
+        roc_log(LogError, "udp receiver: can't format multicast group address");
+        return false;
+    }
+
+    char iface[64];
+    if (config_.multicast_interface.valid()) {
+        if (!config_.multicast_interface.get_ip(iface, sizeof(iface))) {
+            roc_log(LogError, "udp receiver: can't format multicast interface address");
+            return false;
+        }
+    }
+
+    if (int err = uv_udp_set_membership(
+            &handle_, group, config_.multicast_interface.valid() ? iface : NULL,
+            membership)) {
+        roc_log(LogError, "udp receiver: uv_udp_set_membership(): [%s] %s",
+                uv_err_name(err), uv_strerror(err));
+        return false;
+    }
+
+    return true;
+}
+
+bool UDPReceiver::set_ipv6_membership_(uv_membership membership) {
+    ipv6_mreq mreq;
+    memset(&mreq, 0, sizeof(mreq));
+
+    mreq.ipv6mr_multiaddr = ((const sockaddr_in6*)address_.saddr())->sin6_addr;
+
+    if (!get_interface_index(config_.multicast_interface, mreq.ipv6mr_interface)) {
+        return false;
+    }
+
+    uv_os_fd_t fd;
+    if (int err = uv_fileno((uv_handle_t*)&handle_, &fd)) {
+        roc_log(LogError, "udp receiver: uv_fileno(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    const int opt = membership == UV_JOIN_GROUP ? IPV6_JOIN_GROUP : IPV6_LEAVE_GROUP;
+
+    if (setsockopt(fd, IPPROTO_IPV6, opt, &mreq, sizeof(mreq)) == -1) {
+        roc_log(LogError, "udp receiver: can't set membership: %s",
+                core::errno_to_str(errno).c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool UDPReceiver::set_source_membership_(uv_membership membership) {
+    if (config_.multicast_source.version() != address_.version()
+        || (config_.multicast_interface.valid()
+            && config_.multicast_interface.version() != address_.version())) {
+        roc_log(LogError,
+                "udp receiver: multicast group, source, and interface should have"
+                " the same IP version");
+        return false;
+    }
+
+    uv_os_fd_t fd;
+    if (int err = uv_fileno((uv_handle_t*)&handle_, &fd)) {
+        roc_log(LogError, "udp receiver: uv_fileno(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    if (address_.version() == 4) {
+#if defined(IP_ADD_SOURCE_MEMBERSHIP)
+        ip_mreq_source mreq;
+        memset(&mreq, 0, sizeof(mreq));
+
+        mreq.imr_multiaddr = ((const sockaddr_in*)address_.saddr())->sin_addr;
+        mreq.imr_sourceaddr =
+            ((const sockaddr_in*)config_.multicast_source.saddr())->sin_addr;
+
+        if (config_.multicast_interface.valid()) {
+            mreq.imr_interface =
+                ((const sockaddr_in*)config_.multicast_interface.saddr())->sin_addr;
+        } else {
+            mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+        }
+
+        const int opt = membership == UV_JOIN_GROUP ? IP_ADD_SOURCE_MEMBERSHIP
+                                                    : IP_DROP_SOURCE_MEMBERSHIP;
+
+        if (setsockopt(fd, IPPROTO_IP, opt, &mreq, sizeof(mreq)) == -1) {
+            roc_log(LogError, "udp receiver: can't set source membership: %s",
+                    core::errno_to_str(errno).c_str());
+            return false;
+        }
+
+        return true;
+#endif // defined(IP_ADD_SOURCE_MEMBERSHIP)
+    } else {
+#if defined(MCAST_JOIN_SOURCE_GROUP)
+        group_source_req req;
+        memset(&req, 0, sizeof(req));
+
+        // IPv6 interfaces are identified by index
+        if (config_.multicast_interface.valid()) {
+            unsigned index = 0;
+            if (!get_interface_index(config_.multicast_interface, index)) {
+                return false;
+            }
+            req.gsr_interface = index;
+        }
+
+        memcpy(&req.gsr_group, address_.saddr(), address_.slen());
+        memcpy(&req.gsr_source, config_.multicast_source.saddr(),
+               config_.multicast_source.slen());
+
+        const int opt = membership == UV_JOIN_GROUP ? MCAST_JOIN_SOURCE_GROUP
+                                                    : MCAST_LEAVE_SOURCE_GROUP;
+
+        if (setsockopt(fd, IPPROTO_IPV6, opt, &req, sizeof(req)) == -1) {
+            roc_log(LogError, "udp receiver: can't set source membership: %s",
+                    core::errno_to_str(errno).c_str());
+            return false;
+        }
+
+        return true;
+#endif // defined(MCAST_JOIN_SOURCE_GROUP)
+    }
+
+    roc_log(LogError, "udp receiver: source-specific multicast is not supported");
+    return false;
+}
+
+size_t UDPReceiver::kernel_drops_() const {
+#if defined(__linux__) && defined(SO_MEMINFO)
+    // libuv doesn't provide control messages to the receive callback, so the
+    // SO_RXQ_OVFL counter can't be read from received packets. Instead, the same
+    // socket drop counter is queried separately. SK_MEMINFO_DROPS is an enum
+    // value, so it can't be checked by the preprocessor.
+    if (!handle_initialized_) {
+        return 0;
+    }
+
+    uv_os_fd_t fd;
+    if (uv_fileno((const uv_handle_t*)&handle_, &fd) != 0) {
+        return 0;
+    }
+
+    uint32_t meminfo[SK_MEMINFO_VARS] = {};
+    socklen_t len = sizeof(meminfo);
+
+    if (getsockopt(fd, SOL_SOCKET, SO_MEMINFO, meminfo, &len) == -1
+        || len <= SK_MEMINFO_DROPS * sizeof(uint32_t)) {
+        return 0;
+    }
+
+    return meminfo[SK_MEMINFO_DROPS];
+#else  // !defined(__linux__) || !defined(SO_MEMINFO)
+    return 0;
+#endif // defined(__linux__) && defined(SO_MEMINFO)
+}
+
+void UDPReceiver::enable_timestamps_() {
+#if defined(SO_TIMESTAMPNS) && defined(SIOCGSTAMPNS)
+    uv_os_fd_t fd;
+    if (int err = uv_fileno((uv_handle_t*)&handle_, &fd)) {
+        roc_log(LogDebug, "udp receiver: uv_fileno(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return;
+    }
+
+    int enable = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) == -1) {
+        roc_log(LogDebug,
+                "udp receiver: can't enable kernel timestamps, using read time instead");
+        return;
+    }
+
+    kernel_timestamps_ = true;
+#endif // defined(SO_TIMESTAMPNS) && defined(SIOCGSTAMPNS)
+}
+
+core::nanoseconds_t UDPReceiver::receive_timestamp_() {
+    const core::nanoseconds_t read_time = core::timestamp();
+
+#if defined(SO_TIMESTAMPNS) && defined(SIOCGSTAMPNS)
+    // libuv doesn't provide control messages to the receive callback, but the
+    // kernel timestamp of the last packet read from the socket may be queried
+    // separately. It uses the realtime clock, so we convert it to the time
+    // spent in the socket queue and subtract it from the monotonic read time.
+    if (kernel_timestamps_) {
+        uv_os_fd_t fd;
+        timespec kernel_ts, now_ts;
+
+        if (uv_fileno((uv_handle_t*)&handle_, &fd) != 0
+            || ioctl(fd, SIOCGSTAMPNS, &kernel_ts) == -1
+            || clock_gettime(CLOCK_REALTIME, &now_ts) == -1) {
+            roc_log(LogDebug,
+                    "udp receiver: can't get kernel timestamp, using read time instead");
+            kernel_timestamps_ = false;
+            return read_time;
+        }
+
+        const core::nanoseconds_t socket_delay =
+            (core::nanoseconds_t(now_ts.tv_sec) - kernel_ts.tv_sec) * core::Second
+            + (core::nanoseconds_t(now_ts.tv_nsec) - kernel_ts.tv_nsec);
+
+        if (socket_delay >= 0 && socket_delay < MaxSocketDelay) {
+            return read_time - socket_delay;
+        }
+    }
+#endif // defined(SO_TIMESTAMPNS) && defined(SIOCGSTAMPNS)
+
+    return read_time;
+}
+
 } // namespace netio
 } // namespace roc
@@ -19,6 +19,8 @@
 #include "roc_core/list.h"
 #include "roc_core/list_node.h"
 #include "roc_core/refcnt.h"
+#include "roc_core/time.h"
+#include "roc_netio/socket_options.h"
 #include "roc_packet/address.h"
 #include "roc_packet/iwriter.h"
 #include "roc_packet/packet_pool.h"
@@ -26,11 +28,56 @@
 namespace roc {
 namespace netio {
 
+//! UDP receiver parameters.
+struct UDPReceiverConfig {
+    //! Interface for joining multicast group.
+    //! @remarks
+    //!  Only IP address is used. If invalid, the system default is used. For
+    //!  IPv6, the local interface with this address is looked up by index.
+    packet::Address multicast_interface;
+
+    //! Multicast source address.
+    //! @remarks
+    //!  Only IP address is used. If valid, source-specific multicast is used,
+    //!  i.e. only packets from this source are received from the group.
+    packet::Address multicast_source;
+
+    //! Socket options.
+    SocketOptions socket_options;
+};
+
+//! UDP receiver statistics.
+struct UDPReceiverStats {
+    //! Number of packets read from the socket.
+    size_t n_packets;
+
+    //! Number of packets dropped by the kernel.
+    //! @remarks
+    //!  Counts packets dropped because the socket receive buffer was full,
+    //!  i.e. the value reported by SO_RXQ_OVFL. Zero if not supported.
+    size_t n_kernel_drops;
+
+    UDPReceiverStats()
+        : n_packets(0)
+        , n_kernel_drops(0) {
+    }
+};
+
 //! UDP receiver.
+//! @remarks
+//!  If the bind address is a multicast address, the receiver joins this
+//!  multicast group when started and leaves it when stopped. Multicast
+//!  options from the config are ignored for other addresses.
+//!
+//!  Every received packet is stamped with its receive time. When supported by
+//!  the OS, the time when the kernel received the packet is used, so that the
+//!  time spent in the socket queue is not counted as network jitter. Otherwise,
+//!  the time when the packet was read from the socket is used.
 class UDPReceiver : public core::RefCnt<UDPReceiver>, public core::ListNode {
 public:
     //! Initialize.
     UDPReceiver(uv_loop_t& event_loop,
+                const UDPReceiverConfig& config,
                 packet::IWriter& writer,
                 packet::PacketPool& packet_pool,
                 core::BufferPool<uint8_t>& buffer_pool,
@@ -57,6 +104,11 @@ public:
     //! Get bind address.
     const packet::Address& address() const;
 
+    //! Get statistics.
+    //! @remarks
+    //!  Should be called from the event loop thread.
+    void get_stats(UDPReceiverStats& stats) const;
+
 private:
     static void close_cb_(uv_handle_t* handle);
     static void alloc_cb_(uv_handle_t* handle, size_t size, uv_buf_t* buf);
@@ -70,12 +122,27 @@ private:
 
     void destroy();
 
+    bool join_multicast_group_();
+    void leave_multicast_group_();
+    bool set_membership_(uv_membership membership);
+    bool set_ipv6_membership_(uv_membership membership);
+    bool set_source_membership_(uv_membership membership);
+
+    size_t kernel_drops_() const;
+
+    void enable_timestamps_();
+    core::nanoseconds_t receive_timestamp_();
+
     core::IAllocator& allocator_;
 
     uv_loop_t& loop_;
 
     uv_udp_t handle_;
     bool handle_initialized_;
+    bool kernel_timestamps_;
+
+    const UDPReceiverConfig config_;
+    bool multicast_joined_;
 
     packet::Address address_;
     packet::IWriter& writer_;
@@ -6,28 +6,72 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <time.h>
+
+#if defined(__linux__)
+#include <linux/net_tstamp.h>
+#include <linux/sockios.h>
+#endif
+
 #include "roc_netio/udp_sender.h"
+#include "roc_core/errno_to_str.h"
 #include "roc_core/helpers.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_packet/address_to_str.h"
 
+#if defined(SO_TXTIME) && defined(SCM_TXTIME) && defined(CLOCK_TAI)
+#define ROC_NETIO_TXTIME
+#endif
+
 namespace roc {
 namespace netio {
 
-UDPSender::UDPSender(uv_loop_t& event_loop, core::IAllocator& allocator)
+namespace {
+
+// The timer is armed this much before the packet send time, to compensate
+// millisecond granularity of libuv timers. The rest is waited by polling the
+// event loop, so that other ports are still served.
+const core::nanoseconds_t TimerAdvance = core::Millisecond;
+
+// The network thread spins at most this much before the packet send time.
+// Should be small, because the event loop is blocked while spinning.
+const core::nanoseconds_t SpinDuration = 5 * core::Microsecond;
+
+// If a packet should still be held by the kernel for at least this much, but
+// it has already left the socket, the kernel doesn't honor SO_TXTIME, which
+// happens when the ETF queuing discipline isn't configured.
+const core::nanoseconds_t TxtimeCheckAdvance = core::Millisecond;
+
+} // namespace
+
+UDPSender::UDPSender(uv_loop_t& event_loop,
+                     const UDPSenderConfig& config,
+                     core::IAllocator& allocator)
     : allocator_(allocator)
     , loop_(event_loop)
     , write_sem_initialized_(false)
     , handle_initialized_(false)
+    , timer_initialized_(false)
+    , idle_initialized_(false)
+    , config_(config)
+    , txtime_(false)
+    , txtime_checked_(false)
+    , last_txtime_(0)
     , pending_(0)
     , stopped_(true)
     , container_(NULL)
-    , packet_counter_(0) {
+    , packet_counter_(0)
+    , num_dropped_packets_(0) {
 }
 
 UDPSender::~UDPSender() {
-    if (handle_initialized_ || write_sem_initialized_) {
+    if (handle_initialized_ || write_sem_initialized_ || timer_initialized_
+        || idle_initialized_) {
         roc_panic("udp sender: sender was not fully closed before calling destructor");
     }
 }
@@ -55,6 +99,24 @@ bool UDPSender::start(packet::Address& bind_address) {
     handle_.data = this;
     handle_initialized_ = true;
 
+    if (int err = uv_timer_init(&loop_, &timer_)) {
+        roc_log(LogError, "udp sender: uv_timer_init(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    timer_.data = this;
+    timer_initialized_ = true;
+
+    if (int err = uv_idle_init(&loop_, &idle_)) {
+        roc_log(LogError, "udp sender: uv_idle_init(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    idle_.data = this;
+    idle_initialized_ = true;
+
     unsigned flags = 0;
     if (bind_address.port() > 0) {
         flags |= UV_UDP_REUSEADDR;
@@ -80,6 +142,18 @@ bool UDPSender::start(packet::Address& bind_address) {
         return false;
     }
 
+    if (!set_socket_options(handle_, bind_address.version(), config_.socket_options)) {
+        return false;
+    }
+
+    if (!set_multicast_options_()) {
+        return false;
+    }
+
+    if (config_.txtime) {
+        txtime_ = enable_txtime_();
+    }
+
     roc_log(LogInfo, "udp sender: opened port %s",
             packet::address_to_str(bind_address).c_str());
 
@@ -93,6 +167,11 @@ void UDPSender::stop() {
 
     stopped_ = true;
 
+    while (packet::PacketPtr pp = paced_list_.front()) {
+        paced_list_.remove(*pp);
+        --pending_;
+    }
+
     if (pending_ == 0) {
         close_();
     }
@@ -101,7 +180,8 @@ void UDPSender::stop() {
 void UDPSender::remove(core::List<UDPSender>& container) {
     roc_panic_if(container_);
 
-    if (handle_initialized_ || write_sem_initialized_) {
+    if (handle_initialized_ || write_sem_initialized_ || timer_initialized_
+        || idle_initialized_) {
         stop();
         container_ = &container;
         address_ = packet::Address();
@@ -144,6 +224,10 @@ void UDPSender::write(const packet::PacketPtr& pp) {
     }
 }
 
+size_t UDPSender::num_dropped_packets() const {
+    return (size_t)(long)num_dropped_packets_;
+}
+
 void UDPSender::close_cb_(uv_handle_t* handle) {
     roc_panic_if_not(handle);
 
@@ -151,11 +235,16 @@ void UDPSender::close_cb_(uv_handle_t* handle) {
 
     if (handle == (uv_handle_t*)&self.handle_) {
         self.handle_initialized_ = false;
+    } else if (handle == (uv_handle_t*)&self.timer_) {
+        self.timer_initialized_ = false;
+    } else if (handle == (uv_handle_t*)&self.idle_) {
+        self.idle_initialized_ = false;
     } else {
         self.write_sem_initialized_ = false;
     }
 
-    if (self.handle_initialized_ || self.write_sem_initialized_) {
+    if (self.handle_initialized_ || self.write_sem_initialized_
+        || self.timer_initialized_ || self.idle_initialized_) {
         return;
     }
 
@@ -170,30 +259,33 @@ void UDPSender::write_sem_cb_(uv_async_t* handle) {
     UDPSender& self = *(UDPSender*)handle->data;
 
     while (packet::PacketPtr pp = self.read_()) {
-        packet::UDP& udp = *pp->udp();
+        if (pp->udp()->send_time == 0 && self.paced_list_.size() == 0) {
+            self.send_(pp);
+        } else if (self.txtime_ && self.paced_list_.size() == 0
+                   && self.send_txtime_(pp)) {
+            continue;
+        } else {
+            self.paced_list_.push_back(*pp);
+        }
+    }
 
-        self.packet_counter_++;
+    self.send_paced_();
+}
 
-        roc_log(LogTrace, "udp sender: sending packet: num=%u src=%s dst=%s sz=%ld",
-                self.packet_counter_, packet::address_to_str(self.address_).c_str(),
-                packet::address_to_str(udp.dst_addr).c_str(), (long)pp->data().size());
+void UDPSender::timer_cb_(uv_timer_t* handle) {
+    roc_panic_if_not(handle);
+
+    UDPSender& self = *(UDPSender*)handle->data;
 
-        uv_buf_t buf;
-        buf.base = (char*)pp->data().data();
-        buf.len = pp->data().size();
+    self.send_paced_();
+}
 
-        udp.request.data = &self;
+void UDPSender::idle_cb_(uv_idle_t* handle) {
+    roc_panic_if_not(handle);
 
-        if (int err = uv_udp_send(&udp.request, &self.handle_, &buf, 1,
-                                  udp.dst_addr.saddr(), send_cb_)) {
-            roc_log(LogError, "udp sender: uv_udp_send(): [%s] %s", uv_err_name(err),
-                    uv_strerror(err));
-            continue;
-        }
+    UDPSender& self = *(UDPSender*)handle->data;
 
-        // will be decremented in send_cb_()
-        pp->incref();
-    }
+    self.send_paced_();
 }
 
 void UDPSender::send_cb_(uv_udp_send_t* req, int status) {
@@ -218,15 +310,10 @@ void UDPSender::send_cb_(uv_udp_send_t* req, int status) {
                 packet::address_to_str(self.address_).c_str(),
                 packet::address_to_str(pp->udp()->dst_addr).c_str(),
                 (long)pp->data().size(), uv_err_name(status), uv_strerror(status));
+        ++self.num_dropped_packets_;
     }
 
-    core::Mutex::Lock lock(self.mutex_);
-
-    --self.pending_;
-
-    if (self.stopped_ && self.pending_ == 0) {
-        self.close_();
-    }
+    self.finish_send_();
 }
 
 packet::PacketPtr UDPSender::read_() {
@@ -251,6 +338,290 @@ void UDPSender::close_() {
     if (write_sem_initialized_ && !uv_is_closing((uv_handle_t*)&write_sem_)) {
         uv_close((uv_handle_t*)&write_sem_, close_cb_);
     }
+
+    if (timer_initialized_ && !uv_is_closing((uv_handle_t*)&timer_)) {
+        uv_close((uv_handle_t*)&timer_, close_cb_);
+    }
+
+    if (idle_initialized_ && !uv_is_closing((uv_handle_t*)&idle_)) {
+        uv_close((uv_handle_t*)&idle_, close_cb_);
+    }
+}
+
+bool UDPSender::set_multicast_options_() {
+    if (config_.multicast_ttl != 0) {
+        if (int err = uv_udp_set_multicast_ttl(&handle_, config_.multicast_ttl)) {
+            roc_log(LogError, "udp sender: uv_udp_set_multicast_ttl(): [%s] %s",
+                    uv_err_name(err), uv_strerror(err));
+            return false;
+        }
+    }
+
+    // libuv can't pass interface index for IPv6
+    if (config_.multicast_interface.valid()
+        && config_.multicast_interface.version() == 6) {
+        unsigned index = 0;
+        if (!get_interface_index(config_.multicast_interface, index)) {
+            return false;
+        }
+
+        uv_os_fd_t fd;
+        if (int err = uv_fileno((uv_handle_t*)&handle_, &fd)) {
+            roc_log(LogError, "udp sender: uv_fileno(): [%s] %s", uv_err_name(err),
+                    uv_strerror(err));
+            return false;
+        }
+
+        if (setsockopt(fd, IPPROTO_IPV6, IPV6_MULTICAST_IF, &index, sizeof(index))
+            == -1) {
+            roc_log(LogError, "udp sender: setsockopt(IPV6_MULTICAST_IF): %s",
+                    core::errno_to_str(errno).c_str());
+            return false;
+        }
+    } else if (config_.multicast_interface.valid()) {
+        char ip[64];
+        if (!config_.multicast_interface.get_ip(ip, sizeof(ip))) {
+            roc_log(LogError, "udp sender: can't format multicast interface address");
+            return false;
+        }
+
+        if (int err = uv_udp_set_multicast_interface(&handle_, ip)) {
+            roc_log(LogError, "udp sender: uv_udp_set_multicast_interface(): [%s] %s",
+                    uv_err_name(err), uv_strerror(err));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool UDPSender::enable_txtime_() {
+#if defined(ROC_NETIO_TXTIME)
+    uv_os_fd_t fd;
+    if (int err = uv_fileno((uv_handle_t*)&handle_, &fd)) {
+        roc_log(LogError, "udp sender: uv_fileno(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    sock_txtime cfg;
+    cfg.clockid = CLOCK_TAI;
+    cfg.flags = 0;
+
+    if (setsockopt(fd, SOL_SOCKET, SO_TXTIME, &cfg, sizeof(cfg)) == -1) {
+        roc_log(LogInfo,
+                "udp sender: setsockopt(SO_TXTIME): %s:"
+                " falling back to pacing in network thread",
+                core::errno_to_str(errno).c_str());
+        return false;
+    }
+
+    // the kernel accepts SO_TXTIME even if the outgoing interface doesn't use
+    // the ETF queuing discipline, so it's checked later by check_txtime_()
+    roc_log(LogDebug, "udp sender: enabled SO_TXTIME");
+    return true;
+#else  // !defined(ROC_NETIO_TXTIME)
+    roc_log(LogInfo,
+            "udp sender: SO_TXTIME is not supported:"
+            " falling back to pacing in network thread");
+    return false;
+#endif // defined(ROC_NETIO_TXTIME)
+}
+
+void UDPSender::send_paced_() {
+    while (packet::PacketPtr pp = paced_list_.front()) {
+        const core::nanoseconds_t send_time = pp->udp()->send_time;
+        const core::nanoseconds_t now = core::timestamp();
+
+        if (send_time - now > TimerAdvance) {
+            stop_idle_();
+
+            const uint64_t timeout =
+                uint64_t((send_time - now - TimerAdvance) / core::Millisecond);
+
+            // timer timeout is relative to the cached loop time
+            uv_update_time(&loop_);
+
+            if (int err = uv_timer_start(&timer_, timer_cb_, timeout, 0)) {
+                roc_panic("udp sender: uv_timer_start(): [%s] %s", uv_err_name(err),
+                          uv_strerror(err));
+            }
+            return;
+        }
+
+        if (send_time - now > SpinDuration) {
+            // idle handle makes the event loop poll without blocking and
+            // invoke idle_cb_() on every iteration, after other events
+            if (int err = uv_idle_start(&idle_, idle_cb_)) {
+                roc_panic("udp sender: uv_idle_start(): [%s] %s", uv_err_name(err),
+                          uv_strerror(err));
+            }
+            return;
+        }
+
+        while (core::timestamp() < send_time) {
+            // spin for at most SpinDuration
+        }
+
+        paced_list_.remove(*pp);
+        send_(pp);
+    }
+
+    stop_idle_();
+}
+
+void UDPSender::stop_idle_() {
+    if (int err = uv_idle_stop(&idle_)) {
+        roc_panic("udp sender: uv_idle_stop(): [%s] %s", uv_err_name(err),
+                  uv_strerror(err));
+    }
+}
+
+void UDPSender::send_(const packet::PacketPtr& pp) {
+    packet::UDP& udp = *pp->udp();
+
+    packet_counter_++;
+
+    roc_log(LogTrace, "udp sender: sending packet: num=%u src=%s dst=%s sz=%ld",
+            packet_counter_, packet::address_to_str(address_).c_str(),
+            packet::address_to_str(udp.dst_addr).c_str(), (long)pp->data().size());
+
+    uv_buf_t buf;
+    buf.base = (char*)pp->data().data();
+    buf.len = pp->data().size();
+
+    udp.request.data = this;
+
+    if (int err = uv_udp_send(&udp.request, &handle_, &buf, 1, udp.dst_addr.saddr(),
+                              send_cb_)) {
+        roc_log(LogError, "udp sender: uv_udp_send(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        ++num_dropped_packets_;
+        finish_send_();
+        return;
+    }
+
+    // will be decremented in send_cb_()
+    pp->incref();
+}
+
+bool UDPSender::send_txtime_(const packet::PacketPtr& pp) {
+#if defined(ROC_NETIO_TXTIME)
+    packet::UDP& udp = *pp->udp();
+
+    // packets queued by libuv would be sent after this one
+    if (handle_.send_queue_count != 0) {
+        return false;
+    }
+
+    uv_os_fd_t fd;
+    if (uv_fileno((uv_handle_t*)&handle_, &fd) != 0) {
+        return false;
+    }
+
+    if (!txtime_checked_) {
+        check_txtime_(fd);
+        if (!txtime_) {
+            return false;
+        }
+    }
+
+    timespec tai;
+    if (clock_gettime(CLOCK_TAI, &tai) == -1) {
+        return false;
+    }
+
+    // convert send time from the monotonic clock to CLOCK_TAI
+    const uint64_t txtime = uint64_t(udp.send_time - core::timestamp()
+                                     + core::nanoseconds_t(tai.tv_sec) * core::Second
+                                     + core::nanoseconds_t(tai.tv_nsec));
+
+    iovec iov;
+    iov.iov_base = pp->data().data();
+    iov.iov_len = pp->data().size();
+
+    char control[CMSG_SPACE(sizeof(txtime))];
+    memset(control, 0, sizeof(control));
+
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = (void*)udp.dst_addr.saddr();
+    msg.msg_namelen = (socklen_t)udp.dst_addr.slen();
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_TXTIME;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(txtime));
+    memcpy(CMSG_DATA(cmsg), &txtime, sizeof(txtime));
+
+    if (sendmsg(fd, &msg, 0) == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+            // socket buffer is full; let libuv retry when it's writable
+            return false;
+        }
+        roc_log(LogError, "udp sender: sendmsg(SCM_TXTIME): %s",
+                core::errno_to_str(errno).c_str());
+        ++num_dropped_packets_;
+    } else {
+        packet_counter_++;
+
+        roc_log(LogTrace,
+                "udp sender: sent packet with txtime: num=%u src=%s dst=%s sz=%ld",
+                packet_counter_, packet::address_to_str(address_).c_str(),
+                packet::address_to_str(udp.dst_addr).c_str(), (long)pp->data().size());
+
+        last_txtime_ = udp.send_time;
+    }
+
+    finish_send_();
+    return true;
+#else  // !defined(ROC_NETIO_TXTIME)
+    (void)pp;
+    return false;
+#endif // defined(ROC_NETIO_TXTIME)
+}
+
+void UDPSender::check_txtime_(int fd) {
+#if defined(SIOCOUTQ)
+    // wait until the previous packet should be held long enough
+    if (last_txtime_ == 0 || last_txtime_ - core::timestamp() < TxtimeCheckAdvance) {
+        return;
+    }
+
+    txtime_checked_ = true;
+
+    int n_unsent = 0;
+    if (ioctl(fd, SIOCOUTQ, &n_unsent) == -1) {
+        roc_log(LogDebug, "udp sender: ioctl(SIOCOUTQ): %s",
+                core::errno_to_str(errno).c_str());
+        return;
+    }
+
+    if (n_unsent == 0) {
+        roc_log(LogError,
+                "udp sender: kernel sends packets before their SO_TXTIME,"
+                " probably ETF qdisc is not configured:"
+                " falling back to pacing in network thread");
+        txtime_ = false;
+    }
+#else  // !defined(SIOCOUTQ)
+    (void)fd;
+    txtime_checked_ = true;
+#endif // defined(SIOCOUTQ)
+}
+
+void UDPSender::finish_send_() {
+    core::Mutex::Lock lock(mutex_);
+
+    --pending_;
+
+    if (stopped_ && pending_ == 0) {
+        close_();
+    }
 }
 
 } // namespace netio
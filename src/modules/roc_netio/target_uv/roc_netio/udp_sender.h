@@ -14,24 +14,65 @@
 
 #include <uv.h>
 
+#include "roc_core/atomic.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list.h"
 #include "roc_core/list_node.h"
 #include "roc_core/mutex.h"
 #include "roc_core/refcnt.h"
+#include "roc_core/time.h"
+#include "roc_netio/socket_options.h"
 #include "roc_packet/address.h"
 #include "roc_packet/iwriter.h"
 
 namespace roc {
 namespace netio {
 
+//! UDP sender parameters.
+struct UDPSenderConfig {
+    //! Pass packet send time to the kernel.
+    //! @remarks
+    //!  Uses SO_TXTIME with CLOCK_TAI, which requires Linux and the ETF
+    //!  queuing discipline configured on the outgoing interface. If SO_TXTIME
+    //!  is not supported, or if the kernel is found to send packets before
+    //!  their send time, packets are released by the network thread.
+    bool txtime;
+
+    //! TTL of outgoing multicast packets.
+    //! @remarks
+    //!  If zero, the system default is used, which is usually 1, i.e. multicast
+    //!  packets don't leave the local network.
+    int multicast_ttl;
+
+    //! Interface for outgoing multicast packets.
+    //! @remarks
+    //!  Only IP address is used. If invalid, the system default is used. For
+    //!  IPv6, the local interface with this address is looked up by index.
+    packet::Address multicast_interface;
+
+    //! Socket options.
+    SocketOptions socket_options;
+
+    UDPSenderConfig()
+        : txtime(false)
+        , multicast_ttl(0) {
+    }
+};
+
 //! UDP sender.
+//! @remarks
+//!  Packets with non-zero send time are not sent before that time. If the
+//!  kernel can't release packets by itself, the network thread uses a timer
+//!  to wake up shortly before the send time, then polls the event loop
+//!  without blocking it, and spins only for the last few microseconds.
 class UDPSender : public core::RefCnt<UDPSender>,
                   public core::ListNode,
                   public packet::IWriter {
 public:
     //! Initialize.
-    UDPSender(uv_loop_t& event_loop, core::IAllocator& allocator);
+    UDPSender(uv_loop_t& event_loop,
+              const UDPSenderConfig& config,
+              core::IAllocator& allocator);
 
     //! Destroy.
     ~UDPSender();
@@ -59,9 +100,16 @@ public:
     //!  May be called from any thread.
     virtual void write(const packet::PacketPtr&);
 
+    //! Get number of packets that failed to be sent.
+    //! @remarks
+    //!  May be called from any thread.
+    size_t num_dropped_packets() const;
+
 private:
     static void close_cb_(uv_handle_t* handle);
     static void write_sem_cb_(uv_async_t* handle);
+    static void timer_cb_(uv_timer_t* handle);
+    static void idle_cb_(uv_idle_t* handle);
     static void send_cb_(uv_udp_send_t* req, int status);
 
     friend class core::RefCnt<UDPSender>;
@@ -71,6 +119,16 @@ private:
     packet::PacketPtr read_();
     void close_();
 
+    bool enable_txtime_();
+    bool set_multicast_options_();
+
+    void send_paced_();
+    void stop_idle_();
+    void send_(const packet::PacketPtr& pp);
+    bool send_txtime_(const packet::PacketPtr& pp);
+    void check_txtime_(int fd);
+    void finish_send_();
+
     core::IAllocator& allocator_;
 
     uv_loop_t& loop_;
@@ -81,17 +139,31 @@ private:
     uv_udp_t handle_;
     bool handle_initialized_;
 
+    uv_timer_t timer_;
+    bool timer_initialized_;
+
+    uv_idle_t idle_;
+    bool idle_initialized_;
+
+    const UDPSenderConfig config_;
+    bool txtime_;
+    bool txtime_checked_;
+    core::nanoseconds_t last_txtime_;
+
     packet::Address address_;
 
     core::List<packet::Packet> list_;
     core::Mutex mutex_;
 
+    core::List<packet::Packet> paced_list_;
+
     size_t pending_;
     bool stopped_;
 
     core::List<UDPSender>* container_;
 
     unsigned packet_counter_;
+    core::Atomic num_dropped_packets_;
 };
 
 } // namespace netio
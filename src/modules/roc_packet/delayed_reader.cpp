@@ -39,6 +39,11 @@ PacketPtr DelayedReader::read() {
     return reader_.read();
 }
 
+void DelayedReader::reset() {
+    queue_.reset();
+    started_ = false;
+}
+
 bool DelayedReader::fetch_packets_() {
     while (PacketPtr pp = reader_.read()) {
         queue_.write(pp);
@@ -37,6 +37,11 @@ public:
     //! Read packet.
     virtual PacketPtr read();
 
+    //! Reset to initial state.
+    //! @remarks
+    //!  Drops delayed packets; the delay is inserted again before next packet.
+    void reset();
+
 private:
     bool fetch_packets_();
     PacketPtr read_queued_packet_();
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2015 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/diagonal_interleaver.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+DiagonalInterleaver::DiagonalInterleaver(IWriter& writer,
+                                         core::IAllocator& allocator,
+                                         size_t block_size,
+                                         size_t depth)
+    : writer_(writer)
+    , depth_(depth)
+    , spacing_(0)
+    , packets_(allocator)
+    , cur_slot_(0)
+    , valid_(false) {
+    roc_panic_if(block_size == 0);
+    roc_panic_if(depth == 0);
+
+    // Lane delay should be a multiple of depth, so that lanes never collide,
+    // and should exceed block size, so that consecutive output packets are
+    // always from different blocks.
+    spacing_ = (block_size / depth_ + 1) * depth_;
+
+    if (!packets_.resize((depth_ - 1) * spacing_ + 1)) {
+        return;
+    }
+
+    roc_log(LogDebug,
+            "initializing diagonal interleaver: block_size=%u depth=%u delay=%u",
+            (unsigned)block_size, (unsigned)depth_, (unsigned)delay());
+
+    valid_ = true;
+}
+
+bool DiagonalInterleaver::valid() const {
+    return valid_;
+}
+
+void DiagonalInterleaver::write(const PacketPtr& p) {
+    roc_panic_if_not(valid());
+
+    const size_t lane = cur_slot_ % depth_;
+    const size_t pos = (cur_slot_ + lane * spacing_) % packets_.size();
+
+    roc_panic_if(packets_[pos]);
+    packets_[pos] = p;
+
+    const size_t out_pos = cur_slot_ % packets_.size();
+
+    if (packets_[out_pos]) {
+        writer_.write(packets_[out_pos]);
+        packets_[out_pos] = NULL;
+    }
+
+    cur_slot_++;
+}
+
+void DiagonalInterleaver::flush() {
+    roc_panic_if_not(valid());
+
+    for (size_t i = 0; i < packets_.size(); ++i) {
+        const size_t pos = (cur_slot_ + i) % packets_.size();
+
+        if (packets_[pos]) {
+            writer_.write(packets_[pos]);
+            packets_[pos] = NULL;
+        }
+    }
+
+    cur_slot_ = 0;
+}
+
+size_t DiagonalInterleaver::delay() const {
+    return packets_.size() - 1;
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2015 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/diagonal_interleaver.h
+//! @brief Spreads packets across multiple FEC blocks.
+
+#ifndef ROC_PACKET_DIAGONAL_INTERLEAVER_H_
+#define ROC_PACKET_DIAGONAL_INTERLEAVER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+
+namespace roc {
+namespace packet {
+
+//! Block-diagonal (convolutional) interleaver.
+//!
+//! @remarks
+//!  Input packets are distributed between @p depth lanes in round-robin
+//!  order. Lane @c i delays its packets by @c i*S slots, where @c S is the
+//!  smallest multiple of @p depth greater than @p block_size. Output packets
+//!  are taken from the lanes in the same order.
+//!
+//!  As a result, every @p depth consecutive output packets come from
+//!  different FEC blocks, so that a burst loss of @c B packets results in
+//!  at most about @c B/depth losses per block. The reordering is fixed and
+//!  the delay of every packet is bounded by delay().
+class DiagonalInterleaver : public IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p writer is used to write reordered packets
+    //!  - @p allocator is used to allocate the delay line
+    //!  - @p block_size is the number of source and repair packets in FEC block
+    //!  - @p depth is the number of FEC blocks to spread packets across
+    DiagonalInterleaver(IWriter& writer,
+                        core::IAllocator& allocator,
+                        size_t block_size,
+                        size_t depth);
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Write next packet.
+    //! @remarks
+    //!  Packet is placed into the delay line, and the packet which slot
+    //!  has come is written to output writer, if any.
+    virtual void write(const PacketPtr& packet);
+
+    //! Send all buffered packets to output writer.
+    void flush();
+
+    //! Maximum delay between writing packet and moment we get it in output
+    //! in terms of packets number.
+    size_t delay() const;
+
+private:
+    IWriter& writer_;
+
+    const size_t depth_;
+    size_t spacing_;
+
+    // Delay line indexed by output slot.
+    core::Array<PacketPtr> packets_;
+
+    size_t cur_slot_;
+
+    bool valid_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_DIAGONAL_INTERLEAVER_H_
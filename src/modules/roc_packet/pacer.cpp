@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/pacer.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+Pacer::Pacer(IWriter& writer, size_t sample_rate)
+    : writer_(writer)
+    , sample_rate_(sample_rate)
+    , base_time_(0)
+    , num_samples_(0)
+    , last_send_time_(0) {
+    roc_panic_if(sample_rate == 0);
+}
+
+void Pacer::set_min_send_time(core::nanoseconds_t time) {
+    if (next_send_time_() < time) {
+        base_time_ = time;
+        num_samples_ = 0;
+    }
+}
+
+void Pacer::set_max_send_time(core::nanoseconds_t time) {
+    if (next_send_time_() > time) {
+        base_time_ = time;
+        num_samples_ = 0;
+    }
+}
+
+void Pacer::write(const PacketPtr& packet) {
+    if (!packet) {
+        roc_panic("pacer: unexpected null packet");
+    }
+
+    core::nanoseconds_t send_time = last_send_time_;
+
+    if ((packet->flags() & Packet::FlagAudio) && packet->rtp()) {
+        send_time = next_send_time_();
+
+        num_samples_ += packet->rtp()->duration;
+
+        // move whole seconds to base time to keep the multiplication
+        // in next_send_time_() from overflowing on long streams
+        base_time_ += core::nanoseconds_t(num_samples_ / sample_rate_) * core::Second;
+        num_samples_ %= sample_rate_;
+    }
+
+    if (!packet->udp()) {
+        packet->add_flags(Packet::FlagUDP);
+    }
+    packet->udp()->send_time = send_time;
+
+    last_send_time_ = send_time;
+
+    writer_.write(packet);
+}
+
+core::nanoseconds_t Pacer::next_send_time_() const {
+    return base_time_
+        + core::nanoseconds_t(num_samples_) * core::Second
+        / core::nanoseconds_t(sample_rate_);
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/pacer.h
+//! @brief Packet pacer.
+
+#ifndef ROC_PACKET_PACER_H_
+#define ROC_PACKET_PACER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+
+namespace roc {
+namespace packet {
+
+//! Assigns send time to packets.
+//! @remarks
+//!  Audio packets are scheduled one after another, each one delayed from the
+//!  previous one by the previous packet duration. Other packets, e.g. FEC
+//!  repair packets, are scheduled together with the last audio packet. The
+//!  schedule is computed from the total number of samples, so rounding errors
+//!  don't accumulate.
+//!
+//!  The send time is stored in the UDP part of the packet; it's then up to
+//!  the network sender to release the packet at that time.
+class Pacer : public IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  Packets are written to @p writer. @p sample_rate defines the units of
+    //!  RTP timestamps and durations.
+    Pacer(IWriter& writer, size_t sample_rate);
+
+    //! Set the earliest send time for subsequent packets.
+    //! @remarks
+    //!  If the schedule is behind @p time, e.g. because there was a pause in
+    //!  the stream, it's restarted from @p time.
+    void set_min_send_time(core::nanoseconds_t time);
+
+    //! Set the latest send time for subsequent packets.
+    //! @remarks
+    //!  If the schedule is ahead of @p time, e.g. because packets are written
+    //!  faster than real time, it's restarted from @p time. This keeps the
+    //!  number of packets waiting for their send time bounded.
+    void set_max_send_time(core::nanoseconds_t time);
+
+    //! Write packet.
+    virtual void write(const PacketPtr& packet);
+
+private:
+    core::nanoseconds_t next_send_time_() const;
+
+    IWriter& writer_;
+
+    const size_t sample_rate_;
+
+    core::nanoseconds_t base_time_;
+    size_t num_samples_;
+
+    core::nanoseconds_t last_send_time_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_PACER_H_
@@ -15,6 +15,7 @@ namespace packet {
 
 Router::Router(core::IAllocator& allocator, size_t max_routes)
     : routes_(allocator)
+    , num_dropped_(0)
     , valid_(false) {
     if (!routes_.grow(max_routes)) {
         return;
@@ -82,6 +83,22 @@ void Router::write(const PacketPtr& packet) {
     }
 
     roc_log(LogDebug, "router: can't route packet, dropping");
+    num_dropped_++;
+}
+
+size_t Router::num_dropped() const {
+    return num_dropped_;
+}
+
+void Router::reset() {
+    roc_panic_if_not(valid());
+
+    for (size_t n = 0; n < routes_.size(); n++) {
+        routes_[n].source = 0;
+        routes_[n].has_source = false;
+    }
+
+    num_dropped_ = 0;
 }
 
 } // namespace packet
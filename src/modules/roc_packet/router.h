@@ -41,6 +41,14 @@ public:
     //!  Route @p packet to a writer or drop it if no routes found.
     virtual void write(const PacketPtr& packet);
 
+    //! Get number of packets dropped because no route was found.
+    size_t num_dropped() const;
+
+    //! Forget detected streams and reset counters.
+    //! @remarks
+    //!  Routes are kept.
+    void reset();
+
 private:
     struct Route {
         IWriter* writer;
@@ -51,6 +59,8 @@ private:
 
     core::Array<Route> routes_;
 
+    size_t num_dropped_;
+
     bool valid_;
 };
 
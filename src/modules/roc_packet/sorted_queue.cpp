@@ -14,7 +14,9 @@ namespace roc {
 namespace packet {
 
 SortedQueue::SortedQueue(size_t max_size)
-    : max_size_(max_size) {
+    : max_size_(max_size)
+    , num_duplicates_(0)
+    , num_overflows_(0) {
 }
 
 PacketPtr SortedQueue::read() {
@@ -36,6 +38,7 @@ void SortedQueue::write(const PacketPtr& packet) {
                 "sorted queue: queue is full, dropping packet:"
                 " max_size=%u",
                 (unsigned)max_size_);
+        num_overflows_++;
         return;
     }
 
@@ -54,6 +57,7 @@ void SortedQueue::write(const PacketPtr& packet) {
 
         if (cmp == 0) {
             roc_log(LogDebug, "sorted queue: dropping duplicate packet");
+            num_duplicates_++;
             return;
         }
 
@@ -71,6 +75,25 @@ size_t SortedQueue::size() const {
     return list_.size();
 }
 
+void SortedQueue::reset() {
+    while (PacketPtr packet = list_.front()) {
+        list_.remove(*packet);
+    }
+
+    latest_ = NULL;
+
+    num_duplicates_ = 0;
+    num_overflows_ = 0;
+}
+
+size_t SortedQueue::num_duplicates() const {
+    return num_duplicates_;
+}
+
+size_t SortedQueue::num_overflows() const {
+    return num_overflows_;
+}
+
 PacketPtr SortedQueue::head() const {
     return list_.back();
 }
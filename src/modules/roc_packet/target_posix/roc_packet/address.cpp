@@ -113,6 +113,19 @@ bool Address::get_ip(char* buf, size_t bufsz) const {
     return true;
 }
 
+bool Address::multicast() const {
+    switch (family_()) {
+    case AF_INET:
+        return IN_MULTICAST(ntohl(sa_.addr4.sin_addr.s_addr));
+
+    case AF_INET6:
+        return IN6_IS_ADDR_MULTICAST(&sa_.addr6.sin6_addr);
+
+    default:
+        return false;
+    }
+}
+
 bool Address::operator==(const Address& other) const {
     if (family_() != other.family_()) {
         return false;
@@ -56,6 +56,9 @@ public:
     //! Get IP address.
     bool get_ip(char* buf, size_t bufsz) const;
 
+    //! Check if the IP address is a multicast address.
+    bool multicast() const;
+
     //! Compare addresses.
     bool operator==(const Address& other) const;
 
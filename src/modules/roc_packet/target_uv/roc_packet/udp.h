@@ -16,6 +16,7 @@
 
 #include "roc_core/slice.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 #include "roc_packet/address.h"
 
 namespace roc {
@@ -29,8 +30,26 @@ struct UDP {
     //! Destination address.
     Address dst_addr;
 
+    //! Packet receive timestamp, nanoseconds.
+    //! @remarks
+    //!  Time when the packet was received from network, in the same clock as
+    //!  core::timestamp(). Zero if the packet was not received from network.
+    core::nanoseconds_t receive_timestamp;
+
+    //! Packet send time, nanoseconds.
+    //! @remarks
+    //!  Time when the packet should be sent to network, in the same clock as
+    //!  core::timestamp(). Zero if the packet should be sent immediately.
+    core::nanoseconds_t send_time;
+
     //! Sender request state.
     uv_udp_send_t request;
+
+    //! Construct zero UDP packet.
+    UDP()
+        : receive_timestamp(0)
+        , send_time(0) {
+    }
 };
 
 } // namespace packet
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/timing_reader.h
+//! @brief Timing reader.
+
+#ifndef ROC_PACKET_TIMING_READER_H_
+#define ROC_PACKET_TIMING_READER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stage_timer.h"
+#include "roc_core/time_histogram.h"
+#include "roc_packet/ireader.h"
+
+namespace roc {
+namespace packet {
+
+//! Measures time spent reading packets.
+//! @remarks
+//!  Passes every call to the underlying reader and adds its duration, excluding
+//!  nested stages measured by the same timer, to the histogram.
+class TimingReader : public IReader, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    TimingReader(IReader& reader,
+                 core::TimeHistogram& histogram,
+                 core::StageTimer& timer);
+
+    //! Read next packet.
+    virtual PacketPtr read();
+
+private:
+    IReader& reader_;
+    core::TimeHistogram& histogram_;
+    core::StageTimer& timer_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_TIMING_READER_H_
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/timing_writer.h"
+
+namespace roc {
+namespace packet {
+
+TimingWriter::TimingWriter(IWriter& writer,
+                           core::TimeHistogram& histogram,
+                           core::StageTimer& timer)
+    : writer_(writer)
+    , histogram_(histogram)
+    , timer_(timer) {
+}
+
+void TimingWriter::write(const PacketPtr& packet) {
+    const core::nanoseconds_t outer = timer_.begin();
+    const core::nanoseconds_t start = core::timestamp();
+
+    writer_.write(packet);
+
+    histogram_.add(timer_.end(outer, core::timestamp() - start));
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/timing_writer.h
+//! @brief Timing writer.
+
+#ifndef ROC_PACKET_TIMING_WRITER_H_
+#define ROC_PACKET_TIMING_WRITER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stage_timer.h"
+#include "roc_core/time_histogram.h"
+#include "roc_packet/iwriter.h"
+
+namespace roc {
+namespace packet {
+
+//! Measures time spent writing packets.
+//! @remarks
+//!  Passes every call to the underlying writer and adds its duration, excluding
+//!  nested stages measured by the same timer, to the histogram.
+class TimingWriter : public IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    TimingWriter(IWriter& writer,
+                 core::TimeHistogram& histogram,
+                 core::StageTimer& timer);
+
+    //! Write packet.
+    virtual void write(const PacketPtr& packet);
+
+private:
+    IWriter& writer_;
+    core::TimeHistogram& histogram_;
+    core::StageTimer& timer_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_TIMING_WRITER_H_
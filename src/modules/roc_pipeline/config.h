@@ -13,6 +13,8 @@
 #define ROC_PIPELINE_CONFIG_H_
 
 #include "roc_audio/latency_monitor.h"
+#include "roc_audio/latency_tuner.h"
+#include "roc_audio/plc.h"
 #include "roc_audio/resampler.h"
 #include "roc_audio/watchdog.h"
 #include "roc_core/stddefs.h"
@@ -34,6 +36,9 @@ const packet::channel_mask_t DefaultChannelMask = 0x3;
 //! Default packet length.
 const core::nanoseconds_t DefaultPacketLength = 7 * core::Millisecond;
 
+//! Default packet length for Opus, which supports only a few frame lengths.
+const core::nanoseconds_t DefaultOpusPacketLength = 10 * core::Millisecond;
+
 //! Default internal frame size.
 const size_t DefaultInternalFrameSize = 640;
 
@@ -109,12 +114,39 @@ struct SenderConfig {
     //! Interleave packets.
     bool interleaving;
 
+    //! Number of FEC blocks to spread packets across when interleaving.
+    //! @remarks
+    //!  If zero, packets are shuffled randomly within a single FEC block.
+    //!  Otherwise, block-diagonal interleaving of the given depth is used.
+    size_t interleaving_depth;
+
     //! Constrain receiver speed using a CPU timer according to the sample rate.
     bool timing;
 
+    //! Assign send time to packets.
+    //! @remarks
+    //!  Packets are spread evenly according to their duration, and the network
+    //!  sender releases them at the assigned time instead of sending them in
+    //!  bursts as soon as they are produced. If frames are written faster
+    //!  than real time, the schedule is kept at most pacing_lead plus one
+    //!  packet ahead of the current time.
+    bool pacing;
+
+    //! How much earlier packets are produced than sent, nanoseconds.
+    //! @remarks
+    //!  Used when both timing and pacing are enabled. Packets are handed to
+    //!  the network sender this much ahead of their send time, so that late
+    //!  wakeups of the writing thread don't affect the send time.
+    core::nanoseconds_t pacing_lead;
+
     //! Fill unitialized data with large values to make them more noticable.
     bool poisoning;
 
+    //! Measure time spent in every pipeline stage.
+    //! @remarks
+    //!  If disabled, no timing stages are inserted into the pipeline.
+    bool profiling;
+
     SenderConfig()
         : input_sample_rate(DefaultSampleRate)
         , input_channels(DefaultChannelMask)
@@ -123,8 +155,12 @@ struct SenderConfig {
         , payload_type(rtp::PayloadType_L16_Stereo)
         , resampling(false)
         , interleaving(false)
+        , interleaving_depth(0)
         , timing(false)
-        , poisoning(false) {
+        , pacing(false)
+        , pacing_lead(2 * core::Millisecond)
+        , poisoning(false)
+        , profiling(false) {
     }
 };
 
@@ -156,12 +192,22 @@ struct ReceiverSessionConfig {
     //! Resampler parameters.
     audio::ResamplerConfig resampler;
 
+    //! Packet loss concealment parameters.
+    audio::PLCConfig plc;
+
+    //! Latency tuner parameters.
+    //! @remarks
+    //!  When enabled, the target latency is initially set to target_latency
+    //!  and is then adjusted within the tuner range.
+    audio::LatencyTunerConfig latency_tuner;
+
     ReceiverSessionConfig()
         : channels(DefaultChannelMask)
         , packet_length(DefaultPacketLength)
         , target_latency(200 * core::Millisecond) {
         latency_monitor.min_latency = target_latency * DefaultMinLatencyFactor;
         latency_monitor.max_latency = target_latency * DefaultMaxLatencyFactor;
+        latency_tuner.max_latency = target_latency;
     }
 };
 
@@ -208,6 +254,43 @@ struct ReceiverConfig {
 
     //! Parameters for receiver output.
     ReceiverOutputConfig output;
+
+    //! Number of threads for FEC decoding.
+    //! @remarks
+    //!  If zero, FEC decoding of all sessions is performed in the thread
+    //!  reading audio. Otherwise, it's dispatched to a pool of threads.
+    size_t fec_decoding_threads;
+
+    //! Number of session pipelines to keep constructed in advance.
+    //! @remarks
+    //!  The pool is filled with sessions for session_pool_payload_type when the
+    //!  receiver is created. When a session is terminated, it's reset and returned
+    //!  to the pool if the pool isn't full. A new sender is bound to a pooled
+    //!  session with the same payload type, if any, instead of allocating a new one.
+    size_t session_pool_size;
+
+    //! Payload type of sessions created in advance.
+    rtp::PayloadType session_pool_payload_type;
+
+    //! Measure time spent in every pipeline stage.
+    //! @remarks
+    //!  If disabled, no timing stages are inserted into the pipeline.
+    bool profiling;
+
+    //! Minimum interval between statistics updates, nanoseconds of stream time.
+    //! @remarks
+    //!  Statistics are collected from all sessions and published after the first
+    //!  frame and then at most once per interval. If zero, they're published after
+    //!  every frame.
+    core::nanoseconds_t stats_interval;
+
+    ReceiverConfig()
+        : fec_decoding_threads(0)
+        , session_pool_size(0)
+        , session_pool_payload_type(rtp::PayloadType_L16_Stereo)
+        , profiling(false)
+        , stats_interval(10 * core::Millisecond) {
+    }
 };
 
 } // namespace pipeline
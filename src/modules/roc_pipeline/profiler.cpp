@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_pipeline/profiler.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace pipeline {
+
+const char* stage_to_str(Stage stage) {
+    switch (stage) {
+    case Stage_Queue:
+        return "queue";
+    case Stage_Validator:
+        return "validator";
+    case Stage_FEC:
+        return "fec";
+    case Stage_Depacketizer:
+        return "depacketizer";
+    case Stage_Watchdog:
+        return "watchdog";
+    case Stage_Resampler:
+        return "resampler";
+    case Stage_Mixer:
+        return "mixer";
+    case Stage_Packetizer:
+        return "packetizer";
+    case Stage_Interleaver:
+        return "interleaver";
+    case Stage_Output:
+        return "output";
+    case Stage_Max:
+        break;
+    }
+    return "invalid";
+}
+
+void log_profile(const ProfilerStats& stats) {
+    for (size_t n = 0; n < stats.n_stages; n++) {
+        const StageStats& stage_stats = stats.stages[n];
+
+        roc_log(LogInfo,
+                "profiler: stage=%s calls=%lu p50=%.3fus p99=%.3fus max=%.3fus",
+                stage_to_str(stage_stats.stage), (unsigned long)stage_stats.n_calls,
+                (double)stage_stats.p50 / core::Microsecond,
+                (double)stage_stats.p99 / core::Microsecond,
+                (double)stage_stats.max / core::Microsecond);
+    }
+}
+
+Profiler::Profiler() {
+}
+
+core::StageTimer& Profiler::timer() {
+    return timer_;
+}
+
+core::TimeHistogram& Profiler::histogram(Stage stage) {
+    if ((size_t)stage >= Stage_Max) {
+        roc_panic("profiler: invalid stage: %d", (int)stage);
+    }
+    return histograms_[stage];
+}
+
+void Profiler::get_stats(ProfilerStats& stats) const {
+    stats.n_stages = 0;
+
+    for (size_t n = 0; n < Stage_Max; n++) {
+        const core::TimeHistogram& hist = histograms_[n];
+
+        const size_t n_calls = hist.count();
+        if (n_calls == 0) {
+            continue;
+        }
+
+        StageStats& stage_stats = stats.stages[stats.n_stages++];
+
+        stage_stats.stage = (Stage)n;
+        stage_stats.n_calls = n_calls;
+        stage_stats.p50 = hist.quantile(0.50);
+        stage_stats.p99 = hist.quantile(0.99);
+        stage_stats.max = hist.max();
+    }
+}
+
+} // namespace pipeline
+} // namespace roc
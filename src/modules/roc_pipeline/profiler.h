@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/profiler.h
+//! @brief Pipeline profiler.
+
+#ifndef ROC_PIPELINE_PROFILER_H_
+#define ROC_PIPELINE_PROFILER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stage_timer.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_core/time_histogram.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Pipeline stage.
+enum Stage {
+    //! Sorting packets and delaying playback (receiver).
+    Stage_Queue,
+
+    //! Validating RTP packets (receiver).
+    Stage_Validator,
+
+    //! FEC encoding or decoding.
+    Stage_FEC,
+
+    //! Decoding packets and concealing losses (receiver).
+    Stage_Depacketizer,
+
+    //! Detecting broken playback (receiver).
+    Stage_Watchdog,
+
+    //! Resampling.
+    Stage_Resampler,
+
+    //! Mixing sessions and converting samples (receiver).
+    Stage_Mixer,
+
+    //! Encoding samples into packets (sender).
+    Stage_Packetizer,
+
+    //! Interleaving packets (sender).
+    Stage_Interleaver,
+
+    //! Pacing, routing and composing packets (sender).
+    Stage_Output,
+
+    //! Number of stages.
+    Stage_Max
+};
+
+//! Get stage name.
+const char* stage_to_str(Stage stage);
+
+//! Stage timing statistics.
+struct StageStats {
+    //! Stage.
+    Stage stage;
+
+    //! Number of measured calls.
+    size_t n_calls;
+
+    //! Median call duration, nanoseconds.
+    core::nanoseconds_t p50;
+
+    //! 99th percentile of call duration, nanoseconds.
+    core::nanoseconds_t p99;
+
+    //! Maximum call duration, nanoseconds.
+    core::nanoseconds_t max;
+
+    StageStats()
+        : stage(Stage_Max)
+        , n_calls(0)
+        , p50(0)
+        , p99(0)
+        , max(0) {
+    }
+};
+
+//! Profiler statistics.
+struct ProfilerStats {
+    //! Number of filled stages.
+    size_t n_stages;
+
+    //! Statistics of stages which were called at least once.
+    StageStats stages[Stage_Max];
+
+    ProfilerStats()
+        : n_stages(0) {
+    }
+};
+
+//! Log profiler statistics, one line per stage.
+void log_profile(const ProfilerStats& stats);
+
+//! Pipeline profiler.
+//! @remarks
+//!  Holds a time histogram for every pipeline stage and a timer shared by
+//!  all stages. Timing readers and writers are inserted into the pipeline
+//!  after every measured stage and report the time spent in the stage itself,
+//!  excluding the stages it calls.
+//!
+//!  Stages should be called from a single thread. Statistics may be retrieved
+//!  from any thread without locks.
+class Profiler : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    Profiler();
+
+    //! Get timer shared by stages.
+    core::StageTimer& timer();
+
+    //! Get histogram for given stage.
+    core::TimeHistogram& histogram(Stage stage);
+
+    //! Get statistics.
+    void get_stats(ProfilerStats& stats) const;
+
+private:
+    core::StageTimer timer_;
+    core::TimeHistogram histograms_[Stage_Max];
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_PROFILER_H_
@@ -30,24 +30,44 @@ Receiver::Receiver(const ReceiverConfig& config,
     , config_(config)
     , timestamp_(0)
     , num_channels_(packet::num_channels(config.output.channels))
+    , stats_interval_((packet::timestamp_t)packet::timestamp_from_ns(
+          config.stats_interval, config.output.sample_rate))
+    , stats_timestamp_(0)
+    , stats_published_(false)
+    , num_packets_(0)
+    , num_dropped_packets_(0)
     , active_cond_(control_mutex_) {
-    mixer_.reset(new (allocator_)
-                     audio::Mixer(sample_buffer_pool, config.output.internal_frame_size),
+    if (config.fec_decoding_threads != 0) {
+        fec_decoding_pool_.reset(new (allocator_) fec::DecodingPool(
+                                     config.fec_decoding_threads, allocator_),
+                                 allocator_);
+        if (!fec_decoding_pool_ || !fec_decoding_pool_->valid()) {
+            return;
+        }
+    }
+
+    if (config.profiling) {
+        profiler_.reset(new (allocator_) Profiler, allocator_);
+        if (!profiler_) {
+            return;
+        }
+    }
+
+    // mixer poisons its buffers itself, so that both read() and read_as()
+    // paths are covered
+    mixer_.reset(new (allocator_) audio::Mixer(sample_buffer_pool,
+                                               config.output.internal_frame_size,
+                                               config.output.poisoning),
                  allocator_);
     if (!mixer_ || !mixer_->valid()) {
         return;
     }
-    audio::IReader* areader = mixer_.get();
 
-    if (config.output.poisoning) {
-        poisoner_.reset(new (allocator_) audio::PoisonReader(*areader), allocator_);
-        if (!poisoner_) {
-            return;
-        }
-        areader = poisoner_.get();
+    if (!fill_session_pool_()) {
+        return;
     }
 
-    audio_reader_ = areader;
+    audio_reader_ = mixer_.get();
 }
 
 bool Receiver::valid() {
@@ -85,6 +105,25 @@ size_t Receiver::num_sessions() const {
     return sessions_.size();
 }
 
+void Receiver::get_fec_stats(fec::ReaderStats& stats) const {
+    ReceiverStats recv_stats;
+    stats_.load(recv_stats);
+
+    stats = recv_stats.fec;
+}
+
+void Receiver::get_stats(ReceiverStats& stats) const {
+    stats_.load(stats);
+}
+
+void Receiver::get_profile(ProfilerStats& stats) const {
+    if (profiler_) {
+        profiler_->get_stats(stats);
+    } else {
+        stats = ProfilerStats();
+    }
+}
+
 void Receiver::write(const packet::PacketPtr& packet) {
     core::Mutex::Lock lock(control_mutex_);
 
@@ -98,16 +137,53 @@ void Receiver::write(const packet::PacketPtr& packet) {
 }
 
 void Receiver::read(audio::Frame& frame) {
-    core::Mutex::Lock lock(pipeline_mutex_);
+    read_as(frame.data(), frame.size(), audio::SampleFormat_Float);
+}
 
+void Receiver::read_as(void* data, size_t n_samples, audio::SampleFormat format) {
     if (config_.output.timing) {
-        ticker_.wait(timestamp_);
+        core::nanoseconds_t deadline = 0;
+        {
+            core::Mutex::Lock lock(pipeline_mutex_);
+            deadline = ticker_.deadline(timestamp_);
+        }
+        core::sleep_until(deadline);
     }
 
-    prepare_();
+    core::Mutex::Lock lock(pipeline_mutex_);
+
+    read_(data, n_samples, format);
+}
+
+size_t Receiver::read_ready(void* data,
+                            size_t n_samples,
+                            audio::SampleFormat format,
+                            core::nanoseconds_t& deadline) {
+    core::Mutex::Lock lock(pipeline_mutex_);
+
+    if (!config_.output.timing) {
+        read_(data, n_samples, format);
+        deadline = 0;
+        return n_samples;
+    }
+
+    const size_t frame_len = n_samples / num_channels_;
+
+    const core::Ticker::Ticks elapsed = ticker_.elapsed();
+
+    size_t ready_len = 0;
+    if (elapsed > timestamp_) {
+        ready_len = (size_t)std::min((core::Ticker::Ticks)frame_len,
+                                     elapsed - (core::Ticker::Ticks)timestamp_);
+    }
 
-    audio_reader_->read(frame);
-    timestamp_ += frame.size() / num_channels_;
+    if (ready_len != 0) {
+        read_(data, ready_len * num_channels_, format);
+    }
+
+    deadline = ticker_.deadline((core::Ticker::Ticks)timestamp_ + frame_len);
+
+    return ready_len * num_channels_;
 }
 
 IReceiver::Status Receiver::status() const {
@@ -124,6 +200,39 @@ void Receiver::wait_active() const {
     }
 }
 
+void Receiver::read_(void* data, size_t n_samples, audio::SampleFormat format) {
+    prepare_();
+
+    if (profiler_) {
+        core::StageTimer& timer = profiler_->timer();
+
+        const core::nanoseconds_t outer = timer.begin();
+        const core::nanoseconds_t start = core::timestamp();
+
+        mix_(data, n_samples, format);
+
+        const core::nanoseconds_t elapsed = core::timestamp() - start;
+        profiler_->histogram(Stage_Mixer).add(timer.end(outer, elapsed));
+    } else {
+        mix_(data, n_samples, format);
+    }
+
+    timestamp_ += n_samples / num_channels_;
+
+    if (!stats_published_ || timestamp_ - stats_timestamp_ >= stats_interval_) {
+        update_stats_();
+    }
+}
+
+void Receiver::mix_(void* data, size_t n_samples, audio::SampleFormat format) {
+    if (format == audio::SampleFormat_Float) {
+        audio::Frame frame((audio::sample_t*)data, n_samples);
+        audio_reader_->read(frame);
+    } else {
+        mixer_->read_as(data, n_samples, format, num_channels_);
+    }
+}
+
 void Receiver::prepare_() {
     core::Mutex::Lock lock(control_mutex_);
 
@@ -157,14 +266,17 @@ void Receiver::fetch_packets_() {
         }
 
         packets_.remove(*packet);
+        num_packets_++;
 
         if (!parse_packet_(packet)) {
             roc_log(LogDebug, "receiver: can't parse packet, dropping");
+            num_dropped_packets_++;
             continue;
         }
 
         if (!route_packet_(packet)) {
             roc_log(LogDebug, "receiver: can't route packet, dropping");
+            num_dropped_packets_++;
             continue;
         }
     }
@@ -214,13 +326,19 @@ bool Receiver::create_session_(const packet::PacketPtr& packet) {
 
     const packet::Address src_address = packet->udp()->src_addr;
 
-    core::SharedPtr<ReceiverSession> sess = new (allocator_) ReceiverSession(
-        config_.default_session, config_.output, packet->rtp()->payload_type, src_address,
-        format_map_, packet_pool_, byte_buffer_pool_, sample_buffer_pool_, allocator_);
+    core::SharedPtr<ReceiverSession> sess =
+        take_pooled_session_(packet->rtp()->payload_type, src_address);
 
-    if (!sess || !sess->valid()) {
-        roc_log(LogError, "receiver: can't create session, initialization failed");
-        return false;
+    if (!sess) {
+        sess = new (allocator_) ReceiverSession(
+            config_.default_session, config_.output, packet->rtp()->payload_type,
+            src_address, format_map_, fec_decoding_pool_.get(), profiler_.get(),
+            packet_pool_, byte_buffer_pool_, sample_buffer_pool_, allocator_);
+
+        if (!sess || !sess->valid()) {
+            roc_log(LogError, "receiver: can't create session, initialization failed");
+            return false;
+        }
     }
 
     if (!sess->handle(packet)) {
@@ -234,11 +352,63 @@ bool Receiver::create_session_(const packet::PacketPtr& packet) {
     return true;
 }
 
-void Receiver::remove_session_(ReceiverSession& sess) {
+void Receiver::remove_session_(const core::SharedPtr<ReceiverSession>& sess) {
     roc_log(LogInfo, "receiver: removing session");
 
-    mixer_->remove(sess.reader());
-    sessions_.remove(sess);
+    // fold counters of the removed session into the receiver totals, so that
+    // they never go backwards
+    sess->get_fec_stats(removed_fec_stats_, true);
+
+    mixer_->remove(sess->reader());
+    sessions_.remove(*sess);
+
+    if (session_pool_.size() < config_.session_pool_size) {
+        sess->reset(packet::Address());
+        session_pool_.push_back(*sess);
+    }
+}
+
+bool Receiver::fill_session_pool_() {
+    while (session_pool_.size() < config_.session_pool_size) {
+        core::SharedPtr<ReceiverSession> sess = new (allocator_) ReceiverSession(
+            config_.default_session, config_.output, config_.session_pool_payload_type,
+            packet::Address(), format_map_, fec_decoding_pool_.get(), profiler_.get(),
+            packet_pool_, byte_buffer_pool_, sample_buffer_pool_, allocator_);
+
+        if (!sess || !sess->valid()) {
+            roc_log(LogError, "receiver: can't create pooled session: payload_type=%u",
+                    (unsigned)config_.session_pool_payload_type);
+            return false;
+        }
+
+        session_pool_.push_back(*sess);
+    }
+
+    return true;
+}
+
+core::SharedPtr<ReceiverSession>
+Receiver::take_pooled_session_(unsigned int payload_type,
+                               const packet::Address& src_address) {
+    core::SharedPtr<ReceiverSession> sess;
+
+    for (sess = session_pool_.front(); sess; sess = session_pool_.nextof(*sess)) {
+        if (sess->payload_type() == payload_type) {
+            break;
+        }
+    }
+
+    if (!sess) {
+        return NULL;
+    }
+
+    roc_log(LogDebug, "receiver: reusing pooled session: payload_type=%u",
+            payload_type);
+
+    session_pool_.remove(*sess);
+    sess->reset(src_address);
+
+    return sess;
 }
 
 void Receiver::update_sessions_() {
@@ -248,9 +418,41 @@ void Receiver::update_sessions_() {
         next = sessions_.nextof(*curr);
 
         if (!curr->update(timestamp_)) {
-            remove_session_(*curr);
+            remove_session_(curr);
+        }
+    }
+}
+
+void Receiver::update_stats_() {
+    // sessions are added and removed only by prepare_(), which is called
+    // under pipeline mutex, so we don't need control mutex here
+    ReceiverStats stats;
+
+    stats.n_sessions = sessions_.size();
+    stats.n_packets = num_packets_;
+    stats.n_dropped_packets = num_dropped_packets_;
+
+    stats.n_pool_packets = packet_pool_.num_used();
+    stats.n_pool_byte_buffers = byte_buffer_pool_.num_used();
+    stats.n_pool_sample_buffers = sample_buffer_pool_.num_used();
+
+    stats.fec = removed_fec_stats_;
+
+    core::SharedPtr<ReceiverSession> sess;
+    size_t n = 0;
+
+    for (sess = sessions_.front(); sess; sess = sessions_.nextof(*sess)) {
+        sess->get_fec_stats(stats.fec, false);
+
+        if (n < ReceiverStats::MaxSessions) {
+            sess->get_stats(stats.sessions[n++]);
         }
     }
+
+    stats_.store(stats);
+
+    stats_timestamp_ = timestamp_;
+    stats_published_ = true;
 }
 
 } // namespace pipeline
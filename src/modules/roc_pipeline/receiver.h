@@ -14,21 +14,26 @@
 
 #include "roc_audio/ireader.h"
 #include "roc_audio/mixer.h"
-#include "roc_audio/poison_reader.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/cond.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list.h"
 #include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/seqlock.h"
+#include "roc_core/shared_ptr.h"
 #include "roc_core/unique_ptr.h"
+#include "roc_fec/decoding_pool.h"
+#include "roc_fec/reader_stats.h"
 #include "roc_packet/ireader.h"
 #include "roc_packet/iwriter.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_pipeline/config.h"
 #include "roc_pipeline/ireceiver.h"
+#include "roc_pipeline/profiler.h"
 #include "roc_pipeline/receiver_port.h"
 #include "roc_pipeline/receiver_session.h"
+#include "roc_pipeline/receiver_stats.h"
 #include "roc_rtp/format_map.h"
 
 namespace roc {
@@ -57,12 +62,52 @@ public:
     //! Get number of alive sessions.
     size_t num_sessions() const;
 
+    //! Get FEC statistics.
+    //! @remarks
+    //!  Sums statistics of alive sessions and sessions removed before. Returns
+    //!  counters from the snapshot published by read(), see get_stats().
+    void get_fec_stats(fec::ReaderStats& stats) const;
+
+    //! Get receiver and session statistics.
+    //! @remarks
+    //!  Statistics are published by read() at most once per stats_interval
+    //!  from config. This method doesn't block and may be called from any thread.
+    void get_stats(ReceiverStats& stats) const;
+
+    //! Get time spent in pipeline stages.
+    //! @remarks
+    //!  Returns no stages if profiling is disabled in config. This method
+    //!  doesn't block and may be called from any thread.
+    void get_profile(ProfilerStats& stats) const;
+
     //! Write packet.
     virtual void write(const packet::PacketPtr&);
 
     //! Read frame.
+    //! @remarks
+    //!  If timing is enabled, blocks until it's time to decode the frame.
+    //!  The pipeline is not locked while waiting.
     virtual void read(audio::Frame&);
 
+    //! Read samples in given format.
+    //! @remarks
+    //!  Same as read(), but mixed samples are converted to @p format directly
+    //!  into @p data. @p n_samples is the number of samples for all channels.
+    void read_as(void* data, size_t n_samples, audio::SampleFormat format);
+
+    //! Read samples that are ready without blocking.
+    //! @remarks
+    //!  If timing is enabled, reads only samples that should have been decoded
+    //!  by now according to the output sample rate. Otherwise reads all
+    //!  @p n_samples. @p deadline is set to the time when the next @p n_samples
+    //!  will be ready, or to zero if timing is disabled.
+    //! @returns
+    //!  number of samples (for all channels) written to the beginning of @p data.
+    size_t read_ready(void* data,
+                      size_t n_samples,
+                      audio::SampleFormat format,
+                      core::nanoseconds_t& deadline);
+
     //! Get current receiver status.
     virtual Status status() const;
 
@@ -73,6 +118,8 @@ private:
     Status status_() const;
 
     void prepare_();
+    void read_(void* data, size_t n_samples, audio::SampleFormat format);
+    void mix_(void* data, size_t n_samples, audio::SampleFormat format);
 
     void fetch_packets_();
 
@@ -80,9 +127,14 @@ private:
     bool route_packet_(const packet::PacketPtr& packet);
 
     bool create_session_(const packet::PacketPtr& packet);
-    void remove_session_(ReceiverSession& sess);
+    void remove_session_(const core::SharedPtr<ReceiverSession>& sess);
+
+    bool fill_session_pool_();
+    core::SharedPtr<ReceiverSession>
+    take_pooled_session_(unsigned int payload_type, const packet::Address& src_address);
 
     void update_sessions_();
+    void update_stats_();
 
     const rtp::FormatMap& format_map_;
 
@@ -91,15 +143,18 @@ private:
     core::BufferPool<audio::sample_t>& sample_buffer_pool_;
     core::IAllocator& allocator_;
 
+    core::UniquePtr<fec::DecodingPool> fec_decoding_pool_;
+    core::UniquePtr<Profiler> profiler_;
+
     core::List<ReceiverPort> ports_;
     core::List<ReceiverSession> sessions_;
+    core::List<ReceiverSession> session_pool_;
 
     core::List<packet::Packet> packets_;
 
     core::Ticker ticker_;
 
     core::UniquePtr<audio::Mixer> mixer_;
-    core::UniquePtr<audio::PoisonReader> poisoner_;
 
     audio::IReader* audio_reader_;
 
@@ -108,6 +163,17 @@ private:
     packet::timestamp_t timestamp_;
     size_t num_channels_;
 
+    const packet::timestamp_t stats_interval_;
+    packet::timestamp_t stats_timestamp_;
+    bool stats_published_;
+
+    fec::ReaderStats removed_fec_stats_;
+
+    size_t num_packets_;
+    size_t num_dropped_packets_;
+
+    core::Seqlock<ReceiverStats> stats_;
+
     core::Mutex control_mutex_;
     core::Mutex pipeline_mutex_;
     core::Cond active_cond_;
@@ -9,6 +9,7 @@
 #include "roc_pipeline/receiver_session.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/time.h"
 
 #ifdef ROC_TARGET_OPENFEC
 #include "roc_fec/of_decoder.h"
@@ -22,11 +23,22 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
                                  const unsigned int payload_type,
                                  const packet::Address& src_address,
                                  const rtp::FormatMap& format_map,
+                                 fec::DecodingPool* fec_decoding_pool,
+                                 Profiler* profiler,
                                  packet::PacketPool& packet_pool,
                                  core::BufferPool<uint8_t>& byte_buffer_pool,
                                  core::BufferPool<audio::sample_t>& sample_buffer_pool,
                                  core::IAllocator& allocator)
-    : src_address_(src_address)
+    : payload_type_(payload_type)
+    , src_address_(src_address)
+    , sample_rate_(0)
+    , num_packets_(0)
+    , has_seqnum_(false)
+    , base_seqnum_(0)
+    , max_seqnum_(0)
+    , seqnum_cycles_(0)
+    , num_duplicates_(0)
+    , num_out_of_window_(0)
     , allocator_(allocator)
     , audio_reader_(NULL) {
     const rtp::Format* format = format_map.format(payload_type);
@@ -34,6 +46,8 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
         return;
     }
 
+    sample_rate_ = format->sample_rate;
+
     queue_router_.reset(new (allocator_) packet::Router(allocator_, 2), allocator_);
     if (!queue_router_ || !queue_router_->valid()) {
         return;
@@ -61,6 +75,17 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
     }
     preader = delayed_reader_.get();
 
+    if (profiler) {
+        queue_timing_.reset(new (allocator_) packet::TimingReader(
+                                *preader, profiler->histogram(Stage_Queue),
+                                profiler->timer()),
+                            allocator_);
+        if (!queue_timing_) {
+            return;
+        }
+        preader = queue_timing_.get();
+    }
+
     validator_.reset(new (allocator_)
                          rtp::Validator(*preader, *format, session_config.rtp_validator),
                      allocator_);
@@ -69,6 +94,17 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
     }
     preader = validator_.get();
 
+    if (profiler) {
+        validator_timing_.reset(new (allocator_) packet::TimingReader(
+                                    *preader, profiler->histogram(Stage_Validator),
+                                    profiler->timer()),
+                                allocator_);
+        if (!validator_timing_) {
+            return;
+        }
+        preader = validator_timing_.get();
+    }
+
 #ifdef ROC_TARGET_OPENFEC
     if (session_config.fec.codec != fec::NoCodec) {
         repair_queue_.reset(new (allocator_) packet::SortedQueue(0), allocator_);
@@ -96,7 +132,7 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
 
         fec_reader_.reset(new (allocator_) fec::Reader(
                               session_config.fec, *fec_decoder_, *preader, *repair_queue_,
-                              *fec_parser_, packet_pool, allocator_),
+                              *fec_parser_, packet_pool, fec_decoding_pool, allocator_),
                           allocator_);
         if (!fec_reader_ || !fec_reader_->valid()) {
             return;
@@ -110,6 +146,17 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
             return;
         }
         preader = fec_validator_.get();
+
+        if (profiler) {
+            fec_timing_.reset(new (allocator_) packet::TimingReader(
+                                  *preader, profiler->histogram(Stage_FEC),
+                                  profiler->timer()),
+                              allocator_);
+            if (!fec_timing_) {
+                return;
+            }
+            preader = fec_timing_.get();
+        }
     }
 #endif // ROC_TARGET_OPENFEC
 
@@ -118,9 +165,19 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
         return;
     }
 
-    depacketizer_.reset(new (allocator_) audio::Depacketizer(*preader, *decoder_,
-                                                             session_config.channels,
-                                                             output_config.beeping),
+    if (session_config.plc.enabled) {
+        plc_.reset(new (allocator_)
+                       audio::PLC(session_config.plc, session_config.channels,
+                                  format->sample_rate, allocator_),
+                   allocator_);
+        if (!plc_ || !plc_->valid()) {
+            return;
+        }
+    }
+
+    depacketizer_.reset(new (allocator_) audio::Depacketizer(
+                            *preader, *decoder_, plc_.get(), session_config.channels,
+                            output_config.beeping),
                         allocator_);
     if (!depacketizer_) {
         return;
@@ -128,6 +185,17 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
 
     audio::IReader* areader = depacketizer_.get();
 
+    if (profiler) {
+        depacketizer_timing_.reset(new (allocator_) audio::TimingReader(
+                                       *areader, profiler->histogram(Stage_Depacketizer),
+                                       profiler->timer()),
+                                   allocator_);
+        if (!depacketizer_timing_) {
+            return;
+        }
+        areader = depacketizer_timing_.get();
+    }
+
     if (session_config.watchdog.no_playback_timeout != 0
         || session_config.watchdog.broken_playback_timeout != 0
         || session_config.watchdog.frame_status_window != 0) {
@@ -140,6 +208,17 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
             return;
         }
         areader = watchdog_.get();
+
+        if (profiler) {
+            watchdog_timing_.reset(new (allocator_) audio::TimingReader(
+                                       *areader, profiler->histogram(Stage_Watchdog),
+                                       profiler->timer()),
+                                   allocator_);
+            if (!watchdog_timing_) {
+                return;
+            }
+            areader = watchdog_timing_.get();
+        }
     }
 
     if (output_config.resampling) {
@@ -152,14 +231,25 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
             areader = resampler_poisoner_.get();
         }
         resampler_.reset(new (allocator_) audio::ResamplerReader(
-                             *areader, sample_buffer_pool, allocator,
-                             session_config.resampler, session_config.channels,
+                             *areader, sample_buffer_pool, session_config.resampler,
+                             session_config.channels,
                              output_config.internal_frame_size),
                          allocator_);
         if (!resampler_ || !resampler_->valid()) {
             return;
         }
         areader = resampler_.get();
+
+        if (profiler) {
+            resampler_timing_.reset(new (allocator_) audio::TimingReader(
+                                        *areader, profiler->histogram(Stage_Resampler),
+                                        profiler->timer()),
+                                    allocator_);
+            if (!resampler_timing_) {
+                return;
+            }
+            areader = resampler_timing_.get();
+        }
     }
 
     if (output_config.poisoning) {
@@ -171,9 +261,19 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
         areader = session_poisoner_.get();
     }
 
+    if (session_config.latency_tuner.enabled && resampler_) {
+        latency_tuner_.reset(new (allocator_) audio::LatencyTuner(
+                                 session_config.latency_tuner,
+                                 session_config.target_latency, format->sample_rate),
+                             allocator_);
+        if (!latency_tuner_ || !latency_tuner_->valid()) {
+            return;
+        }
+    }
+
     latency_monitor_.reset(new (allocator_) audio::LatencyMonitor(
                                *source_queue_, *depacketizer_, resampler_.get(),
-                               session_config.latency_monitor,
+                               latency_tuner_.get(), session_config.latency_monitor,
                                session_config.target_latency, format->sample_rate,
                                output_config.sample_rate),
                            allocator_);
@@ -192,6 +292,57 @@ bool ReceiverSession::valid() const {
     return audio_reader_;
 }
 
+unsigned int ReceiverSession::payload_type() const {
+    return payload_type_;
+}
+
+void ReceiverSession::reset(const packet::Address& src_address) {
+    roc_panic_if(!valid());
+
+    src_address_ = src_address;
+
+    num_packets_ = 0;
+    has_seqnum_ = false;
+    base_seqnum_ = 0;
+    max_seqnum_ = 0;
+    seqnum_cycles_ = 0;
+    memset(seqnum_window_, 0, sizeof(seqnum_window_));
+    num_duplicates_ = 0;
+    num_out_of_window_ = 0;
+
+    queue_router_->reset();
+    source_queue_->reset();
+    if (repair_queue_) {
+        repair_queue_->reset();
+    }
+
+    delayed_reader_->reset();
+    validator_->reset();
+
+    if (fec_reader_) {
+        fec_reader_->reset();
+        fec_validator_->reset();
+    }
+
+    decoder_->reset();
+    if (plc_) {
+        plc_->reset();
+    }
+    depacketizer_->reset();
+
+    if (watchdog_) {
+        watchdog_->reset();
+    }
+    if (resampler_) {
+        resampler_->reset();
+    }
+
+    if (latency_tuner_) {
+        latency_tuner_->reset();
+    }
+    latency_monitor_->reset();
+}
+
 bool ReceiverSession::handle(const packet::PacketPtr& packet) {
     roc_panic_if(!valid());
 
@@ -204,6 +355,18 @@ bool ReceiverSession::handle(const packet::PacketPtr& packet) {
         return false;
     }
 
+    if (packet->rtp() && (packet->flags() & packet::Packet::FlagAudio)) {
+        update_seqnum_(packet->rtp()->seqnum);
+
+        if (latency_tuner_) {
+            core::nanoseconds_t receive_timestamp = udp->receive_timestamp;
+            if (receive_timestamp == 0) {
+                receive_timestamp = core::timestamp();
+            }
+            latency_tuner_->add_packet(receive_timestamp, packet->rtp()->timestamp);
+        }
+    }
+
     queue_router_->write(packet);
     return true;
 }
@@ -212,6 +375,9 @@ bool ReceiverSession::update(packet::timestamp_t time) {
     roc_panic_if(!valid());
 
     if (watchdog_) {
+        if (watchdog_->broken() && latency_monitor_ && latency_monitor_->recover()) {
+            watchdog_->reset_breakage();
+        }
         if (!watchdog_->update()) {
             return false;
         }
@@ -232,5 +398,126 @@ audio::IReader& ReceiverSession::reader() {
     return *audio_reader_;
 }
 
+void ReceiverSession::get_fec_stats(fec::ReaderStats& stats, bool final) const {
+    roc_panic_if(!valid());
+
+    if (fec_reader_) {
+        if (final) {
+            stats.add(fec_reader_->final_stats());
+        } else {
+            stats.add(fec_reader_->stats());
+        }
+    }
+}
+
+void ReceiverSession::get_stats(ReceiverSessionStats& stats) const {
+    roc_panic_if(!valid());
+
+    stats = ReceiverSessionStats();
+
+    stats.src_address = src_address_;
+
+    stats.n_packets_received = num_packets_;
+    stats.n_packets_duplicate = num_duplicates_;
+
+    if (has_seqnum_) {
+        const size_t n_expected = seqnum_cycles_ + max_seqnum_ - base_seqnum_ + 1;
+        const size_t n_unique =
+            num_packets_ - stats.n_packets_duplicate - num_out_of_window_;
+
+        if (n_expected > n_unique) {
+            stats.n_packets_lost = n_expected - n_unique;
+        }
+    }
+
+    stats.n_packets_dropped =
+        queue_router_->num_dropped() + source_queue_->num_overflows();
+    if (repair_queue_) {
+        stats.n_packets_dropped += repair_queue_->num_overflows();
+    }
+
+    if (fec_reader_) {
+        stats.n_packets_repaired = fec_reader_->stats().n_repaired;
+    }
+
+    const audio::DepacketizerStats& depacketizer_stats = depacketizer_->stats();
+
+    stats.n_packets_late = depacketizer_stats.n_late_packets;
+    stats.n_frames = depacketizer_stats.n_frames;
+    stats.n_blank_frames = depacketizer_stats.n_blank_frames;
+    stats.n_incomplete_frames = depacketizer_stats.n_incomplete_frames;
+
+    stats.latency = packet::timestamp_to_ns(
+        (packet::timestamp_diff_t)latency_monitor_->latency(), sample_rate_);
+    stats.target_latency = packet::timestamp_to_ns(
+        (packet::timestamp_diff_t)latency_monitor_->target_latency(), sample_rate_);
+    stats.scaling = latency_monitor_->freq_coeff();
+
+    if (watchdog_) {
+        stats.blank_duration = packet::timestamp_to_ns(
+            (packet::timestamp_diff_t)watchdog_->blank_duration(), sample_rate_);
+        stats.broken = watchdog_->broken();
+    }
+
+    if (latency_tuner_) {
+        stats.jitter = latency_tuner_->mean_jitter();
+    }
+}
+
+// Duplicates are detected here rather than in the source queue, because the
+// queue doesn't see duplicates of packets that were already read from it.
+void ReceiverSession::update_seqnum_(packet::seqnum_t seqnum) {
+    num_packets_++;
+
+    if (!has_seqnum_) {
+        base_seqnum_ = max_seqnum_ = seqnum;
+        has_seqnum_ = true;
+        set_seqnum_seen_(seqnum, true);
+        return;
+    }
+
+    if (packet::seqnum_lt(max_seqnum_, seqnum)) {
+        // forget seqnums that are now outside of the window
+        const size_t gap = (size_t)packet::seqnum_diff(seqnum, max_seqnum_);
+        if (gap >= SeqnumWindow) {
+            memset(seqnum_window_, 0, sizeof(seqnum_window_));
+        } else {
+            for (size_t n = 1; n < gap; n++) {
+                set_seqnum_seen_(packet::seqnum_t(max_seqnum_ + n), false);
+            }
+        }
+        set_seqnum_seen_(seqnum, true);
+
+        if (seqnum < max_seqnum_) {
+            seqnum_cycles_ += (size_t)1 << 16;
+        }
+        max_seqnum_ = seqnum;
+    } else if ((size_t)packet::seqnum_diff(max_seqnum_, seqnum) < SeqnumWindow) {
+        if (seqnum_seen_(seqnum)) {
+            num_duplicates_++;
+        } else {
+            set_seqnum_seen_(seqnum, true);
+        }
+    } else {
+        // can't tell if it's a duplicate; don't count it as unique, otherwise
+        // a late duplicate would hide a real loss
+        num_out_of_window_++;
+    }
+}
+
+bool ReceiverSession::seqnum_seen_(packet::seqnum_t seqnum) const {
+    const size_t pos = seqnum % SeqnumWindow;
+    return (seqnum_window_[pos / 64] >> (pos % 64)) & 1;
+}
+
+void ReceiverSession::set_seqnum_seen_(packet::seqnum_t seqnum, bool seen) {
+    const size_t pos = seqnum % SeqnumWindow;
+    if (seen) {
+        seqnum_window_[pos / 64] |= (uint64_t)1 << (pos % 64);
+    } else {
+        seqnum_window_[pos / 64] &= ~((uint64_t)1 << (pos % 64));
+    }
+}
+
 } // namespace pipeline
 } // namespace roc
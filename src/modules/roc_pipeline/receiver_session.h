@@ -16,16 +16,21 @@
 #include "roc_audio/idecoder.h"
 #include "roc_audio/ireader.h"
 #include "roc_audio/latency_monitor.h"
+#include "roc_audio/latency_tuner.h"
+#include "roc_audio/plc.h"
 #include "roc_audio/poison_reader.h"
 #include "roc_audio/resampler_reader.h"
+#include "roc_audio/timing_reader.h"
 #include "roc_audio/watchdog.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list_node.h"
 #include "roc_core/refcnt.h"
 #include "roc_core/unique_ptr.h"
+#include "roc_fec/decoding_pool.h"
 #include "roc_fec/idecoder.h"
 #include "roc_fec/reader.h"
+#include "roc_fec/reader_stats.h"
 #include "roc_packet/address.h"
 #include "roc_packet/delayed_reader.h"
 #include "roc_packet/iparser.h"
@@ -34,7 +39,10 @@
 #include "roc_packet/packet_pool.h"
 #include "roc_packet/router.h"
 #include "roc_packet/sorted_queue.h"
+#include "roc_packet/timing_reader.h"
 #include "roc_pipeline/config.h"
+#include "roc_pipeline/profiler.h"
+#include "roc_pipeline/receiver_stats.h"
 #include "roc_rtp/format_map.h"
 #include "roc_rtp/parser.h"
 #include "roc_rtp/validator.h"
@@ -48,11 +56,16 @@ namespace pipeline {
 class ReceiverSession : public core::RefCnt<ReceiverSession>, public core::ListNode {
 public:
     //! Initialize.
+    //! @remarks
+    //!  If @p fec_decoding_pool is not NULL, FEC decoding is performed using it.
+    //!  If @p profiler is not NULL, time spent in every stage is reported to it.
     ReceiverSession(const ReceiverSessionConfig& session_config,
                     const ReceiverOutputConfig& output_config,
                     unsigned int payload_type,
                     const packet::Address& src_address,
                     const rtp::FormatMap& format_map,
+                    fec::DecodingPool* fec_decoding_pool,
+                    Profiler* profiler,
                     packet::PacketPool& packet_pool,
                     core::BufferPool<uint8_t>& byte_buffer_pool,
                     core::BufferPool<audio::sample_t>& sample_buffer_pool,
@@ -61,6 +74,16 @@ public:
     //! Check if the session pipeline was succefully constructed.
     bool valid() const;
 
+    //! Get payload type of the session.
+    unsigned int payload_type() const;
+
+    //! Reset session to initial state and bind it to a new sender.
+    //! @remarks
+    //!  Drops all queued packets and resets every stage of the pipeline without
+    //!  reallocating it, so that the session may be reused for another sender
+    //!  with the same payload type.
+    void reset(const packet::Address& src_address);
+
     //! Try to route a packet to this session.
     //! @returns
     //!  true if the packet is dedicated for this session
@@ -74,12 +97,41 @@ public:
     //! Get audio reader.
     audio::IReader& reader();
 
+    //! Add session FEC statistics to @p stats.
+    //! @remarks
+    //!  If @p final is true, the current partially read block is accounted too.
+    void get_fec_stats(fec::ReaderStats& stats, bool final) const;
+
+    //! Get session statistics.
+    //! @remarks
+    //!  Counters are accumulated since the session was created or reset.
+    void get_stats(ReceiverSessionStats& stats) const;
+
 private:
     friend class core::RefCnt<ReceiverSession>;
 
     void destroy();
 
-    const packet::Address src_address_;
+    void update_seqnum_(packet::seqnum_t seqnum);
+    bool seqnum_seen_(packet::seqnum_t seqnum) const;
+    void set_seqnum_seen_(packet::seqnum_t seqnum, bool seen);
+
+    // number of recent seqnums for which duplicates are detected
+    enum { SeqnumWindow = 256 };
+
+    const unsigned int payload_type_;
+    packet::Address src_address_;
+
+    size_t sample_rate_;
+
+    size_t num_packets_;
+    bool has_seqnum_;
+    packet::seqnum_t base_seqnum_;
+    packet::seqnum_t max_seqnum_;
+    size_t seqnum_cycles_;
+    uint64_t seqnum_window_[SeqnumWindow / 64];
+    size_t num_duplicates_;
+    size_t num_out_of_window_;
 
     core::IAllocator& allocator_;
 
@@ -100,6 +152,7 @@ private:
     core::UniquePtr<rtp::Validator> fec_validator_;
 
     core::UniquePtr<audio::IDecoder> decoder_;
+    core::UniquePtr<audio::PLC> plc_;
     core::UniquePtr<audio::Depacketizer> depacketizer_;
 
     core::UniquePtr<audio::PoisonReader> resampler_poisoner_;
@@ -107,7 +160,15 @@ private:
 
     core::UniquePtr<audio::PoisonReader> session_poisoner_;
 
+    core::UniquePtr<audio::LatencyTuner> latency_tuner_;
     core::UniquePtr<audio::LatencyMonitor> latency_monitor_;
+
+    core::UniquePtr<packet::TimingReader> queue_timing_;
+    core::UniquePtr<packet::TimingReader> validator_timing_;
+    core::UniquePtr<packet::TimingReader> fec_timing_;
+    core::UniquePtr<audio::TimingReader> depacketizer_timing_;
+    core::UniquePtr<audio::TimingReader> watchdog_timing_;
+    core::UniquePtr<audio::TimingReader> resampler_timing_;
 };
 
 } // namespace pipeline
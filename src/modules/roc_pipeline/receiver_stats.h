@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/receiver_stats.h
+//! @brief Receiver statistics.
+
+#ifndef ROC_PIPELINE_RECEIVER_STATS_H_
+#define ROC_PIPELINE_RECEIVER_STATS_H_
+
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_fec/reader_stats.h"
+#include "roc_packet/address.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Receiver session statistics.
+struct ReceiverSessionStats {
+    //! Sender address.
+    packet::Address src_address;
+
+    //! Number of source packets received, including duplicates.
+    size_t n_packets_received;
+
+    //! Number of source packets that were never received.
+    //! @remarks
+    //!  Computed from RTP sequence numbers as defined by RFC 3550. Packets
+    //!  older than the last 256 sequence numbers are not counted as received.
+    size_t n_packets_lost;
+
+    //! Number of source packets dropped because they arrived too late.
+    size_t n_packets_late;
+
+    //! Number of duplicate source packets received.
+    //! @remarks
+    //!  Detected among the last 256 sequence numbers, even if the original
+    //!  packet was already played.
+    size_t n_packets_duplicate;
+
+    //! Number of lost source packets repaired using FEC.
+    size_t n_packets_repaired;
+
+    //! Number of packets dropped because of unknown stream or full queue.
+    size_t n_packets_dropped;
+
+    //! Current latency, nanoseconds.
+    core::nanoseconds_t latency;
+
+    //! Current target latency, nanoseconds.
+    core::nanoseconds_t target_latency;
+
+    //! Resampler scaling factor applied to compensate clock drift.
+    float scaling;
+
+    //! Mean jitter as defined by RFC 3550, nanoseconds.
+    //! @remarks
+    //!  Zero if the latency tuner is disabled.
+    core::nanoseconds_t jitter;
+
+    //! Number of frames produced.
+    size_t n_frames;
+
+    //! Number of frames without any decoded samples.
+    size_t n_blank_frames;
+
+    //! Number of frames partially filled with decoded samples.
+    size_t n_incomplete_frames;
+
+    //! How long every frame has been blank, nanoseconds.
+    //! @remarks
+    //!  Zero if the watchdog is disabled.
+    core::nanoseconds_t blank_duration;
+
+    //! Whether the watchdog detected frequent breakages.
+    //! @remarks
+    //!  The session is terminated on the next update unless the latency
+    //!  monitor recovers the stream.
+    bool broken;
+
+    ReceiverSessionStats()
+        : n_packets_received(0)
+        , n_packets_lost(0)
+        , n_packets_late(0)
+        , n_packets_duplicate(0)
+        , n_packets_repaired(0)
+        , n_packets_dropped(0)
+        , latency(0)
+        , target_latency(0)
+        , scaling(1.f)
+        , jitter(0)
+        , n_frames(0)
+        , n_blank_frames(0)
+        , n_incomplete_frames(0)
+        , blank_duration(0)
+        , broken(false) {
+    }
+};
+
+//! Receiver statistics.
+struct ReceiverStats {
+    //! Maximum number of sessions reported.
+    enum { MaxSessions = 16 };
+
+    //! Number of alive sessions.
+    size_t n_sessions;
+
+    //! Number of packets passed to receiver.
+    size_t n_packets;
+
+    //! Number of packets dropped because they can't be parsed or routed.
+    size_t n_dropped_packets;
+
+    //! Number of packets allocated from packet pool.
+    size_t n_pool_packets;
+
+    //! Number of buffers allocated from byte buffer pool.
+    size_t n_pool_byte_buffers;
+
+    //! Number of buffers allocated from sample buffer pool.
+    size_t n_pool_sample_buffers;
+
+    //! FEC statistics summed over alive and removed sessions.
+    fec::ReaderStats fec;
+
+    //! Statistics of first alive sessions.
+    //! @remarks
+    //!  Only first min(n_sessions, MaxSessions) elements are filled.
+    ReceiverSessionStats sessions[MaxSessions];
+
+    ReceiverStats()
+        : n_sessions(0)
+        , n_packets(0)
+        , n_dropped_packets(0)
+        , n_pool_packets(0)
+        , n_pool_byte_buffers(0)
+        , n_pool_sample_buffers(0) {
+    }
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_RECEIVER_STATS_H_
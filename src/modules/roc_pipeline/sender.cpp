@@ -9,6 +9,8 @@
 #include "roc_pipeline/sender.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_packet/address_to_str.h"
+#include "roc_pipeline/proto_to_str.h"
 
 #ifdef ROC_TARGET_OPENFEC
 #include "roc_fec/of_encoder.h"
@@ -27,7 +29,14 @@ Sender::Sender(const SenderConfig& config,
                core::BufferPool<uint8_t>& byte_buffer_pool,
                core::BufferPool<audio::sample_t>& sample_buffer_pool,
                core::IAllocator& allocator)
-    : audio_writer_(NULL)
+    : source_protocol_(source_port_config.protocol)
+    , repair_protocol_(repair_port_config.protocol)
+    , pacing_lead_(config.pacing_lead)
+    , packet_length_(config.packet_length)
+    , packet_pool_(packet_pool)
+    , byte_buffer_pool_(byte_buffer_pool)
+    , num_reserved_packets_(0)
+    , audio_writer_(NULL)
     , timestamp_(0)
     , num_channels_(packet::num_channels(config.input_channels)) {
     const rtp::Format* format = format_map.format(config.payload_type);
@@ -35,6 +44,27 @@ Sender::Sender(const SenderConfig& config,
         return;
     }
 
+    if (!format->is_valid_duration(config.packet_length)) {
+        roc_log(LogError,
+                "sender: packet length %lu us not supported by payload type %u",
+                (unsigned long)(config.packet_length / core::Microsecond),
+                (unsigned)config.payload_type);
+        return;
+    }
+
+    num_reserved_packets_ = num_packets_(config, *format);
+
+    convert_buf_ =
+        new (sample_buffer_pool) core::Buffer<audio::sample_t>(sample_buffer_pool);
+    if (!convert_buf_) {
+        return;
+    }
+    convert_buf_.resize(sample_buffer_pool.buffer_size() / num_channels_
+                        * num_channels_);
+    if (convert_buf_.size() == 0) {
+        return;
+    }
+
     if (config.timing) {
         ticker_.reset(new (allocator) core::Ticker(config.input_sample_rate), allocator);
         if (!ticker_) {
@@ -43,7 +73,8 @@ Sender::Sender(const SenderConfig& config,
     }
 
     source_port_.reset(new (allocator)
-                           SenderPort(source_port_config, source_writer, allocator),
+                           SenderPort(source_port_config, source_writer,
+                                      packet_pool, allocator),
                        allocator);
     if (!source_port_ || !source_port_->valid()) {
         return;
@@ -51,13 +82,21 @@ Sender::Sender(const SenderConfig& config,
 
     if (repair_port_config.protocol != Proto_None) {
         repair_port_.reset(new (allocator)
-                               SenderPort(repair_port_config, repair_writer, allocator),
+                               SenderPort(repair_port_config, repair_writer,
+                                          packet_pool, allocator),
                            allocator);
         if (!repair_port_ || !repair_port_->valid()) {
             return;
         }
     }
 
+    if (config.profiling) {
+        profiler_.reset(new (allocator) Profiler, allocator);
+        if (!profiler_) {
+            return;
+        }
+    }
+
     router_.reset(new (allocator) packet::Router(allocator, 2), allocator);
     if (!router_ || !router_->valid()) {
         return;
@@ -73,13 +112,44 @@ Sender::Sender(const SenderConfig& config,
         }
     }
 
+    if (config.pacing) {
+        pacer_.reset(new (allocator) packet::Pacer(*pwriter, format->sample_rate),
+                     allocator);
+        if (!pacer_) {
+            return;
+        }
+        pwriter = pacer_.get();
+    }
+
+    if (profiler_) {
+        output_timing_.reset(new (allocator) packet::TimingWriter(
+                                 *pwriter, profiler_->histogram(Stage_Output),
+                                 profiler_->timer()),
+                             allocator);
+        if (!output_timing_) {
+            return;
+        }
+        pwriter = output_timing_.get();
+    }
+
 #ifdef ROC_TARGET_OPENFEC
     if (config.fec.codec != fec::NoCodec) {
         if (!repair_port_) {
             return;
         }
 
-        if (config.interleaving) {
+        if (config.interleaving && config.interleaving_depth != 0) {
+            diagonal_interleaver_.reset(
+                new (allocator) packet::DiagonalInterleaver(
+                    *pwriter, allocator,
+                    config.fec.n_source_packets + config.fec.n_repair_packets,
+                    config.interleaving_depth),
+                allocator);
+            if (!diagonal_interleaver_ || !diagonal_interleaver_->valid()) {
+                return;
+            }
+            pwriter = diagonal_interleaver_.get();
+        } else if (config.interleaving) {
             interleaver_.reset(new (allocator)
                                    packet::Interleaver(*pwriter, allocator,
                                                        config.fec.n_source_packets
@@ -91,6 +161,18 @@ Sender::Sender(const SenderConfig& config,
             pwriter = interleaver_.get();
         }
 
+        if (profiler_ && (diagonal_interleaver_ || interleaver_)) {
+            interleaver_timing_.reset(new (allocator) packet::TimingWriter(
+                                          *pwriter,
+                                          profiler_->histogram(Stage_Interleaver),
+                                          profiler_->timer()),
+                                      allocator);
+            if (!interleaver_timing_) {
+                return;
+            }
+            pwriter = interleaver_timing_.get();
+        }
+
         const size_t source_packet_size = format->size(config.packet_length);
 
         core::UniquePtr<fec::OFEncoder> fec_encoder(
@@ -110,6 +192,17 @@ Sender::Sender(const SenderConfig& config,
             return;
         }
         pwriter = fec_writer_.get();
+
+        if (profiler_) {
+            fec_timing_.reset(new (allocator) packet::TimingWriter(
+                                  *pwriter, profiler_->histogram(Stage_FEC),
+                                  profiler_->timer()),
+                              allocator);
+            if (!fec_timing_) {
+                return;
+            }
+            pwriter = fec_timing_.get();
+        }
     }
 #endif // ROC_TARGET_OPENFEC
 
@@ -129,6 +222,17 @@ Sender::Sender(const SenderConfig& config,
 
     audio::IWriter* awriter = packetizer_.get();
 
+    if (profiler_) {
+        packetizer_timing_.reset(new (allocator) audio::TimingWriter(
+                                     *awriter, profiler_->histogram(Stage_Packetizer),
+                                     profiler_->timer()),
+                                 allocator);
+        if (!packetizer_timing_) {
+            return;
+        }
+        awriter = packetizer_timing_.get();
+    }
+
     if (config.resampling && config.input_sample_rate != format->sample_rate) {
         if (config.poisoning) {
             resampler_poisoner_.reset(new (allocator) audio::PoisonWriter(*awriter),
@@ -139,7 +243,7 @@ Sender::Sender(const SenderConfig& config,
             awriter = resampler_poisoner_.get();
         }
         resampler_.reset(new (allocator) audio::ResamplerWriter(
-                             *awriter, sample_buffer_pool, allocator, config.resampler,
+                             *awriter, sample_buffer_pool, config.resampler,
                              config.input_channels, config.internal_frame_size),
                          allocator);
         if (!resampler_ || !resampler_->valid()) {
@@ -150,6 +254,17 @@ Sender::Sender(const SenderConfig& config,
             return;
         }
         awriter = resampler_.get();
+
+        if (profiler_) {
+            resampler_timing_.reset(new (allocator) audio::TimingWriter(
+                                        *awriter, profiler_->histogram(Stage_Resampler),
+                                        profiler_->timer()),
+                                    allocator);
+            if (!resampler_timing_) {
+                return;
+            }
+            awriter = resampler_timing_.get();
+        }
     }
 
     if (config.poisoning) {
@@ -168,15 +283,199 @@ bool Sender::valid() {
     return audio_writer_;
 }
 
+bool Sender::add_destination(const PortConfig& port_config) {
+    roc_panic_if(!valid());
+
+    SenderPort* port = NULL;
+
+    if (port_config.protocol == source_protocol_) {
+        port = source_port_.get();
+    } else if (repair_port_ && port_config.protocol == repair_protocol_) {
+        port = repair_port_.get();
+    }
+
+    if (!port) {
+        roc_log(LogError, "sender: can't add destination %s: unexpected protocol %s",
+                packet::address_to_str(port_config.address).c_str(),
+                proto_to_str(port_config.protocol));
+        return false;
+    }
+
+    if (!port->add_destination(port_config.address)) {
+        roc_log(LogError, "sender: can't add destination %s: can't allocate memory",
+                packet::address_to_str(port_config.address).c_str());
+        return false;
+    }
+
+    roc_log(LogDebug, "sender: added destination %s %s",
+            packet::address_to_str(port_config.address).c_str(),
+            proto_to_str(port_config.protocol));
+
+    return true;
+}
+
+bool Sender::reserve() {
+    roc_panic_if(!valid());
+
+    // packet buffers are shared between destinations, but every destination
+    // needs its own packet
+    size_t num_destinations = source_port_->num_destinations();
+    if (repair_port_) {
+        num_destinations = std::max(num_destinations, repair_port_->num_destinations());
+    }
+
+    if (!packet_pool_.reserve(num_reserved_packets_ * num_destinations)) {
+        roc_log(LogError, "sender: can't reserve %lu packets",
+                (unsigned long)(num_reserved_packets_ * num_destinations));
+        return false;
+    }
+
+    if (!byte_buffer_pool_.reserve(num_reserved_packets_)) {
+        roc_log(LogError, "sender: can't reserve %lu buffers",
+                (unsigned long)num_reserved_packets_);
+        return false;
+    }
+
+    roc_log(LogDebug, "sender: reserved %lu packets",
+            (unsigned long)num_reserved_packets_);
+
+    return true;
+}
+
+bool Sender::has_resampler() const {
+    return resampler_;
+}
+
 void Sender::write(audio::Frame& frame) {
     roc_panic_if(!valid());
 
-    if (ticker_) {
+    if (pacer_) {
+        core::nanoseconds_t min_send_time = 0;
+
+        if (ticker_) {
+            min_send_time = ticker_->deadline(timestamp_);
+            core::sleep_until(min_send_time - pacing_lead_);
+        } else {
+            min_send_time = core::timestamp();
+        }
+
+        pacer_->set_min_send_time(min_send_time);
+
+        // without ticker, frames may be written faster than real time; don't
+        // let the schedule run away from the actual time
+        pacer_->set_max_send_time(min_send_time + pacing_lead_ + packet_length_);
+    } else if (ticker_) {
         ticker_->wait(timestamp_);
     }
 
     audio_writer_->write(frame);
     timestamp_ += frame.size() / num_channels_;
+
+    update_stats_();
+}
+
+void Sender::write_as(void* data, size_t n_samples, audio::SampleFormat format) {
+    roc_panic_if(!valid());
+
+    if (format == audio::SampleFormat_Float) {
+        audio::Frame frame((audio::sample_t*)data, n_samples);
+        write(frame);
+        return;
+    }
+
+    const size_t frame_len = n_samples / num_channels_;
+    const size_t max_len = convert_buf_.size() / num_channels_;
+
+    size_t pos = 0;
+
+    while (pos < frame_len) {
+        const size_t n_write = std::min(frame_len - pos, max_len);
+
+        audio::sample_t* samples = convert_buf_.data();
+
+        audio::sample_format_to_float(format, data, frame_len, pos, samples, n_write,
+                                      num_channels_);
+
+        audio::Frame frame(samples, n_write * num_channels_);
+        write(frame);
+
+        pos += n_write;
+    }
+}
+
+void Sender::flush() {
+    roc_panic_if(!valid());
+
+    packetizer_->flush();
+
+    if (fec_writer_) {
+        fec_writer_->flush();
+    }
+
+    if (interleaver_) {
+        interleaver_->flush();
+    }
+
+    if (diagonal_interleaver_) {
+        diagonal_interleaver_->flush();
+    }
+
+    update_stats_();
+}
+
+void Sender::get_stats(SenderStats& stats) const {
+    stats_.load(stats);
+}
+
+void Sender::get_profile(ProfilerStats& stats) const {
+    if (profiler_) {
+        profiler_->get_stats(stats);
+    } else {
+        stats = ProfilerStats();
+    }
+}
+
+void Sender::update_stats_() {
+    SenderStats stats;
+
+    stats.n_samples = (size_t)timestamp_;
+
+    stats.n_source_packets = source_port_->num_packets();
+    stats.n_bytes = source_port_->num_bytes();
+    stats.n_dropped_packets = source_port_->num_dropped_packets();
+
+    if (repair_port_) {
+        stats.n_repair_packets = repair_port_->num_packets();
+        stats.n_bytes += repair_port_->num_bytes();
+        stats.n_dropped_packets += repair_port_->num_dropped_packets();
+    }
+
+    stats_.store(stats);
+}
+
+size_t Sender::num_packets_(const SenderConfig& config, const rtp::Format& format) {
+    const size_t packet_samples =
+        (size_t)packet::timestamp_from_ns(config.packet_length, format.sample_rate);
+
+    // packets produced from one internal frame
+    size_t n_packets = 1;
+    if (packet_samples != 0) {
+        n_packets += config.internal_frame_size / num_channels_ / packet_samples;
+    }
+
+    // packets held by fec writer and interleaver until the block is complete
+    size_t n_block_packets = 1;
+#ifdef ROC_TARGET_OPENFEC
+    if (config.fec.codec != fec::NoCodec) {
+        n_block_packets = config.fec.n_source_packets + config.fec.n_repair_packets;
+        if (config.interleaving && config.interleaving_depth != 0) {
+            n_block_packets *= config.interleaving_depth;
+        }
+    }
+#endif // ROC_TARGET_OPENFEC
+
+    // the same number of packets may be still queued in the outgoing writer
+    return (n_packets + n_block_packets) * 2;
 }
 
 } // namespace pipeline
@@ -17,18 +17,26 @@
 #include "roc_audio/packetizer.h"
 #include "roc_audio/poison_writer.h"
 #include "roc_audio/resampler_writer.h"
+#include "roc_audio/sample_format.h"
+#include "roc_audio/timing_writer.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/seqlock.h"
 #include "roc_core/ticker.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_fec/iencoder.h"
 #include "roc_fec/writer.h"
+#include "roc_packet/diagonal_interleaver.h"
 #include "roc_packet/interleaver.h"
+#include "roc_packet/pacer.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_packet/router.h"
+#include "roc_packet/timing_writer.h"
 #include "roc_pipeline/config.h"
+#include "roc_pipeline/profiler.h"
 #include "roc_pipeline/sender_port.h"
+#include "roc_pipeline/sender_stats.h"
 #include "roc_rtp/format_map.h"
 
 namespace roc {
@@ -52,16 +60,76 @@ public:
     //! Check if the pipeline was successfully constructed.
     bool valid();
 
+    //! Check if the pipeline performs resampling.
+    //! @remarks
+    //!  Resampling is skipped when the input sample rate matches the sample
+    //!  rate of the payload format.
+    bool has_resampler() const;
+
+    //! Add one more destination for source or repair packets.
+    //! @remarks
+    //!  @p port_config should have the same protocol as the source or repair
+    //!  port passed to the constructor. Packets sent to that port are also sent
+    //!  to the given address. Audio is encoded and packets are composed only
+    //!  once; all destinations share the same packet buffers.
+    //! @returns
+    //!  false if the protocol doesn't match or memory can't be allocated.
+    bool add_destination(const PortConfig& port_config);
+
+    //! Preallocate packets and buffers used by the pipeline.
+    //! @remarks
+    //!  Touches packet and buffer pools so that the packets needed to fill
+    //!  and send first FEC blocks are allocated in advance and the first
+    //!  writes cost the same as the subsequent ones.
+    //! @returns
+    //!  false if memory can't be allocated.
+    bool reserve();
+
     //! Write audio frame.
     virtual void write(audio::Frame& frame);
 
+    //! Write samples in given format.
+    //! @remarks
+    //!  Converts @p data to the pipeline format in small chunks right before
+    //!  passing them to the pipeline, so that every chunk is still in cache
+    //!  when it's encoded. @p n_samples is the number of samples for all channels.
+    void write_as(void* data, size_t n_samples, audio::SampleFormat format);
+
+    //! Flush packets held by the pipeline.
+    //! @remarks
+    //!  Writes the partially filled packet, repair packets held for pacing, and
+    //!  packets held by interleaver. Should be called when the stream ends.
+    void flush();
+
+    //! Get statistics.
+    //! @remarks
+    //!  Statistics are published by write() after every frame. This method
+    //!  doesn't block and may be called from any thread.
+    void get_stats(SenderStats& stats) const;
+
+    //! Get time spent in pipeline stages.
+    //! @remarks
+    //!  Returns no stages if profiling is disabled in config. This method
+    //!  doesn't block and may be called from any thread.
+    void get_profile(ProfilerStats& stats) const;
+
 private:
+    size_t num_packets_(const SenderConfig& config, const rtp::Format& format);
+    void update_stats_();
+
+    const Protocol source_protocol_;
+    const Protocol repair_protocol_;
+
+    core::UniquePtr<Profiler> profiler_;
+
     core::UniquePtr<SenderPort> source_port_;
     core::UniquePtr<SenderPort> repair_port_;
 
     core::UniquePtr<packet::Router> router_;
+    core::UniquePtr<packet::Pacer> pacer_;
 
     core::UniquePtr<packet::Interleaver> interleaver_;
+    core::UniquePtr<packet::DiagonalInterleaver> diagonal_interleaver_;
 
     core::UniquePtr<fec::IEncoder> fec_encoder_;
     core::UniquePtr<fec::Writer> fec_writer_;
@@ -74,12 +142,28 @@ private:
 
     core::UniquePtr<audio::PoisonWriter> pipeline_poisoner_;
 
+    core::UniquePtr<packet::TimingWriter> output_timing_;
+    core::UniquePtr<packet::TimingWriter> interleaver_timing_;
+    core::UniquePtr<packet::TimingWriter> fec_timing_;
+    core::UniquePtr<audio::TimingWriter> packetizer_timing_;
+    core::UniquePtr<audio::TimingWriter> resampler_timing_;
+
     core::UniquePtr<core::Ticker> ticker_;
+    core::nanoseconds_t pacing_lead_;
+    core::nanoseconds_t packet_length_;
+
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& byte_buffer_pool_;
+    size_t num_reserved_packets_;
+
+    core::Slice<audio::sample_t> convert_buf_;
 
     audio::IWriter* audio_writer_;
 
     packet::timestamp_t timestamp_;
     size_t num_channels_;
+
+    core::Seqlock<SenderStats> stats_;
 };
 
 } // namespace pipeline
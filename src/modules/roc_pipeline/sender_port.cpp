@@ -17,10 +17,16 @@ namespace pipeline {
 
 SenderPort::SenderPort(const PortConfig& config,
                        packet::IWriter& writer,
+                       packet::PacketPool& packet_pool,
                        core::IAllocator& allocator)
     : dst_address_(config.address)
+    , extra_destinations_(allocator)
     , writer_(writer)
-    , composer_(NULL) {
+    , packet_pool_(packet_pool)
+    , composer_(NULL)
+    , num_packets_(0)
+    , num_bytes_(0)
+    , num_dropped_packets_(0) {
     packet::IComposer* composer = NULL;
 
     switch ((unsigned)config.protocol) {
@@ -105,10 +111,52 @@ packet::IComposer& SenderPort::composer() {
     return *composer_;
 }
 
+bool SenderPort::add_destination(const packet::Address& address) {
+    roc_panic_if(!valid());
+
+    if (!extra_destinations_.grow(extra_destinations_.size() + 1)) {
+        return false;
+    }
+
+    Destination dst;
+    dst.address = address;
+
+    extra_destinations_.push_back(dst);
+    return true;
+}
+
+size_t SenderPort::num_destinations() const {
+    return extra_destinations_.size() + 1;
+}
+
+size_t SenderPort::num_packets() const {
+    return num_packets_;
+}
+
+size_t SenderPort::num_bytes() const {
+    return num_bytes_;
+}
+
+size_t SenderPort::num_dropped_packets() const {
+    return num_dropped_packets_;
+}
+
+size_t SenderPort::num_dropped_packets(size_t index) const {
+    roc_panic_if(index >= num_destinations());
+
+    if (index == 0) {
+        return 0;
+    }
+
+    return extra_destinations_[index - 1].num_dropped_packets;
+}
+
 void SenderPort::write(const packet::PacketPtr& packet) {
     roc_panic_if(!valid());
 
-    packet->add_flags(packet::Packet::FlagUDP);
+    if (!packet->udp()) {
+        packet->add_flags(packet::Packet::FlagUDP);
+    }
 
     packet::UDP& udp = *packet->udp();
 
@@ -121,7 +169,37 @@ void SenderPort::write(const packet::PacketPtr& packet) {
         packet->add_flags(packet::Packet::FlagComposed);
     }
 
+    const size_t packet_size = packet->data().size();
+
     writer_.write(packet);
+
+    num_packets_++;
+    num_bytes_ += packet_size;
+
+    for (size_t n = 0; n < extra_destinations_.size(); n++) {
+        Destination& dst = extra_destinations_[n];
+
+        packet::PacketPtr copy = new (packet_pool_) packet::Packet(packet_pool_);
+        if (!copy) {
+            // other destinations should still get the packet
+            roc_log(LogError, "sender port: can't allocate packet");
+            dst.num_dropped_packets++;
+            num_dropped_packets_++;
+            continue;
+        }
+
+        copy->add_flags(packet::Packet::FlagUDP | packet::Packet::FlagComposed);
+
+        copy->udp()->dst_addr = dst.address;
+        copy->udp()->send_time = udp.send_time;
+
+        copy->set_data(packet->data());
+
+        writer_.write(copy);
+
+        num_packets_++;
+        num_bytes_ += packet_size;
+    }
 }
 
 } // namespace pipeline
@@ -12,11 +12,13 @@
 #ifndef ROC_PIPELINE_SENDER_PORT_H_
 #define ROC_PIPELINE_SENDER_PORT_H_
 
+#include "roc_core/array.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_packet/icomposer.h"
 #include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
 #include "roc_pipeline/config.h"
 #include "roc_rtp/composer.h"
 
@@ -31,6 +33,7 @@ public:
     //! Initialize.
     SenderPort(const PortConfig& config,
                packet::IWriter& writer,
+               packet::PacketPool& packet_pool,
                core::IAllocator& allocator);
 
     //! Check if the port pipeline was succefully constructed.
@@ -39,15 +42,63 @@ public:
     //! Get packet composer.
     packet::IComposer& composer();
 
+    //! Add one more destination address.
+    //! @remarks
+    //!  Every packet is sent to the port address and to all added addresses.
+    //!  Packets are composed once; for every additional destination, a new
+    //!  packet sharing the same buffer is sent.
+    //! @returns
+    //!  false if memory can't be allocated.
+    bool add_destination(const packet::Address& address);
+
+    //! Get number of destination addresses.
+    size_t num_destinations() const;
+
+    //! Get number of packets sent.
+    //! @remarks
+    //!  A packet is counted once for every destination it was sent to.
+    size_t num_packets() const;
+
+    //! Get number of bytes in sent packets.
+    //! @remarks
+    //!  Counted like num_packets().
+    size_t num_bytes() const;
+
+    //! Get number of packets not sent to additional destinations.
+    //! @remarks
+    //!  Counts copies that couldn't be allocated, for all destinations.
+    size_t num_dropped_packets() const;
+
+    //! Get number of packets not sent to given destination.
+    //! @remarks
+    //!  @p index is zero for the port address and n for the n-th added
+    //!  destination.
+    size_t num_dropped_packets(size_t index) const;
+
     //! Write packet.
     void write(const packet::PacketPtr& packet);
 
 private:
+    struct Destination {
+        packet::Address address;
+        size_t num_dropped_packets;
+
+        Destination()
+            : num_dropped_packets(0) {
+        }
+    };
+
     const packet::Address dst_address_;
+    core::Array<Destination> extra_destinations_;
 
     packet::IWriter& writer_;
+    packet::PacketPool& packet_pool_;
     packet::IComposer* composer_;
 
+    size_t num_packets_;
+    size_t num_bytes_;
+    size_t num_dropped_packets_;
+
     core::UniquePtr<rtp::Composer> rtp_composer_;
     core::UniquePtr<packet::IComposer> fec_composer_;
 };
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/sender_stats.h
+//! @brief Sender statistics.
+
+#ifndef ROC_PIPELINE_SENDER_STATS_H_
+#define ROC_PIPELINE_SENDER_STATS_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Sender statistics.
+//! @remarks
+//!  Packets sent to multiple destinations are counted once per destination.
+struct SenderStats {
+    //! Number of samples per channel written to sender.
+    size_t n_samples;
+
+    //! Number of source packets sent.
+    size_t n_source_packets;
+
+    //! Number of repair packets sent.
+    size_t n_repair_packets;
+
+    //! Number of bytes in sent packets.
+    size_t n_bytes;
+
+    //! Number of packets not sent to additional destinations.
+    //! @remarks
+    //!  Incremented when a packet copy for a destination can't be allocated.
+    size_t n_dropped_packets;
+
+    SenderStats()
+        : n_samples(0)
+        , n_source_packets(0)
+        , n_repair_packets(0)
+        , n_bytes(0)
+        , n_dropped_packets(0) {
+    }
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_SENDER_STATS_H_
@@ -23,11 +23,22 @@
 namespace roc {
 namespace rtp {
 
+//! Payload encoding.
+enum Encoding {
+    Encoding_L16,     //!< PCM, 16-bit signed big-endian integers.
+    Encoding_L24,     //!< PCM, 24-bit signed big-endian integers.
+    Encoding_Float32, //!< PCM, 32-bit big-endian IEEE 754 floats.
+    Encoding_Opus     //!< Opus codec.
+};
+
 //! RTP payload format.
 struct Format {
     //! Payload type.
     PayloadType payload_type;
 
+    //! Payload encoding.
+    Encoding encoding;
+
     //! Packet flags.
     unsigned flags;
 
@@ -43,6 +54,9 @@ struct Format {
     //! Get packet size in bytes for given duration in nanoseconds.
     size_t (*size)(core::nanoseconds_t duration);
 
+    //! Check if packets of given duration in nanoseconds can be produced.
+    bool (*is_valid_duration)(core::nanoseconds_t duration);
+
     //! Create encoder.
     audio::IEncoder* (*new_encoder)(core::IAllocator& allocator);
 
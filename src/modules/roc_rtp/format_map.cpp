@@ -7,10 +7,17 @@
  */
 
 #include "roc_rtp/format_map.h"
+#include "roc_core/helpers.h"
 #include "roc_rtp/pcm_decoder.h"
 #include "roc_rtp/pcm_encoder.h"
 #include "roc_rtp/pcm_helpers.h"
 
+#ifdef ROC_TARGET_OPUS
+#include "roc_rtp/opus_decoder.h"
+#include "roc_rtp/opus_encoder.h"
+#include "roc_rtp/opus_helpers.h"
+#endif // ROC_TARGET_OPUS
+
 namespace roc {
 namespace rtp {
 
@@ -18,26 +25,237 @@ namespace {
 
 Format pcm_l16_stereo = {
     /* payload_type */ PayloadType_L16_Stereo,
+    /* encoding     */ Encoding_L16,
     /* flags        */ packet::Packet::FlagAudio,
     /* sample_rate  */ 44100,
     /* channel_mask */ 0x3,
     /* duration     */ &pcm_duration_from_header<int16_t, 2>,
     /* size         */ &pcm_packet_size_from_duration<int16_t, 2, 44100>,
+    /* valid        */ &pcm_is_valid_duration<44100>,
     /* new_encoder  */ &PCMEncoder<int16_t, 2>::create,
     /* new_decoder  */ &PCMDecoder<int16_t, 2>::create,
 };
 
 Format pcm_l16_mono = {
     /* payload_type */ PayloadType_L16_Mono,
+    /* encoding     */ Encoding_L16,
     /* flags        */ packet::Packet::FlagAudio,
     /* sample_rate  */ 44100,
     /* channel_mask */ 0x1,
     /* duration     */ &pcm_duration_from_header<int16_t, 1>,
     /* size         */ &pcm_packet_size_from_duration<int16_t, 1, 44100>,
+    /* valid        */ &pcm_is_valid_duration<44100>,
+    /* new_encoder  */ &PCMEncoder<int16_t, 1>::create,
+    /* new_decoder  */ &PCMDecoder<int16_t, 1>::create,
+};
+
+Format pcm_l16_48k_stereo = {
+    /* payload_type */ PayloadType_L16_48k_Stereo,
+    /* encoding     */ Encoding_L16,
+    /* flags        */ packet::Packet::FlagAudio,
+    /* sample_rate  */ 48000,
+    /* channel_mask */ 0x3,
+    /* duration     */ &pcm_duration_from_header<int16_t, 2>,
+    /* size         */ &pcm_packet_size_from_duration<int16_t, 2, 48000>,
+    /* valid        */ &pcm_is_valid_duration<48000>,
+    /* new_encoder  */ &PCMEncoder<int16_t, 2>::create,
+    /* new_decoder  */ &PCMDecoder<int16_t, 2>::create,
+};
+
+Format pcm_l16_48k_mono = {
+    /* payload_type */ PayloadType_L16_48k_Mono,
+    /* encoding     */ Encoding_L16,
+    /* flags        */ packet::Packet::FlagAudio,
+    /* sample_rate  */ 48000,
+    /* channel_mask */ 0x1,
+    /* duration     */ &pcm_duration_from_header<int16_t, 1>,
+    /* size         */ &pcm_packet_size_from_duration<int16_t, 1, 48000>,
+    /* valid        */ &pcm_is_valid_duration<48000>,
+    /* new_encoder  */ &PCMEncoder<int16_t, 1>::create,
+    /* new_decoder  */ &PCMDecoder<int16_t, 1>::create,
+};
+
+Format pcm_l24_48k_stereo = {
+    /* payload_type */ PayloadType_L24_48k_Stereo,
+    /* encoding     */ Encoding_L24,
+    /* flags        */ packet::Packet::FlagAudio,
+    /* sample_rate  */ 48000,
+    /* channel_mask */ 0x3,
+    /* duration     */ &pcm_duration_from_header<PCMInt24, 2>,
+    /* size         */ &pcm_packet_size_from_duration<PCMInt24, 2, 48000>,
+    /* valid        */ &pcm_is_valid_duration<48000>,
+    /* new_encoder  */ &PCMEncoder<PCMInt24, 2>::create,
+    /* new_decoder  */ &PCMDecoder<PCMInt24, 2>::create,
+};
+
+Format pcm_l24_48k_mono = {
+    /* payload_type */ PayloadType_L24_48k_Mono,
+    /* encoding     */ Encoding_L24,
+    /* flags        */ packet::Packet::FlagAudio,
+    /* sample_rate  */ 48000,
+    /* channel_mask */ 0x1,
+    /* duration     */ &pcm_duration_from_header<PCMInt24, 1>,
+    /* size         */ &pcm_packet_size_from_duration<PCMInt24, 1, 48000>,
+    /* valid        */ &pcm_is_valid_duration<48000>,
+    /* new_encoder  */ &PCMEncoder<PCMInt24, 1>::create,
+    /* new_decoder  */ &PCMDecoder<PCMInt24, 1>::create,
+};
+
+Format pcm_f32_48k_stereo = {
+    /* payload_type */ PayloadType_F32_48k_Stereo,
+    /* encoding     */ Encoding_Float32,
+    /* flags        */ packet::Packet::FlagAudio,
+    /* sample_rate  */ 48000,
+    /* channel_mask */ 0x3,
+    /* duration     */ &pcm_duration_from_header<PCMFloat32, 2>,
+    /* size         */ &pcm_packet_size_from_duration<PCMFloat32, 2, 48000>,
+    /* valid        */ &pcm_is_valid_duration<48000>,
+    /* new_encoder  */ &PCMEncoder<PCMFloat32, 2>::create,
+    /* new_decoder  */ &PCMDecoder<PCMFloat32, 2>::create,
+};
+
+Format pcm_f32_48k_mono = {
+    /* payload_type */ PayloadType_F32_48k_Mono,
+    /* encoding     */ Encoding_Float32,
+    /* flags        */ packet::Packet::FlagAudio,
+    /* sample_rate  */ 48000,
+    /* channel_mask */ 0x1,
+    /* duration     */ &pcm_duration_from_header<PCMFloat32, 1>,
+    /* size         */ &pcm_packet_size_from_duration<PCMFloat32, 1, 48000>,
+    /* valid        */ &pcm_is_valid_duration<48000>,
+    /* new_encoder  */ &PCMEncoder<PCMFloat32, 1>::create,
+    /* new_decoder  */ &PCMDecoder<PCMFloat32, 1>::create,
+};
+
+Format pcm_l16_96k_stereo = {
+    /* payload_type */ PayloadType_L16_96k_Stereo,
+    /* encoding     */ Encoding_L16,
+    /* flags        */ packet::Packet::FlagAudio,
+    /* sample_rate  */ 96000,
+    /* channel_mask */ 0x3,
+    /* duration     */ &pcm_duration_from_header<int16_t, 2>,
+    /* size         */ &pcm_packet_size_from_duration<int16_t, 2, 96000>,
+    /* valid        */ &pcm_is_valid_duration<96000>,
+    /* new_encoder  */ &PCMEncoder<int16_t, 2>::create,
+    /* new_decoder  */ &PCMDecoder<int16_t, 2>::create,
+};
+
+Format pcm_l16_96k_mono = {
+    /* payload_type */ PayloadType_L16_96k_Mono,
+    /* encoding     */ Encoding_L16,
+    /* flags        */ packet::Packet::FlagAudio,
+    /* sample_rate  */ 96000,
+    /* channel_mask */ 0x1,
+    /* duration     */ &pcm_duration_from_header<int16_t, 1>,
+    /* size         */ &pcm_packet_size_from_duration<int16_t, 1, 96000>,
+    /* valid        */ &pcm_is_valid_duration<96000>,
     /* new_encoder  */ &PCMEncoder<int16_t, 1>::create,
     /* new_decoder  */ &PCMDecoder<int16_t, 1>::create,
 };
 
+Format pcm_l24_96k_stereo = {
+    /* payload_type */ PayloadType_L24_96k_Stereo,
+    /* encoding     */ Encoding_L24,
+    /* flags        */ packet::Packet::FlagAudio,
+    /* sample_rate  */ 96000,
+    /* channel_mask */ 0x3,
+    /* duration     */ &pcm_duration_from_header<PCMInt24, 2>,
+    /* size         */ &pcm_packet_size_from_duration<PCMInt24, 2, 96000>,
+    /* valid        */ &pcm_is_valid_duration<96000>,
+    /* new_encoder  */ &PCMEncoder<PCMInt24, 2>::create,
+    /* new_decoder  */ &PCMDecoder<PCMInt24, 2>::create,
+};
+
+Format pcm_l24_96k_mono = {
+    /* payload_type */ PayloadType_L24_96k_Mono,
+    /* encoding     */ Encoding_L24,
+    /* flags        */ packet::Packet::FlagAudio,
+    /* sample_rate  */ 96000,
+    /* channel_mask */ 0x1,
+    /* duration     */ &pcm_duration_from_header<PCMInt24, 1>,
+    /* size         */ &pcm_packet_size_from_duration<PCMInt24, 1, 96000>,
+    /* valid        */ &pcm_is_valid_duration<96000>,
+    /* new_encoder  */ &PCMEncoder<PCMInt24, 1>::create,
+    /* new_decoder  */ &PCMDecoder<PCMInt24, 1>::create,
+};
+
+Format pcm_f32_96k_stereo = {
+    /* payload_type */ PayloadType_F32_96k_Stereo,
+    /* encoding     */ Encoding_Float32,
+    /* flags        */ packet::Packet::FlagAudio,
+    /* sample_rate  */ 96000,
+    /* channel_mask */ 0x3,
+    /* duration     */ &pcm_duration_from_header<PCMFloat32, 2>,
+    /* size         */ &pcm_packet_size_from_duration<PCMFloat32, 2, 96000>,
+    /* valid        */ &pcm_is_valid_duration<96000>,
+    /* new_encoder  */ &PCMEncoder<PCMFloat32, 2>::create,
+    /* new_decoder  */ &PCMDecoder<PCMFloat32, 2>::create,
+};
+
+Format pcm_f32_96k_mono = {
+    /* payload_type */ PayloadType_F32_96k_Mono,
+    /* encoding     */ Encoding_Float32,
+    /* flags        */ packet::Packet::FlagAudio,
+    /* sample_rate  */ 96000,
+    /* channel_mask */ 0x1,
+    /* duration     */ &pcm_duration_from_header<PCMFloat32, 1>,
+    /* size         */ &pcm_packet_size_from_duration<PCMFloat32, 1, 96000>,
+    /* valid        */ &pcm_is_valid_duration<96000>,
+    /* new_encoder  */ &PCMEncoder<PCMFloat32, 1>::create,
+    /* new_decoder  */ &PCMDecoder<PCMFloat32, 1>::create,
+};
+
+#ifdef ROC_TARGET_OPUS
+
+Format opus_stereo = {
+    /* payload_type */ PayloadType_Opus_Stereo,
+    /* encoding     */ Encoding_Opus,
+    /* flags        */ packet::Packet::FlagAudio,
+    /* sample_rate  */ OpusSampleRate,
+    /* channel_mask */ 0x3,
+    /* duration     */ &opus_duration_from_header,
+    /* size         */ &opus_packet_size_from_duration<2>,
+    /* valid        */ &opus_is_valid_duration,
+    /* new_encoder  */ &OpusEncoder::create<2>,
+    /* new_decoder  */ &OpusDecoder::create<2>,
+};
+
+Format opus_mono = {
+    /* payload_type */ PayloadType_Opus_Mono,
+    /* encoding     */ Encoding_Opus,
+    /* flags        */ packet::Packet::FlagAudio,
+    /* sample_rate  */ OpusSampleRate,
+    /* channel_mask */ 0x1,
+    /* duration     */ &opus_duration_from_header,
+    /* size         */ &opus_packet_size_from_duration<1>,
+    /* valid        */ &opus_is_valid_duration,
+    /* new_encoder  */ &OpusEncoder::create<1>,
+    /* new_decoder  */ &OpusDecoder::create<1>,
+};
+
+#endif // ROC_TARGET_OPUS
+
+const Format* formats[] = {
+    &pcm_l16_stereo,
+    &pcm_l16_mono,
+    &pcm_l16_48k_stereo,
+    &pcm_l16_48k_mono,
+    &pcm_l24_48k_stereo,
+    &pcm_l24_48k_mono,
+    &pcm_f32_48k_stereo,
+    &pcm_f32_48k_mono,
+    &pcm_l16_96k_stereo,
+    &pcm_l16_96k_mono,
+    &pcm_l24_96k_stereo,
+    &pcm_l24_96k_mono,
+    &pcm_f32_96k_stereo,
+    &pcm_f32_96k_mono,
+#ifdef ROC_TARGET_OPUS
+    &opus_stereo,
+    &opus_mono,
+#endif // ROC_TARGET_OPUS
+};
+
 } // namespace
 
 const Format* FormatMap::format(unsigned int pt) const {
@@ -48,10 +266,66 @@ const Format* FormatMap::format(unsigned int pt) const {
     case PayloadType_L16_Mono:
         return &pcm_l16_mono;
 
+    case PayloadType_L16_48k_Stereo:
+        return &pcm_l16_48k_stereo;
+
+    case PayloadType_L16_48k_Mono:
+        return &pcm_l16_48k_mono;
+
+    case PayloadType_L24_48k_Stereo:
+        return &pcm_l24_48k_stereo;
+
+    case PayloadType_L24_48k_Mono:
+        return &pcm_l24_48k_mono;
+
+    case PayloadType_F32_48k_Stereo:
+        return &pcm_f32_48k_stereo;
+
+    case PayloadType_F32_48k_Mono:
+        return &pcm_f32_48k_mono;
+
+    case PayloadType_L16_96k_Stereo:
+        return &pcm_l16_96k_stereo;
+
+    case PayloadType_L16_96k_Mono:
+        return &pcm_l16_96k_mono;
+
+    case PayloadType_L24_96k_Stereo:
+        return &pcm_l24_96k_stereo;
+
+    case PayloadType_L24_96k_Mono:
+        return &pcm_l24_96k_mono;
+
+    case PayloadType_F32_96k_Stereo:
+        return &pcm_f32_96k_stereo;
+
+    case PayloadType_F32_96k_Mono:
+        return &pcm_f32_96k_mono;
+
+#ifdef ROC_TARGET_OPUS
+    case PayloadType_Opus_Stereo:
+        return &opus_stereo;
+
+    case PayloadType_Opus_Mono:
+        return &opus_mono;
+#endif // ROC_TARGET_OPUS
+
     default:
         return NULL;
     }
 }
 
+const Format* FormatMap::find(Encoding encoding,
+                              size_t sample_rate,
+                              packet::channel_mask_t channels) const {
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(formats); n++) {
+        if (formats[n]->encoding == encoding && formats[n]->sample_rate == sample_rate
+            && formats[n]->channel_mask == channels) {
+            return formats[n];
+        }
+    }
+    return NULL;
+}
+
 } // namespace rtp
 } // namespace roc
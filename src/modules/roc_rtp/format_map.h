@@ -26,6 +26,14 @@ public:
     //!  pointer to the format structure or null if there is no format
     //!  registered for this payload type.
     const Format* format(unsigned int pt) const;
+
+    //! Find format by encoding parameters.
+    //! @returns
+    //!  pointer to the format structure or null if there is no format
+    //!  registered for this encoding, sample rate, and channel mask.
+    const Format* find(Encoding encoding,
+                       size_t sample_rate,
+                       packet::channel_mask_t channels) const;
 };
 
 } // namespace rtp
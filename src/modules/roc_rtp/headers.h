@@ -28,7 +28,24 @@ enum Version {
 //! RTP payload type.
 enum PayloadType {
     PayloadType_L16_Stereo = 10, //!< Audio, 16-bit samples, 2 channels, 44100 Hz.
-    PayloadType_L16_Mono = 11    //!< Audio, 16-bit samples, 1 channel, 44100 Hz.
+    PayloadType_L16_Mono = 11,   //!< Audio, 16-bit samples, 1 channel, 44100 Hz.
+
+    PayloadType_Opus_Stereo = 96, //!< Audio, Opus, 2 channels, 48000 Hz (dynamic).
+    PayloadType_Opus_Mono = 97,   //!< Audio, Opus, 1 channel, 48000 Hz (dynamic).
+
+    PayloadType_L16_48k_Stereo = 98,  //!< Audio, 16-bit, 2 channels, 48000 Hz (dynamic).
+    PayloadType_L16_48k_Mono = 99,    //!< Audio, 16-bit, 1 channel, 48000 Hz (dynamic).
+    PayloadType_L24_48k_Stereo = 100, //!< Audio, 24-bit, 2 channels, 48000 Hz (dynamic).
+    PayloadType_L24_48k_Mono = 101,   //!< Audio, 24-bit, 1 channel, 48000 Hz (dynamic).
+    PayloadType_F32_48k_Stereo = 102, //!< Audio, float, 2 channels, 48000 Hz (dynamic).
+    PayloadType_F32_48k_Mono = 103,   //!< Audio, float, 1 channel, 48000 Hz (dynamic).
+
+    PayloadType_L16_96k_Stereo = 104, //!< Audio, 16-bit, 2 channels, 96000 Hz (dynamic).
+    PayloadType_L16_96k_Mono = 105,   //!< Audio, 16-bit, 1 channel, 96000 Hz (dynamic).
+    PayloadType_L24_96k_Stereo = 106, //!< Audio, 24-bit, 2 channels, 96000 Hz (dynamic).
+    PayloadType_L24_96k_Mono = 107,   //!< Audio, 24-bit, 1 channel, 96000 Hz (dynamic).
+    PayloadType_F32_96k_Stereo = 108, //!< Audio, float, 2 channels, 96000 Hz (dynamic).
+    PayloadType_F32_96k_Mono = 109    //!< Audio, float, 1 channel, 96000 Hz (dynamic).
 };
 
 //! RTP header.
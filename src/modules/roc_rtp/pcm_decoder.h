@@ -20,6 +20,10 @@ namespace roc {
 namespace rtp {
 
 //! PCM decoder.
+//! @remarks
+//!  Uses a specialized decoding kernel for the output channel mask. The kernel
+//!  for the packet channel mask is selected at construction time, and another
+//!  one is selected only if the output channel mask changes.
 template <class Sample, size_t NumCh>
 class PCMDecoder : public audio::IDecoder, public core::NonCopyable<> {
 public:
@@ -28,16 +32,30 @@ public:
         return new (allocator) PCMDecoder;
     }
 
+    //! Initialize.
+    PCMDecoder()
+        : chan_mask_(packet::channel_mask_t(1 << NumCh) - 1)
+        , kernel_(pcm_decode_kernel<Sample, NumCh>(chan_mask_)) {
+    }
+
     //! Read samples from packet.
     virtual size_t read_samples(const packet::Packet& packet,
                                 size_t offset,
                                 audio::sample_t* samples,
                                 size_t n_samples,
                                 packet::channel_mask_t channels) {
+        if (channels != chan_mask_) {
+            chan_mask_ = channels;
+            kernel_ = pcm_decode_kernel<Sample, NumCh>(chan_mask_);
+        }
         return pcm_read<Sample, NumCh>(packet.rtp()->payload.data(),
                                        packet.rtp()->payload.size(), offset, samples,
-                                       n_samples, channels);
+                                       n_samples, channels, kernel_);
     }
+
+private:
+    packet::channel_mask_t chan_mask_;
+    typename PCMDecodeKernel<Sample>::Func kernel_;
 };
 
 } // namespace rtp
@@ -20,6 +20,10 @@ namespace roc {
 namespace rtp {
 
 //! PCM encoder.
+//! @remarks
+//!  Uses a specialized encoding kernel for the input channel mask. The kernel
+//!  for the packet channel mask is selected at construction time, and another
+//!  one is selected only if the input channel mask changes.
 template <class Sample, size_t NumCh>
 class PCMEncoder : public audio::IEncoder, public core::NonCopyable<> {
 public:
@@ -28,6 +32,12 @@ public:
         return new (allocator) PCMEncoder;
     }
 
+    //! Initialize.
+    PCMEncoder()
+        : chan_mask_(packet::channel_mask_t(1 << NumCh) - 1)
+        , kernel_(pcm_encode_kernel<Sample, NumCh>(chan_mask_)) {
+    }
+
     //! Get packet payload size.
     virtual size_t payload_size(size_t num_samples) const {
         return pcm_payload_size_from_samples<Sample, NumCh>(num_samples);
@@ -39,10 +49,18 @@ public:
                                  const audio::sample_t* samples,
                                  size_t n_samples,
                                  packet::channel_mask_t channels) {
+        if (channels != chan_mask_) {
+            chan_mask_ = channels;
+            kernel_ = pcm_encode_kernel<Sample, NumCh>(chan_mask_);
+        }
         return pcm_write<Sample, NumCh>(packet.rtp()->payload.data(),
                                         packet.rtp()->payload.size(), offset, samples,
-                                        n_samples, channels);
+                                        n_samples, channels, kernel_);
     }
+
+private:
+    packet::channel_mask_t chan_mask_;
+    typename PCMEncodeKernel<Sample>::Func kernel_;
 };
 
 } // namespace rtp
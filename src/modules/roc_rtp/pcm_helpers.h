@@ -15,6 +15,7 @@
 #include "roc_audio/units.h"
 #include "roc_core/endian.h"
 #include "roc_core/stddefs.h"
+#include "roc_packet/rtp.h"
 #include "roc_packet/units.h"
 #include "roc_rtp/headers.h"
 
@@ -45,6 +46,28 @@ size_t pcm_packet_size_from_duration(core::nanoseconds_t duration) {
         + pcm_payload_size_from_samples<Sample, NumCh>((size_t)num_samples);
 }
 
+//! Check packet duration.
+//! @remarks
+//!  PCM packets may have any non-zero number of samples.
+template <size_t SampleRate> bool pcm_is_valid_duration(core::nanoseconds_t duration) {
+    return packet::timestamp_from_ns(duration, SampleRate) > 0;
+}
+
+//! Packed 24-bit sample.
+//! @remarks
+//!  Signed big-endian integer in two's complement notation.
+struct PCMInt24 {
+    uint8_t bytes[3]; //!< Sample bytes, most significant first.
+};
+
+//! 32-bit float sample.
+//! @remarks
+//!  IEEE 754 single precision float in big-endian byte order. Stored as an
+//!  integer, since a byte-swapped float is not necessarily a valid float.
+struct PCMFloat32 {
+    uint32_t bits; //!< Sample bits in network byte order.
+};
+
 //! Encode single sample.
 template <class T> T pcm_pack(audio::sample_t);
 
@@ -56,35 +79,84 @@ template <> int16_t inline pcm_pack(float s) {
     return (int16_t)core::hton16((uint16_t)(int16_t)s);
 }
 
+//! Encode single sample (PCMInt24).
+template <> PCMInt24 inline pcm_pack(float s) {
+    s *= 8388608.0f;
+    s = std::min(s, +8388607.0f);
+    s = std::max(s, -8388608.0f);
+    const uint32_t v = (uint32_t)(int32_t)s;
+    PCMInt24 ret;
+    ret.bytes[0] = uint8_t(v >> 16);
+    ret.bytes[1] = uint8_t(v >> 8);
+    ret.bytes[2] = uint8_t(v);
+    return ret;
+}
+
+//! Encode single sample (PCMFloat32).
+template <> PCMFloat32 inline pcm_pack(float s) {
+    uint32_t v;
+    memcpy(&v, &s, sizeof(v));
+    PCMFloat32 ret;
+    ret.bits = core::hton32(v);
+    return ret;
+}
+
 //! Decode single sample (int16_t).
 inline float pcm_unpack(int16_t s) {
     return float((int16_t)core::ntoh16((uint16_t)s)) / 32768.0f;
 }
 
-//! Decode multiple samples.
-template <class Sample, size_t NumCh>
-size_t pcm_write(void* out_data,
-                 size_t out_size,
-                 size_t out_offset,
-                 const audio::sample_t* in_samples,
-                 size_t in_n_samples,
-                 packet::channel_mask_t in_chan_mask) {
-    const packet::channel_mask_t out_chan_mask = packet::channel_mask_t(1 << NumCh) - 1;
-    const packet::channel_mask_t inout_chan_mask = in_chan_mask | out_chan_mask;
+//! Decode single sample (PCMInt24).
+inline float pcm_unpack(PCMInt24 s) {
+    // shift to the upper bits and back to extend sign
+    const int32_t v = int32_t(
+        ((uint32_t)s.bytes[0] << 24) | ((uint32_t)s.bytes[1] << 16)
+        | ((uint32_t)s.bytes[2] << 8));
+    return float(v >> 8) / 8388608.0f;
+}
 
-    size_t len = out_size / NumCh / sizeof(Sample);
-    size_t off = out_offset;
-    if (off > len) {
-        off = len;
-    }
+//! Decode single sample (PCMFloat32).
+inline float pcm_unpack(PCMFloat32 s) {
+    const uint32_t v = core::ntoh32(s.bits);
+    float ret;
+    memcpy(&ret, &v, sizeof(ret));
+    return ret;
+}
 
-    if (in_n_samples > (len - off)) {
-        in_n_samples = (len - off);
-    }
+//! PCM encoding kernel.
+//! @remarks
+//!  Encodes @c n_samples samples per channel from interleaved @c in_samples
+//!  with @c in_chan_mask channels to interleaved @c out_samples.
+template <class Sample> struct PCMEncodeKernel {
+    //! Kernel function.
+    typedef void (*Func)(Sample* out_samples,
+                         const audio::sample_t* in_samples,
+                         size_t n_samples,
+                         packet::channel_mask_t in_chan_mask);
+};
+
+//! PCM decoding kernel.
+//! @remarks
+//!  Decodes @c n_samples samples per channel from interleaved @c in_samples
+//!  to interleaved @c out_samples with @c out_chan_mask channels.
+template <class Sample> struct PCMDecodeKernel {
+    //! Kernel function.
+    typedef void (*Func)(audio::sample_t* out_samples,
+                         const Sample* in_samples,
+                         size_t n_samples,
+                         packet::channel_mask_t out_chan_mask);
+};
 
-    Sample* out_samples = (Sample*)out_data + (off * NumCh);
+//! Encode samples, arbitrary channel masks.
+template <class Sample, size_t NumCh>
+void pcm_encode_generic(Sample* out_samples,
+                        const audio::sample_t* in_samples,
+                        size_t n_samples,
+                        packet::channel_mask_t in_chan_mask) {
+    const packet::channel_mask_t out_chan_mask = packet::channel_mask_t(1 << NumCh) - 1;
+    const packet::channel_mask_t inout_chan_mask = in_chan_mask | out_chan_mask;
 
-    for (size_t ns = 0; ns < in_n_samples; ns++) {
+    for (size_t ns = 0; ns < n_samples; ns++) {
         for (packet::channel_mask_t ch = 1; ch <= inout_chan_mask && ch != 0; ch <<= 1) {
             if (in_chan_mask & ch) {
                 if (out_chan_mask & ch) {
@@ -97,21 +169,187 @@ size_t pcm_write(void* out_data,
             }
         }
     }
+}
+
+//! Encode samples, input channel mask matches packet channel mask.
+template <class Sample, size_t NumCh>
+void pcm_encode_same(Sample* out_samples,
+                     const audio::sample_t* in_samples,
+                     size_t n_samples,
+                     packet::channel_mask_t) {
+    for (size_t n = 0; n < n_samples * NumCh; n++) {
+        out_samples[n] = pcm_pack<Sample>(in_samples[n]);
+    }
+}
+
+//! Encode samples, mono input to stereo packet.
+//! @remarks
+//!  Right channel of the packet is not modified.
+template <class Sample>
+void pcm_encode_mono_to_stereo(Sample* out_samples,
+                               const audio::sample_t* in_samples,
+                               size_t n_samples,
+                               packet::channel_mask_t) {
+    for (size_t n = 0; n < n_samples; n++) {
+        out_samples[n * 2] = pcm_pack<Sample>(in_samples[n]);
+    }
+}
+
+//! Encode samples, stereo input to mono packet.
+//! @remarks
+//!  Right channel of the input is skipped.
+template <class Sample>
+void pcm_encode_stereo_to_mono(Sample* out_samples,
+                               const audio::sample_t* in_samples,
+                               size_t n_samples,
+                               packet::channel_mask_t) {
+    for (size_t n = 0; n < n_samples; n++) {
+        out_samples[n] = pcm_pack<Sample>(in_samples[n * 2]);
+    }
+}
+
+//! Decode samples, arbitrary channel masks.
+template <class Sample, size_t NumCh>
+void pcm_decode_generic(audio::sample_t* out_samples,
+                        const Sample* in_samples,
+                        size_t n_samples,
+                        packet::channel_mask_t out_chan_mask) {
+    const packet::channel_mask_t in_chan_mask = packet::channel_mask_t(1 << NumCh) - 1;
+    const packet::channel_mask_t inout_chan_mask = in_chan_mask | out_chan_mask;
+
+    for (size_t ns = 0; ns < n_samples; ns++) {
+        for (packet::channel_mask_t ch = 1; ch <= inout_chan_mask && ch != 0; ch <<= 1) {
+            audio::sample_t s = 0;
+            if (in_chan_mask & ch) {
+                s = pcm_unpack(*in_samples++);
+            }
+            if (out_chan_mask & ch) {
+                *out_samples++ = s;
+            }
+        }
+    }
+}
+
+//! Decode samples, output channel mask matches packet channel mask.
+template <class Sample, size_t NumCh>
+void pcm_decode_same(audio::sample_t* out_samples,
+                     const Sample* in_samples,
+                     size_t n_samples,
+                     packet::channel_mask_t) {
+    for (size_t n = 0; n < n_samples * NumCh; n++) {
+        out_samples[n] = pcm_unpack(in_samples[n]);
+    }
+}
+
+//! Decode samples, mono packet to stereo output.
+//! @remarks
+//!  Right channel of the output is zeroed.
+template <class Sample>
+void pcm_decode_mono_to_stereo(audio::sample_t* out_samples,
+                               const Sample* in_samples,
+                               size_t n_samples,
+                               packet::channel_mask_t) {
+    for (size_t n = 0; n < n_samples; n++) {
+        out_samples[n * 2] = pcm_unpack(in_samples[n]);
+        out_samples[n * 2 + 1] = 0;
+    }
+}
+
+//! Decode samples, stereo packet to mono output.
+//! @remarks
+//!  Right channel of the packet is skipped.
+template <class Sample>
+void pcm_decode_stereo_to_mono(audio::sample_t* out_samples,
+                               const Sample* in_samples,
+                               size_t n_samples,
+                               packet::channel_mask_t) {
+    for (size_t n = 0; n < n_samples; n++) {
+        out_samples[n] = pcm_unpack(in_samples[n * 2]);
+    }
+}
+
+//! Select encoding kernel for given input channel mask.
+template <class Sample, size_t NumCh>
+typename PCMEncodeKernel<Sample>::Func
+pcm_encode_kernel(packet::channel_mask_t in_chan_mask) {
+    const packet::channel_mask_t out_chan_mask = packet::channel_mask_t(1 << NumCh) - 1;
+
+    if (in_chan_mask == out_chan_mask) {
+        return &pcm_encode_same<Sample, NumCh>;
+    }
+    if (NumCh == 2 && in_chan_mask == 0x1) {
+        return &pcm_encode_mono_to_stereo<Sample>;
+    }
+    if (NumCh == 1 && in_chan_mask == 0x3) {
+        return &pcm_encode_stereo_to_mono<Sample>;
+    }
+    return &pcm_encode_generic<Sample, NumCh>;
+}
+
+//! Select decoding kernel for given output channel mask.
+template <class Sample, size_t NumCh>
+typename PCMDecodeKernel<Sample>::Func
+pcm_decode_kernel(packet::channel_mask_t out_chan_mask) {
+    const packet::channel_mask_t in_chan_mask = packet::channel_mask_t(1 << NumCh) - 1;
+
+    if (out_chan_mask == in_chan_mask) {
+        return &pcm_decode_same<Sample, NumCh>;
+    }
+    if (NumCh == 1 && out_chan_mask == 0x3) {
+        return &pcm_decode_mono_to_stereo<Sample>;
+    }
+    if (NumCh == 2 && out_chan_mask == 0x1) {
+        return &pcm_decode_stereo_to_mono<Sample>;
+    }
+    return &pcm_decode_generic<Sample, NumCh>;
+}
+
+//! Encode multiple samples using given kernel.
+template <class Sample, size_t NumCh>
+size_t pcm_write(void* out_data,
+                 size_t out_size,
+                 size_t out_offset,
+                 const audio::sample_t* in_samples,
+                 size_t in_n_samples,
+                 packet::channel_mask_t in_chan_mask,
+                 typename PCMEncodeKernel<Sample>::Func kernel) {
+    size_t len = out_size / NumCh / sizeof(Sample);
+    size_t off = out_offset;
+    if (off > len) {
+        off = len;
+    }
+
+    if (in_n_samples > (len - off)) {
+        in_n_samples = (len - off);
+    }
+
+    kernel((Sample*)out_data + (off * NumCh), in_samples, in_n_samples, in_chan_mask);
 
     return in_n_samples;
 }
 
-//! Decode multiple samples.
+//! Encode multiple samples.
+template <class Sample, size_t NumCh>
+size_t pcm_write(void* out_data,
+                 size_t out_size,
+                 size_t out_offset,
+                 const audio::sample_t* in_samples,
+                 size_t in_n_samples,
+                 packet::channel_mask_t in_chan_mask) {
+    return pcm_write<Sample, NumCh>(out_data, out_size, out_offset, in_samples,
+                                    in_n_samples, in_chan_mask,
+                                    &pcm_encode_generic<Sample, NumCh>);
+}
+
+//! Decode multiple samples using given kernel.
 template <class Sample, size_t NumCh>
 size_t pcm_read(const void* in_data,
                 size_t in_size,
                 size_t in_offset,
                 audio::sample_t* out_samples,
                 size_t out_n_samples,
-                packet::channel_mask_t out_chan_mask) {
-    const packet::channel_mask_t in_chan_mask = packet::channel_mask_t(1 << NumCh) - 1;
-    const packet::channel_mask_t inout_chan_mask = in_chan_mask | out_chan_mask;
-
+                packet::channel_mask_t out_chan_mask,
+                typename PCMDecodeKernel<Sample>::Func kernel) {
     size_t len = in_size / NumCh / sizeof(Sample);
     size_t off = in_offset;
     if (off > len) {
@@ -122,23 +360,25 @@ size_t pcm_read(const void* in_data,
         out_n_samples = (len - off);
     }
 
-    const Sample* in_samples = (const Sample*)in_data + (off * NumCh);
-
-    for (size_t ns = 0; ns < out_n_samples; ns++) {
-        for (packet::channel_mask_t ch = 1; ch <= inout_chan_mask && ch != 0; ch <<= 1) {
-            audio::sample_t s = 0;
-            if (in_chan_mask & ch) {
-                s = pcm_unpack(*in_samples++);
-            }
-            if (out_chan_mask & ch) {
-                *out_samples++ = s;
-            }
-        }
-    }
+    kernel(out_samples, (const Sample*)in_data + (off * NumCh), out_n_samples,
+           out_chan_mask);
 
     return out_n_samples;
 }
 
+//! Decode multiple samples.
+template <class Sample, size_t NumCh>
+size_t pcm_read(const void* in_data,
+                size_t in_size,
+                size_t in_offset,
+                audio::sample_t* out_samples,
+                size_t out_n_samples,
+                packet::channel_mask_t out_chan_mask) {
+    return pcm_read<Sample, NumCh>(in_data, in_size, in_offset, out_samples,
+                                   out_n_samples, out_chan_mask,
+                                   &pcm_decode_generic<Sample, NumCh>);
+}
+
 } // namespace rtp
 } // namespace roc
 
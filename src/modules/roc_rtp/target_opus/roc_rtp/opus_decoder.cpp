@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtp/opus_decoder.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/unique_ptr.h"
+
+namespace roc {
+namespace rtp {
+
+audio::IDecoder* OpusDecoder::create_(core::IAllocator& allocator, size_t num_channels) {
+    core::UniquePtr<OpusDecoder> decoder(new (allocator) OpusDecoder(num_channels),
+                                         allocator);
+    if (!decoder || !decoder->valid()) {
+        return NULL;
+    }
+    return decoder.release();
+}
+
+OpusDecoder::OpusDecoder(size_t num_channels)
+    : decoder_(NULL)
+    , num_channels_(num_channels)
+    , has_frame_(false)
+    , frame_source_(0)
+    , frame_seqnum_(0)
+    , frame_timestamp_(0)
+    , frame_samples_(0)
+    , conceal_pos_(0)
+    , conceal_samples_(0) {
+    roc_panic_if(num_channels_ == 0 || num_channels_ > OpusMaxChannels);
+
+    int err = OPUS_OK;
+    decoder_ = opus_decoder_create((opus_int32)OpusSampleRate, (int)num_channels_, &err);
+    if (!decoder_) {
+        roc_log(LogError, "opus decoder: opus_decoder_create() failed: %s",
+                opus_strerror(err));
+        return;
+    }
+}
+
+OpusDecoder::~OpusDecoder() {
+    if (decoder_) {
+        opus_decoder_destroy(decoder_);
+    }
+}
+
+bool OpusDecoder::valid() const {
+    return decoder_;
+}
+
+size_t OpusDecoder::read_samples(const packet::Packet& packet,
+                                 size_t offset,
+                                 audio::sample_t* samples,
+                                 size_t n_samples,
+                                 packet::channel_mask_t channels) {
+    roc_panic_if_not(valid());
+
+    if (!packet.rtp()) {
+        roc_panic("opus decoder: unexpected non-rtp packet");
+    }
+
+    if (!is_decoded_(*packet.rtp())) {
+        decode_(*packet.rtp());
+    }
+
+    if (offset >= frame_samples_) {
+        return 0;
+    }
+
+    if (n_samples > frame_samples_ - offset) {
+        n_samples = frame_samples_ - offset;
+    }
+
+    copy_samples_(samples, frame_ + offset * num_channels_, n_samples, channels);
+
+    return n_samples;
+}
+
+size_t OpusDecoder::conceal_samples(audio::sample_t* samples,
+                                    size_t n_samples,
+                                    packet::channel_mask_t channels) {
+    roc_panic_if_not(valid());
+
+    // nothing to extrapolate from
+    if (!has_frame_) {
+        return 0;
+    }
+
+    const size_t out_num_channels = packet::num_channels(channels);
+
+    size_t n_concealed = 0;
+
+    while (n_concealed < n_samples) {
+        if (conceal_pos_ == conceal_samples_) {
+            const int ret = opus_decode_float(decoder_, NULL, 0, conceal_frame_,
+                                              ConcealFrameSamples, 0);
+            if (ret <= 0) {
+                roc_log(LogDebug, "opus decoder: can't conceal samples: %s",
+                        opus_strerror(ret));
+                break;
+            }
+            conceal_pos_ = 0;
+            conceal_samples_ = (size_t)ret;
+        }
+
+        size_t ns = conceal_samples_ - conceal_pos_;
+        if (ns > n_samples - n_concealed) {
+            ns = n_samples - n_concealed;
+        }
+
+        copy_samples_(samples + n_concealed * out_num_channels,
+                      conceal_frame_ + conceal_pos_ * num_channels_, ns, channels);
+
+        conceal_pos_ += ns;
+        n_concealed += ns;
+    }
+
+    return n_concealed;
+}
+
+void OpusDecoder::reset() {
+    roc_panic_if_not(valid());
+
+    opus_decoder_ctl(decoder_, OPUS_RESET_STATE);
+
+    has_frame_ = false;
+    frame_samples_ = 0;
+    conceal_pos_ = 0;
+    conceal_samples_ = 0;
+}
+
+bool OpusDecoder::is_decoded_(const packet::RTP& rtp) const {
+    return has_frame_ && rtp.source == frame_source_ && rtp.seqnum == frame_seqnum_
+        && rtp.timestamp == frame_timestamp_;
+}
+
+void OpusDecoder::decode_(const packet::RTP& rtp) {
+    const int ret =
+        opus_decode_float(decoder_, rtp.payload.data(), (opus_int32)rtp.payload.size(),
+                          frame_, (int)OpusMaxFrameSamples, 0);
+
+    if (ret < 0) {
+        roc_log(LogDebug, "opus decoder: can't decode packet: sn=%lu err=%s",
+                (unsigned long)rtp.seqnum, opus_strerror(ret));
+        frame_samples_ = 0;
+    } else {
+        frame_samples_ = (size_t)ret;
+    }
+
+    has_frame_ = true;
+    frame_source_ = rtp.source;
+    frame_seqnum_ = rtp.seqnum;
+    frame_timestamp_ = rtp.timestamp;
+
+    // remaining concealed samples are outdated now
+    conceal_pos_ = 0;
+    conceal_samples_ = 0;
+}
+
+void OpusDecoder::copy_samples_(audio::sample_t* out_samples,
+                                const audio::sample_t* in_samples,
+                                size_t n_samples,
+                                packet::channel_mask_t out_chan_mask) const {
+    const packet::channel_mask_t in_chan_mask =
+        packet::channel_mask_t(1 << num_channels_) - 1;
+    const packet::channel_mask_t inout_chan_mask = in_chan_mask | out_chan_mask;
+
+    for (size_t ns = 0; ns < n_samples; ns++) {
+        for (packet::channel_mask_t ch = 1; ch <= inout_chan_mask && ch != 0; ch <<= 1) {
+            audio::sample_t s = 0;
+            if (in_chan_mask & ch) {
+                s = *in_samples++;
+            }
+            if (out_chan_mask & ch) {
+                *out_samples++ = s;
+            }
+        }
+    }
+}
+
+} // namespace rtp
+} // namespace roc
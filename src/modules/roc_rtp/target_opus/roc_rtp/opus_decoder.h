@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtp/target_opus/roc_rtp/opus_decoder.h
+//! @brief Opus decoder.
+
+#ifndef ROC_RTP_OPUS_DECODER_H_
+#define ROC_RTP_OPUS_DECODER_H_
+
+#include "roc_audio/idecoder.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_rtp/opus_helpers.h"
+
+namespace roc {
+namespace rtp {
+
+//! Opus decoder.
+//! @remarks
+//!  Decodes the whole packet when it's accessed for the first time and
+//!  then returns samples from the decoded frame. Lost packets are concealed
+//!  using Opus built-in packet loss concealment.
+class OpusDecoder : public audio::IDecoder, public core::NonCopyable<> {
+public:
+    //! Create decoder.
+    template <size_t NumCh> static audio::IDecoder* create(core::IAllocator& allocator) {
+        return create_(allocator, NumCh);
+    }
+
+    //! Initialize.
+    explicit OpusDecoder(size_t num_channels);
+
+    virtual ~OpusDecoder();
+
+    //! Check if the object was successfully constructed.
+    bool valid() const;
+
+    //! Read samples from packet.
+    virtual size_t read_samples(const packet::Packet& packet,
+                                size_t offset,
+                                audio::sample_t* samples,
+                                size_t n_samples,
+                                packet::channel_mask_t channels);
+
+    //! Conceal lost samples.
+    virtual size_t conceal_samples(audio::sample_t* samples,
+                                   size_t n_samples,
+                                   packet::channel_mask_t channels);
+
+    //! Reset decoder state.
+    virtual void reset();
+
+private:
+    enum {
+        // 10ms
+        ConcealFrameSamples = 480
+    };
+
+    static audio::IDecoder* create_(core::IAllocator& allocator, size_t num_channels);
+
+    bool is_decoded_(const packet::RTP& rtp) const;
+    void decode_(const packet::RTP& rtp);
+
+    void copy_samples_(audio::sample_t* out_samples,
+                       const audio::sample_t* in_samples,
+                       size_t n_samples,
+                       packet::channel_mask_t out_chan_mask) const;
+
+    ::OpusDecoder* decoder_;
+
+    const size_t num_channels_;
+
+    bool has_frame_;
+    packet::source_t frame_source_;
+    packet::seqnum_t frame_seqnum_;
+    packet::timestamp_t frame_timestamp_;
+
+    size_t frame_samples_;
+    audio::sample_t frame_[OpusMaxFrameSamples * OpusMaxChannels];
+
+    size_t conceal_pos_;
+    size_t conceal_samples_;
+    audio::sample_t conceal_frame_[ConcealFrameSamples * OpusMaxChannels];
+};
+
+} // namespace rtp
+} // namespace roc
+
+#endif // ROC_RTP_OPUS_DECODER_H_
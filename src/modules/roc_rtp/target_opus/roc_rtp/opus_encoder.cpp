@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtp/opus_encoder.h"
+#include "roc_core/helpers.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/unique_ptr.h"
+
+namespace roc {
+namespace rtp {
+
+namespace {
+
+// frame sizes supported by Opus: 2.5, 5, 10, 20, 40, and 60 ms
+const size_t FrameSizes[] = { 120, 240, 480, 960, 1920, 2880 };
+
+size_t round_frame_size(size_t n_samples) {
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(FrameSizes); n++) {
+        if (n_samples <= FrameSizes[n]) {
+            return FrameSizes[n];
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+audio::IEncoder* OpusEncoder::create_(core::IAllocator& allocator, size_t num_channels) {
+    core::UniquePtr<OpusEncoder> encoder(new (allocator) OpusEncoder(num_channels),
+                                         allocator);
+    if (!encoder || !encoder->valid()) {
+        return NULL;
+    }
+    return encoder.release();
+}
+
+OpusEncoder::OpusEncoder(size_t num_channels)
+    : encoder_(NULL)
+    , num_channels_(num_channels) {
+    roc_panic_if(num_channels_ == 0 || num_channels_ > OpusMaxChannels);
+
+    int err = OPUS_OK;
+    encoder_ = opus_encoder_create((opus_int32)OpusSampleRate, (int)num_channels_,
+                                   OPUS_APPLICATION_AUDIO, &err);
+    if (!encoder_) {
+        roc_log(LogError, "opus encoder: opus_encoder_create() failed: %s",
+                opus_strerror(err));
+        return;
+    }
+
+    const opus_int32 bitrate = (opus_int32)(OpusChannelBitrate * num_channels_);
+
+    if ((err = opus_encoder_ctl(encoder_, OPUS_SET_BITRATE(bitrate))) != OPUS_OK
+        || (err = opus_encoder_ctl(encoder_, OPUS_SET_VBR(0))) != OPUS_OK) {
+        roc_log(LogError, "opus encoder: opus_encoder_ctl() failed: %s",
+                opus_strerror(err));
+        opus_encoder_destroy(encoder_);
+        encoder_ = NULL;
+        return;
+    }
+}
+
+OpusEncoder::~OpusEncoder() {
+    if (encoder_) {
+        opus_encoder_destroy(encoder_);
+    }
+}
+
+bool OpusEncoder::valid() const {
+    return encoder_;
+}
+
+size_t OpusEncoder::payload_size(size_t num_samples) const {
+    return (num_channels_ == 1 ? opus_payload_size_from_samples<1>(num_samples)
+                               : opus_payload_size_from_samples<2>(num_samples));
+}
+
+size_t OpusEncoder::write_samples(packet::Packet&,
+                                  size_t offset,
+                                  const audio::sample_t* in_samples,
+                                  size_t in_n_samples,
+                                  packet::channel_mask_t in_chan_mask) {
+    roc_panic_if_not(valid());
+
+    const packet::channel_mask_t out_chan_mask =
+        packet::channel_mask_t(1 << num_channels_) - 1;
+    const packet::channel_mask_t inout_chan_mask = in_chan_mask | out_chan_mask;
+
+    if (offset > OpusMaxFrameSamples) {
+        offset = OpusMaxFrameSamples;
+    }
+
+    if (in_n_samples > OpusMaxFrameSamples - offset) {
+        in_n_samples = OpusMaxFrameSamples - offset;
+    }
+
+    audio::sample_t* out_samples = frame_ + offset * num_channels_;
+
+    for (size_t ns = 0; ns < in_n_samples; ns++) {
+        for (packet::channel_mask_t ch = 1; ch <= inout_chan_mask && ch != 0; ch <<= 1) {
+            audio::sample_t s = 0;
+            if (in_chan_mask & ch) {
+                s = *in_samples++;
+            }
+            // unlike PCM, missing channels are zeroed since the frame
+            // buffer is reused between packets
+            if (out_chan_mask & ch) {
+                *out_samples++ = s;
+            }
+        }
+    }
+
+    return in_n_samples;
+}
+
+bool OpusEncoder::finish_packet(packet::Packet& packet, size_t n_samples) {
+    roc_panic_if_not(valid());
+
+    if (!packet.rtp()) {
+        roc_panic("opus encoder: unexpected non-rtp packet");
+    }
+
+    // truncated packet is padded with silence up to the nearest frame size
+    const size_t frame_size = round_frame_size(n_samples);
+    if (frame_size == 0) {
+        roc_log(LogError, "opus encoder: unsupported frame size: n_samples=%lu",
+                (unsigned long)n_samples);
+        return false;
+    }
+
+    for (size_t n = n_samples * num_channels_; n < frame_size * num_channels_; n++) {
+        frame_[n] = 0;
+    }
+
+    core::Slice<uint8_t>& payload = packet.rtp()->payload;
+
+    const opus_int32 size = opus_encode_float(encoder_, frame_, (int)frame_size,
+                                              payload.data(), (opus_int32)payload.size());
+    if (size < 0) {
+        roc_log(LogDebug, "opus encoder: opus_encode_float() failed: %s",
+                opus_strerror(size));
+        return false;
+    }
+
+    // keep packet size constant
+    if ((size_t)size < payload.size()) {
+        const int err = opus_packet_pad(payload.data(), size, (opus_int32)payload.size());
+        if (err != OPUS_OK) {
+            roc_log(LogDebug, "opus encoder: opus_packet_pad() failed: %s",
+                    opus_strerror(err));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace rtp
+} // namespace roc
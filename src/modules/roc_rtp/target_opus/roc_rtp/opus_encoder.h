@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtp/target_opus/roc_rtp/opus_encoder.h
+//! @brief Opus encoder.
+
+#ifndef ROC_RTP_OPUS_ENCODER_H_
+#define ROC_RTP_OPUS_ENCODER_H_
+
+#include "roc_audio/iencoder.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_rtp/opus_helpers.h"
+
+namespace roc {
+namespace rtp {
+
+//! Opus encoder.
+//! @remarks
+//!  Accumulates samples written to a packet and encodes them as a single
+//!  Opus frame when the packet is finished. Works in constant bitrate mode,
+//!  so that all packets of the same duration have the same size, as
+//!  required by FEC.
+class OpusEncoder : public audio::IEncoder, public core::NonCopyable<> {
+public:
+    //! Create encoder.
+    template <size_t NumCh> static audio::IEncoder* create(core::IAllocator& allocator) {
+        return create_(allocator, NumCh);
+    }
+
+    //! Initialize.
+    explicit OpusEncoder(size_t num_channels);
+
+    virtual ~OpusEncoder();
+
+    //! Check if the object was successfully constructed.
+    bool valid() const;
+
+    //! Get packet payload size.
+    virtual size_t payload_size(size_t num_samples) const;
+
+    //! Write samples to packet.
+    virtual size_t write_samples(packet::Packet& packet,
+                                 size_t offset,
+                                 const audio::sample_t* samples,
+                                 size_t n_samples,
+                                 packet::channel_mask_t channels);
+
+    //! Encode samples written to packet.
+    virtual bool finish_packet(packet::Packet& packet, size_t n_samples);
+
+private:
+    static audio::IEncoder* create_(core::IAllocator& allocator, size_t num_channels);
+
+    ::OpusEncoder* encoder_;
+
+    const size_t num_channels_;
+
+    audio::sample_t frame_[OpusMaxFrameSamples * OpusMaxChannels];
+};
+
+} // namespace rtp
+} // namespace roc
+
+#endif // ROC_RTP_OPUS_ENCODER_H_
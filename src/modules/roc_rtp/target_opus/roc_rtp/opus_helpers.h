@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtp/target_opus/roc_rtp/opus_helpers.h
+//! @brief Opus helpers.
+
+#ifndef ROC_RTP_OPUS_HELPERS_H_
+#define ROC_RTP_OPUS_HELPERS_H_
+
+#include <opus/opus.h>
+
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_packet/rtp.h"
+#include "roc_packet/units.h"
+#include "roc_rtp/headers.h"
+
+namespace roc {
+namespace rtp {
+
+//! Opus sample rate.
+const size_t OpusSampleRate = 48000;
+
+//! Opus bitrate per channel, in bits per second.
+const size_t OpusChannelBitrate = 64000;
+
+//! Maximum number of samples per channel in Opus packet (60ms).
+const size_t OpusMaxFrameSamples = 2880;
+
+//! Maximum number of channels in Opus packet.
+const size_t OpusMaxChannels = 2;
+
+//! Calculate packet duration.
+inline packet::timestamp_t opus_duration_from_header(const packet::RTP& rtp) {
+    const int n_samples = opus_packet_get_nb_samples(
+        rtp.payload.data(), (opus_int32)rtp.payload.size(), (opus_int32)OpusSampleRate);
+    if (n_samples <= 0) {
+        return 0;
+    }
+    return packet::timestamp_t(n_samples);
+}
+
+//! Calculate payload size.
+//! @remarks
+//!  Encoder works in constant bitrate mode, so payload size depends only on
+//!  the number of samples.
+template <size_t NumCh>
+size_t opus_payload_size_from_samples(size_t num_samples) {
+    const size_t bits_per_byte = 8;
+    return (num_samples * NumCh * OpusChannelBitrate + bits_per_byte * OpusSampleRate - 1)
+        / (bits_per_byte * OpusSampleRate);
+}
+
+//! Calculate packet size.
+template <size_t NumCh>
+size_t opus_packet_size_from_duration(core::nanoseconds_t duration) {
+    const packet::timestamp_diff_t num_samples =
+        packet::timestamp_from_ns(duration, OpusSampleRate);
+    if (num_samples < 0) {
+        return 0;
+    }
+    return sizeof(Header) + opus_payload_size_from_samples<NumCh>((size_t)num_samples);
+}
+
+//! Check packet duration.
+//! @remarks
+//!  Opus supports only 2.5, 5, 10, 20, 40, and 60 ms frames.
+inline bool opus_is_valid_duration(core::nanoseconds_t duration) {
+    switch (packet::timestamp_from_ns(duration, OpusSampleRate)) {
+    case 120:
+    case 240:
+    case 480:
+    case 960:
+    case 1920:
+    case 2880:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace rtp
+} // namespace roc
+
+#endif // ROC_RTP_OPUS_HELPERS_H_
@@ -20,6 +20,10 @@ Validator::Validator(packet::IReader& reader,
     , config_(config) {
 }
 
+void Validator::reset() {
+    prev_packet_ = NULL;
+}
+
 packet::PacketPtr Validator::read() {
     packet::PacketPtr next_packet = reader_.read();
     if (!next_packet) {
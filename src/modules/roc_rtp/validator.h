@@ -53,6 +53,11 @@ public:
     //!  is valid, return it. Otherwise, returns NULL.
     virtual packet::PacketPtr read();
 
+    //! Reset to initial state.
+    //! @remarks
+    //!  Forgets previous packet, so that the next packet is always valid.
+    void reset();
+
 private:
     bool check_(const packet::RTP& prev, const packet::RTP& next) const;
 
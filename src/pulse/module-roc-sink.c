@@ -302,6 +302,11 @@ int pa__init(pa_module* m) {
         goto error;
     }
 
+    if (roc_sender_start(u->sender) != 0) {
+        pa_log("can't start roc sender");
+        goto error;
+    }
+
     /* create and initialize sink */
     pa_sink_new_data data;
     pa_sink_new_data_init(&data);
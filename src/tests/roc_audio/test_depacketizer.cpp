@@ -36,6 +36,28 @@ rtp::Composer rtp_composer(NULL);
 rtp::PCMEncoder<int16_t, NumCh> pcm_encoder;
 rtp::PCMDecoder<int16_t, NumCh> pcm_decoder;
 
+// Conceals no more than given number of samples per call with a constant.
+class ConcealingDecoder : public rtp::PCMDecoder<int16_t, NumCh> {
+public:
+    ConcealingDecoder(size_t max_samples, sample_t value)
+        : max_samples_(max_samples)
+        , value_(value) {
+    }
+
+    virtual size_t
+    conceal_samples(sample_t* samples, size_t n_samples, packet::channel_mask_t) {
+        n_samples = std::min(n_samples, max_samples_);
+        for (size_t n = 0; n < n_samples * NumCh; n++) {
+            samples[n] = value_;
+        }
+        return n_samples;
+    }
+
+private:
+    const size_t max_samples_;
+    const sample_t value_;
+};
+
 } // namespace
 
 TEST_GROUP(depacketizer) {
@@ -104,7 +126,7 @@ TEST_GROUP(depacketizer) {
 
 TEST(depacketizer, one_packet_one_read) {
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     queue.write(new_packet(0, 0.11f));
 
@@ -113,7 +135,7 @@ TEST(depacketizer, one_packet_one_read) {
 
 TEST(depacketizer, one_packet_multiple_reads) {
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     queue.write(new_packet(0, 0.11f));
 
@@ -126,7 +148,7 @@ TEST(depacketizer, multiple_packets_one_read) {
     enum { NumPackets = 10 };
 
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     for (packet::timestamp_t n = 0; n < NumPackets; n++) {
         queue.write(new_packet(n * SamplesPerPacket, 0.11f));
@@ -141,7 +163,7 @@ TEST(depacketizer, multiple_packets_multiple_reads) {
     CHECK(SamplesPerPacket % FramesPerPacket== 0);
 
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     queue.write(new_packet(1 * SamplesPerPacket, 0.11f));
     queue.write(new_packet(2 * SamplesPerPacket, 0.22f));
@@ -162,7 +184,7 @@ TEST(depacketizer, multiple_packets_multiple_reads) {
 
 TEST(depacketizer, timestamp_overflow) {
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     const packet::timestamp_t ts2 = 0;
     const packet::timestamp_t ts1 = ts2 - SamplesPerPacket;
@@ -179,7 +201,7 @@ TEST(depacketizer, timestamp_overflow) {
 
 TEST(depacketizer, drop_late_packets) {
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     const packet::timestamp_t ts1 = SamplesPerPacket * 2;
     const packet::timestamp_t ts2 = SamplesPerPacket * 1;
@@ -195,7 +217,7 @@ TEST(depacketizer, drop_late_packets) {
 
 TEST(depacketizer, drop_late_packets_timestamp_overflow) {
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     const packet::timestamp_t ts1 = 0;
     const packet::timestamp_t ts2 = ts1 - SamplesPerPacket;
@@ -211,14 +233,14 @@ TEST(depacketizer, drop_late_packets_timestamp_overflow) {
 
 TEST(depacketizer, zeros_no_packets) {
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     expect_output(dp, SamplesPerPacket, 0.00f);
 }
 
 TEST(depacketizer, zeros_no_next_packet) {
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     queue.write(new_packet(0, 0.11f));
 
@@ -228,7 +250,7 @@ TEST(depacketizer, zeros_no_next_packet) {
 
 TEST(depacketizer, zeros_between_packets) {
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     queue.write(new_packet(1 * SamplesPerPacket, 0.11f));
     queue.write(new_packet(3 * SamplesPerPacket, 0.33f));
@@ -238,9 +260,69 @@ TEST(depacketizer, zeros_between_packets) {
     expect_output(dp, SamplesPerPacket, 0.33f);
 }
 
+TEST(depacketizer, conceal_between_packets) {
+    ConcealingDecoder decoder(SamplesPerPacket / 2, 0.77f);
+
+    packet::Queue queue;
+    Depacketizer dp(queue, decoder, NULL, ChMask, false);
+
+    // no concealment before first packet
+    expect_output(dp, SamplesPerPacket, 0.00f);
+
+    queue.write(new_packet(2 * SamplesPerPacket, 0.11f));
+    queue.write(new_packet(4 * SamplesPerPacket, 0.33f));
+
+    expect_output(dp, SamplesPerPacket, 0.11f);
+
+    core::Slice<sample_t> buf = new_buffer(SamplesPerPacket);
+    Frame frame(buf.data(), buf.size());
+    dp.read(frame);
+
+    expect_values(frame.data(), SamplesPerPacket / 2 * NumCh, 0.77f);
+    expect_values(frame.data() + SamplesPerPacket / 2 * NumCh,
+                  SamplesPerPacket / 2 * NumCh, 0.00f);
+
+    expect_output(dp, SamplesPerPacket, 0.33f);
+}
+
+TEST(depacketizer, plc_between_packets) {
+    enum { NumHistoryPackets = 8 };
+
+    PLCConfig config;
+    config.enabled = true;
+
+    PLC plc(config, ChMask, 44100, allocator);
+    CHECK(plc.valid());
+
+    packet::Queue queue;
+    Depacketizer dp(queue, pcm_decoder, &plc, ChMask, false);
+
+    for (size_t n = 0; n < NumHistoryPackets; n++) {
+        queue.write(new_packet(n * SamplesPerPacket, 0.11f));
+    }
+    queue.write(new_packet((NumHistoryPackets + 1) * SamplesPerPacket, 0.33f));
+
+    for (size_t n = 0; n < NumHistoryPackets; n++) {
+        expect_output(dp, SamplesPerPacket, 0.11f);
+    }
+
+    // gap is concealed by repeating the signal
+    expect_output(dp, SamplesPerPacket, 0.11f);
+
+    core::Slice<sample_t> buf = new_buffer(SamplesPerPacket);
+    Frame frame(buf.data(), buf.size());
+    dp.read(frame);
+
+    // beginning of the next packet is cross-faded with the concealed signal
+    CHECK(frame.data()[0] < 0.33f);
+    CHECK(frame.data()[0] > 0.11f);
+    expect_values(frame.data() + SamplesPerPacket / 2 * NumCh,
+                  SamplesPerPacket / 2 * NumCh, 0.33f);
+}
+
 TEST(depacketizer, zeros_between_packets_timestamp_overflow) {
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     const packet::timestamp_t ts2 = 0;
     const packet::timestamp_t ts1 = ts2 - SamplesPerPacket;
@@ -254,11 +336,91 @@ TEST(depacketizer, zeros_between_packets_timestamp_overflow) {
     expect_output(dp, SamplesPerPacket, 0.33f);
 }
 
+TEST(depacketizer, add_delay) {
+    packet::Queue queue;
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
+
+    // ignored before first packet
+    dp.add_delay(SamplesPerPacket);
+
+    queue.write(new_packet(0, 0.11f));
+    queue.write(new_packet(SamplesPerPacket, 0.22f));
+
+    expect_output(dp, SamplesPerPacket / 2, 0.11f);
+
+    dp.add_delay(SamplesPerPacket);
+
+    const packet::timestamp_t ts = dp.timestamp();
+
+    expect_output(dp, SamplesPerPacket, 0.000f);
+    UNSIGNED_LONGS_EQUAL(ts, dp.timestamp());
+
+    expect_output(dp, SamplesPerPacket / 2, 0.11f);
+    expect_output(dp, SamplesPerPacket, 0.22f);
+}
+
+TEST(depacketizer, skip) {
+    packet::Queue queue;
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
+
+    // ignored before first packet
+    dp.skip(SamplesPerPacket);
+
+    queue.write(new_packet(0, 0.11f));
+    queue.write(new_packet(SamplesPerPacket, 0.22f));
+    queue.write(new_packet(SamplesPerPacket * 2, 0.33f));
+    queue.write(new_packet(SamplesPerPacket * 3, 0.44f));
+
+    expect_output(dp, SamplesPerPacket / 2, 0.11f);
+
+    const packet::timestamp_t ts = dp.timestamp();
+
+    // cancels pending delay first
+    dp.add_delay(SamplesPerPacket);
+    dp.skip(SamplesPerPacket);
+
+    UNSIGNED_LONGS_EQUAL(ts, dp.timestamp());
+    UNSIGNED_LONGS_EQUAL(0, dp.pending_delay());
+
+    // skips the rest of the current packet and one queued packet
+    dp.skip(SamplesPerPacket * 2);
+
+    UNSIGNED_LONGS_EQUAL(ts + SamplesPerPacket * 2, dp.timestamp());
+
+    expect_flags(dp, SamplesPerPacket / 2, 0);
+    expect_output(dp, SamplesPerPacket, 0.44f);
+}
+
+TEST(depacketizer, reset) {
+    packet::Queue queue;
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
+
+    queue.write(new_packet(0, 0.11f));
+    queue.write(new_packet(SamplesPerPacket, 0.22f));
+
+    expect_output(dp, SamplesPerPacket / 2, 0.11f);
+    CHECK(dp.started());
+
+    dp.reset();
+    CHECK(!dp.started());
+
+    // the rest of the old stream is dropped
+    while (queue.read()) {
+    }
+
+    expect_output(dp, SamplesPerPacket, 0.00f);
+
+    queue.write(new_packet(SamplesPerPacket * 10, 0.33f));
+
+    expect_output(dp, SamplesPerPacket, 0.33f);
+    UNSIGNED_LONGS_EQUAL(SamplesPerPacket * 11, dp.timestamp());
+}
+
 TEST(depacketizer, zeros_after_packet) {
     CHECK(SamplesPerPacket % 2 == 0);
 
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     queue.write(new_packet(0, 0.11f));
 
@@ -279,7 +441,7 @@ TEST(depacketizer, zeros_after_packet) {
 
 TEST(depacketizer, packet_after_zeros) {
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     expect_output(dp, SamplesPerPacket, 0.00f);
 
@@ -292,7 +454,7 @@ TEST(depacketizer, overlapping_packets) {
     CHECK(SamplesPerPacket % 2 == 0);
 
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     packet::timestamp_t ts1 = 0;
     packet::timestamp_t ts2 = SamplesPerPacket / 2;
@@ -311,7 +473,7 @@ TEST(depacketizer, frame_flags_incompltete_blank) {
     enum { PacketsPerFrame = 3 };
 
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     packet::PacketPtr packets[][PacketsPerFrame] = {
         {
@@ -374,11 +536,18 @@ TEST(depacketizer, frame_flags_incompltete_blank) {
 
         expect_flags(dp, SamplesPerPacket * PacketsPerFrame, frame_flags[n]);
     }
+
+    UNSIGNED_LONGS_EQUAL(13, dp.stats().n_packets);
+    UNSIGNED_LONGS_EQUAL(0, dp.stats().n_late_packets);
+    UNSIGNED_LONGS_EQUAL(ROC_ARRAY_SIZE(packets), dp.stats().n_frames);
+    UNSIGNED_LONGS_EQUAL(2, dp.stats().n_blank_frames);
+    UNSIGNED_LONGS_EQUAL(4, dp.stats().n_incomplete_frames);
+    UNSIGNED_LONGS_EQUAL(13 * SamplesPerPacket, dp.stats().n_decoded_samples);
 }
 
 TEST(depacketizer, frame_flags_drops) {
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     packet::PacketPtr packets[] = {
         new_packet(SamplesPerPacket * 4, 0.11f),
@@ -405,6 +574,17 @@ TEST(depacketizer, frame_flags_drops) {
     for (size_t n = 0; n < ROC_ARRAY_SIZE(frame_flags); n++) {
         expect_flags(dp, SamplesPerPacket, frame_flags[n]);
     }
+
+    UNSIGNED_LONGS_EQUAL(4, dp.stats().n_packets);
+    UNSIGNED_LONGS_EQUAL(3, dp.stats().n_late_packets);
+    UNSIGNED_LONGS_EQUAL(ROC_ARRAY_SIZE(frame_flags), dp.stats().n_frames);
+    UNSIGNED_LONGS_EQUAL(1, dp.stats().n_blank_frames);
+    UNSIGNED_LONGS_EQUAL(SamplesPerPacket, dp.stats().n_missing_samples);
+
+    dp.reset();
+
+    UNSIGNED_LONGS_EQUAL(0, dp.stats().n_packets);
+    UNSIGNED_LONGS_EQUAL(0, dp.stats().n_frames);
 }
 
 TEST(depacketizer, timestamp) {
@@ -418,7 +598,7 @@ TEST(depacketizer, timestamp) {
     CHECK(SamplesPerPacket % FramesPerPacket== 0);
 
     packet::Queue queue;
-    Depacketizer dp(queue, pcm_decoder, ChMask, false);
+    Depacketizer dp(queue, pcm_decoder, NULL, ChMask, false);
 
     for (size_t n = 0; n < NumPackets * FramesPerPacket; n++) {
         expect_output(dp, SamplesPerFrame, 0.0f);
@@ -9,28 +9,78 @@
 #include <CppUTest/TestHarness.h>
 
 #include "roc_audio/freq_estimator.h"
+#include "roc_core/log.h"
+#include "roc_core/stddefs.h"
 
 namespace roc {
 namespace audio {
 
 namespace {
 
-enum { Target = 10000 };
+enum {
+    Target = 10000,
+
+    SampleRate = 44100,
+    UpdateInterval = SampleRate / 200,
+    SimTarget = SampleRate / 5,
+    SimDuration = SampleRate * 300
+};
 
 const float Epsilon = 0.0001f;
 
+const double MaxLatencyError = 0.01;
+const double MaxCoeffError = 50e-6;
+const double MaxScalingDelta = 0.005;
+
 } // namespace
 
-TEST_GROUP(freq_estimator){};
+TEST_GROUP(freq_estimator) {
+    FreqEstimatorConfig config;
+
+    // Simulate a session where sender clock is faster than receiver clock by
+    // @p drift and return the time after which the latency stays close to the
+    // target and the coefficient compensates the drift, in seconds.
+    double convergence_time(double drift) {
+        FreqEstimator fe(config, SimTarget);
+
+        double latency = SimTarget;
+        double converged_at = -1;
+
+        for (size_t pos = 0; pos < SimDuration; pos += UpdateInterval) {
+            const double coeff = std::min(
+                std::max((double)fe.freq_coeff(), 1 - MaxScalingDelta),
+                1 + MaxScalingDelta);
+
+            latency += UpdateInterval * (1 + drift - coeff);
+            fe.update((packet::timestamp_t)latency);
+
+            const bool converged =
+                std::fabs(latency - SimTarget) < SimTarget * MaxLatencyError
+                && std::fabs((double)fe.freq_coeff() - 1 - drift) < MaxCoeffError;
+
+            if (!converged) {
+                converged_at = -1;
+            } else if (converged_at < 0) {
+                converged_at = double(pos) / SampleRate;
+            }
+        }
+
+        roc_log(LogInfo, "freq estimator: mode=%d drift=%.6f convergence_time=%.1fs",
+                (int)config.mode, drift, converged_at);
+
+        CHECK(converged_at >= 0);
+        return converged_at;
+    }
+};
 
 TEST(freq_estimator, initial) {
-    FreqEstimator fe(Target);
+    FreqEstimator fe(config, Target);
 
     DOUBLES_EQUAL(1.0, fe.freq_coeff(), Epsilon);
 }
 
 TEST(freq_estimator, aim_queue_size) {
-    FreqEstimator fe(Target);
+    FreqEstimator fe(config, Target);
 
     for (size_t n = 0; n < 1000; n++) {
         fe.update(Target);
@@ -40,7 +90,7 @@ TEST(freq_estimator, aim_queue_size) {
 }
 
 TEST(freq_estimator, large_queue_size) {
-    FreqEstimator fe(Target);
+    FreqEstimator fe(config, Target);
 
     do {
         fe.update(Target * 2);
@@ -48,12 +98,62 @@ TEST(freq_estimator, large_queue_size) {
 }
 
 TEST(freq_estimator, small_queue_size) {
-    FreqEstimator fe(Target);
+    FreqEstimator fe(config, Target);
 
     do {
         fe.update(Target / 2);
     } while (fe.freq_coeff() > 0.99f);
 }
 
+TEST(freq_estimator, fixed_mode) {
+    config.mode = FreqEstimatorMode_Fixed;
+
+    FreqEstimator fe(config, Target);
+    CHECK(fe.locked());
+
+    do {
+        fe.update(Target * 2);
+    } while (fe.freq_coeff() < 1.01f);
+
+    CHECK(fe.locked());
+}
+
+TEST(freq_estimator, lock_and_unlock) {
+    FreqEstimator fe(config, Target);
+    CHECK(!fe.locked());
+
+    for (size_t n = 0; n < config.lock_duration * fe_decim_factor; n++) {
+        fe.update(Target);
+    }
+    CHECK(fe.locked());
+
+    fe.set_target(Target * 2);
+
+    for (size_t n = 0; n < fe_decim_factor * fe_decim_factor; n++) {
+        fe.update(Target);
+    }
+    CHECK(!fe.locked());
+}
+
+TEST(freq_estimator, convergence_positive_drift) {
+    const double adaptive_time = convergence_time(+500e-6);
+
+    config.mode = FreqEstimatorMode_Fixed;
+    const double fixed_time = convergence_time(+500e-6);
+
+    CHECK(adaptive_time < 20);
+    CHECK(adaptive_time * 5 < fixed_time);
+}
+
+TEST(freq_estimator, convergence_negative_drift) {
+    const double adaptive_time = convergence_time(-500e-6);
+
+    config.mode = FreqEstimatorMode_Fixed;
+    const double fixed_time = convergence_time(-500e-6);
+
+    CHECK(adaptive_time < 20);
+    CHECK(adaptive_time * 5 < fixed_time);
+}
+
 } // namespace audio
 } // namespace roc
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/depacketizer.h"
+#include "roc_audio/latency_monitor.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/time.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/sorted_queue.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/pcm_decoder.h"
+#include "roc_rtp/pcm_encoder.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum {
+    MaxBufSize = 1000,
+    SampleRate = 1000,
+    SamplesPerPacket = 10,
+    NumPackets = 5,
+    NumCh = 2,
+    ChMask = 0x3
+};
+
+const core::nanoseconds_t PacketLength = SamplesPerPacket * core::Second / SampleRate;
+
+core::HeapAllocator allocator;
+core::BufferPool<sample_t> sample_buffer_pool(allocator, MaxBufSize, true);
+core::BufferPool<uint8_t> byte_buffer_pool(allocator, MaxBufSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+rtp::Composer rtp_composer(NULL);
+
+rtp::PCMEncoder<int16_t, NumCh> pcm_encoder;
+rtp::PCMDecoder<int16_t, NumCh> pcm_decoder;
+
+} // namespace
+
+TEST_GROUP(latency_monitor) {
+    LatencyMonitorConfig config;
+
+    void setup() {
+        config.min_latency = 0;
+        config.max_latency = NumPackets * 4 * PacketLength;
+    }
+
+    // Creates packet number n; if receive_ts is non-zero, packet gets UDP header
+    // with this receive timestamp.
+    packet::PacketPtr new_packet(size_t n, core::nanoseconds_t receive_ts) {
+        return new_packet(n, packet::timestamp_t(n * SamplesPerPacket), receive_ts);
+    }
+
+    packet::PacketPtr
+    new_packet(size_t n, packet::timestamp_t ts, core::nanoseconds_t receive_ts) {
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        core::Slice<uint8_t> bp =
+            new (byte_buffer_pool) core::Buffer<uint8_t>(byte_buffer_pool);
+        CHECK(bp);
+
+        CHECK(rtp_composer.prepare(*pp, bp, pcm_encoder.payload_size(SamplesPerPacket)));
+
+        pp->set_data(bp);
+
+        pp->rtp()->seqnum = packet::seqnum_t(n);
+        pp->rtp()->timestamp = ts;
+        pp->rtp()->duration = SamplesPerPacket;
+
+        sample_t samples[SamplesPerPacket * NumCh] = {};
+        UNSIGNED_LONGS_EQUAL(
+            SamplesPerPacket,
+            pcm_encoder.write_samples(*pp, 0, samples, SamplesPerPacket, ChMask));
+
+        CHECK(rtp_composer.compose(*pp));
+
+        if (receive_ts != 0) {
+            pp->add_flags(packet::Packet::FlagUDP);
+            pp->udp()->receive_timestamp = receive_ts;
+        }
+
+        return pp;
+    }
+
+    void read_packet(Depacketizer& depacketizer) {
+        core::Slice<sample_t> buf =
+            new (sample_buffer_pool) core::Buffer<sample_t>(sample_buffer_pool);
+        CHECK(buf);
+        buf.resize(SamplesPerPacket * NumCh);
+
+        Frame frame(buf.data(), buf.size());
+        depacketizer.read(frame);
+    }
+
+    // Writes NumPackets packets, the latest one with given receive timestamp,
+    // reads the first one, and returns latency measured by monitor.
+    packet::timestamp_t measure_latency(core::nanoseconds_t receive_ts) {
+        packet::SortedQueue queue(0);
+        Depacketizer depacketizer(queue, pcm_decoder, NULL, ChMask, false);
+
+        LatencyMonitor monitor(queue, depacketizer, NULL, NULL, config,
+                               NumPackets * PacketLength, SampleRate, SampleRate);
+        CHECK(monitor.valid());
+
+        for (size_t n = 0; n < NumPackets; n++) {
+            queue.write(new_packet(n, n == NumPackets - 1 ? receive_ts : 0));
+        }
+
+        read_packet(depacketizer);
+
+        CHECK(monitor.update(SamplesPerPacket));
+        return monitor.latency();
+    }
+
+    // Writes NumPackets packets, reads the first one, then writes a packet
+    // which timestamp jumps by given number of samples, and updates monitor.
+    bool update_after_jump(packet::timestamp_diff_t jump, packet::timestamp_t& latency) {
+        packet::SortedQueue queue(0);
+        Depacketizer depacketizer(queue, pcm_decoder, NULL, ChMask, false);
+
+        LatencyMonitor monitor(queue, depacketizer, NULL, NULL, config,
+                               NumPackets * PacketLength, SampleRate, SampleRate);
+        CHECK(monitor.valid());
+
+        for (size_t n = 0; n < NumPackets; n++) {
+            queue.write(new_packet(n, 0));
+        }
+
+        read_packet(depacketizer);
+
+        CHECK(monitor.update(SamplesPerPacket));
+        UNSIGNED_LONGS_EQUAL((NumPackets - 1) * SamplesPerPacket, monitor.latency());
+
+        queue.write(new_packet(
+            NumPackets, packet::timestamp_t(NumPackets * SamplesPerPacket + jump), 0));
+
+        const bool ret = monitor.update(SamplesPerPacket);
+        latency = monitor.latency();
+        return ret;
+    }
+};
+
+TEST(latency_monitor, no_receive_timestamp) {
+    // distance between the read position and the end of the latest packet
+    UNSIGNED_LONGS_EQUAL((NumPackets - 1) * SamplesPerPacket, measure_latency(0));
+}
+
+TEST(latency_monitor, fresh_receive_timestamp) {
+    const packet::timestamp_t latency = measure_latency(core::timestamp());
+
+    CHECK(latency >= (NumPackets - 1) * SamplesPerPacket);
+    CHECK(latency < NumPackets * SamplesPerPacket);
+}
+
+TEST(latency_monitor, old_receive_timestamp) {
+    const packet::timestamp_t latency =
+        measure_latency(core::timestamp() - PacketLength / 2);
+
+    // extended by the time passed since the packet arrival
+    CHECK(latency >= (NumPackets - 1) * SamplesPerPacket + SamplesPerPacket / 2);
+    CHECK(latency <= NumPackets * SamplesPerPacket);
+}
+
+TEST(latency_monitor, arrival_offset_clamped) {
+    // the next packet is late or lost, but the offset doesn't grow beyond the
+    // duration of the latest packet
+    UNSIGNED_LONGS_EQUAL(NumPackets * SamplesPerPacket,
+                         measure_latency(core::timestamp() - core::Second));
+}
+
+TEST(latency_monitor, recover_small_forward_jump) {
+    packet::timestamp_t latency = 0;
+
+    // above max latency, but close enough to recover in place
+    CHECK(update_after_jump(NumPackets * SamplesPerPacket * 4, latency));
+    UNSIGNED_LONGS_EQUAL(NumPackets * SamplesPerPacket, latency);
+}
+
+TEST(latency_monitor, recover_small_backward_jump) {
+    packet::timestamp_t latency = 0;
+
+    // below min latency, but close enough to recover in place
+    CHECK(update_after_jump(-NumPackets * SamplesPerPacket * 2, latency));
+    UNSIGNED_LONGS_EQUAL(NumPackets * SamplesPerPacket, latency);
+}
+
+TEST(latency_monitor, no_recovery_when_disabled) {
+    config.latency_recovery = false;
+
+    packet::timestamp_t latency = 0;
+    CHECK(!update_after_jump(NumPackets * SamplesPerPacket * 4, latency));
+}
+
+TEST(latency_monitor, large_forward_jump) {
+    packet::timestamp_t latency = 0;
+
+    CHECK(!update_after_jump(SampleRate * 3600, latency));
+}
+
+TEST(latency_monitor, large_backward_jump) {
+    packet::timestamp_t latency = 0;
+
+    CHECK(!update_after_jump(-SampleRate * 3600, latency));
+}
+
+TEST(latency_monitor, huge_jump_no_overflow) {
+    packet::timestamp_t latency = 0;
+
+    // timestamp distance is close to the maximum int32 value
+    CHECK(!update_after_jump(0x7fffffff - NumPackets * SamplesPerPacket, latency));
+    CHECK(!update_after_jump(-0x7fffffff, latency));
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/latency_tuner.h"
+#include "roc_core/helpers.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { SampleRate = 44100, SamplesPerPacket = 441 };
+
+const core::nanoseconds_t PacketDuration = 10 * core::Millisecond;
+const core::nanoseconds_t InitialLatency = 200 * core::Millisecond;
+const core::nanoseconds_t NetworkDelay = 30 * core::Millisecond;
+
+packet::timestamp_t ns_to_ts(core::nanoseconds_t ns) {
+    return (packet::timestamp_t)packet::timestamp_from_ns(ns, SampleRate);
+}
+
+} // namespace
+
+TEST_GROUP(latency_tuner) {
+    LatencyTunerConfig config;
+
+    size_t packet_num;
+    unsigned int seed;
+
+    void setup() {
+        config.enabled = true;
+        packet_num = 0;
+        seed = 1;
+    }
+
+    // Deterministic pseudo-random number in range [0; 1).
+    double next_random() {
+        seed = seed * 1103515245 + 12345;
+        return double((seed >> 16) & 0x7fff) / 0x8000;
+    }
+
+    // Simulate given duration of the stream with packet delays uniformly
+    // distributed in range [NetworkDelay; NetworkDelay + max_jitter].
+    void simulate(LatencyTuner & tuner, core::nanoseconds_t duration,
+                  core::nanoseconds_t max_jitter) {
+        const size_t n_packets = size_t(duration / PacketDuration);
+
+        for (size_t n = 0; n < n_packets; n++) {
+            const core::nanoseconds_t send_time =
+                core::nanoseconds_t(packet_num) * PacketDuration;
+            const core::nanoseconds_t jitter =
+                core::nanoseconds_t(next_random() * (double)max_jitter);
+
+            tuner.add_packet(send_time + NetworkDelay + jitter,
+                             packet::timestamp_t(packet_num * SamplesPerPacket));
+            packet_num++;
+        }
+    }
+};
+
+TEST(latency_tuner, invalid_config) {
+    config.min_latency = InitialLatency * 2;
+
+    LatencyTuner tuner(config, InitialLatency, SampleRate);
+    CHECK(!tuner.valid());
+}
+
+TEST(latency_tuner, initial) {
+    LatencyTuner tuner(config, InitialLatency, SampleRate);
+    CHECK(tuner.valid());
+
+    UNSIGNED_LONGS_EQUAL(ns_to_ts(InitialLatency), tuner.target_latency());
+
+    simulate(tuner, core::Second, 0);
+
+    // no sudden changes
+    CHECK(tuner.target_latency() <= ns_to_ts(InitialLatency));
+    CHECK(tuner.target_latency() > ns_to_ts(InitialLatency) * 9 / 10);
+}
+
+TEST(latency_tuner, low_jitter) {
+    config.max_latency = InitialLatency;
+
+    LatencyTuner tuner(config, InitialLatency, SampleRate);
+    CHECK(tuner.valid());
+
+    simulate(tuner, 120 * core::Second, 3 * core::Millisecond);
+
+    UNSIGNED_LONGS_EQUAL(ns_to_ts(config.min_latency), tuner.target_latency());
+
+    CHECK(tuner.peak_jitter() <= 3 * core::Millisecond);
+    CHECK(tuner.mean_jitter() <= 3 * core::Millisecond);
+}
+
+TEST(latency_tuner, jitter_spike) {
+    LatencyTuner tuner(config, InitialLatency, SampleRate);
+    CHECK(tuner.valid());
+
+    simulate(tuner, 120 * core::Second, 2 * core::Millisecond);
+    UNSIGNED_LONGS_EQUAL(ns_to_ts(config.min_latency), tuner.target_latency());
+
+    // latency should be raised within a few packets
+    simulate(tuner, 100 * core::Millisecond, 60 * core::Millisecond);
+
+    CHECK(tuner.peak_jitter() >= 30 * core::Millisecond);
+    CHECK(tuner.target_latency()
+          >= packet::timestamp_t(ns_to_ts(tuner.peak_jitter()) * 19 / 10));
+}
+
+TEST(latency_tuner, slow_decrease) {
+    LatencyTuner tuner(config, InitialLatency, SampleRate);
+    CHECK(tuner.valid());
+
+    simulate(tuner, 20 * core::Second, 80 * core::Millisecond);
+
+    CHECK(tuner.target_latency() >= ns_to_ts(140 * core::Millisecond));
+
+    // high jitter is remembered for at least one window
+    simulate(tuner, config.jitter_window, 2 * core::Millisecond);
+    CHECK(tuner.target_latency() >= ns_to_ts(140 * core::Millisecond));
+
+    // then latency is lowered gradually
+    const packet::timestamp_t max_step =
+        ns_to_ts(core::nanoseconds_t(core::Second * config.decrease_speed)) + 1;
+
+    packet::timestamp_t prev_target = tuner.target_latency();
+
+    for (size_t n = 0; n < 120; n++) {
+        simulate(tuner, core::Second, 2 * core::Millisecond);
+
+        CHECK(tuner.target_latency() <= prev_target);
+        CHECK(prev_target - tuner.target_latency() <= max_step);
+
+        prev_target = tuner.target_latency();
+    }
+
+    UNSIGNED_LONGS_EQUAL(ns_to_ts(config.min_latency), tuner.target_latency());
+}
+
+TEST(latency_tuner, varying_jitter) {
+    LatencyTuner tuner(config, InitialLatency, SampleRate);
+    CHECK(tuner.valid());
+
+    const core::nanoseconds_t profile[] = {
+        5 * core::Millisecond,  40 * core::Millisecond, 10 * core::Millisecond,
+        70 * core::Millisecond, 20 * core::Millisecond, 5 * core::Millisecond,
+    };
+
+    for (size_t p = 0; p < ROC_ARRAY_SIZE(profile); p++) {
+        for (size_t n = 0; n < 300; n++) {
+            simulate(tuner, 100 * core::Millisecond, profile[p]);
+
+            // target always covers the jitter seen in the current window
+            CHECK(tuner.target_latency() >= ns_to_ts(tuner.peak_jitter()));
+
+            CHECK(tuner.target_latency() >= ns_to_ts(config.min_latency));
+            CHECK(tuner.target_latency() <= ns_to_ts(config.max_latency));
+        }
+    }
+}
+
+TEST(latency_tuner, clamp_to_max) {
+    LatencyTuner tuner(config, InitialLatency, SampleRate);
+    CHECK(tuner.valid());
+
+    simulate(tuner, 5 * core::Second, 500 * core::Millisecond);
+
+    UNSIGNED_LONGS_EQUAL(ns_to_ts(config.max_latency), tuner.target_latency());
+}
+
+} // namespace audio
+} // namespace roc
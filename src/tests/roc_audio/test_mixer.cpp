@@ -26,6 +26,13 @@ core::HeapAllocator allocator;
 core::BufferPool<sample_t> buffer_pool(allocator, MaxSz, true);
 core::BufferPool<sample_t> large_buffer_pool(allocator, MaxSz * 10, true);
 
+// Leaves frame untouched.
+class EmptyReader : public IReader {
+public:
+    virtual void read(Frame&) {
+    }
+};
+
 } // namespace
 
 TEST_GROUP(mixer) {
@@ -49,7 +56,7 @@ TEST_GROUP(mixer) {
 };
 
 TEST(mixer, no_readers) {
-    Mixer mixer(buffer_pool, MaxSz);
+    Mixer mixer(buffer_pool, MaxSz, false);
     CHECK(mixer.valid());
 
     expect_output(mixer, BufSz, 0);
@@ -58,7 +65,7 @@ TEST(mixer, no_readers) {
 TEST(mixer, one_reader) {
     MockReader reader;
 
-    Mixer mixer(buffer_pool, MaxSz);
+    Mixer mixer(buffer_pool, MaxSz, false);
     CHECK(mixer.valid());
 
     mixer.add(reader);
@@ -72,7 +79,7 @@ TEST(mixer, one_reader) {
 TEST(mixer, one_reader_large) {
     MockReader reader;
 
-    Mixer mixer(buffer_pool, MaxSz);
+    Mixer mixer(buffer_pool, MaxSz, false);
     CHECK(mixer.valid());
 
     mixer.add(reader);
@@ -87,7 +94,7 @@ TEST(mixer, two_readers) {
     MockReader reader1;
     MockReader reader2;
 
-    Mixer mixer(buffer_pool, MaxSz);
+    Mixer mixer(buffer_pool, MaxSz, false);
     CHECK(mixer.valid());
 
     mixer.add(reader1);
@@ -106,7 +113,7 @@ TEST(mixer, remove_reader) {
     MockReader reader1;
     MockReader reader2;
 
-    Mixer mixer(buffer_pool, MaxSz);
+    Mixer mixer(buffer_pool, MaxSz, false);
     CHECK(mixer.valid());
 
     mixer.add(reader1);
@@ -136,7 +143,7 @@ TEST(mixer, clamp) {
     MockReader reader1;
     MockReader reader2;
 
-    Mixer mixer(buffer_pool, MaxSz);
+    Mixer mixer(buffer_pool, MaxSz, false);
     CHECK(mixer.valid());
 
     mixer.add(reader1);
@@ -161,5 +168,103 @@ TEST(mixer, clamp) {
     CHECK(reader2.num_unread() == 0);
 }
 
+TEST(mixer, read_as_s16le) {
+    enum { NumCh = 2 };
+
+    MockReader reader1;
+    MockReader reader2;
+
+    Mixer mixer(buffer_pool, MaxSz, false);
+    CHECK(mixer.valid());
+
+    mixer.add(reader1);
+    mixer.add(reader2);
+
+    reader1.add(MaxSz * 2, 0.25f);
+    reader2.add(MaxSz * 2, 0.5f);
+
+    int16_t output[MaxSz * 2];
+    mixer.read_as(output, MaxSz * 2, SampleFormat_S16LE, NumCh);
+
+    for (size_t n = 0; n < MaxSz * 2; n++) {
+        const uint8_t* bytes = (const uint8_t*)&output[n];
+        LONGS_EQUAL(24576, int16_t(bytes[0] | (bytes[1] << 8)));
+    }
+
+    reader1.add(MaxSz, 0.9f);
+    reader2.add(MaxSz, 0.9f);
+
+    mixer.read_as(output, MaxSz, SampleFormat_S16LE, NumCh);
+
+    for (size_t n = 0; n < MaxSz; n++) {
+        const uint8_t* bytes = (const uint8_t*)&output[n];
+        LONGS_EQUAL(32767, int16_t(bytes[0] | (bytes[1] << 8)));
+    }
+
+    CHECK(reader1.num_unread() == 0);
+    CHECK(reader2.num_unread() == 0);
+}
+
+TEST(mixer, read_as_same_mix_as_read) {
+    enum { NumCh = 2, NumReaders = 3 };
+
+    const sample_t values[NumReaders] = { 0.9f, 0.9f, -0.9f };
+
+    MockReader readers[NumReaders];
+
+    Mixer mixer(buffer_pool, MaxSz, false);
+    CHECK(mixer.valid());
+
+    for (size_t r = 0; r < NumReaders; r++) {
+        mixer.add(readers[r]);
+        readers[r].add(BufSz * 2, values[r]);
+    }
+
+    // intermediate sum saturates, but the final one doesn't
+    core::Slice<sample_t> buf = new_buffer(BufSz);
+    Frame frame(buf.data(), buf.size());
+    mixer.read(frame);
+
+    for (size_t n = 0; n < BufSz; n++) {
+        DOUBLES_EQUAL(0.9f, frame.data()[n], 0.0001);
+    }
+
+    int16_t expected[BufSz];
+    sample_format_from_float(SampleFormat_S16LE, expected, BufSz / NumCh, 0,
+                             frame.data(), BufSz / NumCh, NumCh);
+
+    int16_t output[BufSz];
+    mixer.read_as(output, BufSz, SampleFormat_S16LE, NumCh);
+
+    for (size_t n = 0; n < BufSz; n++) {
+        LONGS_EQUAL(expected[n], output[n]);
+    }
+
+    for (size_t r = 0; r < NumReaders; r++) {
+        CHECK(readers[r].num_unread() == 0);
+    }
+}
+
+TEST(mixer, poisoning) {
+    enum { NumCh = 2 };
+
+    EmptyReader reader;
+
+    Mixer mixer(buffer_pool, MaxSz, true);
+    CHECK(mixer.valid());
+
+    mixer.add(reader);
+
+    expect_output(mixer, BufSz, SampleMax);
+
+    int16_t output[BufSz];
+    mixer.read_as(output, BufSz, SampleFormat_S16LE, NumCh);
+
+    for (size_t n = 0; n < BufSz; n++) {
+        const uint8_t* bytes = (const uint8_t*)&output[n];
+        LONGS_EQUAL(32767, int16_t(bytes[0] | (bytes[1] << 8)));
+    }
+}
+
 } // namespace audio
 } // namespace roc
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/plc.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/log.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum {
+    SampleRate = 44100,
+    NumCh = 2,
+    ChMask = 0x3,
+    FrameSize = 441,
+    HistoryFrames = 10,
+    MaxSamples = SampleRate
+};
+
+core::HeapAllocator allocator;
+
+// Harmonic signal with a fundamental frequency not aligned to sample grid.
+sample_t nth_sample(size_t n, size_t ch) {
+    const double t = double(n) / SampleRate;
+    const double f = 187.3;
+    return sample_t(0.4 * std::sin(2 * M_PI * f * t + ch)
+                    + 0.2 * std::sin(2 * M_PI * 2 * f * t + 0.5)
+                    + 0.1 * std::sin(2 * M_PI * 3 * f * t + 1.2 * ch));
+}
+
+void generate(sample_t* samples, size_t offset, size_t n_samples) {
+    for (size_t n = 0; n < n_samples; n++) {
+        for (size_t ch = 0; ch < NumCh; ch++) {
+            samples[n * NumCh + ch] = nth_sample(offset + n, ch);
+        }
+    }
+}
+
+// Signal-to-noise ratio of the concealed signal against the original one, dB.
+double snr(const sample_t* concealed, const sample_t* original, size_t n_samples) {
+    double signal = 0, noise = 0;
+    for (size_t n = 0; n < n_samples * NumCh; n++) {
+        const double sig = (double)original[n];
+        const double err = (double)concealed[n] - sig;
+        signal += sig * sig;
+        noise += err * err;
+    }
+    return 10 * std::log10(signal / noise);
+}
+
+sample_t input[MaxSamples * NumCh];
+sample_t output[MaxSamples * NumCh];
+
+} // namespace
+
+TEST_GROUP(plc) {
+    PLCConfig config;
+
+    void setup() {
+        config.enabled = true;
+    }
+
+    size_t feed_history(PLC & plc, size_t offset) {
+        for (size_t n = 0; n < HistoryFrames; n++) {
+            generate(input, offset, FrameSize);
+            plc.update(input, FrameSize);
+            offset += FrameSize;
+        }
+        return offset;
+    }
+};
+
+TEST(plc, short_history) {
+    PLC plc(config, ChMask, SampleRate, allocator);
+    CHECK(plc.valid());
+
+    generate(input, 0, FrameSize);
+    plc.update(input, FrameSize);
+
+    UNSIGNED_LONGS_EQUAL(0, plc.conceal(output, FrameSize));
+}
+
+TEST(plc, invalid_config) {
+    config.overlap_length = config.min_pitch_period * 2;
+
+    PLC plc(config, ChMask, SampleRate, allocator);
+    CHECK(!plc.valid());
+}
+
+TEST(plc, quality) {
+    enum { GapSize = SampleRate * 5 / 1000 };
+
+    PLC plc(config, ChMask, SampleRate, allocator);
+    CHECK(plc.valid());
+
+    const size_t offset = feed_history(plc, 0);
+
+    UNSIGNED_LONGS_EQUAL(GapSize, plc.conceal(output, GapSize));
+    generate(input, offset, GapSize);
+
+    const double plc_snr = snr(output, input, GapSize);
+
+    for (size_t n = 0; n < GapSize * NumCh; n++) {
+        output[n] = 0;
+    }
+    const double zeros_snr = snr(output, input, GapSize);
+
+    roc_log(LogInfo, "plc: gap=%lu snr=%.2lfdB zeros_snr=%.2lfdB",
+            (unsigned long)GapSize, plc_snr, zeros_snr);
+
+    CHECK(plc_snr > 10);
+    CHECK(plc_snr > zeros_snr + 10);
+}
+
+TEST(plc, fade_out) {
+    const size_t hold =
+        (size_t)packet::timestamp_from_ns(config.hold_length, SampleRate);
+    const size_t fade =
+        (size_t)packet::timestamp_from_ns(config.fade_length, SampleRate);
+
+    PLC plc(config, ChMask, SampleRate, allocator);
+    CHECK(plc.valid());
+
+    feed_history(plc, 0);
+
+    UNSIGNED_LONGS_EQUAL(hold + fade, plc.conceal(output, MaxSamples));
+
+    double head = 0, tail = 0;
+    for (size_t n = 0; n < FrameSize * NumCh; n++) {
+        head = std::max(head, (double)std::fabs(output[n]));
+        tail = std::max(tail, (double)std::fabs(output[(hold + fade) * NumCh - n - 1]));
+    }
+
+    CHECK(head > 0.3);
+    CHECK(tail < head * FrameSize / fade * 1.1);
+
+    UNSIGNED_LONGS_EQUAL(0, plc.conceal(output, FrameSize));
+}
+
+TEST(plc, resume) {
+    enum { GapSize = SampleRate * 3 / 1000 };
+
+    PLC plc(config, ChMask, SampleRate, allocator);
+    CHECK(plc.valid());
+
+    size_t offset = feed_history(plc, 0);
+
+    UNSIGNED_LONGS_EQUAL(GapSize, plc.conceal(output, GapSize));
+    offset += GapSize;
+
+    generate(input, offset, FrameSize);
+    plc.update(input, FrameSize);
+
+    // first sample is mostly concealed signal, which should continue smoothly
+    for (size_t ch = 0; ch < NumCh; ch++) {
+        const double jump = std::fabs(input[ch] - output[(GapSize - 1) * NumCh + ch]);
+        CHECK(jump < 0.1);
+    }
+
+    // after the overlap, samples are passed through
+    const size_t overlap =
+        (size_t)packet::timestamp_from_ns(config.overlap_length, SampleRate);
+    for (size_t n = overlap; n < FrameSize; n++) {
+        for (size_t ch = 0; ch < NumCh; ch++) {
+            DOUBLES_EQUAL(nth_sample(offset + n, ch), input[n * NumCh + ch], 0);
+        }
+    }
+
+    // concealment can start again immediately
+    UNSIGNED_LONGS_EQUAL(GapSize, plc.conceal(output, GapSize));
+}
+
+TEST(plc, cpu_time) {
+    enum { NumGaps = 200 };
+
+    PLC plc(config, ChMask, SampleRate, allocator);
+    CHECK(plc.valid());
+
+    size_t offset = feed_history(plc, 0);
+
+    core::nanoseconds_t conceal_time = 0;
+
+    for (size_t n = 0; n < NumGaps; n++) {
+        const core::nanoseconds_t start = core::timestamp();
+        UNSIGNED_LONGS_EQUAL(FrameSize, plc.conceal(output, FrameSize));
+        conceal_time += core::timestamp() - start;
+
+        offset = feed_history(plc, offset + FrameSize);
+    }
+
+    const core::nanoseconds_t frame_duration = FrameSize * core::Second / SampleRate;
+    const core::nanoseconds_t avg_time = conceal_time / NumGaps;
+
+    roc_log(LogInfo, "plc: frame=%ldns avg_conceal_time=%ldns ratio=%.4lf",
+            (long)frame_duration, (long)avg_time, double(avg_time) / frame_duration);
+
+    // concealment of a frame should take a small fraction of its duration
+    CHECK(avg_time < frame_duration / 10);
+}
+
+} // namespace audio
+} // namespace roc
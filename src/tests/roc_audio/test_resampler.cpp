@@ -123,7 +123,7 @@ TEST(resampler, invalid_scaling) {
     enum { ChMask = 0x1, InvalidScaling = FrameSize };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, config, ChMask, FrameSize);
 
     CHECK(rr.valid());
 
@@ -135,7 +135,7 @@ TEST(resampler, upscaling_twice_single) {
     enum { ChMask = 0x1 };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, config, ChMask, FrameSize);
 
     CHECK(rr.valid());
 
@@ -171,7 +171,7 @@ TEST(resampler, upscaling_twice_awgn) {
     enum { ChMask = 0x1 };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, config, ChMask, FrameSize);
 
     CHECK(rr.valid());
 
@@ -203,7 +203,7 @@ TEST(resampler, downsample) {
     enum { ChMask = 0x1 };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, config, ChMask, FrameSize);
 
     CHECK(rr.valid());
 
@@ -233,7 +233,7 @@ TEST(resampler, two_tones_sep_channels) {
     enum { ChMask = 0x3, nChannels = 2 };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, config, ChMask, FrameSize);
 
     CHECK(rr.valid());
 
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/sample_format.h"
+#include "roc_core/helpers.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { NumCh = 2, FrameLen = 8, MaxBytes = FrameLen * NumCh * 4 };
+
+const float Epsilon = 0.0001f;
+
+} // namespace
+
+TEST_GROUP(sample_format) {};
+
+TEST(sample_format, size) {
+    UNSIGNED_LONGS_EQUAL(4, sample_format_size(SampleFormat_Float));
+    UNSIGNED_LONGS_EQUAL(4, sample_format_size(SampleFormat_FloatPlanar));
+    UNSIGNED_LONGS_EQUAL(2, sample_format_size(SampleFormat_S16LE));
+    UNSIGNED_LONGS_EQUAL(4, sample_format_size(SampleFormat_S32LE));
+}
+
+TEST(sample_format, s16le_bytes) {
+    const sample_t input[] = { 0.0f, 0.5f, -0.5f, 1.0f, -1.0f, 2.0f };
+    const uint8_t expected[] = { 0x00, 0x00, 0x00, 0x40, 0x00, 0xC0,
+                                 0xFF, 0x7F, 0x00, 0x80, 0xFF, 0x7F };
+
+    uint8_t output[sizeof(expected)] = {};
+
+    sample_format_from_float(SampleFormat_S16LE, output, 3, 0, input, 3, NumCh);
+
+    for (size_t n = 0; n < sizeof(expected); n++) {
+        UNSIGNED_LONGS_EQUAL(expected[n], output[n]);
+    }
+}
+
+TEST(sample_format, s32le_bytes) {
+    const sample_t input[] = { 0.5f, -1.0f };
+    const uint8_t expected[] = { 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x80 };
+
+    uint8_t output[sizeof(expected)] = {};
+
+    sample_format_from_float(SampleFormat_S32LE, output, 1, 0, input, 1, NumCh);
+
+    for (size_t n = 0; n < sizeof(expected); n++) {
+        UNSIGNED_LONGS_EQUAL(expected[n], output[n]);
+    }
+}
+
+TEST(sample_format, s16le_rounding) {
+    const sample_t input[] = {
+        0.99999f, -1.0f, 1.0f, -2.0f, 1.6f / 32768, -1.6f / 32768, 0.4f / 32768, 0.5f,
+    };
+    const int16_t expected[] = {
+        32767, -32768, 32767, -32768, 2, -2, 0, 16384,
+    };
+
+    uint8_t output[sizeof(expected)] = {};
+
+    sample_format_from_float(SampleFormat_S16LE, output, 4, 0, input, 4, NumCh);
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(expected); n++) {
+        LONGS_EQUAL(expected[n], int16_t(output[n * 2] | (output[n * 2 + 1] << 8)));
+    }
+}
+
+TEST(sample_format, s32le_rounding) {
+    const sample_t input[] = {
+        0.99999f, -1.0f, 1.6f / 2147483648.0f, -1.6f / 2147483648.0f,
+    };
+    const int32_t expected[] = {
+        2147462144, -2147483647 - 1, 2, -2,
+    };
+
+    uint8_t output[sizeof(expected)] = {};
+
+    sample_format_from_float(SampleFormat_S32LE, output, 2, 0, input, 2, NumCh);
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(expected); n++) {
+        const uint8_t* bytes = output + n * 4;
+        const uint32_t v = uint32_t(bytes[0]) | (uint32_t(bytes[1]) << 8)
+            | (uint32_t(bytes[2]) << 16) | (uint32_t(bytes[3]) << 24);
+        LONGS_EQUAL(expected[n], (int32_t)v);
+    }
+}
+
+TEST(sample_format, roundtrip) {
+    const SampleFormat formats[] = { SampleFormat_Float, SampleFormat_FloatPlanar,
+                                     SampleFormat_S16LE, SampleFormat_S32LE };
+
+    for (size_t nf = 0; nf < ROC_ARRAY_SIZE(formats); nf++) {
+        sample_t input[FrameLen * NumCh];
+        for (size_t n = 0; n < FrameLen * NumCh; n++) {
+            input[n] = float(n) / (FrameLen * NumCh) - 0.5f;
+        }
+
+        uint8_t frame[MaxBytes] = {};
+        sample_format_from_float(formats[nf], frame, FrameLen, 0, input, FrameLen,
+                                 NumCh);
+
+        sample_t output[FrameLen * NumCh] = {};
+        sample_format_to_float(formats[nf], frame, FrameLen, 0, output, FrameLen,
+                               NumCh);
+
+        for (size_t n = 0; n < FrameLen * NumCh; n++) {
+            DOUBLES_EQUAL(input[n], output[n], Epsilon);
+        }
+    }
+}
+
+TEST(sample_format, planar_layout) {
+    sample_t input[FrameLen * NumCh];
+    for (size_t n = 0; n < FrameLen; n++) {
+        input[n * NumCh] = 0.25f;
+        input[n * NumCh + 1] = -0.25f;
+    }
+
+    float frame[FrameLen * NumCh] = {};
+
+    sample_format_from_float(SampleFormat_FloatPlanar, frame, FrameLen, 0, input,
+                             FrameLen / 2, NumCh);
+    sample_format_from_float(SampleFormat_FloatPlanar, frame, FrameLen, FrameLen / 2,
+                             input, FrameLen / 2, NumCh);
+
+    for (size_t n = 0; n < FrameLen; n++) {
+        DOUBLES_EQUAL(0.25f, frame[n], Epsilon);
+        DOUBLES_EQUAL(-0.25f, frame[FrameLen + n], Epsilon);
+    }
+
+    sample_t output[FrameLen * NumCh] = {};
+
+    sample_format_to_float(SampleFormat_FloatPlanar, frame, FrameLen, 0, output,
+                           FrameLen, NumCh);
+
+    for (size_t n = 0; n < FrameLen * NumCh; n++) {
+        DOUBLES_EQUAL(input[n], output[n], Epsilon);
+    }
+}
+
+TEST(sample_format, clamp) {
+    const sample_t input[] = { 1.5f, -1.5f };
+
+    sample_t output[2] = {};
+    sample_format_from_float(SampleFormat_Float, output, 1, 0, input, 1, NumCh);
+
+    DOUBLES_EQUAL(1.0f, output[0], Epsilon);
+    DOUBLES_EQUAL(-1.0f, output[1], Epsilon);
+}
+
+} // namespace audio
+} // namespace roc
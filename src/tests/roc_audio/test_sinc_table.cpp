@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/resampler.h"
+#include "roc_audio/sinc_table.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/unique_ptr.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { ChMask = 0x3, FrameSize = 512, NumResamplers = 100 };
+
+core::HeapAllocator allocator;
+
+} // namespace
+
+TEST_GROUP(sinc_table) {};
+
+TEST(sinc_table, same_params) {
+    core::SharedPtr<SincTable> t1 = SincTableCache::instance().get(32, 128);
+    core::SharedPtr<SincTable> t2 = SincTableCache::instance().get(32, 128);
+
+    CHECK(t1);
+    CHECK(t1 == t2);
+
+    LONGS_EQUAL(32, t1->window_size());
+    LONGS_EQUAL(128, t1->window_interp());
+    LONGS_EQUAL(32 * 128 + 2, t1->size());
+
+    LONGS_EQUAL(1, SincTableCache::instance().num_tables());
+}
+
+TEST(sinc_table, different_params) {
+    core::SharedPtr<SincTable> t1 = SincTableCache::instance().get(32, 128);
+    core::SharedPtr<SincTable> t2 = SincTableCache::instance().get(64, 128);
+    core::SharedPtr<SincTable> t3 = SincTableCache::instance().get(32, 256);
+
+    CHECK(t1);
+    CHECK(t2);
+    CHECK(t3);
+
+    CHECK(t1 != t2);
+    CHECK(t1 != t3);
+    CHECK(t2 != t3);
+
+    LONGS_EQUAL(3, SincTableCache::instance().num_tables());
+    LONGS_EQUAL((t1->size() + t2->size() + t3->size()) * sizeof(sample_t),
+                SincTableCache::instance().num_bytes());
+}
+
+TEST(sinc_table, free_unused) {
+    LONGS_EQUAL(0, SincTableCache::instance().num_tables());
+
+    {
+        core::SharedPtr<SincTable> table = SincTableCache::instance().get(32, 128);
+        CHECK(table);
+
+        LONGS_EQUAL(1, SincTableCache::instance().num_tables());
+    }
+
+    LONGS_EQUAL(0, SincTableCache::instance().num_tables());
+    LONGS_EQUAL(0, SincTableCache::instance().num_bytes());
+}
+
+TEST(sinc_table, shared_between_resamplers) {
+    ResamplerConfig config;
+
+    core::UniquePtr<Resampler> resamplers[NumResamplers];
+
+    for (size_t n = 0; n < NumResamplers; n++) {
+        resamplers[n].reset(new (allocator) Resampler(config, ChMask, FrameSize),
+                            allocator);
+        CHECK(resamplers[n]);
+        CHECK(resamplers[n]->valid());
+    }
+
+    LONGS_EQUAL(1, SincTableCache::instance().num_tables());
+    LONGS_EQUAL((config.window_size * config.window_interp + 2) * sizeof(sample_t),
+                SincTableCache::instance().num_bytes());
+
+    for (size_t n = 0; n < NumResamplers; n++) {
+        resamplers[n].reset();
+    }
+
+    LONGS_EQUAL(0, SincTableCache::instance().num_tables());
+}
+
+} // namespace audio
+} // namespace roc
@@ -139,6 +139,25 @@ TEST(watchdog, no_playback_timeout_blank_and_non_blank_frames) {
     }
 }
 
+TEST(watchdog, blank_duration) {
+    Watchdog watchdog(test_reader, NumCh,
+                      make_config(NoPlaybackTimeout, BrokenPlaybackTimeout), SampleRate,
+                      allocator);
+    CHECK(watchdog.valid());
+
+    UNSIGNED_LONGS_EQUAL(0, watchdog.blank_duration());
+
+    check_read(watchdog, true, SamplesPerFrame, Frame::FlagBlank);
+    check_read(watchdog, true, SamplesPerFrame, Frame::FlagBlank);
+    UNSIGNED_LONGS_EQUAL(SamplesPerFrame * 2, watchdog.blank_duration());
+
+    check_read(watchdog, true, SamplesPerFrame, 0);
+    UNSIGNED_LONGS_EQUAL(0, watchdog.blank_duration());
+
+    check_read(watchdog, true, SamplesPerFrame, Frame::FlagBlank);
+    UNSIGNED_LONGS_EQUAL(SamplesPerFrame, watchdog.blank_duration());
+}
+
 TEST(watchdog, no_playback_timeout_disabled) {
     {
         Watchdog watchdog(test_reader, NumCh,
@@ -284,6 +303,32 @@ TEST(watchdog, broken_playback_timeout_constant_drops) {
     CHECK(!watchdog.update());
 }
 
+TEST(watchdog, broken_playback_timeout_reset_breakage) {
+    Watchdog watchdog(test_reader, NumCh,
+                      make_config(NoPlaybackTimeout, BrokenPlaybackTimeout), SampleRate,
+                      allocator);
+    CHECK(watchdog.valid());
+
+    for (packet::timestamp_t n = 0; n < BreakageWindowsPerTimeout; n++) {
+        CHECK(!watchdog.broken());
+        CHECK(watchdog.update());
+        check_read(watchdog, true, BreakageWindow, Frame::FlagDrops);
+    }
+
+    CHECK(watchdog.broken());
+    watchdog.reset_breakage();
+    CHECK(!watchdog.broken());
+
+    for (packet::timestamp_t n = 0; n < BreakageWindowsPerTimeout; n++) {
+        CHECK(watchdog.update());
+        check_read(watchdog, true, BreakageWindow, Frame::FlagDrops);
+    }
+
+    CHECK(watchdog.broken());
+    CHECK(!watchdog.update());
+    check_read(watchdog, false, BreakageWindow, 0);
+}
+
 TEST(watchdog, broken_playback_timeout_frame_overlaps_with_breakage_window) {
     {
         Watchdog watchdog(test_reader, NumCh,
@@ -112,5 +112,38 @@ TEST(pool, new_destroy_many) {
     LONGS_EQUAL(0, allocator.num_allocations());
 }
 
+TEST(pool, reserve) {
+    {
+        Pool<Object> pool(allocator, sizeof(Object), true);
+
+        CHECK(pool.reserve(1 + 2 + 4));
+
+        LONGS_EQUAL(3, allocator.num_allocations());
+
+        Object* objects[1 + 2 + 4] = {};
+
+        for (size_t n = 0; n < 1 + 2 + 4; n++) {
+            objects[n] = new (pool) Object;
+            CHECK(objects[n]);
+        }
+
+        LONGS_EQUAL(3, allocator.num_allocations());
+
+        CHECK(pool.reserve(1 + 2 + 4));
+
+        LONGS_EQUAL(4, allocator.num_allocations());
+
+        for (size_t n = 0; n < 1 + 2 + 4; n++) {
+            pool.destroy(*objects[n]);
+        }
+
+        CHECK(pool.reserve(1 + 2 + 4));
+
+        LONGS_EQUAL(4, allocator.num_allocations());
+    }
+
+    LONGS_EQUAL(0, allocator.num_allocations());
+}
+
 } // namespace core
 } // namespace roc
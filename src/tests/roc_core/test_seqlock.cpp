@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/seqlock.h"
+#include "roc_core/thread.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { NumValues = 8, NumWrites = 100000 };
+
+struct Value {
+    long values[NumValues];
+
+    Value() {
+        for (size_t n = 0; n < NumValues; n++) {
+            values[n] = 0;
+        }
+    }
+};
+
+class Writer : public Thread {
+public:
+    Writer(Seqlock<Value>& seqlock)
+        : seqlock_(seqlock) {
+    }
+
+private:
+    virtual void run() {
+        for (long i = 1; i <= NumWrites; i++) {
+            Value v;
+            for (size_t n = 0; n < NumValues; n++) {
+                v.values[n] = i;
+            }
+            seqlock_.store(v);
+        }
+    }
+
+    Seqlock<Value>& seqlock_;
+};
+
+} // namespace
+
+TEST_GROUP(seqlock) {};
+
+TEST(seqlock, store_load) {
+    Seqlock<Value> seqlock;
+
+    Value v;
+    CHECK(seqlock.try_load(v));
+    LONGS_EQUAL(0, v.values[0]);
+
+    v.values[0] = 1;
+    v.values[NumValues - 1] = 2;
+    seqlock.store(v);
+
+    Value r;
+    seqlock.load(r);
+    LONGS_EQUAL(1, r.values[0]);
+    LONGS_EQUAL(2, r.values[NumValues - 1]);
+}
+
+TEST(seqlock, concurrent) {
+    Seqlock<Value> seqlock;
+
+    Writer writer(seqlock);
+    CHECK(writer.start());
+
+    long prev = 0;
+
+    while (prev < NumWrites) {
+        Value v;
+        seqlock.load(v);
+
+        for (size_t n = 1; n < NumValues; n++) {
+            LONGS_EQUAL(v.values[0], v.values[n]);
+        }
+
+        CHECK(v.values[0] >= prev);
+        prev = v.values[0];
+    }
+
+    writer.join();
+}
+
+} // namespace core
+} // namespace roc
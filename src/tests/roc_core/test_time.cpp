@@ -31,6 +31,14 @@ TEST(time, sleep_until) {
     CHECK(timestamp() >= ts + Millisecond);
 }
 
+TEST(time, sleep_until_precise) {
+    const nanoseconds_t ts = timestamp();
+
+    sleep_until_precise(ts + Millisecond, 100 * Microsecond);
+
+    CHECK(timestamp() >= ts + Millisecond);
+}
+
 TEST(time, sleep_for) {
     const nanoseconds_t ts = timestamp();
 
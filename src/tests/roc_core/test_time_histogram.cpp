@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/stage_timer.h"
+#include "roc_core/time_histogram.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(time_histogram) {};
+
+TEST(time_histogram, empty) {
+    TimeHistogram hist;
+
+    UNSIGNED_LONGS_EQUAL(0, hist.count());
+    LONGS_EQUAL(0, hist.max());
+    LONGS_EQUAL(0, hist.quantile(0.5));
+    LONGS_EQUAL(0, hist.quantile(0.99));
+}
+
+TEST(time_histogram, small_values) {
+    TimeHistogram hist;
+
+    hist.add(0);
+    hist.add(1);
+    hist.add(2);
+    hist.add(3);
+
+    UNSIGNED_LONGS_EQUAL(4, hist.count());
+    LONGS_EQUAL(3, hist.max());
+    LONGS_EQUAL(0, hist.quantile(0));
+    LONGS_EQUAL(1, hist.quantile(0.5));
+    LONGS_EQUAL(3, hist.quantile(1));
+}
+
+TEST(time_histogram, quantiles) {
+    TimeHistogram hist;
+
+    for (nanoseconds_t n = 1; n <= 1000; n++) {
+        hist.add(n * Microsecond);
+    }
+
+    UNSIGNED_LONGS_EQUAL(1000, hist.count());
+    LONGS_EQUAL(1000 * Microsecond, hist.max());
+
+    const nanoseconds_t p50 = hist.quantile(0.5);
+    CHECK(p50 >= 500 * Microsecond);
+    CHECK(p50 <= 500 * Microsecond * 5 / 4);
+
+    const nanoseconds_t p99 = hist.quantile(0.99);
+    CHECK(p99 >= 990 * Microsecond);
+    CHECK(p99 <= 1000 * Microsecond);
+
+    LONGS_EQUAL(1000 * Microsecond, hist.quantile(1));
+}
+
+TEST(time_histogram, large_values) {
+    TimeHistogram hist;
+
+    hist.add(Second);
+    hist.add(-1);
+
+    UNSIGNED_LONGS_EQUAL(2, hist.count());
+    LONGS_EQUAL(Second, hist.max());
+    LONGS_EQUAL(0, hist.quantile(0.5));
+    LONGS_EQUAL(Second, hist.quantile(1));
+}
+
+TEST(time_histogram, stage_timer) {
+    StageTimer timer;
+
+    const nanoseconds_t outer = timer.begin();
+
+    const nanoseconds_t inner1 = timer.begin();
+    LONGS_EQUAL(10, timer.end(inner1, 10));
+
+    const nanoseconds_t inner2 = timer.begin();
+    const nanoseconds_t nested = timer.begin();
+    LONGS_EQUAL(5, timer.end(nested, 5));
+    LONGS_EQUAL(15, timer.end(inner2, 20));
+
+    LONGS_EQUAL(70, timer.end(outer, 100));
+}
+
+} // namespace core
+} // namespace roc
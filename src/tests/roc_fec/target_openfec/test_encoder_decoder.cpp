@@ -28,6 +28,30 @@ const size_t PayloadSize = 251;
 core::HeapAllocator allocator;
 core::BufferPool<uint8_t> buffer_pool(allocator, PayloadSize, true);
 
+// Counts total number of allocations.
+class CountingAllocator : public core::IAllocator {
+public:
+    CountingAllocator()
+        : num_allocations_(0) {
+    }
+
+    virtual void* allocate(size_t size) {
+        num_allocations_++;
+        return allocator.allocate(size);
+    }
+
+    virtual void deallocate(void* ptr) {
+        allocator.deallocate(ptr);
+    }
+
+    size_t num_allocations() const {
+        return num_allocations_;
+    }
+
+private:
+    size_t num_allocations_;
+};
+
 } // namespace
 
 class Codec {
@@ -166,5 +190,145 @@ TEST(encoder_decoder, load_test) {
     }
 }
 
+TEST(encoder_decoder, pool_allocations_per_block) {
+    enum { NumBlocks = 50, NumWarmupBlocks = 5 };
+
+    for (int type = ReedSolomon8m; type != CodecTypeMax; ++type) {
+        config.codec = (CodecType)type;
+
+        CountingAllocator counting_allocator;
+
+        {
+            core::BufferPool<uint8_t> decoder_pool(counting_allocator, PayloadSize,
+                                                   true);
+
+            OFEncoder encoder(config, PayloadSize, allocator);
+            OFDecoder decoder(config, PayloadSize, decoder_pool, counting_allocator);
+
+            CHECK(encoder.valid());
+            CHECK(decoder.valid());
+
+            core::Slice<uint8_t> buffers[NumSourcePackets + NumRepairPackets];
+
+            size_t num_allocations = 0;
+
+            for (size_t block = 0; block < NumBlocks; ++block) {
+                if (block == NumWarmupBlocks) {
+                    num_allocations = counting_allocator.num_allocations();
+                }
+
+                for (size_t i = 0; i < NumSourcePackets + NumRepairPackets; ++i) {
+                    buffers[i] = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+                    buffers[i].resize(PayloadSize);
+                    for (size_t j = 0; j < PayloadSize; ++j) {
+                        buffers[i].data()[j] = (uint8_t)core::random(0, 0xff);
+                    }
+                    encoder.set(i, buffers[i]);
+                }
+                encoder.commit();
+                encoder.reset();
+
+                for (size_t i = 0; i < NumSourcePackets + NumRepairPackets; ++i) {
+                    if (i == block % NumSourcePackets || i == NumSourcePackets + 1) {
+                        continue;
+                    }
+                    decoder.set(i, buffers[i]);
+                }
+
+                core::Slice<uint8_t> repaired = decoder.repair(block % NumSourcePackets);
+                if (repaired) {
+                    CHECK(memcmp(buffers[block % NumSourcePackets].data(),
+                                 repaired.data(), PayloadSize)
+                          == 0);
+                }
+
+                decoder.reset();
+            }
+
+            // Repaired buffers are taken from the pool, so after a few blocks
+            // decoding doesn't allocate memory from our allocator anymore.
+            // OpenFEC still allocates its session with malloc(), which is not
+            // seen here; see sessions_per_block test.
+            LONGS_EQUAL(num_allocations, counting_allocator.num_allocations());
+        }
+    }
+}
+
+TEST(encoder_decoder, sessions_per_block) {
+    enum { NumBlocks = 30 };
+
+    for (int type = ReedSolomon8m; type != CodecTypeMax; ++type) {
+        config.codec = (CodecType)type;
+
+        OFEncoder encoder(config, PayloadSize, allocator);
+        OFDecoder decoder(config, PayloadSize, buffer_pool, allocator);
+
+        CHECK(encoder.valid());
+        CHECK(decoder.valid());
+
+        core::Slice<uint8_t> buffers[NumSourcePackets + NumRepairPackets];
+
+        size_t num_lossy_blocks = 0;
+
+        for (size_t block = 0; block < NumBlocks; ++block) {
+            for (size_t i = 0; i < NumSourcePackets + NumRepairPackets; ++i) {
+                buffers[i] = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+                buffers[i].resize(PayloadSize);
+                for (size_t j = 0; j < PayloadSize; ++j) {
+                    buffers[i].data()[j] = (uint8_t)core::random(0, 0xff);
+                }
+                encoder.set(i, buffers[i]);
+            }
+            encoder.commit();
+            encoder.reset();
+
+            // every third block has no losses, every third block has a loss
+            // and can be repaired, every third block has too few packets
+            const size_t lost = block % NumSourcePackets;
+            const size_t n_packets = block % 3 == 2 ? NumSourcePackets - 1
+                                                    : NumSourcePackets + NumRepairPackets;
+
+            for (size_t i = 0; i < n_packets; ++i) {
+                if (block % 3 != 0 && i == lost) {
+                    continue;
+                }
+                decoder.set(i, buffers[i]);
+            }
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                decoder.repair(i);
+            }
+
+            if (block % 3 == 1) {
+                num_lossy_blocks++;
+            }
+
+            decoder.reset();
+        }
+
+        // A session is created only for blocks that have a loss and enough
+        // packets to repair it, and only once per such block.
+        LONGS_EQUAL(num_lossy_blocks, decoder.num_sessions());
+    }
+}
+
+TEST(encoder_decoder, not_enough_packets) {
+    for (int type = ReedSolomon8m; type != CodecTypeMax; ++type) {
+        config.codec = (CodecType)type;
+        Codec code(config);
+        code.encode();
+        // Not enough packets to repair anything.
+        for (size_t i = 0; i < NumSourcePackets - 1; ++i) {
+            code.decoder().set(i, code.get_buffer(i));
+        }
+        CHECK(!code.decoder().repair(NumSourcePackets - 1));
+        // Enough packets now.
+        for (size_t i = NumSourcePackets; i < NumSourcePackets + NumRepairPackets; ++i) {
+            code.decoder().set(i, code.get_buffer(i));
+        }
+        CHECK(code.decode());
+    }
+}
+
 } // namespace fec
 } // namespace roc
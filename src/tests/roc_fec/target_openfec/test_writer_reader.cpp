@@ -7,17 +7,20 @@
  */
 
 #include <CppUTest/TestHarness.h>
+#include <algorithm>
 #include <set>
 
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_fec/composer.h"
+#include "roc_fec/decoding_pool.h"
 #include "roc_fec/headers.h"
 #include "roc_fec/of_decoder.h"
 #include "roc_fec/of_encoder.h"
 #include "roc_fec/reader.h"
 #include "roc_fec/writer.h"
+#include "roc_packet/diagonal_interleaver.h"
 #include "roc_packet/interleaver.h"
 #include "roc_packet/ireader.h"
 #include "roc_packet/iwriter.h"
@@ -162,6 +165,109 @@ private:
     std::set<size_t> lost_packet_nums_;
 };
 
+// Simulates a bottleneck link using token bucket and additionally loses
+// given source packets after it. Bucket is refilled when a source packet
+// is written, i.e. proportionally to the stream time.
+class TokenBucketLink : public packet::IWriter {
+public:
+    TokenBucketLink(packet::IWriter& writer, size_t depth, size_t rate, size_t cost)
+        : writer_(writer)
+        , depth_(depth)
+        , rate_(rate)
+        , cost_(cost)
+        , tokens_(depth)
+        , cur_burst_(0)
+        , max_burst_(0)
+        , n_dropped_(0) {
+    }
+
+    virtual void write(const packet::PacketPtr& p) {
+        if (p->flags() & packet::Packet::FlagRepair) {
+            if (++cur_burst_ > max_burst_) {
+                max_burst_ = cur_burst_;
+            }
+        } else {
+            cur_burst_ = 0;
+            tokens_ = std::min(depth_, tokens_ + rate_);
+        }
+
+        if (tokens_ < cost_) {
+            n_dropped_++;
+            return;
+        }
+        tokens_ -= cost_;
+
+        if (p->flags() & packet::Packet::FlagAudio) {
+            if (lost_source_nums_.find(p->rtp()->seqnum % NumSourcePackets)
+                != lost_source_nums_.end()) {
+                return;
+            }
+        }
+
+        writer_.write(p);
+    }
+
+    void lose_source(size_t n) {
+        lost_source_nums_.insert(n);
+    }
+
+    size_t max_repair_burst() const {
+        return max_burst_;
+    }
+
+    size_t n_dropped() const {
+        return n_dropped_;
+    }
+
+private:
+    packet::IWriter& writer_;
+
+    const size_t depth_;
+    const size_t rate_;
+    const size_t cost_;
+    size_t tokens_;
+
+    size_t cur_burst_;
+    size_t max_burst_;
+    size_t n_dropped_;
+
+    std::set<size_t> lost_source_nums_;
+};
+
+// Loses bursts of consecutive packets.
+class BurstLossLink : public packet::IWriter {
+public:
+    BurstLossLink(packet::IWriter& writer,
+                  size_t period,
+                  size_t burst_start,
+                  size_t burst_len)
+        : writer_(writer)
+        , period_(period)
+        , burst_start_(burst_start)
+        , burst_len_(burst_len)
+        , packet_num_(0) {
+    }
+
+    virtual void write(const packet::PacketPtr& p) {
+        const size_t pos = packet_num_++ % period_;
+
+        if (pos >= burst_start_ && pos < burst_start_ + burst_len_) {
+            return;
+        }
+
+        writer_.write(p);
+    }
+
+private:
+    packet::IWriter& writer_;
+
+    const size_t period_;
+    const size_t burst_start_;
+    const size_t burst_len_;
+
+    size_t packet_num_;
+};
+
 } // namespace
 
 TEST_GROUP(writer_reader) {
@@ -211,6 +317,123 @@ TEST_GROUP(writer_reader) {
         return pp;
     }
 
+    // Writes NumBlocks blocks through a token bucket link which also loses
+    // two source packets per block, and returns the number of source packets
+    // that reader has delivered.
+    size_t run_token_bucket(size_t& max_repair_burst) {
+        enum { NumBlocks = 20 };
+
+        OFEncoder encoder(config, FECPayloadSize, allocator);
+        OFDecoder decoder(config, FECPayloadSize, buffer_pool, allocator);
+
+        CHECK(encoder.valid());
+        CHECK(decoder.valid());
+
+        PacketDispatcher dispatcher;
+
+        // Link capacity is 1.5 packets per source packet, which is enough for
+        // 20 source and 10 repair packets per block on average, but can't
+        // hold a burst of more than two packets.
+        TokenBucketLink link(dispatcher, 4, 3, 2);
+
+        link.lose_source(3);
+        link.lose_source(11);
+
+        Writer writer(config, FECPayloadSize, encoder, link, source_composer,
+                      repair_composer, packet_pool, buffer_pool, allocator);
+
+        Reader reader(config, decoder, dispatcher.source_reader(),
+                      dispatcher.repair_reader(), rtp_parser, packet_pool, NULL,
+                      allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        // One more block to let paced writer flush repair packets of the
+        // last checked block.
+        for (size_t block_num = 0; block_num < NumBlocks + 1; ++block_num) {
+            fill_all_packets(NumSourcePackets * block_num);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                writer.write(source_packets[i]);
+            }
+        }
+        dispatcher.release_all();
+
+        size_t n_delivered = 0;
+
+        for (;;) {
+            packet::PacketPtr p = reader.read();
+            CHECK(p);
+
+            const size_t sn = p->rtp()->seqnum;
+            if (sn >= NumSourcePackets * NumBlocks) {
+                break;
+            }
+
+            check_audio_packet(p, sn);
+            n_delivered++;
+        }
+
+        max_repair_burst = link.max_repair_burst();
+
+        return n_delivered;
+    }
+
+    // Writes NumBlocks blocks through a link which loses a burst of 15
+    // packets every 4 blocks, using diagonal interleaver of given depth, and
+    // returns the number of source packets that reader has delivered.
+    size_t run_burst_loss(size_t interleaving_depth) {
+        enum { NumBlocks = 40 };
+
+        OFEncoder encoder(config, FECPayloadSize, allocator);
+        OFDecoder decoder(config, FECPayloadSize, buffer_pool, allocator);
+
+        CHECK(encoder.valid());
+        CHECK(decoder.valid());
+
+        PacketDispatcher dispatcher;
+
+        BurstLossLink link(dispatcher, (NumSourcePackets + NumRepairPackets) * 4, 40,
+                           15);
+
+        packet::DiagonalInterleaver intrlvr(
+            link, allocator, NumSourcePackets + NumRepairPackets, interleaving_depth);
+
+        CHECK(intrlvr.valid());
+
+        Writer writer(config, FECPayloadSize, encoder, intrlvr, source_composer,
+                      repair_composer, packet_pool, buffer_pool, allocator);
+
+        Reader reader(config, decoder, dispatcher.source_reader(),
+                      dispatcher.repair_reader(), rtp_parser, packet_pool, NULL,
+                      allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+            fill_all_packets(NumSourcePackets * block_num);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                writer.write(source_packets[i]);
+            }
+        }
+        intrlvr.flush();
+        dispatcher.release_all();
+
+        size_t n_delivered = 0;
+
+        while (packet::PacketPtr p = reader.read()) {
+            check_audio_packet(p, p->rtp()->seqnum);
+            n_delivered++;
+        }
+
+        LONGS_EQUAL(0, dispatcher.source_size());
+
+        return n_delivered;
+    }
+
     void check_audio_packet(packet::PacketPtr pp, size_t sn) {
         CHECK(pp);
 
@@ -248,7 +471,7 @@ TEST(writer_reader, encode) {
                   repair_composer, packet_pool, buffer_pool, allocator);
 
     Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
-                  rtp_parser, packet_pool, allocator);
+                  rtp_parser, packet_pool, NULL, allocator);
 
     CHECK(writer.valid());
     CHECK(reader.valid());
@@ -281,7 +504,7 @@ TEST(writer_reader, 1_loss) {
                   repair_composer, packet_pool, buffer_pool, allocator);
 
     Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
-                  rtp_parser, packet_pool, allocator);
+                  rtp_parser, packet_pool, NULL, allocator);
 
     CHECK(writer.valid());
     CHECK(reader.valid());
@@ -318,7 +541,7 @@ TEST(writer_reader, multiblocks_1_loss) {
                   repair_composer, packet_pool, buffer_pool, allocator);
 
     Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
-                  rtp_parser, packet_pool, allocator);
+                  rtp_parser, packet_pool, NULL, allocator);
 
     CHECK(writer.valid());
     CHECK(reader.valid());
@@ -377,7 +600,7 @@ TEST(writer_reader, interleaver) {
                   repair_composer, packet_pool, buffer_pool, allocator);
 
     Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
-                  rtp_parser, packet_pool, allocator);
+                  rtp_parser, packet_pool, NULL, allocator);
 
     CHECK(writer.valid());
     CHECK(reader.valid());
@@ -414,7 +637,7 @@ TEST(writer_reader, decoding_when_multiple_blocks_in_queue) {
                   repair_composer, packet_pool, buffer_pool, allocator);
 
     Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
-                  rtp_parser, packet_pool, allocator);
+                  rtp_parser, packet_pool, NULL, allocator);
 
     CHECK(writer.valid());
     CHECK(reader.valid());
@@ -460,7 +683,7 @@ IGNORE_TEST(writer_reader, decoding_late_packet) {
                   repair_composer, packet_pool, buffer_pool, allocator);
 
     Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
-                  rtp_parser, packet_pool, allocator);
+                  rtp_parser, packet_pool, NULL, allocator);
 
     CHECK(writer.valid());
     CHECK(reader.valid());
@@ -518,7 +741,7 @@ TEST(writer_reader, get_packets_before_marker_bit) {
                   repair_composer, packet_pool, buffer_pool, allocator);
 
     Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
-                  rtp_parser, packet_pool, allocator);
+                  rtp_parser, packet_pool, NULL, allocator);
 
     CHECK(writer.valid());
     CHECK(reader.valid());
@@ -627,7 +850,7 @@ TEST(writer_reader, decode_bad_seqnum) {
                   repair_composer, packet_pool, buffer_pool, allocator);
 
     Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
-                  rtp_parser, packet_pool, allocator);
+                  rtp_parser, packet_pool, NULL, allocator);
 
     CHECK(writer.valid());
     CHECK(reader.valid());
@@ -669,7 +892,7 @@ TEST(writer_reader, decode_bad_source_id) {
                   repair_composer, packet_pool, buffer_pool, allocator);
 
     Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
-                  rtp_parser, packet_pool, allocator);
+                  rtp_parser, packet_pool, NULL, allocator);
 
     CHECK(writer.valid());
     CHECK(reader.valid());
@@ -717,7 +940,7 @@ TEST(writer_reader, multitime_decode) {
                   repair_composer, packet_pool, buffer_pool, allocator);
 
     Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
-                  rtp_parser, packet_pool, allocator);
+                  rtp_parser, packet_pool, NULL, allocator);
 
     CHECK(writer.valid());
     CHECK(reader.valid());
@@ -773,7 +996,7 @@ TEST(writer_reader, delayed_packets) {
                   repair_composer, packet_pool, buffer_pool, allocator);
 
     Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
-                  rtp_parser, packet_pool, allocator);
+                  rtp_parser, packet_pool, NULL, allocator);
 
     CHECK(writer.valid());
     CHECK(reader.valid());
@@ -797,5 +1020,319 @@ TEST(writer_reader, delayed_packets) {
     }
 }
 
+TEST(writer_reader, repair_pacing) {
+    enum { NumBlocks = 10 };
+
+    config.pace_repair_packets = true;
+
+    OFEncoder encoder(config, FECPayloadSize, allocator);
+    OFDecoder decoder(config, FECPayloadSize, buffer_pool, allocator);
+
+    CHECK(encoder.valid());
+    CHECK(decoder.valid());
+
+    PacketDispatcher dispatcher;
+
+    Writer writer(config, FECPayloadSize, encoder, dispatcher, source_composer,
+                  repair_composer, packet_pool, buffer_pool, allocator);
+
+    Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
+                  rtp_parser, packet_pool, NULL, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+        fill_all_packets(NumSourcePackets * block_num);
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            writer.write(source_packets[i]);
+
+            // Repair packets of previous block are written during this block.
+            if (block_num == 0) {
+                LONGS_EQUAL(0, dispatcher.repair_size());
+            } else {
+                LONGS_EQUAL(NumRepairPackets * (block_num - 1)
+                                + (i + 1) * NumRepairPackets / NumSourcePackets,
+                            dispatcher.repair_size());
+            }
+        }
+
+        LONGS_EQUAL(NumSourcePackets * (block_num + 1), dispatcher.source_size());
+    }
+    dispatcher.release_all();
+
+    // Every block except the last one has its repair packets sent.
+    for (size_t i = 0; i < NumSourcePackets * (NumBlocks - 1); ++i) {
+        packet::PacketPtr p = reader.read();
+        CHECK(p);
+        check_audio_packet(p, i);
+    }
+}
+
+TEST(writer_reader, repair_pacing_flush) {
+    config.pace_repair_packets = true;
+
+    OFEncoder encoder(config, FECPayloadSize, allocator);
+    OFDecoder decoder(config, FECPayloadSize, buffer_pool, allocator);
+
+    CHECK(encoder.valid());
+    CHECK(decoder.valid());
+
+    PacketDispatcher dispatcher;
+
+    Writer writer(config, FECPayloadSize, encoder, dispatcher, source_composer,
+                  repair_composer, packet_pool, buffer_pool, allocator);
+
+    Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
+                  rtp_parser, packet_pool, NULL, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    fill_all_packets(0);
+
+    dispatcher.lose(1);
+    dispatcher.lose(NumSourcePackets - 1);
+
+    for (size_t i = 0; i < NumSourcePackets; ++i) {
+        writer.write(source_packets[i]);
+    }
+
+    LONGS_EQUAL(NumSourcePackets - 2, dispatcher.source_size());
+    LONGS_EQUAL(0, dispatcher.repair_size());
+
+    // Repair packets of the last block are written on flush.
+    writer.flush();
+
+    LONGS_EQUAL(NumSourcePackets - 2, dispatcher.source_size());
+    LONGS_EQUAL(NumRepairPackets, dispatcher.repair_size());
+
+    // Second flush doesn't write anything.
+    writer.flush();
+
+    LONGS_EQUAL(NumRepairPackets, dispatcher.repair_size());
+
+    dispatcher.release_all();
+
+    for (size_t i = 0; i < NumSourcePackets; ++i) {
+        packet::PacketPtr p = reader.read();
+        CHECK(p);
+        check_audio_packet(p, i);
+    }
+}
+
+TEST(writer_reader, repair_pacing_token_bucket) {
+    enum { NumBlocks = 20 };
+
+    size_t max_repair_burst = 0;
+
+    // Without pacing, repair packets are sent back to back and most of them
+    // are dropped by the link, so the block can't be repaired.
+    config.pace_repair_packets = false;
+
+    LONGS_EQUAL((NumSourcePackets - 2) * NumBlocks, run_token_bucket(max_repair_burst));
+    LONGS_EQUAL(NumRepairPackets, max_repair_burst);
+
+    // With pacing, repair packets are spread over the next block, pass through
+    // the link, and every lost packet is repaired.
+    config.pace_repair_packets = true;
+
+    LONGS_EQUAL(NumSourcePackets * NumBlocks, run_token_bucket(max_repair_burst));
+    LONGS_EQUAL(1, max_repair_burst);
+}
+
+TEST(writer_reader, diagonal_interleaver_burst_loss) {
+    enum { NumBlocks = 40 };
+
+    // Depth of 1 means no interleaving; every burst covers 15 packets of a
+    // single block, which exceeds the number of repair packets.
+    LONGS_EQUAL((NumSourcePackets * NumBlocks) - (NumBlocks / 4) * 10, run_burst_loss(1));
+
+    // With interleaving, every burst is spread across several blocks and
+    // every lost packet is repaired.
+    LONGS_EQUAL(NumSourcePackets * NumBlocks, run_burst_loss(4));
+}
+
+TEST(writer_reader, decoding_pool) {
+    enum { NumBlocks = 40, NumThreads = 2 };
+
+    for (size_t num_threads = 0; num_threads <= NumThreads; num_threads++) {
+        DecodingPool decoding_pool(num_threads, allocator);
+        CHECK(decoding_pool.valid());
+
+        OFEncoder encoder(config, FECPayloadSize, allocator);
+        OFDecoder decoder(config, FECPayloadSize, buffer_pool, allocator);
+
+        CHECK(encoder.valid());
+        CHECK(decoder.valid());
+
+        PacketDispatcher dispatcher;
+
+        Writer writer(config, FECPayloadSize, encoder, dispatcher, source_composer,
+                      repair_composer, packet_pool, buffer_pool, allocator);
+
+        Reader reader(config, decoder, dispatcher.source_reader(),
+                      dispatcher.repair_reader(), rtp_parser, packet_pool,
+                      &decoding_pool, allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        size_t next_sn = 0;
+
+        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+            dispatcher.lose((block_num * 7 + 1) % NumSourcePackets);
+            dispatcher.lose(NumSourcePackets + block_num % NumRepairPackets);
+            if (block_num % 2 == 0) {
+                dispatcher.lose((block_num * 3 + 11) % NumSourcePackets);
+            }
+
+            fill_all_packets(NumSourcePackets * block_num);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                writer.write(source_packets[i]);
+            }
+            dispatcher.release_all();
+
+            const size_t end_sn = NumSourcePackets * (block_num + 1);
+            size_t n_read = 0;
+
+            // with threads, a lost packet is skipped if its block isn't decoded
+            // yet when read() reaches it, so only the order is checked
+            while (packet::PacketPtr p = reader.read()) {
+                CHECK(p->rtp()->seqnum >= next_sn);
+                CHECK(p->rtp()->seqnum < end_sn);
+
+                check_audio_packet(p, p->rtp()->seqnum);
+
+                next_sn = p->rtp()->seqnum + 1;
+                n_read++;
+            }
+
+            if (num_threads == 0) {
+                UNSIGNED_LONGS_EQUAL(NumSourcePackets, n_read);
+                UNSIGNED_LONGS_EQUAL(end_sn, next_sn);
+            }
+
+            dispatcher.reset();
+        }
+    }
+}
+
+TEST(writer_reader, stats) {
+    enum {
+        NumBlocks = 10,
+        UnrepairableBlock = 4,
+        NumUnrepairable = NumRepairPackets + 1
+    };
+
+    OFEncoder encoder(config, FECPayloadSize, allocator);
+    OFDecoder decoder(config, FECPayloadSize, buffer_pool, allocator);
+
+    CHECK(encoder.valid());
+    CHECK(decoder.valid());
+
+    PacketDispatcher dispatcher;
+
+    Writer writer(config, FECPayloadSize, encoder, dispatcher, source_composer,
+                  repair_composer, packet_pool, buffer_pool, allocator);
+
+    Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
+                  rtp_parser, packet_pool, NULL, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+        size_t n_lost = 0;
+
+        if (block_num == UnrepairableBlock) {
+            for (size_t i = 1; i <= NumUnrepairable; ++i) {
+                dispatcher.lose(i);
+            }
+            n_lost = NumUnrepairable;
+        } else if (block_num % 2 == 1) {
+            dispatcher.lose(5);
+        }
+
+        fill_all_packets(NumSourcePackets * block_num);
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            writer.write(source_packets[i]);
+        }
+        dispatcher.release_all();
+
+        for (size_t i = 0; i < NumSourcePackets - n_lost; ++i) {
+            CHECK(reader.read());
+        }
+
+        dispatcher.reset();
+    }
+
+    const ReaderStats& stats = reader.stats();
+
+    UNSIGNED_LONGS_EQUAL(NumBlocks, stats.n_blocks);
+    UNSIGNED_LONGS_EQUAL(NumBlocks / 2 + NumUnrepairable, stats.n_lost);
+    UNSIGNED_LONGS_EQUAL(NumBlocks / 2, stats.n_repaired);
+    UNSIGNED_LONGS_EQUAL(NumUnrepairable, stats.n_unrepairable);
+    UNSIGNED_LONGS_EQUAL(0, stats.n_late_repair);
+
+    CHECK(stats.n_decodes >= NumBlocks / 2 + 1);
+
+    size_t n_hist = 0;
+    for (size_t n = 0; n < ReaderStats::NumDecodeTimeBuckets; n++) {
+        n_hist += stats.decode_time_hist[n];
+    }
+    UNSIGNED_LONGS_EQUAL(stats.n_decodes, n_hist);
+}
+
+TEST(writer_reader, final_stats) {
+    enum { NumUnrepairable = NumRepairPackets + 1 };
+
+    OFEncoder encoder(config, FECPayloadSize, allocator);
+    OFDecoder decoder(config, FECPayloadSize, buffer_pool, allocator);
+
+    CHECK(encoder.valid());
+    CHECK(decoder.valid());
+
+    PacketDispatcher dispatcher;
+
+    Writer writer(config, FECPayloadSize, encoder, dispatcher, source_composer,
+                  repair_composer, packet_pool, buffer_pool, allocator);
+
+    Reader reader(config, decoder, dispatcher.source_reader(), dispatcher.repair_reader(),
+                  rtp_parser, packet_pool, NULL, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    for (size_t i = 1; i <= NumUnrepairable; ++i) {
+        dispatcher.lose(i);
+    }
+
+    fill_all_packets(0);
+
+    for (size_t i = 0; i < NumSourcePackets; ++i) {
+        writer.write(source_packets[i]);
+    }
+    dispatcher.release_all();
+
+    // read first packet and first packet after the unrepairable gap, so that
+    // the block is only partially read
+    CHECK(reader.read());
+    CHECK(reader.read());
+
+    UNSIGNED_LONGS_EQUAL(0, reader.stats().n_blocks);
+    UNSIGNED_LONGS_EQUAL(0, reader.stats().n_lost);
+
+    const ReaderStats stats = reader.final_stats();
+
+    UNSIGNED_LONGS_EQUAL(0, stats.n_blocks);
+    UNSIGNED_LONGS_EQUAL(NumUnrepairable, stats.n_lost);
+    UNSIGNED_LONGS_EQUAL(NumUnrepairable, stats.n_unrepairable);
+    UNSIGNED_LONGS_EQUAL(0, stats.n_repaired);
+}
+
 } // namespace fec
 } // namespace roc
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2015 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_fec/decoding_pool.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+core::HeapAllocator allocator;
+
+class TestTask : public DecodingTask {
+public:
+    TestTask(core::Atomic& counter)
+        : counter_(counter)
+        , n_decoded_(0) {
+    }
+
+    size_t n_decoded() const {
+        return n_decoded_;
+    }
+
+private:
+    virtual void decode() {
+        ++counter_;
+        n_decoded_++;
+    }
+
+    core::Atomic& counter_;
+    size_t n_decoded_;
+};
+
+} // namespace
+
+TEST_GROUP(decoding_pool) {};
+
+TEST(decoding_pool, no_threads) {
+    DecodingPool pool(0, allocator);
+    CHECK(pool.valid());
+
+    core::Atomic counter;
+    TestTask task(counter);
+
+    pool.schedule(task);
+    LONGS_EQUAL(0, task.n_decoded());
+
+    pool.wait(task);
+    LONGS_EQUAL(1, task.n_decoded());
+
+    pool.wait(task);
+    LONGS_EQUAL(1, task.n_decoded());
+}
+
+TEST(decoding_pool, threads) {
+    enum { NumThreads = 4, NumTasks = 32, NumIterations = 100 };
+
+    DecodingPool pool(NumThreads, allocator);
+    CHECK(pool.valid());
+
+    core::Atomic counter;
+
+    TestTask* tasks[NumTasks];
+    for (size_t n = 0; n < NumTasks; n++) {
+        tasks[n] = new TestTask(counter);
+    }
+
+    for (size_t i = 0; i < NumIterations; i++) {
+        for (size_t n = 0; n < NumTasks; n++) {
+            pool.schedule(*tasks[n]);
+        }
+        for (size_t n = 0; n < NumTasks; n++) {
+            pool.wait(*tasks[n]);
+            LONGS_EQUAL(i + 1, tasks[n]->n_decoded());
+        }
+    }
+
+    LONGS_EQUAL(NumTasks * NumIterations, (long)counter);
+
+    for (size_t n = 0; n < NumTasks; n++) {
+        delete tasks[n];
+    }
+}
+
+TEST(decoding_pool, try_wait_no_threads) {
+    DecodingPool pool(0, allocator);
+    CHECK(pool.valid());
+
+    core::Atomic counter;
+    TestTask task(counter);
+
+    CHECK(pool.try_wait(task));
+    LONGS_EQUAL(0, task.n_decoded());
+
+    pool.schedule(task);
+    LONGS_EQUAL(0, task.n_decoded());
+
+    // decoded in place, since there are no threads
+    CHECK(pool.try_wait(task));
+    LONGS_EQUAL(1, task.n_decoded());
+
+    CHECK(pool.try_wait(task));
+    LONGS_EQUAL(1, task.n_decoded());
+}
+
+TEST(decoding_pool, try_wait_threads) {
+    enum { NumThreads = 2, NumIterations = 100 };
+
+    DecodingPool pool(NumThreads, allocator);
+    CHECK(pool.valid());
+
+    core::Atomic counter;
+    TestTask task(counter);
+
+    for (size_t i = 0; i < NumIterations; i++) {
+        pool.schedule(task);
+
+        while (!pool.try_wait(task)) {
+        }
+
+        LONGS_EQUAL(i + 1, task.n_decoded());
+    }
+
+    CHECK(pool.try_wait(task));
+    LONGS_EQUAL(NumIterations, task.n_decoded());
+}
+
+TEST(decoding_pool, destroy_with_queued_tasks) {
+    enum { NumThreads = 2, NumTasks = 32 };
+
+    for (size_t num_threads = 0; num_threads <= NumThreads; num_threads++) {
+        core::Atomic counter;
+
+        TestTask* tasks[NumTasks];
+        for (size_t n = 0; n < NumTasks; n++) {
+            tasks[n] = new TestTask(counter);
+        }
+
+        {
+            DecodingPool pool(num_threads, allocator);
+            CHECK(pool.valid());
+
+            for (size_t n = 0; n < NumTasks; n++) {
+                pool.schedule(*tasks[n]);
+            }
+        }
+
+        // queued tasks are decoded before the pool is destroyed
+        LONGS_EQUAL(NumTasks, (long)counter);
+
+        for (size_t n = 0; n < NumTasks; n++) {
+            LONGS_EQUAL(1, tasks[n]->n_decoded());
+            delete tasks[n];
+        }
+    }
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <string.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/time.h"
+
+#include "roc/context.h"
+#include "roc/receiver.h"
+
+namespace roc {
+
+namespace {
+
+enum { SampleRate = 44100, NumChans = 2, FrameSamples = 100, NumFrames = 5 };
+
+struct CallbackState {
+    core::Atomic n_frames;
+    core::Atomic n_bad_frames;
+};
+
+void frame_callback(void* arg, const roc_frame* frame) {
+    CallbackState& state = *(CallbackState*)arg;
+
+    if (!frame || !frame->samples
+        || frame->samples_size != FrameSamples * NumChans * sizeof(float)) {
+        ++state.n_bad_frames;
+    }
+
+    ++state.n_frames;
+}
+
+} // namespace
+
+TEST_GROUP(receiver) {
+    roc_context_config context_config;
+    roc_receiver_config receiver_config;
+
+    roc_context* context;
+
+    void setup() {
+        memset(&context_config, 0, sizeof(context_config));
+
+        context = roc_context_open(&context_config);
+        CHECK(context);
+
+        memset(&receiver_config, 0, sizeof(receiver_config));
+        receiver_config.frame_sample_rate = SampleRate;
+        receiver_config.frame_channels = ROC_CHANNEL_SET_STEREO;
+        receiver_config.frame_encoding = ROC_FRAME_ENCODING_PCM_FLOAT;
+        receiver_config.resampler_profile = ROC_RESAMPLER_DISABLE;
+    }
+
+    void teardown() {
+        LONGS_EQUAL(0, roc_context_close(context));
+    }
+};
+
+TEST(receiver, read_ready_no_timing) {
+    roc_receiver* receiver = roc_receiver_open(context, &receiver_config);
+    CHECK(receiver);
+
+    float samples[FrameSamples * NumChans];
+
+    roc_frame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.samples = samples;
+    frame.samples_size = sizeof(samples);
+
+    long long deadline = -1;
+
+    LONGS_EQUAL(0, roc_receiver_read_ready(receiver, &frame, &deadline));
+    LONGS_EQUAL(sizeof(samples), frame.samples_size);
+    CHECK(deadline == 0);
+
+    LONGS_EQUAL(0, roc_receiver_close(receiver));
+}
+
+TEST(receiver, read_ready_timing) {
+    receiver_config.automatic_timing = 1;
+
+    roc_receiver* receiver = roc_receiver_open(context, &receiver_config);
+    CHECK(receiver);
+
+    float samples[FrameSamples * NumChans];
+
+    roc_frame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.samples = samples;
+    frame.samples_size = sizeof(samples);
+
+    long long deadline = 0;
+
+    LONGS_EQUAL(0, roc_receiver_read_ready(receiver, &frame, &deadline));
+    LONGS_EQUAL(0, frame.samples_size);
+    CHECK(deadline > 0);
+
+    core::sleep_until(deadline);
+
+    frame.samples_size = sizeof(samples);
+
+    LONGS_EQUAL(0, roc_receiver_read_ready(receiver, &frame, &deadline));
+    LONGS_EQUAL(sizeof(samples), frame.samples_size);
+
+    LONGS_EQUAL(0, roc_receiver_close(receiver));
+}
+
+TEST(receiver, start_callback) {
+    receiver_config.automatic_timing = 1;
+
+    roc_receiver* receiver = roc_receiver_open(context, &receiver_config);
+    CHECK(receiver);
+
+    CallbackState state;
+
+    LONGS_EQUAL(0, roc_receiver_start(receiver, FrameSamples * NumChans * sizeof(float),
+                                      frame_callback, &state));
+
+    LONGS_EQUAL(-1, roc_receiver_start(receiver, FrameSamples * NumChans * sizeof(float),
+                                       frame_callback, &state));
+
+    while (state.n_frames < NumFrames) {
+        core::sleep_for(core::Millisecond);
+    }
+
+    LONGS_EQUAL(0, roc_receiver_close(receiver));
+
+    LONGS_EQUAL(0, (long)state.n_bad_frames);
+}
+
+TEST(receiver, start_no_timing) {
+    roc_receiver* receiver = roc_receiver_open(context, &receiver_config);
+    CHECK(receiver);
+
+    CallbackState state;
+
+    LONGS_EQUAL(-1, roc_receiver_start(receiver, FrameSamples * NumChans * sizeof(float),
+                                       frame_callback, &state));
+
+    LONGS_EQUAL(0, roc_receiver_close(receiver));
+}
+
+TEST(receiver, start_bad_args) {
+    receiver_config.automatic_timing = 1;
+
+    roc_receiver* receiver = roc_receiver_open(context, &receiver_config);
+    CHECK(receiver);
+
+    CallbackState state;
+
+    LONGS_EQUAL(-1, roc_receiver_start(NULL, FrameSamples * NumChans * sizeof(float),
+                                       frame_callback, &state));
+    LONGS_EQUAL(-1, roc_receiver_start(receiver, 0, frame_callback, &state));
+    LONGS_EQUAL(-1, roc_receiver_start(receiver, sizeof(float), frame_callback, &state));
+    LONGS_EQUAL(-1, roc_receiver_start(receiver, FrameSamples * NumChans * sizeof(float),
+                                       NULL, &state));
+
+    LONGS_EQUAL(0, roc_receiver_close(receiver));
+}
+
+TEST(receiver, session_pool_encoding) {
+    receiver_config.session_pool_size = 2;
+
+    {
+        receiver_config.session_pool_encoding = ROC_PACKET_ENCODING_AVP_L24;
+        receiver_config.session_pool_sample_rate = 48000;
+
+        roc_receiver* receiver = roc_receiver_open(context, &receiver_config);
+        CHECK(receiver);
+
+        LONGS_EQUAL(0, roc_receiver_close(receiver));
+    }
+
+    {
+        // no such format
+        receiver_config.session_pool_encoding = ROC_PACKET_ENCODING_AVP_L24;
+        receiver_config.session_pool_sample_rate = 12345;
+
+        roc_receiver* receiver = roc_receiver_open(context, &receiver_config);
+        CHECK(!receiver);
+    }
+}
+
+} // namespace roc
@@ -100,6 +100,7 @@ public:
         CHECK(roc_sender_connect(sndr_, ROC_PORT_AUDIO_REPAIR, ROC_PROTO_RSM8_REPAIR,
                                  dst_repair_addr)
               == 0);
+        CHECK(roc_sender_start(sndr_) == 0);
     }
 
     ~Sender() {
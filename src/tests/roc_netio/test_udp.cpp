@@ -10,6 +10,7 @@
 
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/time.h"
 #include "roc_netio/transceiver.h"
 #include "roc_packet/concurrent_queue.h"
 #include "roc_packet/packet_pool.h"
@@ -72,6 +73,9 @@ TEST_GROUP(udp) {
         CHECK(pp->udp()->src_addr == tx_addr);
         CHECK(pp->udp()->dst_addr == rx_addr);
 
+        CHECK(pp->udp()->receive_timestamp > 0);
+        CHECK(pp->udp()->receive_timestamp <= core::timestamp());
+
         core::Slice<uint8_t> expected = new_buffer(value);
 
         UNSIGNED_LONGS_EQUAL(expected.size(), pp->data().size());
@@ -111,6 +115,373 @@ TEST(udp, one_sender_one_receiver_single_thread) {
     trx.remove_port(rx_addr);
 }
 
+TEST(udp, paced_sender) {
+    const core::nanoseconds_t Interval = 5 * core::Millisecond;
+
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_udp_receiver(rx_addr, rx_queue));
+
+    CHECK(trx.start());
+
+    const core::nanoseconds_t start = core::timestamp() + Interval;
+
+    for (int p = 0; p < NumPackets; p++) {
+        packet::PacketPtr pp = new_packet(tx_addr, rx_addr, p);
+        pp->udp()->send_time = start + Interval * p;
+        tx_sender->write(pp);
+    }
+
+    for (int p = 0; p < NumPackets; p++) {
+        packet::PacketPtr pp = rx_queue.read();
+        check_packet(pp, tx_addr, rx_addr, p);
+        CHECK(pp->udp()->receive_timestamp >= start + Interval * p);
+    }
+
+    trx.stop();
+    trx.join();
+
+    trx.remove_port(tx_addr);
+    trx.remove_port(rx_addr);
+}
+
+TEST(udp, paced_sender_doesnt_block_receiver) {
+    enum { NumPacedPackets = 200 };
+
+    // paced packets are closer to each other than the timer can wake up
+    const core::nanoseconds_t PacedInterval = 500 * core::Microsecond;
+    const core::nanoseconds_t Interval = 5 * core::Millisecond;
+    const core::nanoseconds_t MaxLatency = 20 * core::Millisecond;
+
+    packet::ConcurrentQueue paced_queue;
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address paced_tx_addr = new_address();
+    packet::Address paced_rx_addr = new_address();
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* paced_sender = trx.add_udp_sender(paced_tx_addr);
+    CHECK(paced_sender);
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_udp_receiver(paced_rx_addr, paced_queue));
+    CHECK(trx.add_udp_receiver(rx_addr, rx_queue));
+
+    CHECK(trx.start());
+
+    const core::nanoseconds_t start = core::timestamp() + PacedInterval;
+
+    for (int p = 0; p < NumPacedPackets; p++) {
+        packet::PacketPtr pp = new_packet(paced_tx_addr, paced_rx_addr, p);
+        pp->udp()->send_time = start + PacedInterval * p;
+        paced_sender->write(pp);
+    }
+
+    // while the paced sender is active, other ports of the same network
+    // thread are served without delay
+    for (int p = 0; core::timestamp() < start + PacedInterval * NumPacedPackets; p++) {
+        const core::nanoseconds_t write_time = core::timestamp();
+
+        tx_sender->write(new_packet(tx_addr, rx_addr, p));
+        check_packet(rx_queue.read(), tx_addr, rx_addr, p);
+
+        CHECK(core::timestamp() - write_time < MaxLatency);
+
+        core::sleep_for(Interval);
+    }
+
+    for (int p = 0; p < NumPacedPackets; p++) {
+        check_packet(paced_queue.read(), paced_tx_addr, paced_rx_addr, p);
+    }
+
+    trx.stop();
+    trx.join();
+
+    trx.remove_port(paced_tx_addr);
+    trx.remove_port(paced_rx_addr);
+    trx.remove_port(tx_addr);
+    trx.remove_port(rx_addr);
+}
+
+#ifdef __linux__
+
+TEST(udp, kernel_receive_timestamp) {
+    const core::nanoseconds_t Delay = 100 * core::Millisecond;
+
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+
+    Transceiver tx_trx(packet_pool, buffer_pool, allocator);
+    CHECK(tx_trx.valid());
+
+    Transceiver rx_trx(packet_pool, buffer_pool, allocator);
+    CHECK(rx_trx.valid());
+
+    packet::IWriter* tx_sender = tx_trx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(rx_trx.add_udp_receiver(rx_addr, rx_queue));
+
+    CHECK(tx_trx.start());
+
+    const core::nanoseconds_t send_time = core::timestamp();
+
+    for (int p = 0; p < NumPackets; p++) {
+        tx_sender->write(new_packet(tx_addr, rx_addr, p));
+    }
+
+    // packets wait in the socket queue until the receiver is started
+    core::sleep_for(Delay);
+
+    const core::nanoseconds_t read_time = core::timestamp();
+
+    CHECK(rx_trx.start());
+
+    for (int p = 0; p < NumPackets; p++) {
+        packet::PacketPtr pp = rx_queue.read();
+        check_packet(pp, tx_addr, rx_addr, p);
+
+        // timestamp is taken by kernel on arrival, not when packet is read
+        CHECK(pp->udp()->receive_timestamp >= send_time);
+        CHECK(pp->udp()->receive_timestamp < read_time);
+    }
+
+    tx_trx.stop();
+    tx_trx.join();
+
+    rx_trx.stop();
+    rx_trx.join();
+
+    tx_trx.remove_port(tx_addr);
+    rx_trx.remove_port(rx_addr);
+}
+
+#endif // __linux__
+
+TEST(udp, multicast_loopback) {
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address();
+
+    packet::Address rx_addr;
+    CHECK(packet::parse_address("239.255.0.1:0", rx_addr));
+
+    packet::Address iface_addr;
+    CHECK(iface_addr.set_ipv4("127.0.0.1", 0));
+
+    UDPSenderConfig sender_config;
+    sender_config.multicast_ttl = 1;
+    sender_config.multicast_interface = iface_addr;
+
+    UDPReceiverConfig receiver_config;
+    receiver_config.multicast_interface = iface_addr;
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr, sender_config);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_udp_receiver(rx_addr, receiver_config, rx_queue));
+    CHECK(rx_addr.multicast());
+    CHECK(rx_addr.port() > 0);
+
+    CHECK(trx.start());
+
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumPackets; p++) {
+            tx_sender->write(new_packet(tx_addr, rx_addr, p));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(rx_queue.read(), tx_addr, rx_addr, p);
+        }
+    }
+
+    trx.stop();
+    trx.join();
+
+    trx.remove_port(tx_addr);
+    trx.remove_port(rx_addr);
+}
+
+#ifdef __linux__
+
+TEST(udp, multicast_source_loopback) {
+    packet::ConcurrentQueue rx_queue;
+
+    // the whole 127.0.0.0/8 is routed to loopback on Linux
+    packet::Address tx_addr;
+    CHECK(packet::parse_address("127.0.0.1:0", tx_addr));
+
+    packet::Address other_tx_addr;
+    CHECK(packet::parse_address("127.0.0.2:0", other_tx_addr));
+
+    packet::Address rx_addr;
+    CHECK(packet::parse_address("232.255.0.1:0", rx_addr));
+
+    packet::Address iface_addr;
+    CHECK(iface_addr.set_ipv4("127.0.0.1", 0));
+
+    UDPSenderConfig sender_config;
+    sender_config.multicast_ttl = 1;
+    sender_config.multicast_interface = iface_addr;
+
+    UDPReceiverConfig receiver_config;
+    receiver_config.multicast_interface = iface_addr;
+    receiver_config.multicast_source = tx_addr;
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr, sender_config);
+    CHECK(tx_sender);
+
+    packet::IWriter* other_tx_sender = trx.add_udp_sender(other_tx_addr, sender_config);
+    CHECK(other_tx_sender);
+
+    CHECK(trx.add_udp_receiver(rx_addr, receiver_config, rx_queue));
+    CHECK(rx_addr.multicast());
+    CHECK(rx_addr.port() > 0);
+
+    CHECK(trx.start());
+
+    for (int i = 0; i < NumIterations; i++) {
+        // packets from other source are filtered out by the kernel
+        for (int p = 0; p < NumPackets; p++) {
+            other_tx_sender->write(new_packet(other_tx_addr, rx_addr, -p));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            tx_sender->write(new_packet(tx_addr, rx_addr, p));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(rx_queue.read(), tx_addr, rx_addr, p);
+        }
+    }
+
+    trx.stop();
+    trx.join();
+
+    trx.remove_port(tx_addr);
+    trx.remove_port(other_tx_addr);
+    trx.remove_port(rx_addr);
+}
+
+#endif // __linux__
+
+TEST(udp, socket_options_and_stats) {
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+
+    UDPSenderConfig sender_config;
+    sender_config.socket_options.send_buffer_size = 64 * 1024;
+    sender_config.socket_options.dscp = 46;
+
+    UDPReceiverConfig receiver_config;
+    receiver_config.socket_options.recv_buffer_size = 256 * 1024;
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr, sender_config);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_udp_receiver(rx_addr, receiver_config, rx_queue));
+
+    UDPReceiverStats stats;
+    CHECK(!trx.get_receiver_stats(tx_addr, stats));
+
+    CHECK(trx.start());
+
+    for (int p = 0; p < NumPackets; p++) {
+        tx_sender->write(new_packet(tx_addr, rx_addr, p));
+    }
+    for (int p = 0; p < NumPackets; p++) {
+        check_packet(rx_queue.read(), tx_addr, rx_addr, p);
+    }
+
+    CHECK(trx.get_receiver_stats(rx_addr, stats));
+    UNSIGNED_LONGS_EQUAL(NumPackets, stats.n_packets);
+    UNSIGNED_LONGS_EQUAL(0, stats.n_kernel_drops);
+
+    trx.stop();
+    trx.join();
+
+    trx.remove_port(tx_addr);
+    trx.remove_port(rx_addr);
+}
+
+#ifdef __linux__
+
+TEST(udp, kernel_drops) {
+    enum { NumFloodPackets = 1000 };
+
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+
+    UDPReceiverConfig receiver_config;
+    receiver_config.socket_options.recv_buffer_size = 4 * 1024;
+
+    Transceiver tx_trx(packet_pool, buffer_pool, allocator);
+    CHECK(tx_trx.valid());
+
+    Transceiver rx_trx(packet_pool, buffer_pool, allocator);
+    CHECK(rx_trx.valid());
+
+    packet::IWriter* tx_sender = tx_trx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(rx_trx.add_udp_receiver(rx_addr, receiver_config, rx_queue));
+
+    CHECK(tx_trx.start());
+
+    // receiver is not started yet, so nobody reads the socket and the
+    // kernel drops packets that don't fit into the small buffer
+    for (int p = 0; p < NumFloodPackets; p++) {
+        tx_sender->write(new_packet(tx_addr, rx_addr, p));
+    }
+
+    core::sleep_for(100 * core::Millisecond);
+
+    CHECK(rx_trx.start());
+
+    UDPReceiverStats stats;
+    CHECK(rx_trx.get_receiver_stats(rx_addr, stats));
+    CHECK(stats.n_kernel_drops > 0);
+    CHECK(stats.n_kernel_drops < NumFloodPackets);
+
+    tx_trx.stop();
+    tx_trx.join();
+
+    rx_trx.stop();
+    rx_trx.join();
+
+    tx_trx.remove_port(tx_addr);
+    rx_trx.remove_port(rx_addr);
+}
+
+#endif // __linux__
+
 TEST(udp, one_sender_one_receiver_separate_threads) {
     packet::ConcurrentQueue rx_queue;
 
@@ -75,6 +75,23 @@ TEST(address, get_ipv6) {
     STRCMP_EQUAL("2001:db8::1", buf);
 }
 
+TEST(address, multicast) {
+    Address addr;
+    CHECK(!addr.multicast());
+
+    CHECK(addr.set_ipv4("239.255.0.1", 123));
+    CHECK(addr.multicast());
+
+    CHECK(addr.set_ipv4("127.0.0.1", 123));
+    CHECK(!addr.multicast());
+
+    CHECK(addr.set_ipv6("ff02::1", 123));
+    CHECK(addr.multicast());
+
+    CHECK(addr.set_ipv6("2001:db8::1", 123));
+    CHECK(!addr.multicast());
+}
+
 TEST(address, parse_ipv4) {
     Address addr;
 
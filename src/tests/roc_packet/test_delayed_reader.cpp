@@ -80,6 +80,30 @@ TEST(delayed_reader, delay) {
     CHECK(!dr.read());
 }
 
+TEST(delayed_reader, reset) {
+    Queue queue;
+    DelayedReader dr(queue, NumSamples * (NumPackets - 1) * NsPerSample, SampleRate);
+
+    for (seqnum_t n = 0; n < NumPackets / 2; n++) {
+        queue.write(new_packet(n));
+        CHECK(!dr.read());
+    }
+
+    dr.reset();
+
+    PacketPtr packets[NumPackets];
+
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        CHECK(!dr.read());
+        packets[n] = new_packet(NumPackets + n);
+        queue.write(packets[n]);
+    }
+
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        CHECK(dr.read() == packets[n]);
+    }
+}
+
 TEST(delayed_reader, instant) {
     Queue queue;
     DelayedReader dr(queue, NumSamples * (NumPackets - 1) * NsPerSample, SampleRate);
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2015 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/array.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/diagonal_interleaver.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { BlockSize = 30, Depth = 4 };
+
+core::HeapAllocator allocator;
+PacketPool pool(allocator, true);
+
+} // namespace
+
+TEST_GROUP(diagonal_interleaver) {
+    PacketPtr new_packet(seqnum_t sn) {
+        PacketPtr packet = new (pool) Packet(pool);
+        CHECK(packet);
+
+        packet->add_flags(Packet::FlagRTP);
+        packet->rtp()->seqnum = sn;
+
+        return packet;
+    }
+};
+
+TEST(diagonal_interleaver, read_write) {
+    Queue queue;
+    DiagonalInterleaver intrlvr(queue, allocator, BlockSize, Depth);
+
+    CHECK(intrlvr.valid());
+
+    const size_t num_packets = BlockSize * 20;
+
+    core::Array<bool> packets_ctr(allocator);
+    CHECK(packets_ctr.resize(num_packets));
+
+    for (size_t i = 0; i < num_packets; i++) {
+        packets_ctr[i] = false;
+    }
+
+    for (size_t i = 0; i < num_packets; i++) {
+        intrlvr.write(new_packet(seqnum_t(i)));
+    }
+
+    // Only packets delayed less than the current position are written.
+    CHECK(queue.size() > num_packets - intrlvr.delay());
+    CHECK(queue.size() < num_packets);
+
+    intrlvr.flush();
+
+    LONGS_EQUAL(num_packets, queue.size());
+
+    for (size_t i = 0; i < num_packets; i++) {
+        PacketPtr p = queue.read();
+        CHECK(p);
+        CHECK(p->rtp()->seqnum < num_packets);
+        CHECK(!packets_ctr[p->rtp()->seqnum]);
+        packets_ctr[p->rtp()->seqnum] = true;
+    }
+
+    LONGS_EQUAL(0, queue.size());
+}
+
+TEST(diagonal_interleaver, bounded_delay) {
+    Queue queue;
+    DiagonalInterleaver intrlvr(queue, allocator, BlockSize, Depth);
+
+    CHECK(intrlvr.valid());
+
+    const size_t num_packets = BlockSize * 20;
+
+    for (size_t i = 0; i < num_packets; i++) {
+        intrlvr.write(new_packet(seqnum_t(i)));
+
+        // Every written packet has been written not later than delay().
+        while (PacketPtr p = queue.read()) {
+            CHECK(p->rtp()->seqnum <= i);
+            CHECK(i - p->rtp()->seqnum <= intrlvr.delay());
+        }
+    }
+}
+
+TEST(diagonal_interleaver, spreading) {
+    Queue queue;
+    DiagonalInterleaver intrlvr(queue, allocator, BlockSize, Depth);
+
+    CHECK(intrlvr.valid());
+
+    const size_t num_packets = BlockSize * 20;
+
+    for (size_t i = 0; i < num_packets; i++) {
+        intrlvr.write(new_packet(seqnum_t(i)));
+    }
+    intrlvr.flush();
+
+    core::Array<PacketPtr> packets(allocator);
+    CHECK(packets.resize(num_packets));
+
+    for (size_t i = 0; i < num_packets; i++) {
+        packets[i] = queue.read();
+        CHECK(packets[i]);
+    }
+
+    // Any Depth consecutive packets are from different blocks, except the
+    // beginning and the end of the stream where the delay line is not full.
+    for (size_t i = intrlvr.delay(); i + Depth <= num_packets - intrlvr.delay(); i++) {
+        for (size_t j = i; j < i + Depth; j++) {
+            for (size_t k = j + 1; k < i + Depth; k++) {
+                CHECK(packets[j]->rtp()->seqnum / BlockSize
+                      != packets[k]->rtp()->seqnum / BlockSize);
+            }
+        }
+    }
+}
+
+TEST(diagonal_interleaver, flush) {
+    Queue queue;
+    DiagonalInterleaver intrlvr(queue, allocator, BlockSize, Depth);
+
+    CHECK(intrlvr.valid());
+
+    for (size_t n = 0; n < BlockSize * 5; n++) {
+        PacketPtr packet = new_packet(seqnum_t(n));
+
+        intrlvr.write(packet);
+        intrlvr.flush();
+        LONGS_EQUAL(1, queue.size());
+
+        CHECK(queue.read() == packet);
+        LONGS_EQUAL(0, queue.size());
+    }
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/pacer.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { SampleRate = 44100, PacketDuration = 441, NumPackets = 1000 };
+
+const core::nanoseconds_t PacketTime = 10 * core::Millisecond;
+const core::nanoseconds_t Start = 1000 * core::Second;
+
+core::HeapAllocator allocator;
+PacketPool pool(allocator, true);
+
+} // namespace
+
+TEST_GROUP(pacer) {
+    PacketPtr new_audio_packet(timestamp_t ts) {
+        PacketPtr packet = new (pool) Packet(pool);
+        CHECK(packet);
+        packet->add_flags(Packet::FlagRTP | Packet::FlagAudio);
+        packet->rtp()->timestamp = ts;
+        packet->rtp()->duration = PacketDuration;
+        return packet;
+    }
+
+    PacketPtr new_repair_packet() {
+        PacketPtr packet = new (pool) Packet(pool);
+        CHECK(packet);
+        packet->add_flags(Packet::FlagRepair);
+        return packet;
+    }
+
+    core::nanoseconds_t send_time(Queue & queue) {
+        PacketPtr packet = queue.read();
+        CHECK(packet);
+        CHECK(packet->udp());
+        return packet->udp()->send_time;
+    }
+};
+
+TEST(pacer, spread) {
+    Queue queue;
+    Pacer pacer(queue, SampleRate);
+
+    pacer.set_min_send_time(Start);
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        pacer.write(new_audio_packet(timestamp_t(n * PacketDuration)));
+    }
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        CHECK(send_time(queue) == Start + core::nanoseconds_t(n) * PacketTime);
+    }
+}
+
+TEST(pacer, repair) {
+    Queue queue;
+    Pacer pacer(queue, SampleRate);
+
+    pacer.set_min_send_time(Start);
+
+    pacer.write(new_audio_packet(0));
+    pacer.write(new_audio_packet(PacketDuration));
+    pacer.write(new_repair_packet());
+    pacer.write(new_audio_packet(PacketDuration * 2));
+
+    CHECK(send_time(queue) == Start);
+    CHECK(send_time(queue) == Start + PacketTime);
+    CHECK(send_time(queue) == Start + PacketTime);
+    CHECK(send_time(queue) == Start + PacketTime * 2);
+}
+
+TEST(pacer, min_send_time) {
+    Queue queue;
+    Pacer pacer(queue, SampleRate);
+
+    pacer.set_min_send_time(Start);
+
+    pacer.write(new_audio_packet(0));
+    pacer.write(new_audio_packet(PacketDuration));
+
+    // schedule is ahead, min send time is ignored
+    pacer.set_min_send_time(Start + PacketTime);
+    pacer.write(new_audio_packet(PacketDuration * 2));
+
+    // schedule is behind, it's restarted
+    pacer.set_min_send_time(Start + PacketTime * 10);
+    pacer.write(new_audio_packet(PacketDuration * 3));
+    pacer.write(new_audio_packet(PacketDuration * 4));
+
+    CHECK(send_time(queue) == Start);
+    CHECK(send_time(queue) == Start + PacketTime);
+    CHECK(send_time(queue) == Start + PacketTime * 2);
+    CHECK(send_time(queue) == Start + PacketTime * 10);
+    CHECK(send_time(queue) == Start + PacketTime * 11);
+}
+
+TEST(pacer, max_send_time) {
+    Queue queue;
+    Pacer pacer(queue, SampleRate);
+
+    pacer.set_min_send_time(Start);
+
+    pacer.write(new_audio_packet(0));
+    pacer.write(new_audio_packet(PacketDuration));
+
+    // schedule is behind, max send time is ignored
+    pacer.set_max_send_time(Start + PacketTime * 10);
+    pacer.write(new_audio_packet(PacketDuration * 2));
+
+    // schedule is ahead, it's restarted
+    pacer.set_max_send_time(Start + PacketTime);
+    pacer.write(new_audio_packet(PacketDuration * 3));
+    pacer.write(new_audio_packet(PacketDuration * 4));
+
+    CHECK(send_time(queue) == Start);
+    CHECK(send_time(queue) == Start + PacketTime);
+    CHECK(send_time(queue) == Start + PacketTime * 2);
+    CHECK(send_time(queue) == Start + PacketTime);
+    CHECK(send_time(queue) == Start + PacketTime * 2);
+}
+
+TEST(pacer, udp_flag) {
+    Queue queue;
+    Pacer pacer(queue, SampleRate);
+
+    PacketPtr packet = new_audio_packet(0);
+    packet->add_flags(Packet::FlagUDP);
+
+    pacer.write(packet);
+
+    CHECK(queue.read() == packet);
+}
+
+} // namespace packet
+} // namespace roc
@@ -184,5 +184,30 @@ TEST(router, different_routes_different_sources) {
     UNSIGNED_LONGS_EQUAL(1, queue_f.size());
 }
 
+TEST(router, dropped_and_reset) {
+    Router router(allocator, MaxRoutes);
+
+    CHECK(router.valid());
+
+    Queue queue;
+    CHECK(router.add_route(queue, Packet::FlagAudio));
+
+    router.write(new_packet(11, Packet::FlagAudio));
+    router.write(new_packet(22, Packet::FlagAudio));
+    router.write(new_packet(11, Packet::FlagFEC));
+
+    UNSIGNED_LONGS_EQUAL(1, queue.size());
+    UNSIGNED_LONGS_EQUAL(2, router.num_dropped());
+
+    router.reset();
+
+    UNSIGNED_LONGS_EQUAL(0, router.num_dropped());
+
+    router.write(new_packet(22, Packet::FlagAudio));
+
+    UNSIGNED_LONGS_EQUAL(2, queue.size());
+    UNSIGNED_LONGS_EQUAL(0, router.num_dropped());
+}
+
 } // namespace packet
 } // namespace roc
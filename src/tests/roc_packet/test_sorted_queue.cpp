@@ -177,6 +177,7 @@ TEST(sorted_queue, many_duplicates) {
     }
 
     LONGS_EQUAL(NumPackets, queue.size());
+    LONGS_EQUAL(NumPackets, queue.num_duplicates());
 
     for (seqnum_t n = 0; n < NumPackets; n++) {
         CHECK(queue.read()->rtp()->seqnum == n);
@@ -197,6 +198,7 @@ TEST(sorted_queue, max_size) {
     queue.write(p3);
 
     LONGS_EQUAL(2, queue.size());
+    LONGS_EQUAL(1, queue.num_overflows());
 
     CHECK(queue.head() == p1);
     CHECK(queue.tail() == p2);
@@ -355,5 +357,27 @@ TEST(sorted_queue, latest) {
     CHECK(queue.latest() == p4);
 }
 
+TEST(sorted_queue, reset) {
+    SortedQueue queue(0);
+
+    queue.write(new_packet(1));
+    queue.write(new_packet(2));
+
+    LONGS_EQUAL(2, queue.size());
+    CHECK(queue.latest());
+
+    queue.reset();
+
+    LONGS_EQUAL(0, queue.size());
+    CHECK(!queue.latest());
+    CHECK(!queue.read());
+
+    PacketPtr p = new_packet(0);
+    queue.write(p);
+
+    LONGS_EQUAL(1, queue.size());
+    CHECK(queue.latest() == p);
+}
+
 } // namespace packet
 } // namespace roc
@@ -10,6 +10,8 @@
 
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/helpers.h"
+#include "roc_core/time.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_packet/parse_address.h"
 #include "roc_pipeline/receiver.h"
@@ -56,6 +58,30 @@ rtp::FormatMap format_map;
 rtp::Composer rtp_composer(NULL);
 rtp::PCMEncoder<int16_t, NumCh> pcm_encoder;
 
+// Counts total number of allocations, including freed ones.
+class CountingAllocator : public core::IAllocator {
+public:
+    CountingAllocator()
+        : num_allocations_(0) {
+    }
+
+    virtual void* allocate(size_t size) {
+        num_allocations_++;
+        return allocator.allocate(size);
+    }
+
+    virtual void deallocate(void* ptr) {
+        allocator.deallocate(ptr);
+    }
+
+    size_t num_allocations() const {
+        return num_allocations_;
+    }
+
+private:
+    size_t num_allocations_;
+};
+
 } // namespace
 
 TEST_GROUP(receiver) {
@@ -171,6 +197,237 @@ TEST(receiver, one_session) {
     }
 }
 
+TEST(receiver, stats) {
+    enum { NumPackets = Latency / SamplesPerPacket };
+
+    config.stats_interval = 0;
+
+    Receiver receiver(config, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(receiver, rtp_composer, pcm_encoder, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(NumPackets - 2, SamplesPerPacket, ChMask);
+
+    // duplicate last packet
+    packet_writer.shift_to(NumPackets - 3, SamplesPerPacket, ChMask);
+    packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+
+    // lose one packet
+    packet_writer.shift_to(NumPackets - 1, SamplesPerPacket, ChMask);
+    packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+
+    for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+        frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+    }
+
+    ReceiverStats stats;
+    receiver.get_stats(stats);
+
+    UNSIGNED_LONGS_EQUAL(1, stats.n_sessions);
+    UNSIGNED_LONGS_EQUAL(NumPackets, stats.n_packets);
+    UNSIGNED_LONGS_EQUAL(0, stats.n_dropped_packets);
+
+    const ReceiverSessionStats& sess = stats.sessions[0];
+
+    CHECK(sess.src_address == src1);
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, sess.n_packets_received);
+    UNSIGNED_LONGS_EQUAL(1, sess.n_packets_duplicate);
+    UNSIGNED_LONGS_EQUAL(1, sess.n_packets_lost);
+    UNSIGNED_LONGS_EQUAL(0, sess.n_packets_late);
+    UNSIGNED_LONGS_EQUAL(0, sess.n_packets_dropped);
+
+    UNSIGNED_LONGS_EQUAL(FramesPerPacket, sess.n_frames);
+    UNSIGNED_LONGS_EQUAL(0, sess.n_blank_frames);
+    UNSIGNED_LONGS_EQUAL(0, sess.n_incomplete_frames);
+
+    DOUBLES_EQUAL(config.default_session.target_latency, sess.target_latency,
+                  core::Second / SampleRate);
+    CHECK(sess.latency > 0);
+    DOUBLES_EQUAL(1.0, sess.scaling, 0.0001);
+
+    UNSIGNED_LONGS_EQUAL(0, sess.blank_duration);
+    CHECK(!sess.broken);
+
+    // queued packets are still allocated from the pools
+    CHECK(stats.n_pool_packets >= NumPackets - 2);
+    CHECK(stats.n_pool_byte_buffers >= NumPackets - 2);
+}
+
+TEST(receiver, stats_late_duplicate) {
+    enum { NumPackets = Latency / SamplesPerPacket };
+
+    config.stats_interval = 0;
+
+    Receiver receiver(config, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(receiver, rtp_composer, pcm_encoder, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(NumPackets, SamplesPerPacket, ChMask);
+
+    for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+        frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+    }
+
+    // duplicate first packet after it was already played
+    packet_writer.shift_to(0, SamplesPerPacket, ChMask);
+    packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+
+    frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+    ReceiverStats stats;
+    receiver.get_stats(stats);
+
+    UNSIGNED_LONGS_EQUAL(1, stats.n_sessions);
+
+    const ReceiverSessionStats& sess = stats.sessions[0];
+
+    UNSIGNED_LONGS_EQUAL(NumPackets + 1, sess.n_packets_received);
+    UNSIGNED_LONGS_EQUAL(1, sess.n_packets_duplicate);
+    UNSIGNED_LONGS_EQUAL(0, sess.n_packets_lost);
+}
+
+TEST(receiver, stats_out_of_window_duplicate) {
+    // more than the number of recent seqnums for which duplicates are detected
+    enum { NumPackets = 300 };
+
+    config.stats_interval = 0;
+
+    Receiver receiver(config, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(receiver, rtp_composer, pcm_encoder, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    for (size_t np = Latency / SamplesPerPacket; np < NumPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+        }
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    // lose one packet
+    packet_writer.shift_to(NumPackets + 1, SamplesPerPacket, ChMask);
+    packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+
+    // duplicate first packet when it's too old to be detected as duplicate
+    packet_writer.shift_to(0, SamplesPerPacket, ChMask);
+    packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+
+    frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+    ReceiverStats stats;
+    receiver.get_stats(stats);
+
+    UNSIGNED_LONGS_EQUAL(1, stats.n_sessions);
+
+    const ReceiverSessionStats& sess = stats.sessions[0];
+
+    UNSIGNED_LONGS_EQUAL(NumPackets + 2, sess.n_packets_received);
+    UNSIGNED_LONGS_EQUAL(0, sess.n_packets_duplicate);
+    UNSIGNED_LONGS_EQUAL(1, sess.n_packets_lost);
+}
+
+TEST(receiver, stats_interval) {
+    enum { FramesPerInterval = 10 };
+
+    config.stats_interval =
+        FramesPerInterval * SamplesPerFrame * core::Second / SampleRate;
+
+    Receiver receiver(config, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(receiver, rtp_composer, pcm_encoder, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    ReceiverStats stats;
+
+    // published after the first frame
+    frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+    receiver.get_stats(stats);
+    UNSIGNED_LONGS_EQUAL(1, stats.n_sessions);
+    UNSIGNED_LONGS_EQUAL(1, stats.sessions[0].n_frames);
+
+    // not published until the interval passes
+    for (size_t nf = 1; nf < FramesPerInterval; nf++) {
+        frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+    }
+    receiver.get_stats(stats);
+    UNSIGNED_LONGS_EQUAL(1, stats.sessions[0].n_frames);
+
+    frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+    receiver.get_stats(stats);
+    UNSIGNED_LONGS_EQUAL(FramesPerInterval + 1, stats.sessions[0].n_frames);
+}
+
+TEST(receiver, profiling) {
+    config.profiling = true;
+
+    Receiver receiver(config, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(receiver, rtp_composer, pcm_encoder, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+        frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+    }
+
+    ProfilerStats stats;
+    receiver.get_profile(stats);
+
+    const Stage expected_stages[] = {
+        Stage_Queue, Stage_Validator, Stage_Depacketizer, Stage_Watchdog, Stage_Mixer,
+    };
+
+    UNSIGNED_LONGS_EQUAL(ROC_ARRAY_SIZE(expected_stages), stats.n_stages);
+
+    for (size_t n = 0; n < stats.n_stages; n++) {
+        LONGS_EQUAL(expected_stages[n], stats.stages[n].stage);
+
+        CHECK(stats.stages[n].n_calls > 0);
+        CHECK(stats.stages[n].p50 <= stats.stages[n].p99);
+        CHECK(stats.stages[n].p99 <= stats.stages[n].max);
+    }
+
+    UNSIGNED_LONGS_EQUAL(FramesPerPacket, stats.stages[stats.n_stages - 1].n_calls);
+}
+
 TEST(receiver, one_session_long_run) {
     enum { NumIterations = 10 };
 
@@ -314,6 +571,213 @@ TEST(receiver, initial_trim) {
     }
 }
 
+TEST(receiver, latency_overshoot_recovery) {
+    enum { ExtraPackets = Latency * 2 / SamplesPerPacket };
+
+    config.default_session.latency_monitor.min_latency =
+        Latency / 2 * core::Second / SampleRate;
+    config.default_session.latency_monitor.max_latency =
+        Latency * 2 * core::Second / SampleRate;
+
+    Receiver receiver(config, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(receiver, rtp_composer, pcm_encoder, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+        }
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    // latency goes above maximum
+    packet_writer.write_packets(ExtraPackets, SamplesPerPacket, ChMask);
+
+    // excess samples are skipped without a gap, and the stream continues
+    // from the target latency
+    frame_reader.set_offset(size_t(packet_writer.offset() - Latency * NumCh));
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+    }
+}
+
+TEST(receiver, latency_undershoot_recovery) {
+    enum {
+        MinLatency = Latency / 2,
+
+        // frames read before latency goes below minimum
+        StarveFrames = (Latency - MinLatency) / SamplesPerFrame + 1,
+
+        // frames of silence inserted to restore target latency
+        GlitchFrames = StarveFrames
+    };
+
+    config.default_session.latency_monitor.min_latency =
+        MinLatency * core::Second / SampleRate;
+    config.default_session.latency_monitor.max_latency =
+        Latency * 2 * core::Second / SampleRate;
+
+    Receiver receiver(config, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(receiver, rtp_composer, pcm_encoder, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+        }
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    // packets are delayed, latency goes below minimum
+    for (size_t nf = 0; nf < StarveFrames; nf++) {
+        frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+    }
+
+    // silence is inserted, packets arrive again
+    for (size_t nf = 0; nf < GlitchFrames; nf++) {
+        frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+
+        UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+
+        if ((nf + 1) % FramesPerPacket == 0) {
+            packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+        }
+    }
+
+    // the stream continues from the same position
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+    }
+}
+
+TEST(receiver, latency_out_of_bounds_no_recovery) {
+    config.default_session.latency_monitor.min_latency =
+        Latency / 2 * core::Second / SampleRate;
+    config.default_session.latency_monitor.max_latency =
+        Latency * 2 * core::Second / SampleRate;
+    config.default_session.latency_monitor.latency_recovery = false;
+
+    Receiver receiver(config, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(receiver, rtp_composer, pcm_encoder, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+        frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+    }
+
+    packet_writer.write_packets(Latency * 2 / SamplesPerPacket, SamplesPerPacket,
+                                ChMask);
+
+    frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+
+    UNSIGNED_LONGS_EQUAL(0, receiver.num_sessions());
+}
+
+TEST(receiver, session_pool) {
+    config.session_pool_size = 1;
+    config.session_pool_payload_type = PayloadType;
+
+    CountingAllocator session_allocator;
+
+    Receiver receiver(config, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, session_allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    const size_t num_allocations = session_allocator.num_allocations();
+
+    {
+        FrameReader frame_reader(receiver, sample_buffer_pool);
+
+        PacketWriter packet_writer(receiver, rtp_composer, pcm_encoder, packet_pool,
+                                   byte_buffer_pool, PayloadType, src1, port1.address);
+
+        packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket,
+                                    ChMask);
+
+        for (size_t np = 0; np < ManyPackets; np++) {
+            for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+                frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+                UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+            }
+            packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+        }
+
+        for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+            for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+                frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+            }
+        }
+
+        while (receiver.num_sessions() != 0) {
+            frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(num_allocations, session_allocator.num_allocations());
+
+    {
+        FrameReader frame_reader(receiver, sample_buffer_pool);
+
+        PacketWriter packet_writer(receiver, rtp_composer, pcm_encoder, packet_pool,
+                                   byte_buffer_pool, PayloadType, src2, port1.address);
+
+        packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket,
+                                    ChMask);
+
+        for (size_t np = 0; np < ManyPackets; np++) {
+            for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+                frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+                UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+            }
+            packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(num_allocations, session_allocator.num_allocations());
+}
+
 TEST(receiver, two_sessions_synchronous) {
     Receiver receiver(config, format_map, packet_pool, byte_buffer_pool,
                       sample_buffer_pool, allocator);
@@ -1108,5 +1572,58 @@ TEST(receiver, status) {
     }
 }
 
+TEST(receiver, read_ready_no_timing) {
+    Receiver receiver(config, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+
+    audio::sample_t samples[SamplesPerFrame * NumCh];
+
+    core::nanoseconds_t deadline = -1;
+
+    UNSIGNED_LONGS_EQUAL(SamplesPerFrame * NumCh,
+                         receiver.read_ready(samples, SamplesPerFrame * NumCh,
+                                             audio::SampleFormat_Float, deadline));
+    CHECK(deadline == 0);
+}
+
+TEST(receiver, read_ready_timing) {
+    const core::nanoseconds_t FrameDuration = SamplesPerFrame * core::Second / SampleRate;
+
+    config.output.timing = true;
+
+    Receiver receiver(config, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+
+    audio::sample_t samples[SamplesPerFrame * NumCh];
+
+    core::nanoseconds_t deadline = 0;
+
+    const core::nanoseconds_t start = core::timestamp();
+
+    UNSIGNED_LONGS_EQUAL(0,
+                         receiver.read_ready(samples, SamplesPerFrame * NumCh,
+                                             audio::SampleFormat_Float, deadline));
+
+    CHECK(deadline >= start + FrameDuration);
+    CHECK(deadline <= core::timestamp() + FrameDuration);
+
+    for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+        core::sleep_until(deadline);
+
+        const core::nanoseconds_t prev_deadline = deadline;
+
+        UNSIGNED_LONGS_EQUAL(SamplesPerFrame * NumCh,
+                             receiver.read_ready(samples, SamplesPerFrame * NumCh,
+                                                 audio::SampleFormat_Float, deadline));
+
+        CHECK(deadline > prev_deadline);
+        CHECK(deadline - prev_deadline <= FrameDuration + core::Microsecond);
+    }
+}
+
 } // namespace pipeline
 } // namespace roc
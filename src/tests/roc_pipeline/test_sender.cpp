@@ -49,6 +49,31 @@ packet::PacketPool packet_pool(allocator, true);
 rtp::FormatMap format_map;
 rtp::Parser rtp_parser(format_map, NULL);
 rtp::PCMDecoder<int16_t, NumCh> pcm_decoder;
+rtp::PCMDecoder<rtp::PCMFloat32, NumCh> pcm_float_decoder;
+
+// Fails the given allocation, counting from zero.
+class FailingAllocator : public core::IAllocator {
+public:
+    explicit FailingAllocator(size_t fail_at)
+        : fail_at_(fail_at)
+        , num_allocations_(0) {
+    }
+
+    virtual void* allocate(size_t size) {
+        if (num_allocations_++ == fail_at_) {
+            return NULL;
+        }
+        return allocator.allocate(size);
+    }
+
+    virtual void deallocate(void* ptr) {
+        allocator.deallocate(ptr);
+    }
+
+private:
+    const size_t fail_at_;
+    size_t num_allocations_;
+};
 
 } // namespace
 
@@ -94,6 +119,229 @@ TEST(sender, write) {
     }
 
     CHECK(!queue.read());
+
+    SenderStats stats;
+    sender.get_stats(stats);
+
+    UNSIGNED_LONGS_EQUAL(ManyFrames * SamplesPerFrame, stats.n_samples);
+    UNSIGNED_LONGS_EQUAL(ManyFrames / FramesPerPacket, stats.n_source_packets);
+    UNSIGNED_LONGS_EQUAL(0, stats.n_repair_packets);
+    CHECK(stats.n_bytes > 0);
+}
+
+TEST(sender, profiling) {
+    config.profiling = true;
+
+    packet::Queue queue;
+
+    Sender sender(config, source_port, queue, repair_port, queue, format_map, packet_pool,
+                  byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(sender.valid());
+
+    FrameWriter frame_writer(sender, sample_buffer_pool);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame * NumCh);
+    }
+
+    ProfilerStats stats;
+    sender.get_profile(stats);
+
+    UNSIGNED_LONGS_EQUAL(2, stats.n_stages);
+
+    LONGS_EQUAL(Stage_Packetizer, stats.stages[0].stage);
+    UNSIGNED_LONGS_EQUAL(ManyFrames, stats.stages[0].n_calls);
+
+    LONGS_EQUAL(Stage_Output, stats.stages[1].stage);
+    UNSIGNED_LONGS_EQUAL(ManyFrames / FramesPerPacket, stats.stages[1].n_calls);
+
+    for (size_t n = 0; n < stats.n_stages; n++) {
+        CHECK(stats.stages[n].p50 <= stats.stages[n].p99);
+        CHECK(stats.stages[n].p99 <= stats.stages[n].max);
+    }
+}
+
+TEST(sender, pacing) {
+    const core::nanoseconds_t PacketDuration =
+        SamplesPerPacket * core::Second / SampleRate;
+
+    packet::Queue queue;
+
+    // frames are written in real time, so the schedule is never capped
+    config.timing = true;
+    config.pacing = true;
+
+    Sender sender(config, source_port, queue, repair_port, queue, format_map, packet_pool,
+                  byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(sender.valid());
+
+    const core::nanoseconds_t start = core::timestamp();
+
+    FrameWriter frame_writer(sender, sample_buffer_pool);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame * NumCh);
+    }
+
+    core::nanoseconds_t prev_send_time = 0;
+
+    for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+        packet::PacketPtr pp = queue.read();
+        CHECK(pp);
+        CHECK(pp->udp());
+
+        const core::nanoseconds_t send_time = pp->udp()->send_time;
+
+        if (np == 0) {
+            CHECK(send_time >= start);
+        } else {
+            CHECK(send_time - prev_send_time >= PacketDuration - 1);
+        }
+
+        prev_send_time = send_time;
+    }
+
+    CHECK(!queue.read());
+}
+
+TEST(sender, pacing_faster_than_real_time) {
+    enum { NumFrames = ManyFrames * 100 };
+
+    packet::Queue queue;
+
+    config.timing = false;
+    config.pacing = true;
+
+    Sender sender(config, source_port, queue, repair_port, queue, format_map, packet_pool,
+                  byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(sender.valid());
+
+    FrameWriter frame_writer(sender, sample_buffer_pool);
+
+    core::nanoseconds_t prev_send_time = 0;
+    size_t num_packets = 0;
+
+    for (size_t nf = 0; nf < NumFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame * NumCh);
+
+        const core::nanoseconds_t now = core::timestamp();
+
+        while (packet::PacketPtr pp = queue.read()) {
+            CHECK(pp->udp());
+
+            const core::nanoseconds_t send_time = pp->udp()->send_time;
+
+            // schedule doesn't run away from the actual time
+            CHECK(send_time - now <= config.pacing_lead + config.packet_length);
+            CHECK(send_time >= prev_send_time);
+
+            prev_send_time = send_time;
+            num_packets++;
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumFrames / FramesPerPacket, num_packets);
+}
+
+TEST(sender, multiple_destinations) {
+    packet::Queue queue;
+
+    Sender sender(config, source_port, queue, repair_port, queue, format_map, packet_pool,
+                  byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(sender.valid());
+
+    PortConfig bad_port;
+    bad_port.address = new_address(2);
+    bad_port.protocol = Proto_RTP_RSm8_Source;
+
+    CHECK(!sender.add_destination(bad_port));
+
+    PortConfig extra_port;
+    extra_port.address = new_address(2);
+    extra_port.protocol = Proto_RTP;
+
+    CHECK(sender.add_destination(extra_port));
+
+    FrameWriter frame_writer(sender, sample_buffer_pool);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame * NumCh);
+    }
+
+    for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+        packet::PacketPtr pp = queue.read();
+        CHECK(pp);
+        CHECK(pp->udp());
+        CHECK(pp->udp()->dst_addr == source_port.address);
+
+        packet::PacketPtr extra_pp = queue.read();
+        CHECK(extra_pp);
+        CHECK(extra_pp->udp());
+        CHECK(extra_pp->udp()->dst_addr == extra_port.address);
+
+        CHECK(pp != extra_pp);
+        CHECK(pp->data().data() == extra_pp->data().data());
+        UNSIGNED_LONGS_EQUAL(pp->data().size(), extra_pp->data().size());
+    }
+
+    CHECK(!queue.read());
+
+    // every destination is counted
+    SenderStats stats;
+    sender.get_stats(stats);
+
+    UNSIGNED_LONGS_EQUAL(ManyFrames / FramesPerPacket * 2, stats.n_source_packets);
+    UNSIGNED_LONGS_EQUAL(0, stats.n_dropped_packets);
+}
+
+TEST(sender, multiple_destinations_allocation_failure) {
+    enum { NumExtraPorts = 3 };
+
+    packet::Queue queue;
+
+    // the first allocation is for the original packet, the second one, for the
+    // copy sent to the first extra destination, fails
+    FailingAllocator failing_allocator(1);
+    packet::PacketPool failing_packet_pool(failing_allocator, true);
+
+    SenderPort port(source_port, queue, failing_packet_pool, allocator);
+    CHECK(port.valid());
+
+    for (size_t n = 0; n < NumExtraPorts; n++) {
+        CHECK(port.add_destination(new_address(int(n) + 2)));
+    }
+
+    packet::PacketPtr pp = new (failing_packet_pool) packet::Packet(failing_packet_pool);
+    CHECK(pp);
+
+    pp->add_flags(packet::Packet::FlagComposed);
+    pp->set_data(new (byte_buffer_pool) core::Buffer<uint8_t>(byte_buffer_pool));
+
+    port.write(pp);
+
+    // the failed copy isn't counted as sent
+    UNSIGNED_LONGS_EQUAL(NumExtraPorts, port.num_packets());
+    UNSIGNED_LONGS_EQUAL(1, port.num_dropped_packets());
+
+    UNSIGNED_LONGS_EQUAL(0, port.num_dropped_packets(0));
+    UNSIGNED_LONGS_EQUAL(1, port.num_dropped_packets(1));
+    for (size_t n = 2; n <= NumExtraPorts; n++) {
+        UNSIGNED_LONGS_EQUAL(0, port.num_dropped_packets(n));
+    }
+
+    // other destinations still get the packet
+    CHECK(queue.read() == pp);
+    for (size_t n = 1; n < NumExtraPorts; n++) {
+        packet::PacketPtr extra_pp = queue.read();
+        CHECK(extra_pp);
+        CHECK(extra_pp->udp()->dst_addr == new_address(int(n) + 2));
+    }
+
+    CHECK(!queue.read());
 }
 
 TEST(sender, frame_size_small) {
@@ -156,5 +404,163 @@ TEST(sender, frame_size_large) {
     CHECK(!queue.read());
 }
 
+TEST(sender, reserve) {
+    enum { NumPackets = 2 };
+
+    // separate allocator to count allocations made by the pipeline
+    core::HeapAllocator reserve_allocator;
+    packet::PacketPool reserve_packet_pool(reserve_allocator, true);
+    core::BufferPool<uint8_t> reserve_byte_buffer_pool(reserve_allocator, MaxBufSize,
+                                                       true);
+
+    packet::Queue queue;
+
+    Sender sender(config, source_port, queue, repair_port, queue, format_map,
+                  reserve_packet_pool, reserve_byte_buffer_pool, sample_buffer_pool,
+                  allocator);
+
+    CHECK(sender.valid());
+    CHECK(sender.reserve());
+
+    const size_t num_allocations = reserve_allocator.num_allocations();
+
+    FrameWriter frame_writer(sender, sample_buffer_pool);
+
+    for (size_t nf = 0; nf < FramesPerPacket * NumPackets; nf++) {
+        frame_writer.write_samples(SamplesPerFrame * NumCh);
+    }
+
+    LONGS_EQUAL(num_allocations, reserve_allocator.num_allocations());
+
+    PacketReader packet_reader(queue, rtp_parser, pcm_decoder, reserve_packet_pool,
+                               PayloadType, source_port.address);
+
+    for (size_t np = 0; np < NumPackets; np++) {
+        packet_reader.read_packet(SamplesPerPacket, ChMask);
+    }
+
+    CHECK(!queue.read());
+}
+
+TEST(sender, packet_length_not_supported) {
+    packet::Queue queue;
+
+    // shorter than one sample
+    config.packet_length = core::Second / SampleRate / 4;
+
+    Sender sender(config, source_port, queue, repair_port, queue, format_map, packet_pool,
+                  byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(!sender.valid());
+}
+
+#ifdef ROC_TARGET_OPUS
+
+TEST(sender, opus_packet_length) {
+    packet::Queue queue;
+
+    config.input_sample_rate = 48000;
+    config.payload_type = rtp::PayloadType_Opus_Stereo;
+
+    {
+        // not a multiple of Opus frame length
+        config.packet_length = 7 * core::Millisecond;
+
+        Sender sender(config, source_port, queue, repair_port, queue, format_map,
+                      packet_pool, byte_buffer_pool, sample_buffer_pool, allocator);
+
+        CHECK(!sender.valid());
+    }
+
+    {
+        config.packet_length = 20 * core::Millisecond;
+
+        Sender sender(config, source_port, queue, repair_port, queue, format_map,
+                      packet_pool, byte_buffer_pool, sample_buffer_pool, allocator);
+
+        CHECK(sender.valid());
+    }
+}
+
+#endif // ROC_TARGET_OPUS
+
+TEST(sender, no_resampling_when_rates_match) {
+    enum { HighSampleRate = 48000 };
+
+    packet::Queue queue;
+
+    config.input_sample_rate = HighSampleRate;
+    config.packet_length = SamplesPerPacket * core::Second / HighSampleRate;
+    config.payload_type = rtp::PayloadType_L16_48k_Stereo;
+    config.resampling = true;
+
+    Sender sender(config, source_port, queue, repair_port, queue, format_map, packet_pool,
+                  byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(sender.valid());
+    CHECK(!sender.has_resampler());
+
+    FrameWriter frame_writer(sender, sample_buffer_pool);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame * NumCh);
+    }
+
+    PacketReader packet_reader(queue, rtp_parser, pcm_decoder, packet_pool,
+                               config.payload_type, source_port.address);
+
+    for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+        packet_reader.read_packet(SamplesPerPacket, ChMask);
+    }
+
+    CHECK(!queue.read());
+}
+
+TEST(sender, no_resampling_float_96k) {
+    enum { HighSampleRate = 96000 };
+
+    packet::Queue queue;
+
+    config.input_sample_rate = HighSampleRate;
+    config.packet_length = SamplesPerPacket * core::Second / HighSampleRate;
+    config.payload_type = rtp::PayloadType_F32_96k_Stereo;
+    config.resampling = true;
+
+    Sender sender(config, source_port, queue, repair_port, queue, format_map, packet_pool,
+                  byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(sender.valid());
+    CHECK(!sender.has_resampler());
+
+    FrameWriter frame_writer(sender, sample_buffer_pool);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame * NumCh);
+    }
+
+    PacketReader packet_reader(queue, rtp_parser, pcm_float_decoder, packet_pool,
+                               config.payload_type, source_port.address);
+
+    for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+        packet_reader.read_packet(SamplesPerPacket, ChMask);
+    }
+
+    CHECK(!queue.read());
+}
+
+TEST(sender, resampling_when_rates_differ) {
+    packet::Queue queue;
+
+    config.input_sample_rate = 48000;
+    config.payload_type = rtp::PayloadType_L16_Stereo;
+    config.resampling = true;
+
+    Sender sender(config, source_port, queue, repair_port, queue, format_map, packet_pool,
+                  byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(sender.valid());
+    CHECK(sender.has_resampler());
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -229,6 +229,59 @@ TEST(sender_receiver, interleaving) {
     send_receive(FlagInterleaving, 1);
 }
 
+TEST(sender_receiver, s16le) {
+    enum { FrameSize = SamplesPerFrame * NumCh };
+
+    packet::Queue queue;
+
+    PortConfig source_port = source_port_config(FlagNone);
+    PortConfig repair_port = repair_port_config(FlagNone);
+
+    Sender sender(sender_config(FlagNone), source_port, queue, repair_port, queue,
+                  format_map, packet_pool, byte_buffer_pool, sample_buffer_pool,
+                  allocator);
+
+    CHECK(sender.valid());
+
+    Receiver receiver(receiver_config(FlagNone), format_map, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(source_port));
+
+    uint8_t frame[FrameSize * 2];
+    uint8_t offset = 0;
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        for (size_t n = 0; n < FrameSize; n++) {
+            const int16_t s = int16_t(nth_sample(offset++) * 32768);
+            frame[n * 2] = uint8_t(s & 0xff);
+            frame[n * 2 + 1] = uint8_t((s >> 8) & 0xff);
+        }
+        sender.write_as(frame, FrameSize, audio::SampleFormat_S16LE);
+    }
+
+    PacketSender packet_sender(packet_pool, receiver);
+    filter_packets(FlagNone, queue, packet_sender);
+
+    packet_sender.deliver(Latency / SamplesPerPacket);
+
+    offset = 0;
+
+    for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            receiver.read_as(frame, FrameSize, audio::SampleFormat_S16LE);
+
+            for (size_t n = 0; n < FrameSize; n++) {
+                const int16_t s = int16_t(frame[n * 2] | (frame[n * 2 + 1] << 8));
+                LONGS_EQUAL(int16_t(nth_sample(offset++) * 32768), s);
+            }
+        }
+
+        packet_sender.deliver(1);
+    }
+}
+
 #ifdef ROC_TARGET_OPENFEC
 TEST(sender_receiver, fec) {
     send_receive(FlagFEC, 1);
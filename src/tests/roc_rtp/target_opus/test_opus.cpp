@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/format_map.h"
+#include "roc_rtp/opus_decoder.h"
+#include "roc_rtp/opus_encoder.h"
+
+namespace roc {
+namespace rtp {
+
+namespace {
+
+enum {
+    NumCh = 2,
+    // 20ms
+    PacketSamples = 960,
+    NumPackets = 20,
+    MaxBufsz = 2048
+};
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBufsz, true);
+packet::PacketPool packet_pool(allocator, true);
+
+double sine(size_t n) {
+    return 0.5 * std::sin(2 * M_PI / OpusSampleRate * 440 * n);
+}
+
+} // namespace
+
+TEST_GROUP(opus) {
+    audio::sample_t input[PacketSamples * NumCh];
+    audio::sample_t output[PacketSamples * NumCh];
+
+    packet::PacketPtr new_packet(const OpusEncoder& encoder, size_t num_samples) {
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        core::Slice<uint8_t> bp = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+        CHECK(bp);
+
+        Composer composer(NULL);
+        CHECK(composer.prepare(*pp, bp, encoder.payload_size(num_samples)));
+
+        pp->set_data(bp);
+        return pp;
+    }
+
+    packet::PacketPtr encode(OpusEncoder & encoder, size_t packet_num) {
+        for (size_t n = 0; n < PacketSamples; n++) {
+            for (size_t ch = 0; ch < NumCh; ch++) {
+                input[n * NumCh + ch] =
+                    (audio::sample_t)sine(packet_num * PacketSamples + n);
+            }
+        }
+
+        packet::PacketPtr pp = new_packet(encoder, PacketSamples);
+
+        pp->rtp()->seqnum = (packet::seqnum_t)packet_num;
+        pp->rtp()->timestamp = (packet::timestamp_t)(packet_num * PacketSamples);
+
+        // write in two parts, like packetizer does when frame and packet
+        // boundaries don't match
+        UNSIGNED_LONGS_EQUAL(
+            PacketSamples / 2,
+            encoder.write_samples(*pp, 0, input, PacketSamples / 2, 0x3));
+        UNSIGNED_LONGS_EQUAL(PacketSamples / 2,
+                             encoder.write_samples(*pp, PacketSamples / 2,
+                                                   input + PacketSamples / 2 * NumCh,
+                                                   PacketSamples / 2, 0x3));
+
+        CHECK(encoder.finish_packet(*pp, PacketSamples));
+
+        return pp;
+    }
+
+    double rms(const audio::sample_t* samples, size_t n_samples) {
+        double sum = 0;
+        for (size_t n = 0; n < n_samples; n++) {
+            const double s = (double)samples[n];
+            sum += s * s;
+        }
+        return std::sqrt(sum / n_samples);
+    }
+};
+
+TEST(opus, encode_decode) {
+    OpusEncoder encoder(NumCh);
+    OpusDecoder decoder(NumCh);
+
+    CHECK(encoder.valid());
+    CHECK(decoder.valid());
+
+    for (size_t np = 0; np < NumPackets; np++) {
+        packet::PacketPtr pp = encode(encoder, np);
+
+        // constant bitrate
+        UNSIGNED_LONGS_EQUAL(encoder.payload_size(PacketSamples),
+                             pp->rtp()->payload.size());
+
+        UNSIGNED_LONGS_EQUAL(PacketSamples, opus_duration_from_header(*pp->rtp()));
+
+        // read in two parts, like depacketizer does
+        UNSIGNED_LONGS_EQUAL(
+            PacketSamples / 3,
+            decoder.read_samples(*pp, 0, output, PacketSamples / 3, 0x3));
+        UNSIGNED_LONGS_EQUAL(PacketSamples - PacketSamples / 3,
+                             decoder.read_samples(*pp, PacketSamples / 3,
+                                                  output + PacketSamples / 3 * NumCh,
+                                                  PacketSamples, 0x3));
+        UNSIGNED_LONGS_EQUAL(0,
+                             decoder.read_samples(*pp, PacketSamples, output,
+                                                  PacketSamples, 0x3));
+
+        // skip codec startup
+        if (np > 2) {
+            DOUBLES_EQUAL(rms(input, PacketSamples * NumCh),
+                          rms(output, PacketSamples * NumCh), 0.05);
+        }
+    }
+}
+
+TEST(opus, channel_mapping) {
+    OpusEncoder encoder(NumCh);
+    OpusDecoder decoder(NumCh);
+
+    CHECK(encoder.valid());
+    CHECK(decoder.valid());
+
+    audio::sample_t mono_output[PacketSamples];
+
+    for (size_t np = 0; np < NumPackets; np++) {
+        packet::PacketPtr pp = encode(encoder, np);
+
+        UNSIGNED_LONGS_EQUAL(
+            PacketSamples,
+            decoder.read_samples(*pp, 0, mono_output, PacketSamples, 0x1));
+
+        if (np > 2) {
+            DOUBLES_EQUAL(rms(input, PacketSamples * NumCh),
+                          rms(mono_output, PacketSamples), 0.05);
+        }
+    }
+}
+
+TEST(opus, conceal) {
+    OpusEncoder encoder(NumCh);
+    OpusDecoder decoder(NumCh);
+
+    CHECK(encoder.valid());
+    CHECK(decoder.valid());
+
+    // nothing to conceal from
+    UNSIGNED_LONGS_EQUAL(0, decoder.conceal_samples(output, PacketSamples, 0x3));
+
+    for (size_t np = 0; np < NumPackets; np++) {
+        packet::PacketPtr pp = encode(encoder, np);
+
+        UNSIGNED_LONGS_EQUAL(PacketSamples,
+                             decoder.read_samples(*pp, 0, output, PacketSamples, 0x3));
+    }
+
+    // concealed samples continue the signal instead of being silent
+    UNSIGNED_LONGS_EQUAL(PacketSamples,
+                         decoder.conceal_samples(output, PacketSamples, 0x3));
+    CHECK(rms(output, PacketSamples * NumCh) > 0.1);
+}
+
+TEST(opus, truncated_packet) {
+    OpusEncoder encoder(NumCh);
+    OpusDecoder decoder(NumCh);
+
+    CHECK(encoder.valid());
+    CHECK(decoder.valid());
+
+    // 7.5ms, padded with silence up to 10ms
+    const size_t num_samples = 360;
+
+    packet::PacketPtr pp = new_packet(encoder, num_samples);
+
+    for (size_t n = 0; n < num_samples * NumCh; n++) {
+        input[n] = 0.1f;
+    }
+
+    UNSIGNED_LONGS_EQUAL(num_samples,
+                         encoder.write_samples(*pp, 0, input, num_samples, 0x3));
+    CHECK(encoder.finish_packet(*pp, num_samples));
+
+    UNSIGNED_LONGS_EQUAL(480, opus_duration_from_header(*pp->rtp()));
+    UNSIGNED_LONGS_EQUAL(480, decoder.read_samples(*pp, 0, output, PacketSamples, 0x3));
+}
+
+TEST(opus, bandwidth) {
+    FormatMap format_map;
+
+    const Format* pcm_format = format_map.format(PayloadType_L16_Stereo);
+    const Format* opus_format = format_map.format(PayloadType_Opus_Stereo);
+
+    CHECK(pcm_format);
+    CHECK(opus_format);
+
+    const core::nanoseconds_t packet_length = 20 * core::Millisecond;
+
+    const size_t pcm_size = pcm_format->size(packet_length);
+    const size_t opus_size = opus_format->size(packet_length);
+
+    // L16 stereo at 44100 Hz is about 1.4 Mbit/s, Opus is 128 kbit/s
+    CHECK(opus_size * 8 < pcm_size);
+}
+
+TEST(opus, packet_length) {
+    FormatMap format_map;
+
+    const Format* format = format_map.format(PayloadType_Opus_Stereo);
+    CHECK(format);
+
+    CHECK(format->is_valid_duration(2500 * core::Microsecond));
+    CHECK(format->is_valid_duration(5 * core::Millisecond));
+    CHECK(format->is_valid_duration(10 * core::Millisecond));
+    CHECK(format->is_valid_duration(20 * core::Millisecond));
+    CHECK(format->is_valid_duration(40 * core::Millisecond));
+    CHECK(format->is_valid_duration(60 * core::Millisecond));
+
+    CHECK(!format->is_valid_duration(0));
+    CHECK(!format->is_valid_duration(7 * core::Millisecond));
+    CHECK(!format->is_valid_duration(30 * core::Millisecond));
+    CHECK(!format->is_valid_duration(120 * core::Millisecond));
+}
+
+} // namespace rtp
+} // namespace roc
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2018 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/helpers.h"
+#include "roc_core/unique_ptr.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/format_map.h"
+
+namespace roc {
+namespace rtp {
+
+namespace {
+
+enum { NumSamples = 96, MaxCh = 2, MaxBufSize = 2000 };
+
+const PayloadType pcm_types[] = {
+    PayloadType_L16_Stereo,     PayloadType_L16_Mono,       PayloadType_L16_48k_Stereo,
+    PayloadType_L16_48k_Mono,   PayloadType_L24_48k_Stereo, PayloadType_L24_48k_Mono,
+    PayloadType_F32_48k_Stereo, PayloadType_F32_48k_Mono,   PayloadType_L16_96k_Stereo,
+    PayloadType_L16_96k_Mono,   PayloadType_L24_96k_Stereo, PayloadType_L24_96k_Mono,
+    PayloadType_F32_96k_Stereo, PayloadType_F32_96k_Mono,
+};
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBufSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+} // namespace
+
+TEST_GROUP(format_map) {};
+
+TEST(format_map, find) {
+    FormatMap format_map;
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(pcm_types); n++) {
+        const Format* format = format_map.format(pcm_types[n]);
+        CHECK(format);
+
+        LONGS_EQUAL(pcm_types[n], format->payload_type);
+
+        CHECK(format == format_map.find(format->encoding, format->sample_rate,
+                                        format->channel_mask));
+    }
+
+    CHECK(!format_map.format(0));
+    CHECK(!format_map.find(Encoding_L24, 44100, 0x3));
+    CHECK(!format_map.find(Encoding_L16, 22050, 0x3));
+    CHECK(!format_map.find(Encoding_L16, 48000, 0x7));
+}
+
+TEST(format_map, packet_size) {
+    FormatMap format_map;
+
+    const Format* l16 = format_map.find(Encoding_L16, 48000, 0x3);
+    const Format* l24 = format_map.find(Encoding_L24, 48000, 0x3);
+    const Format* f32 = format_map.find(Encoding_Float32, 96000, 0x1);
+
+    CHECK(l16);
+    CHECK(l24);
+    CHECK(f32);
+
+    UNSIGNED_LONGS_EQUAL(sizeof(Header) + 48 * 2 * 2, l16->size(core::Millisecond));
+    UNSIGNED_LONGS_EQUAL(sizeof(Header) + 48 * 2 * 3, l24->size(core::Millisecond));
+    UNSIGNED_LONGS_EQUAL(sizeof(Header) + 96 * 1 * 4, f32->size(core::Millisecond));
+}
+
+TEST(format_map, encode_decode) {
+    FormatMap format_map;
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(pcm_types); n++) {
+        const Format* format = format_map.format(pcm_types[n]);
+        CHECK(format);
+
+        core::UniquePtr<audio::IEncoder> encoder(format->new_encoder(allocator),
+                                                 allocator);
+        core::UniquePtr<audio::IDecoder> decoder(format->new_decoder(allocator),
+                                                 allocator);
+        CHECK(encoder);
+        CHECK(decoder);
+
+        const size_t num_ch = packet::num_channels(format->channel_mask);
+
+        audio::sample_t input[NumSamples * MaxCh];
+        for (size_t i = 0; i < NumSamples * num_ch; i++) {
+            input[i] = float(i) / (NumSamples * MaxCh) - 0.5f;
+        }
+
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        core::Slice<uint8_t> bp = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+        CHECK(bp);
+
+        Composer composer(NULL);
+        CHECK(composer.prepare(*pp, bp, encoder->payload_size(NumSamples)));
+        pp->set_data(bp);
+
+        UNSIGNED_LONGS_EQUAL(NumSamples,
+                             encoder->write_samples(*pp, 0, input, NumSamples,
+                                                    format->channel_mask));
+        UNSIGNED_LONGS_EQUAL(NumSamples, format->duration(*pp->rtp()));
+
+        audio::sample_t output[NumSamples * MaxCh];
+        UNSIGNED_LONGS_EQUAL(NumSamples,
+                             decoder->read_samples(*pp, 0, output, NumSamples,
+                                                   format->channel_mask));
+
+        const float epsilon = format->encoding == Encoding_L16 ? 1.0f / 16384 : 1e-6f;
+        for (size_t i = 0; i < NumSamples * num_ch; i++) {
+            DOUBLES_EQUAL(input[i], output[i], epsilon);
+        }
+    }
+}
+
+} // namespace rtp
+} // namespace roc
@@ -10,6 +10,8 @@
 
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/helpers.h"
+#include "roc_core/random.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_rtp/composer.h"
 #include "roc_rtp/pcm_decoder.h"
@@ -79,6 +81,81 @@ TEST_GROUP(pcm) {
             decoder.read_samples(*pp, offset, output, num_samples, channels));
     }
 
+    // Encodes and decodes random samples using selected kernels and
+    // generic ones, and checks that results are identical.
+    template <class Sample, size_t NumCh>
+    void check_kernels(packet::channel_mask_t channels) {
+        enum { NumSamples = 37, MaxCh = 3 };
+
+        const size_t num_channels = packet::num_channels(channels);
+
+        audio::sample_t input[NumSamples * MaxCh];
+        for (size_t n = 0; n < NumSamples * num_channels; n++) {
+            input[n] = float(core::random(0, 2000)) / 1000 - 1;
+        }
+
+        uint8_t kernel_data[NumSamples * NumCh * sizeof(Sample)];
+        uint8_t generic_data[NumSamples * NumCh * sizeof(Sample)];
+
+        for (size_t n = 0; n < sizeof(kernel_data); n++) {
+            kernel_data[n] = generic_data[n] = (uint8_t)n;
+        }
+
+        size_t ns = pcm_write<Sample, NumCh>(kernel_data, sizeof(kernel_data), 0, input,
+                                             NumSamples, channels,
+                                             pcm_encode_kernel<Sample, NumCh>(channels));
+        UNSIGNED_LONGS_EQUAL(NumSamples, ns);
+
+        ns = pcm_write<Sample, NumCh>(generic_data, sizeof(generic_data), 0, input,
+                                      NumSamples, channels);
+        UNSIGNED_LONGS_EQUAL(NumSamples, ns);
+
+        CHECK(memcmp(kernel_data, generic_data, sizeof(kernel_data)) == 0);
+
+        audio::sample_t kernel_output[NumSamples * MaxCh];
+        audio::sample_t generic_output[NumSamples * MaxCh];
+
+        ns = pcm_read<Sample, NumCh>(kernel_data, sizeof(kernel_data), 0, kernel_output,
+                                     NumSamples, channels,
+                                     pcm_decode_kernel<Sample, NumCh>(channels));
+        UNSIGNED_LONGS_EQUAL(NumSamples, ns);
+
+        ns = pcm_read<Sample, NumCh>(generic_data, sizeof(generic_data), 0,
+                                     generic_output, NumSamples, channels);
+        UNSIGNED_LONGS_EQUAL(NumSamples, ns);
+
+        for (size_t n = 0; n < NumSamples * num_channels; n++) {
+            DOUBLES_EQUAL(generic_output[n], kernel_output[n], 0);
+        }
+    }
+
+    template <class Sample> void check_kernels() {
+        const packet::channel_mask_t masks[] = { 0x1, 0x2, 0x3, 0x5, 0x7 };
+
+        for (size_t n = 0; n < ROC_ARRAY_SIZE(masks); n++) {
+            check_kernels<Sample, 1>(masks[n]);
+            check_kernels<Sample, 2>(masks[n]);
+        }
+    }
+
+    template <class Sample> void check_precision(float epsilon) {
+        enum { NumSamples = 9 };
+
+        const audio::sample_t input[NumSamples] = {
+            -1.0f, -0.75f, -0.5f, -0.123456f, 0.0f, 0.123456f, 0.5f, 0.75f, 0.99f,
+        };
+
+        Sample data[NumSamples];
+        audio::sample_t output[NumSamples];
+
+        pcm_write<Sample, 1>(data, sizeof(data), 0, input, NumSamples, 0x1);
+        pcm_read<Sample, 1>(data, sizeof(data), 0, output, NumSamples, 0x1);
+
+        for (size_t n = 0; n < NumSamples; n++) {
+            DOUBLES_EQUAL(input[n], output[n], epsilon);
+        }
+    }
+
     void check(const audio::sample_t* samples, size_t num_samples,
                packet::channel_mask_t channels) {
         size_t n = 0;
@@ -456,5 +533,73 @@ TEST(pcm, decode_truncate) {
     check(output, NumSamples, 0x3);
 }
 
+TEST(pcm, kernels_int16) {
+    check_kernels<int16_t>();
+}
+
+TEST(pcm, kernels_int24) {
+    check_kernels<PCMInt24>();
+}
+
+TEST(pcm, kernels_float32) {
+    check_kernels<PCMFloat32>();
+}
+
+TEST(pcm, precision_int16) {
+    check_precision<int16_t>(2.0f / 32768);
+}
+
+TEST(pcm, precision_int24) {
+    check_precision<PCMInt24>(2.0f / 8388608);
+}
+
+TEST(pcm, precision_float32) {
+    check_precision<PCMFloat32>(0);
+}
+
+TEST(pcm, encoder_decoder_change_mask) {
+    enum { NumSamples = 5 };
+
+    packet::PacketPtr pp = new_packet<int16_t, 2>(NumSamples);
+
+    const audio::sample_t input[NumSamples * 2] = {
+        -0.1f, 0.1f, //
+        -0.2f, 0.2f, //
+        -0.3f, 0.3f, //
+        -0.4f, 0.4f, //
+        -0.5f, 0.5f, //
+    };
+
+    PCMEncoder<int16_t, 2> encoder;
+
+    // stereo kernel, then mono to stereo kernel
+    UNSIGNED_LONGS_EQUAL(NumSamples,
+                         encoder.write_samples(*pp, 0, input, NumSamples, 0x3));
+    UNSIGNED_LONGS_EQUAL(NumSamples,
+                         encoder.write_samples(*pp, 0, input, NumSamples, 0x1));
+
+    for (size_t i = 0; i < MaxSamples; i++) {
+        output[i] = 0.0f;
+    }
+
+    PCMDecoder<int16_t, 2> decoder;
+
+    // stereo to mono kernel, then stereo kernel
+    UNSIGNED_LONGS_EQUAL(NumSamples,
+                         decoder.read_samples(*pp, 0, output, NumSamples, 0x1));
+    UNSIGNED_LONGS_EQUAL(NumSamples,
+                         decoder.read_samples(*pp, 0, output, NumSamples, 0x3));
+
+    const audio::sample_t expected[NumSamples * 2] = {
+        -0.1f, 0.1f, //
+        0.1f,  0.2f, //
+        -0.2f, 0.3f, //
+        0.2f,  0.4f, //
+        -0.3f, 0.5f, //
+    };
+
+    check(expected, NumSamples, 0x3);
+}
+
 } // namespace rtp
 } // namespace roc
@@ -114,6 +114,26 @@ int main(int argc, char** argv) {
         config.default_session.fec.n_repair_packets = (size_t)args.nbrpr_arg;
     }
 
+    if (args.fec_threads_given) {
+        if (config.default_session.fec.codec == fec::NoCodec) {
+            roc_log(LogError, "--fec-threads can't be used when --fec=none");
+            return 1;
+        }
+        if (args.fec_threads_arg < 0) {
+            roc_log(LogError, "invalid --fec-threads: should be >= 0");
+            return 1;
+        }
+        config.fec_decoding_threads = (size_t)args.fec_threads_arg;
+    }
+
+    if (args.session_pool_given) {
+        if (args.session_pool_arg < 0) {
+            roc_log(LogError, "invalid --session-pool: should be >= 0");
+            return 1;
+        }
+        config.session_pool_size = (size_t)args.session_pool_arg;
+    }
+
     if (args.latency_given) {
         if (!core::parse_duration(args.latency_arg,
                                   config.default_session.target_latency)) {
@@ -144,6 +164,30 @@ int main(int argc, char** argv) {
             config.default_session.target_latency * pipeline::DefaultMaxLatencyFactor;
     }
 
+    config.default_session.latency_monitor.latency_recovery =
+        !args.no_latency_recovery_flag;
+
+    config.default_session.latency_tuner.enabled = args.adaptive_latency_flag;
+    config.default_session.latency_tuner.max_latency =
+        config.default_session.target_latency;
+
+    if (args.min_target_latency_given) {
+        if (!core::parse_duration(args.min_target_latency_arg,
+                                  config.default_session.latency_tuner.min_latency)) {
+            roc_log(LogError, "invalid --min-target-latency");
+            return 1;
+        }
+        if (config.default_session.latency_tuner.min_latency
+            > config.default_session.target_latency) {
+            roc_log(LogError, "invalid --min-target-latency: should be <= --latency");
+            return 1;
+        }
+    } else if (config.default_session.latency_tuner.min_latency
+               > config.default_session.target_latency) {
+        config.default_session.latency_tuner.min_latency =
+            config.default_session.target_latency;
+    }
+
     if (args.np_timeout_given) {
         if (!core::parse_duration(args.np_timeout_arg,
                                   config.default_session.watchdog.no_playback_timeout)) {
@@ -223,7 +267,9 @@ int main(int argc, char** argv) {
     }
 
     config.output.poisoning = args.poisoning_flag;
+    config.default_session.plc.enabled = !args.no_plc_flag;
     config.output.beeping = args.beeping_flag;
+    config.profiling = args.profile_flag;
 
     core::HeapAllocator allocator;
     core::BufferPool<uint8_t> byte_buffer_pool(allocator, MaxPacketSize,
@@ -306,6 +352,12 @@ int main(int argc, char** argv) {
     if (player.start()) {
         player.join();
         status = 0;
+
+        if (args.profile_flag) {
+            pipeline::ProfilerStats profile;
+            receiver.get_profile(profile);
+            pipeline::log_profile(profile);
+        }
     } else {
         roc_log(LogError, "can't start player");
     }
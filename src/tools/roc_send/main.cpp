@@ -10,6 +10,7 @@
 #include "roc_core/crash.h"
 #include "roc_core/heap_allocator.h"
 #include "roc_core/log.h"
+#include "roc_core/parse_duration.h"
 #include "roc_core/scoped_destructor.h"
 #include "roc_netio/transceiver.h"
 #include "roc_packet/address_to_str.h"
@@ -75,6 +76,72 @@ int main(int argc, char** argv) {
         packet::parse_address(":0", local_addr);
     }
 
+    rtp::Encoding encoding = rtp::Encoding_L16;
+    size_t packet_rate = 44100;
+
+    switch ((unsigned)args.codec_arg) {
+    case codec_arg_l16:
+        encoding = rtp::Encoding_L16;
+        packet_rate = 44100;
+        break;
+
+    case codec_arg_l24:
+        encoding = rtp::Encoding_L24;
+        packet_rate = 48000;
+        break;
+
+    case codec_arg_f32:
+        encoding = rtp::Encoding_Float32;
+        packet_rate = 48000;
+        break;
+
+    case codec_arg_opus:
+        encoding = rtp::Encoding_Opus;
+        packet_rate = 48000;
+        break;
+
+    default:
+        break;
+    }
+
+    if (args.packet_rate_given) {
+        if (args.packet_rate_arg <= 0) {
+            roc_log(LogError, "invalid --packet-rate: should be > 0");
+            return 1;
+        }
+        packet_rate = (size_t)args.packet_rate_arg;
+    }
+
+    rtp::FormatMap format_map;
+
+    const rtp::Format* format =
+        format_map.find(encoding, packet_rate, config.input_channels);
+    if (!format) {
+        roc_log(LogError,
+                "unsupported --codec and --packet-rate combination"
+                " or codec not enabled at build time");
+        return 1;
+    }
+    config.payload_type = format->payload_type;
+
+    if (format->encoding == rtp::Encoding_Opus) {
+        config.packet_length = pipeline::DefaultOpusPacketLength;
+    }
+
+    if (args.packet_length_given) {
+        if (!core::parse_duration(args.packet_length_arg, config.packet_length)) {
+            roc_log(LogError, "invalid --packet-length");
+            return 1;
+        }
+    }
+
+    if (!format->is_valid_duration(config.packet_length)) {
+        roc_log(LogError,
+                "invalid --packet-length: not supported by --codec"
+                " (opus supports 2500us, 5ms, 10ms, 20ms, 40ms, 60ms)");
+        return 1;
+    }
+
     switch ((unsigned)args.fec_arg) {
     case fec_arg_none:
         config.fec.codec = fec::NoCodec;
@@ -122,6 +189,14 @@ int main(int argc, char** argv) {
         config.fec.n_repair_packets = (size_t)args.nbrpr_arg;
     }
 
+    if (args.fec_pacing_flag) {
+        if (config.fec.codec == fec::NoCodec) {
+            roc_log(LogError, "--fec-pacing can't be used when --fec=none");
+            return 1;
+        }
+        config.fec.pace_repair_packets = true;
+    }
+
     config.resampling = !args.no_resampling_flag;
 
     switch ((unsigned)args.resampler_profile_arg) {
@@ -166,12 +241,26 @@ int main(int argc, char** argv) {
         sample_rate = (size_t)args.rate_arg;
     } else {
         if (!config.resampling) {
-            sample_rate = pipeline::DefaultSampleRate;
+            sample_rate = format->sample_rate;
         }
     }
 
     config.interleaving = args.interleaving_flag;
+
+    if (args.interleaving_depth_given) {
+        if (!config.interleaving) {
+            roc_log(LogError,
+                    "--interleaving-depth can't be used without --interleaving");
+            return 1;
+        }
+        if (args.interleaving_depth_arg <= 0) {
+            roc_log(LogError, "invalid --interleaving-depth: should be > 0");
+            return 1;
+        }
+        config.interleaving_depth = (size_t)args.interleaving_depth_arg;
+    }
     config.poisoning = args.poisoning_flag;
+    config.profiling = args.profile_flag;
 
     core::HeapAllocator allocator;
     core::BufferPool<uint8_t> byte_buffer_pool(allocator, MaxPacketSize,
@@ -192,15 +281,29 @@ int main(int argc, char** argv) {
     config.timing = reader.is_file();
     config.input_sample_rate = reader.sample_rate();
 
-    rtp::FormatMap format_map;
-
     netio::Transceiver trx(packet_pool, byte_buffer_pool, allocator);
     if (!trx.valid()) {
         roc_log(LogError, "can't create network transceiver");
         return 1;
     }
 
-    packet::IWriter* udp_sender = trx.add_udp_sender(local_addr);
+    netio::UDPSenderConfig udp_config;
+
+    switch ((unsigned)args.pacing_arg) {
+    case pacing_arg_software:
+        config.pacing = true;
+        break;
+
+    case pacing_arg_txtime:
+        config.pacing = true;
+        udp_config.txtime = true;
+        break;
+
+    default:
+        break;
+    }
+
+    packet::IWriter* udp_sender = trx.add_udp_sender(local_addr, udp_config);
     if (!udp_sender) {
         roc_log(LogError, "can't create udp sender");
         return 1;
@@ -214,6 +317,11 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    if (!sender.reserve()) {
+        roc_log(LogError, "can't reserve packets for sender pipeline");
+        return 1;
+    }
+
     if (!trx.start()) {
         roc_log(LogError, "can't start transceiver");
         return 1;
@@ -223,7 +331,14 @@ int main(int argc, char** argv) {
 
     if (reader.start(sender)) {
         reader.join();
+        sender.flush();
         status = 0;
+
+        if (args.profile_flag) {
+            pipeline::ProfilerStats profile;
+            sender.get_profile(profile);
+            pipeline::log_profile(profile);
+        }
     } else {
         roc_log(LogError, "can't start reader");
     }